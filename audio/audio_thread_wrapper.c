@@ -22,6 +22,7 @@
 
 #include "audio_thread_wrapper.h"
 #include "../verbosity.h"
+#include "../frame_trace.h"
 
 typedef struct audio_thread
 {
@@ -57,6 +58,8 @@ static void audio_thread_loop(void *data)
    if (!thr)
       return;
 
+   frame_trace_set_thread_name("audio");
+
    thr->driver_data   = thr->driver->init(
          thr->device, thr->out_rate, thr->latency,
          thr->block_frames, thr->new_rate);
@@ -106,7 +109,10 @@ static void audio_thread_loop(void *data)
       }
 
       slock_unlock(thr->lock);
+
+      FRAME_TRACE_BEGIN("audio_callback");
       audio_driver_callback();
+      FRAME_TRACE_END("audio_callback");
    }
 
    thr->driver->free(thr->driver_data);
@@ -0,0 +1,308 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2020 - The RetroArch team
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__NetBSD__)
+#include <sys/resource.h>
+#define HAVE_BENCHMARK_RSS
+#endif
+
+#include <compat/strl.h>
+#include <retro_miscellaneous.h>
+#include <features/features_cpu.h>
+#include <streams/file_stream.h>
+
+#include "benchmark.h"
+#include "verbosity.h"
+
+typedef struct benchmark_samples
+{
+   retro_perf_tick_t *data;
+   size_t size;
+   size_t capacity;
+} benchmark_samples_t;
+
+typedef struct benchmark_state
+{
+   benchmark_samples_t stages[BENCHMARK_STAGE_LAST];
+   benchmark_samples_t frames;
+   benchmark_samples_t draw_calls;
+   benchmark_samples_t primitives;
+   retro_perf_tick_t stage_start[BENCHMARK_STAGE_LAST];
+   retro_perf_tick_t stage_total[BENCHMARK_STAGE_LAST];
+   retro_perf_tick_t frame_last;
+   retro_perf_tick_t first_ticks;
+   retro_time_t first_usec;
+   unsigned stage_runs[BENCHMARK_STAGE_LAST];
+   char path[PATH_MAX_LENGTH];
+   bool enabled;
+} benchmark_state_t;
+
+static const char *benchmark_stage_names[BENCHMARK_STAGE_LAST] = {
+   "core_run",
+   "pixel_conversion",
+   "audio_resample",
+   "rewind",
+   "runahead"
+};
+
+static benchmark_state_t benchmark_st;
+
+static void benchmark_samples_push(benchmark_samples_t *samples,
+      retro_perf_tick_t value)
+{
+   if (samples->size == samples->capacity)
+   {
+      size_t capacity         = samples->capacity
+         ? samples->capacity * 2 : 4096;
+      retro_perf_tick_t *data = (retro_perf_tick_t*)realloc(samples->data,
+            capacity * sizeof(*data));
+
+      if (!data)
+         return;
+
+      samples->data           = data;
+      samples->capacity       = capacity;
+   }
+
+   samples->data[samples->size++] = value;
+}
+
+static int benchmark_ticks_compare(const void *a, const void *b)
+{
+   retro_perf_tick_t x = *(const retro_perf_tick_t*)a;
+   retro_perf_tick_t y = *(const retro_perf_tick_t*)b;
+   return (x > y) - (x < y);
+}
+
+/* Times are written in microseconds with a _us suffix,
+ * counts with a scale of 1 and no suffix */
+static void benchmark_samples_write(RFILE *file, const char *name,
+      benchmark_samples_t *samples, double scale, const char *suffix,
+      bool last)
+{
+   size_t i;
+   double total = 0.0;
+   size_t size  = samples->size;
+
+   if (!size)
+   {
+      filestream_printf(file, "    \"%s\": { \"samples\": 0 }%s\n",
+            name, last ? "" : ",");
+      return;
+   }
+
+   /* Percentiles by nearest rank */
+   qsort(samples->data, size, sizeof(*samples->data),
+         benchmark_ticks_compare);
+   for (i = 0; i < size; i++)
+      total += (double)samples->data[i];
+
+   filestream_printf(file,
+         "    \"%s\": { \"samples\": %u, \"mean%s\": %.3f, "
+         "\"p50%s\": %.3f, \"p90%s\": %.3f, \"p99%s\": %.3f, "
+         "\"max%s\": %.3f }%s\n",
+         name, (unsigned)size,
+         suffix, total / size * scale,
+         suffix, samples->data[(size - 1) * 50 / 100] * scale,
+         suffix, samples->data[(size - 1) * 90 / 100] * scale,
+         suffix, samples->data[(size - 1) * 99 / 100] * scale,
+         suffix, samples->data[size - 1] * scale,
+         last ? "" : ",");
+}
+
+static int64_t benchmark_peak_rss_kib(void)
+{
+#ifdef HAVE_BENCHMARK_RSS
+   struct rusage usage;
+
+   if (getrusage(RUSAGE_SELF, &usage) != 0)
+      return -1;
+#ifdef __APPLE__
+   return (int64_t)usage.ru_maxrss / 1024;
+#else
+   return (int64_t)usage.ru_maxrss;
+#endif
+#else
+   return -1;
+#endif
+}
+
+bool benchmark_init(const char *path)
+{
+   benchmark_state_t *st = &benchmark_st;
+
+   if (st->enabled)
+      benchmark_deinit();
+
+   memset(st, 0, sizeof(*st));
+   strlcpy(st->path, path, sizeof(st->path));
+   st->enabled = true;
+
+   RARCH_LOG("[Benchmark]: Running headless, report goes to \"%s\".\n",
+         path);
+
+   return true;
+}
+
+void benchmark_deinit(void)
+{
+   unsigned i;
+   benchmark_state_t *st = &benchmark_st;
+
+   for (i = 0; i < BENCHMARK_STAGE_LAST; i++)
+      free(st->stages[i].data);
+   free(st->frames.data);
+   free(st->draw_calls.data);
+   free(st->primitives.data);
+
+   memset(st, 0, sizeof(*st));
+}
+
+bool benchmark_is_enabled(void)
+{
+   return benchmark_st.enabled;
+}
+
+void benchmark_begin(enum benchmark_stage stage)
+{
+   benchmark_st.stage_start[stage] = cpu_features_get_perf_counter();
+}
+
+void benchmark_end(enum benchmark_stage stage)
+{
+   benchmark_state_t *st  = &benchmark_st;
+   st->stage_total[stage] += cpu_features_get_perf_counter()
+      - st->stage_start[stage];
+   st->stage_runs[stage]++;
+}
+
+void benchmark_frame(void)
+{
+   unsigned i;
+   benchmark_state_t *st   = &benchmark_st;
+   retro_perf_tick_t ticks = cpu_features_get_perf_counter();
+
+   if (!st->enabled)
+      return;
+
+   /* The first frame only starts the clock */
+   if (st->frame_last)
+      benchmark_samples_push(&st->frames, ticks - st->frame_last);
+   else
+   {
+      st->first_ticks = ticks;
+      st->first_usec  = cpu_features_get_time_usec();
+   }
+   st->frame_last     = ticks;
+
+   for (i = 0; i < BENCHMARK_STAGE_LAST; i++)
+   {
+      if (!st->stage_runs[i])
+         continue;
+      if (st->frames.size)
+         benchmark_samples_push(&st->stages[i], st->stage_total[i]);
+      st->stage_total[i] = 0;
+      st->stage_runs[i]  = 0;
+   }
+}
+
+void benchmark_display(unsigned draw_calls, unsigned primitives)
+{
+   benchmark_state_t *st = &benchmark_st;
+
+   if (!st->enabled)
+      return;
+
+   benchmark_samples_push(&st->draw_calls, draw_calls);
+   benchmark_samples_push(&st->primitives, primitives);
+}
+
+bool benchmark_report(void)
+{
+   unsigned i;
+   int64_t peak_rss;
+   double usec_per_tick  = 0.0;
+   double seconds        = 0.0;
+   RFILE *file           = NULL;
+   benchmark_state_t *st = &benchmark_st;
+   size_t frames         = st->frames.size;
+
+   if (!st->enabled)
+      return false;
+
+   /* cpu_features_get_perf_counter() is not in any fixed unit on every
+    * platform, so measure it against the microsecond clock */
+   if (frames)
+   {
+      retro_time_t usec = cpu_features_get_time_usec() - st->first_usec;
+      retro_perf_tick_t ticks = cpu_features_get_perf_counter()
+         - st->first_ticks;
+      if (ticks)
+         usec_per_tick = (double)usec / (double)ticks;
+      seconds = (double)(st->frame_last - st->first_ticks)
+         * usec_per_tick / 1000000.0;
+   }
+
+   if (!(file = filestream_open(st->path,
+               RETRO_VFS_FILE_ACCESS_WRITE,
+               RETRO_VFS_FILE_ACCESS_HINT_NONE)))
+   {
+      RARCH_ERR("[Benchmark]: Failed to open \"%s\" for writing.\n",
+            st->path);
+      return false;
+   }
+
+   peak_rss = benchmark_peak_rss_kib();
+
+   filestream_printf(file, "{\n");
+   filestream_printf(file, "  \"frames\": %u,\n", (unsigned)frames);
+   filestream_printf(file, "  \"seconds\": %.6f,\n", seconds);
+   filestream_printf(file, "  \"fps\": %.3f,\n",
+         seconds > 0.0 ? frames / seconds : 0.0);
+   if (peak_rss >= 0)
+      filestream_printf(file, "  \"peak_rss_kib\": %u,\n",
+            (unsigned)peak_rss);
+   else
+      filestream_printf(file, "  \"peak_rss_kib\": null,\n");
+   filestream_printf(file, "  \"stages\": {\n");
+   benchmark_samples_write(file, "frame", &st->frames,
+         usec_per_tick, "_us", false);
+   for (i = 0; i < BENCHMARK_STAGE_LAST; i++)
+      benchmark_samples_write(file, benchmark_stage_names[i],
+            &st->stages[i], usec_per_tick, "_us",
+            i == BENCHMARK_STAGE_LAST - 1);
+   filestream_printf(file, "  },\n");
+   /* Per video frame. With the null video driver only the
+    * menu is drawn, through the null display driver, so run
+    * with --menu to measure it. Textures and font glyphs are
+    * not loaded there, so icons and text are not counted. */
+   filestream_printf(file, "  \"display\": {\n");
+   benchmark_samples_write(file, "draw_calls", &st->draw_calls,
+         1.0, "", false);
+   benchmark_samples_write(file, "primitives", &st->primitives,
+         1.0, "", true);
+   filestream_printf(file, "  }\n}\n");
+   filestream_close(file);
+
+   RARCH_LOG("[Benchmark]: %u frames in %.3f s (%.2f fps).\n",
+         (unsigned)frames, seconds,
+         seconds > 0.0 ? frames / seconds : 0.0);
+
+   return true;
+}
@@ -0,0 +1,97 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2020 - The RetroArch team
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _BENCHMARK_H
+#define _BENCHMARK_H
+
+#include <boolean.h>
+#include <retro_common_api.h>
+
+RETRO_BEGIN_DECLS
+
+/* Benchmark mode runs content headless and unthrottled, and times
+ * the stages of every frame. All stages run on the main thread. */
+
+enum benchmark_stage
+{
+   BENCHMARK_STAGE_CORE_RUN = 0,
+   BENCHMARK_STAGE_PIXEL_CONVERSION,
+   BENCHMARK_STAGE_AUDIO_RESAMPLE,
+   BENCHMARK_STAGE_REWIND,
+   BENCHMARK_STAGE_RUNAHEAD,
+   BENCHMARK_STAGE_LAST
+};
+
+/**
+ * benchmark_init:
+ * @path               : file the report is written to
+ *
+ * Enables benchmark mode.
+ *
+ * Returns: true if benchmark mode could be enabled, otherwise false.
+ **/
+bool benchmark_init(const char *path);
+
+void benchmark_deinit(void);
+
+bool benchmark_is_enabled(void);
+
+void benchmark_begin(enum benchmark_stage stage);
+
+void benchmark_end(enum benchmark_stage stage);
+
+/**
+ * benchmark_frame:
+ *
+ * Ends a frame: records its duration, and the time each stage took
+ * in it.
+ **/
+void benchmark_frame(void);
+
+/**
+ * benchmark_display:
+ * @draw_calls         : gfx_display draw calls since the last frame
+ * @primitives         : primitives submitted by those draw calls
+ *
+ * Records the menu and widget draw load of a video frame.
+ **/
+void benchmark_display(unsigned draw_calls, unsigned primitives);
+
+/**
+ * benchmark_report:
+ *
+ * Writes frames per second, timing percentiles of every stage,
+ * display draw counts and peak memory use as JSON to the file
+ * given to benchmark_init().
+ *
+ * Returns: true if the report was written, otherwise false.
+ **/
+bool benchmark_report(void);
+
+#define BENCHMARK_BEGIN(stage) do \
+{ \
+   if (benchmark_is_enabled()) \
+      benchmark_begin(stage); \
+} while (0)
+
+#define BENCHMARK_END(stage) do \
+{ \
+   if (benchmark_is_enabled()) \
+      benchmark_end(stage); \
+} while (0)
+
+RETRO_END_DECLS
+
+#endif
@@ -259,6 +259,12 @@
  */
 #define DEFAULT_FRAME_DELAY 0
 
+/* Picks the frame delay automatically from measured core run
+ * time, backing off when frames overrun. Frame delay, if set,
+ * becomes the upper limit.
+ */
+#define DEFAULT_FRAME_DELAY_AUTO false
+
 /* Inserts a black frame inbetween frames.
  * Useful for 120 Hz monitors who want to play 60 Hz material with eliminated
  * ghosting. video_refresh_rate should still be configured as if it
@@ -943,10 +949,22 @@ static const bool netplay_client_swap_input = true;
 
 static const bool netplay_nat_traversal = false;
 
+/* Also send netplay input over UDP, with some history, so that
+ * lost or stalled TCP segments don't delay remote input. */
+static const bool netplay_udp_input = false;
+
+/* When hosting, send to spectators from a separate thread, serializing
+ * what they all receive only once. */
+static const bool netplay_spectator_relay = false;
+
 static const unsigned netplay_delay_frames = 16;
 
 static const int netplay_check_frames = 600;
 
+/* Maximum number of frames between netplay savestate checkpoints while
+ * no replays are needed. 1 serializes every frame. */
+static const unsigned netplay_checkpoint_frames = 1;
+
 static const bool netplay_use_mitm_server = false;
 
 #define DEFAULT_NETPLAY_MITM_SERVER "nyc"
@@ -1144,6 +1162,11 @@ static const bool input_descriptor_label_show = true;
 
 static const bool input_descriptor_hide_unbound = false;
 
+/* Read keyboard and mouse events in the udev input driver from
+ * a separate thread, so that they are waiting, in order, for
+ * the moment input is polled. */
+static const bool input_udev_reader_thread = false;
+
 static const unsigned input_max_users = 5;
 
 static const unsigned input_poll_type_behavior = 2;
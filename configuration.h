@@ -158,6 +158,7 @@ typedef struct settings
       unsigned netplay_port;
       unsigned netplay_input_latency_frames_min;
       unsigned netplay_input_latency_frames_range;
+      unsigned netplay_checkpoint_frames;
       unsigned netplay_share_digital;
       unsigned netplay_share_analog;
       unsigned bundle_assets_extract_version_current;
@@ -434,6 +435,7 @@ typedef struct settings
       bool video_fullscreen;
       bool video_windowed_fullscreen;
       bool video_vsync;
+      bool video_frame_delay_auto;
       bool video_adaptive_vsync;
       bool video_hard_sync;
       bool video_black_frame_insertion;
@@ -500,6 +502,7 @@ typedef struct settings
       bool input_backtouch_toggle;
       bool input_small_keyboard_enable;
       bool input_keyboard_gamepad_enable;
+      bool input_udev_reader_thread;
 
       /* Frame time counter */
       bool frame_time_counter_reset_after_fastforwarding;
@@ -641,6 +644,8 @@ typedef struct settings
       bool netplay_require_slaves;
       bool netplay_stateless_mode;
       bool netplay_nat_traversal;
+      bool netplay_udp_input;
+      bool netplay_spectator_relay;
       bool netplay_use_mitm_server;
       bool netplay_request_devices[MAX_USERS];
 
@@ -23,11 +23,24 @@
 #include <lists/dir_list.h>
 #include <file/archive_file.h>
 
+/* The core info cache is keyed by .info file
+ * modification times, which requires stat() */
+#if defined(__unix__) || defined(__APPLE__) || defined(__HAIKU__) || (defined(_WIN32) && !defined(_XBOX))
+#include <sys/types.h>
+#include <sys/stat.h>
+#define HAVE_CORE_INFO_CACHE
+/* MSVC only has the S_IF* masks */
+#ifndef S_ISREG
+#define S_ISREG(mode) (((mode) & S_IFMT) == S_IFREG)
+#endif
+#endif
+
 #ifdef HAVE_CONFIG_H
 #include "config.h"
 #endif
 
 #include "retroarch.h"
+#include "verbosity.h"
 
 #include "core_info.h"
 #include "file_path_special.h"
@@ -90,157 +103,719 @@ static void core_info_list_resolve_all_extensions(
 #endif
 }
 
-static void core_info_list_resolve_all_firmware(
-      core_info_list_t *core_info_list)
+static void core_info_free_fields(core_info_t *info)
 {
    size_t i;
-   unsigned c;
+
+   free(info->display_name);
+   free(info->display_version);
+   free(info->core_name);
+   free(info->systemname);
+   free(info->system_id);
+   free(info->system_manufacturer);
+   free(info->supported_extensions);
+   free(info->authors);
+   free(info->permissions);
+   free(info->licenses);
+   free(info->categories);
+   free(info->databases);
+   free(info->notes);
+   free(info->required_hw_api);
+   free(info->description);
+   string_list_free(info->supported_extensions_list);
+   string_list_free(info->authors_list);
+   string_list_free(info->note_list);
+   string_list_free(info->permissions_list);
+   string_list_free(info->licenses_list);
+   string_list_free(info->categories_list);
+   string_list_free(info->databases_list);
+   string_list_free(info->required_hw_api_list);
+
+   for (i = 0; i < info->firmware_count; i++)
+   {
+      free(info->firmware[i].path);
+      free(info->firmware[i].desc);
+   }
+   free(info->firmware);
+
+   info->display_name              = NULL;
+   info->display_version           = NULL;
+   info->core_name                 = NULL;
+   info->systemname                = NULL;
+   info->system_id                 = NULL;
+   info->system_manufacturer       = NULL;
+   info->supported_extensions      = NULL;
+   info->authors                   = NULL;
+   info->permissions               = NULL;
+   info->licenses                  = NULL;
+   info->categories                = NULL;
+   info->databases                 = NULL;
+   info->notes                     = NULL;
+   info->required_hw_api           = NULL;
+   info->description               = NULL;
+   info->supported_extensions_list = NULL;
+   info->authors_list              = NULL;
+   info->note_list                 = NULL;
+   info->permissions_list          = NULL;
+   info->licenses_list             = NULL;
+   info->categories_list           = NULL;
+   info->databases_list            = NULL;
+   info->required_hw_api_list      = NULL;
+   info->firmware                  = NULL;
+   info->firmware_count            = 0;
+   info->has_info                  = false;
+}
+
+static void core_info_list_free(core_info_list_t *core_info_list)
+{
+   size_t i;
+
+   if (!core_info_list)
+      return;
 
    for (i = 0; i < core_info_list->count; i++)
    {
-      unsigned count                  = 0;
-      core_info_firmware_t *firmware  = NULL;
-      core_info_t *info               = (core_info_t*)&core_info_list->list[i];
-      config_file_t *config           = (config_file_t*)info->config_data;
+      core_info_t *info = (core_info_t*)&core_info_list->list[i];
 
-      if (!config || !config_get_uint(config, "firmware_count", &count))
-         continue;
+      core_info_free_fields(info);
+      free(info->path);
+      free(info->core_file_id.str);
+   }
 
-      firmware = (core_info_firmware_t*)calloc(count, sizeof(*firmware));
+   free(core_info_list->all_ext);
+   free(core_info_list->list);
+   free(core_info_list);
+}
 
-      if (!firmware)
-         continue;
+static bool core_info_list_iterate(
+      const char *current_path,
+      const char *path_basedir,
+      char *info_path, size_t len)
+{
+   char info_path_base[PATH_MAX_LENGTH];
+
+   if (!current_path)
+      return false;
+
+   info_path_base[0]          = '\0';
+
+   fill_pathname_base_noext(info_path_base,
+         current_path,
+         sizeof(info_path_base));
+
+#if defined(RARCH_MOBILE) || (defined(RARCH_CONSOLE) && !defined(PSP) && !defined(_3DS) && !defined(VITA) && !defined(HW_WUP))
+   {
+      char *substr = strrchr(info_path_base, '_');
+      if (substr)
+         *substr = '\0';
+   }
+#endif
+
+   strlcat(info_path_base, ".info", sizeof(info_path_base));
+
+   fill_pathname_join(info_path,
+         path_basedir,
+         info_path_base, len);
+
+   return true;
+}
+
+static void core_info_parse_config_file(core_info_t *info,
+      config_file_t *conf)
+{
+   unsigned c;
+   bool tmp_bool      = false;
+   unsigned tmp_uint  = 0;
+   struct config_entry_list
+      *entry = config_get_entry(conf, "display_name");
+
+   if (entry && !string_is_empty(entry->value))
+      info->display_name = strdup(entry->value);
+
+   entry = config_get_entry(conf, "display_version");
+
+   if (entry && !string_is_empty(entry->value))
+      info->display_version = strdup(entry->value);
+
+   entry = config_get_entry(conf, "corename");
+
+   if (entry && !string_is_empty(entry->value))
+      info->core_name = strdup(entry->value);
+
+   entry = config_get_entry(conf, "systemname");
+
+   if (entry && !string_is_empty(entry->value))
+      info->systemname = strdup(entry->value);
+
+   entry = config_get_entry(conf, "systemid");
+
+   if (entry && !string_is_empty(entry->value))
+      info->system_id = strdup(entry->value);
+
+   entry = config_get_entry(conf, "manufacturer");
+
+   if (entry && !string_is_empty(entry->value))
+      info->system_manufacturer = strdup(entry->value);
+
+   entry = config_get_entry(conf, "supported_extensions");
+
+   if (entry && !string_is_empty(entry->value))
+      info->supported_extensions = strdup(entry->value);
+
+   entry = config_get_entry(conf, "authors");
+
+   if (entry && !string_is_empty(entry->value))
+      info->authors = strdup(entry->value);
+
+   entry = config_get_entry(conf, "permissions");
+
+   if (entry && !string_is_empty(entry->value))
+      info->permissions = strdup(entry->value);
+
+   entry = config_get_entry(conf, "license");
+
+   if (entry && !string_is_empty(entry->value))
+      info->licenses = strdup(entry->value);
 
-      info->firmware = firmware;
+   entry = config_get_entry(conf, "categories");
 
-      for (c = 0; c < count; c++)
+   if (entry && !string_is_empty(entry->value))
+      info->categories = strdup(entry->value);
+
+   entry = config_get_entry(conf, "database");
+
+   if (entry && !string_is_empty(entry->value))
+      info->databases = strdup(entry->value);
+
+   entry = config_get_entry(conf, "notes");
+
+   if (entry && !string_is_empty(entry->value))
+      info->notes = strdup(entry->value);
+
+   entry = config_get_entry(conf, "required_hw_api");
+
+   if (entry && !string_is_empty(entry->value))
+      info->required_hw_api = strdup(entry->value);
+
+   entry = config_get_entry(conf, "description");
+
+   if (entry && !string_is_empty(entry->value))
+      info->description = strdup(entry->value);
+
+   if (config_get_bool(conf, "supports_no_game",
+            &tmp_bool))
+      info->supports_no_game = tmp_bool;
+
+   if (config_get_bool(conf, "database_match_archive_member",
+            &tmp_bool))
+      info->database_match_archive_member = tmp_bool;
+
+   if (config_get_bool(conf, "is_experimental",
+            &tmp_bool))
+      info->is_experimental = tmp_bool;
+
+   /* Firmware */
+   if (     config_get_uint(conf, "firmware_count", &tmp_uint)
+         && tmp_uint > 0
+         && (info->firmware = (core_info_firmware_t*)
+               calloc(tmp_uint, sizeof(*info->firmware))))
+   {
+      info->firmware_count = tmp_uint;
+
+      for (c = 0; c < tmp_uint; c++)
       {
          char path_key[64];
          char desc_key[64];
          char opt_key[64];
-         struct config_entry_list 
-            *entry         = NULL;
-         bool tmp_bool     = false;
          path_key[0]       = desc_key[0] = opt_key[0] = '\0';
 
          snprintf(path_key, sizeof(path_key), "firmware%u_path", c);
          snprintf(desc_key, sizeof(desc_key), "firmware%u_desc", c);
          snprintf(opt_key,  sizeof(opt_key),  "firmware%u_opt",  c);
 
-         entry             = config_get_entry(config, path_key);
+         entry             = config_get_entry(conf, path_key);
 
          if (entry && !string_is_empty(entry->value))
             info->firmware[c].path = strdup(entry->value);
 
-         entry             = config_get_entry(config, desc_key);
+         entry             = config_get_entry(conf, desc_key);
 
          if (entry && !string_is_empty(entry->value))
             info->firmware[c].desc     = strdup(entry->value);
 
-         if (config_get_bool(config, opt_key , &tmp_bool))
+         tmp_bool          = false;
+         if (config_get_bool(conf, opt_key , &tmp_bool))
             info->firmware[c].optional = tmp_bool;
       }
    }
+
+   info->has_info = true;
 }
 
-static void core_info_list_free(core_info_list_t *core_info_list)
+/* Splits the '|'-separated fields of a core info
+ * entry into string lists. Shared by the .info
+ * parser and the core info cache reader. */
+static void core_info_resolve_lists(core_info_t *info)
+{
+   if (info->supported_extensions)
+      info->supported_extensions_list =
+         string_split(info->supported_extensions, "|");
+   if (info->authors)
+      info->authors_list     = string_split(info->authors, "|");
+   if (info->permissions)
+      info->permissions_list = string_split(info->permissions, "|");
+   if (info->licenses)
+      info->licenses_list    = string_split(info->licenses, "|");
+   if (info->categories)
+      info->categories_list  = string_split(info->categories, "|");
+   if (info->databases)
+      info->databases_list   = string_split(info->databases, "|");
+   if (info->notes)
+      info->note_list        = string_split(info->notes, "|");
+   if (info->required_hw_api)
+      info->required_hw_api_list =
+         string_split(info->required_hw_api, "|");
+}
+
+/* Core info cache
+ * > Binary snapshot of every parsed .info file,
+ *   stored as 'core_info.cache' in the cache
+ *   directory (the info directory if none is
+ *   set) and read back with a single read
+ * > Each entry is keyed by the size and mtime of
+ *   its .info file; only entries whose key no
+ *   longer matches are re-parsed from disk
+ * > All values are stored in host byte order -
+ *   the cache is never shared between machines */
+
+#define CORE_INFO_CACHE_FILE_NAME "core_info.cache"
+#define CORE_INFO_CACHE_MAGIC     0x49434152 /* 'RACI' */
+#define CORE_INFO_CACHE_VERSION   1
+#define CORE_INFO_CACHE_STR_NULL  0xFFFFFFFF
+#define CORE_INFO_CACHE_NUM_STRS  15
+
+enum core_info_cache_flags
 {
-   size_t i, j;
+   CORE_INFO_CACHE_FLAG_SUPPORTS_NO_GAME              = (1 << 0),
+   CORE_INFO_CACHE_FLAG_DATABASE_MATCH_ARCHIVE_MEMBER = (1 << 1),
+   CORE_INFO_CACHE_FLAG_IS_EXPERIMENTAL               = (1 << 2)
+};
 
-   if (!core_info_list)
+typedef struct
+{
+   const char *info_name;
+   uint64_t info_size;
+   uint64_t info_mtime;
+   size_t offset;
+   uint32_t info_name_len;
+} core_info_cache_entry_t;
+
+typedef struct
+{
+   uint8_t *data;
+   core_info_cache_entry_t *entries;
+   size_t size;
+   size_t num_entries;
+   size_t last_hit;
+} core_info_cache_t;
+
+typedef struct
+{
+   const uint8_t *data;
+   size_t size;
+   size_t pos;
+   bool error;
+} core_info_cache_reader_t;
+
+typedef struct
+{
+   uint8_t *data;
+   size_t size;
+   size_t capacity;
+   bool error;
+} core_info_cache_writer_t;
+
+static void core_info_get_string_fields(core_info_t *info, char ***fields)
+{
+   fields[0]  = &info->display_name;
+   fields[1]  = &info->display_version;
+   fields[2]  = &info->core_name;
+   fields[3]  = &info->system_manufacturer;
+   fields[4]  = &info->systemname;
+   fields[5]  = &info->system_id;
+   fields[6]  = &info->supported_extensions;
+   fields[7]  = &info->authors;
+   fields[8]  = &info->permissions;
+   fields[9]  = &info->licenses;
+   fields[10] = &info->categories;
+   fields[11] = &info->databases;
+   fields[12] = &info->notes;
+   fields[13] = &info->required_hw_api;
+   fields[14] = &info->description;
+}
+
+static bool core_info_cache_get_file_key(const char *path,
+      uint64_t *size, uint64_t *mtime)
+{
+#ifdef HAVE_CORE_INFO_CACHE
+   struct stat buf;
+   if (stat(path, &buf) != 0 || !S_ISREG(buf.st_mode))
+      return false;
+   *size  = (uint64_t)buf.st_size;
+   *mtime = (uint64_t)buf.st_mtime;
+   return true;
+#else
+   return false;
+#endif
+}
+
+static uint32_t core_info_cache_read_u32(core_info_cache_reader_t *reader)
+{
+   uint32_t val = 0;
+   if (reader->error || reader->size - reader->pos < sizeof(val))
+   {
+      reader->error = true;
+      return 0;
+   }
+   memcpy(&val, reader->data + reader->pos, sizeof(val));
+   reader->pos += sizeof(val);
+   return val;
+}
+
+static uint64_t core_info_cache_read_u64(core_info_cache_reader_t *reader)
+{
+   uint64_t val = 0;
+   if (reader->error || reader->size - reader->pos < sizeof(val))
+   {
+      reader->error = true;
+      return 0;
+   }
+   memcpy(&val, reader->data + reader->pos, sizeof(val));
+   reader->pos += sizeof(val);
+   return val;
+}
+
+/* Returns a pointer to the (non-terminated) string
+ * data inside the cache buffer, or NULL */
+static const char *core_info_cache_read_str(
+      core_info_cache_reader_t *reader, uint32_t *len)
+{
+   const char *str = NULL;
+
+   *len = core_info_cache_read_u32(reader);
+
+   if (reader->error || *len == CORE_INFO_CACHE_STR_NULL)
+      return NULL;
+
+   if (reader->size - reader->pos < *len)
+   {
+      reader->error = true;
+      return NULL;
+   }
+
+   str          = (const char*)(reader->data + reader->pos);
+   reader->pos += *len;
+   return str;
+}
+
+static char *core_info_cache_read_strdup(core_info_cache_reader_t *reader)
+{
+   uint32_t len    = 0;
+   const char *str = core_info_cache_read_str(reader, &len);
+   char *out       = NULL;
+
+   if (!str || !(out = (char*)malloc(len + 1)))
+      return NULL;
+
+   memcpy(out, str, len);
+   out[len] = '\0';
+   return out;
+}
+
+static void core_info_cache_free(core_info_cache_t *cache)
+{
+   if (!cache)
       return;
 
-   for (i = 0; i < core_info_list->count; i++)
+   free(cache->data);
+   free(cache->entries);
+   free(cache);
+}
+
+static core_info_cache_t *core_info_cache_read(const char *path)
+{
+   size_t i;
+   void *buf                       = NULL;
+   int64_t len                     = 0;
+   core_info_cache_t *cache        = NULL;
+   core_info_cache_reader_t reader = {0};
+
+   if (     !path_is_valid(path)
+         || !filestream_read_file(path, &buf, &len)
+         || !buf)
+      return NULL;
+
+   reader.data = (const uint8_t*)buf;
+   reader.size = (size_t)len;
+
+   if (     core_info_cache_read_u32(&reader) != CORE_INFO_CACHE_MAGIC
+         || core_info_cache_read_u32(&reader) != CORE_INFO_CACHE_VERSION)
+      goto error;
+
+   if (!(cache = (core_info_cache_t*)calloc(1, sizeof(*cache))))
+      goto error;
+
+   cache->data        = (uint8_t*)buf;
+   cache->size        = (size_t)len;
+   cache->num_entries = core_info_cache_read_u32(&reader);
+
+   /* Every entry takes at least a few bytes; reject
+    * nonsensical counts before allocating */
+   if (reader.error || cache->num_entries > cache->size)
+      goto error;
+
+   if (cache->num_entries &&
+         !(cache->entries = (core_info_cache_entry_t*)
+            calloc(cache->num_entries, sizeof(*cache->entries))))
+      goto error;
+
+   /* Build index; entry payloads are decoded lazily */
+   for (i = 0; i < cache->num_entries; i++)
    {
-      core_info_t *info = (core_info_t*)&core_info_list->list[i];
+      core_info_cache_entry_t *entry = &cache->entries[i];
+      uint32_t entry_size            = core_info_cache_read_u32(&reader);
+      size_t entry_end               = reader.pos + entry_size;
 
-      free(info->path);
-      free(info->core_name);
-      free(info->systemname);
-      free(info->system_id);
-      free(info->system_manufacturer);
-      free(info->display_name);
-      free(info->display_version);
-      free(info->supported_extensions);
-      free(info->authors);
-      free(info->permissions);
-      free(info->licenses);
-      free(info->categories);
-      free(info->databases);
-      free(info->notes);
-      free(info->required_hw_api);
-      free(info->description);
-      string_list_free(info->supported_extensions_list);
-      string_list_free(info->authors_list);
-      string_list_free(info->note_list);
-      string_list_free(info->permissions_list);
-      string_list_free(info->licenses_list);
-      string_list_free(info->categories_list);
-      string_list_free(info->databases_list);
-      string_list_free(info->required_hw_api_list);
-      config_file_free((config_file_t*)info->config_data);
-
-      for (j = 0; j < info->firmware_count; j++)
+      if (reader.error || entry_size > reader.size - reader.pos)
+         goto error;
+
+      entry->info_name  = core_info_cache_read_str(&reader,
+            &entry->info_name_len);
+      entry->info_size  = core_info_cache_read_u64(&reader);
+      entry->info_mtime = core_info_cache_read_u64(&reader);
+      entry->offset     = reader.pos;
+
+      if (reader.error || !entry->info_name || reader.pos > entry_end)
+         goto error;
+
+      reader.pos        = entry_end;
+   }
+
+   return cache;
+
+error:
+   RARCH_WARN("[Core Info]: Ignoring invalid core info cache: \"%s\".\n",
+         path);
+   if (cache)
+      core_info_cache_free(cache);
+   else
+      free(buf);
+   return NULL;
+}
+
+static const core_info_cache_entry_t *core_info_cache_find(
+      core_info_cache_t *cache, const char *info_name,
+      uint64_t info_size, uint64_t info_mtime)
+{
+   size_t i;
+   size_t name_len;
+
+   if (!cache || !cache->num_entries)
+      return NULL;
+
+   name_len = strlen(info_name);
+
+   /* Cores are usually listed in the same order as
+    * when the cache was written - start searching
+    * right after the previous hit */
+   for (i = 0; i < cache->num_entries; i++)
+   {
+      size_t idx                           =
+         (cache->last_hit + i) % cache->num_entries;
+      const core_info_cache_entry_t *entry = &cache->entries[idx];
+
+      if (     entry->info_name_len == name_len
+            && !memcmp(entry->info_name, info_name, name_len))
       {
-         free(info->firmware[j].path);
-         free(info->firmware[j].desc);
+         if (     entry->info_size  != info_size
+               || entry->info_mtime != info_mtime)
+            return NULL;
+
+         cache->last_hit = idx + 1;
+         return entry;
       }
-      free(info->firmware);
+   }
 
-      free(info->core_file_id.str);
+   return NULL;
+}
+
+static bool core_info_cache_fill(core_info_t *info,
+      const core_info_cache_t *cache,
+      const core_info_cache_entry_t *entry)
+{
+   size_t i;
+   uint32_t flags;
+   char **fields[CORE_INFO_CACHE_NUM_STRS];
+   core_info_cache_reader_t reader;
+
+   reader.data  = cache->data;
+   reader.size  = cache->size;
+   reader.pos   = entry->offset;
+   reader.error = false;
+
+   core_info_get_string_fields(info, fields);
+
+   for (i = 0; i < CORE_INFO_CACHE_NUM_STRS; i++)
+      *fields[i] = core_info_cache_read_strdup(&reader);
+
+   flags                               = core_info_cache_read_u32(&reader);
+   info->supports_no_game              =
+      !!(flags & CORE_INFO_CACHE_FLAG_SUPPORTS_NO_GAME);
+   info->database_match_archive_member =
+      !!(flags & CORE_INFO_CACHE_FLAG_DATABASE_MATCH_ARCHIVE_MEMBER);
+   info->is_experimental               =
+      !!(flags & CORE_INFO_CACHE_FLAG_IS_EXPERIMENTAL);
+
+   info->firmware_count = core_info_cache_read_u32(&reader);
+
+   if (reader.error || info->firmware_count > reader.size)
+      info->firmware_count = 0;
+
+   if (info->firmware_count)
+   {
+      if (!(info->firmware = (core_info_firmware_t*)
+               calloc(info->firmware_count, sizeof(*info->firmware))))
+         info->firmware_count = 0;
+
+      for (i = 0; i < info->firmware_count; i++)
+      {
+         info->firmware[i].path     = core_info_cache_read_strdup(&reader);
+         info->firmware[i].desc     = core_info_cache_read_strdup(&reader);
+         info->firmware[i].optional = !!core_info_cache_read_u32(&reader);
+      }
    }
 
-   free(core_info_list->all_ext);
-   free(core_info_list->list);
-   free(core_info_list);
+   info->has_info = true;
+   return !reader.error;
 }
 
-static config_file_t *core_info_list_iterate(
-      const char *current_path,
-      const char *path_basedir)
+static void core_info_cache_write_data(core_info_cache_writer_t *writer,
+      const void *data, size_t len)
 {
-   char info_path[PATH_MAX_LENGTH];
-   char info_path_base[PATH_MAX_LENGTH];
+   if (writer->error)
+      return;
 
-   if (!current_path)
-      return NULL;
+   if (writer->size + len > writer->capacity)
+   {
+      size_t capacity = writer->capacity ? writer->capacity * 2 : 64 * 1024;
+      uint8_t *tmp    = NULL;
 
-   info_path     [0]          = '\0';
-   info_path_base[0]          = '\0';
+      while (capacity < writer->size + len)
+         capacity *= 2;
 
-   fill_pathname_base_noext(info_path_base,
-         current_path,
-         sizeof(info_path_base));
+      if (!(tmp = (uint8_t*)realloc(writer->data, capacity)))
+      {
+         writer->error = true;
+         return;
+      }
 
-#if defined(RARCH_MOBILE) || (defined(RARCH_CONSOLE) && !defined(PSP) && !defined(_3DS) && !defined(VITA) && !defined(HW_WUP))
+      writer->data     = tmp;
+      writer->capacity = capacity;
+   }
+
+   memcpy(writer->data + writer->size, data, len);
+   writer->size += len;
+}
+
+static void core_info_cache_write_u32(core_info_cache_writer_t *writer,
+      uint32_t val)
+{
+   core_info_cache_write_data(writer, &val, sizeof(val));
+}
+
+static void core_info_cache_write_u64(core_info_cache_writer_t *writer,
+      uint64_t val)
+{
+   core_info_cache_write_data(writer, &val, sizeof(val));
+}
+
+static void core_info_cache_write_str(core_info_cache_writer_t *writer,
+      const char *str)
+{
+   if (!str)
    {
-      char *substr = strrchr(info_path_base, '_');
-      if (substr)
-         *substr = '\0';
+      core_info_cache_write_u32(writer, CORE_INFO_CACHE_STR_NULL);
+      return;
    }
-#endif
+   core_info_cache_write_u32(writer, (uint32_t)strlen(str));
+   core_info_cache_write_data(writer, str, strlen(str));
+}
 
-   strlcat(info_path_base, ".info", sizeof(info_path_base));
+static void core_info_cache_write_entry(core_info_cache_writer_t *writer,
+      core_info_t *info, const char *info_name,
+      uint64_t info_size, uint64_t info_mtime)
+{
+   size_t i;
+   uint32_t entry_size;
+   uint32_t flags = 0;
+   size_t size_pos;
+   char **fields[CORE_INFO_CACHE_NUM_STRS];
 
-   fill_pathname_join(info_path,
-         path_basedir,
-         info_path_base, sizeof(info_path_base));
+   core_info_get_string_fields(info, fields);
 
-   if (path_is_valid(info_path))
-      return config_file_new_from_path_to_string(info_path);
-   return NULL;
+   /* Placeholder for entry size */
+   size_pos = writer->size;
+   core_info_cache_write_u32(writer, 0);
+
+   core_info_cache_write_str(writer, info_name);
+   core_info_cache_write_u64(writer, info_size);
+   core_info_cache_write_u64(writer, info_mtime);
+
+   for (i = 0; i < CORE_INFO_CACHE_NUM_STRS; i++)
+      core_info_cache_write_str(writer, *fields[i]);
+
+   if (info->supports_no_game)
+      flags |= CORE_INFO_CACHE_FLAG_SUPPORTS_NO_GAME;
+   if (info->database_match_archive_member)
+      flags |= CORE_INFO_CACHE_FLAG_DATABASE_MATCH_ARCHIVE_MEMBER;
+   if (info->is_experimental)
+      flags |= CORE_INFO_CACHE_FLAG_IS_EXPERIMENTAL;
+   core_info_cache_write_u32(writer, flags);
+
+   core_info_cache_write_u32(writer, (uint32_t)info->firmware_count);
+   for (i = 0; i < info->firmware_count; i++)
+   {
+      core_info_cache_write_str(writer, info->firmware[i].path);
+      core_info_cache_write_str(writer, info->firmware[i].desc);
+      core_info_cache_write_u32(writer, info->firmware[i].optional);
+   }
+
+   if (writer->error)
+      return;
+
+   entry_size = (uint32_t)(writer->size - size_pos - sizeof(entry_size));
+   memcpy(writer->data + size_pos, &entry_size, sizeof(entry_size));
 }
 
 static core_info_list_t *core_info_list_new(const char *path,
       const char *libretro_info_dir,
+      const char *dir_cache,
       const char *exts,
       bool dir_show_hidden_files)
 {
    size_t i;
+   char cache_path[PATH_MAX_LENGTH];
    struct string_list contents      = {0};
    core_info_t *core_info           = NULL;
    core_info_list_t *core_info_list = NULL;
    const char       *path_basedir   = libretro_info_dir;
+   const char       *cache_basedir  = !string_is_empty(dir_cache)
+      ? dir_cache : libretro_info_dir;
+   core_info_cache_t *cache         = NULL;
+   core_info_cache_writer_t writer  = {0};
+   size_t num_cached                = 0;
+   size_t num_parsed                = 0;
+   size_t num_written               = 0;
    bool                          ok = false;
 
    string_list_initialize(&contents);
@@ -253,7 +828,7 @@ static core_info_list_t *core_info_list_new(const char *path,
    {
       /* UWP: browse the optional packages for additional cores */
       struct string_list core_packages = {0};
-      
+
       if (string_list_initialize(&core_packages))
       {
          uwp_fill_installed_core_packages(&core_packages);
@@ -289,140 +864,72 @@ static core_info_list_t *core_info_list_new(const char *path,
    core_info_list->list    = core_info;
    core_info_list->count   = contents.size;
 
-   for (i = 0; i < contents.size; i++)
+   cache_path[0]           = '\0';
+#ifdef HAVE_CORE_INFO_CACHE
+   if (!string_is_empty(cache_basedir))
    {
-      const char *base_path = contents.elems[i].data;
-      config_file_t *conf   = core_info_list_iterate(base_path,
-            path_basedir);
-
-      if (conf)
-      {
-         bool tmp_bool      = false;
-         unsigned tmp_uint  = 0;
-         struct config_entry_list 
-            *entry = config_get_entry(conf, "display_name");
-
-         if (entry && !string_is_empty(entry->value))
-            core_info[i].display_name = strdup(entry->value);
-
-         entry = config_get_entry(conf, "display_version");
-
-         if (entry && !string_is_empty(entry->value))
-            core_info[i].display_version = strdup(entry->value);
-
-         entry = config_get_entry(conf, "corename");
-
-         if (entry && !string_is_empty(entry->value))
-            core_info[i].core_name = strdup(entry->value);
-
-         entry = config_get_entry(conf, "systemname");
-
-         if (entry && !string_is_empty(entry->value))
-               core_info[i].systemname = strdup(entry->value);
-
-         entry = config_get_entry(conf, "systemid");
-
-         if (entry && !string_is_empty(entry->value))
-            core_info[i].system_id = strdup(entry->value);
-
-         entry = config_get_entry(conf, "manufacturer");
-
-         if (entry && !string_is_empty(entry->value))
-            core_info[i].system_manufacturer = strdup(entry->value);
-
-         config_get_uint(conf, "firmware_count", &tmp_uint);
-         core_info[i].firmware_count = tmp_uint;
-
-         entry = config_get_entry(conf, "supported_extensions");
-
-         if (entry && !string_is_empty(entry->value))
-         {
-            core_info[i].supported_extensions      = strdup(entry->value);
-            core_info[i].supported_extensions_list =
-               string_split(core_info[i].supported_extensions, "|");
-         }
-
-         entry = config_get_entry(conf, "authors");
-
-         if (entry && !string_is_empty(entry->value))
-         {
-            core_info[i].authors      = strdup(entry->value);
-            core_info[i].authors_list =
-               string_split(core_info[i].authors, "|");
-         }
+      fill_pathname_join(cache_path, cache_basedir,
+            CORE_INFO_CACHE_FILE_NAME, sizeof(cache_path));
+      cache = core_info_cache_read(cache_path);
+   }
+#endif
 
-         entry = config_get_entry(conf, "permissions");
+   /* Reserve space for the header, filled in below */
+   core_info_cache_write_u32(&writer, CORE_INFO_CACHE_MAGIC);
+   core_info_cache_write_u32(&writer, CORE_INFO_CACHE_VERSION);
+   core_info_cache_write_u32(&writer, 0);
 
-         if (entry && !string_is_empty(entry->value))
-         {
-            core_info[i].permissions      = strdup(entry->value);
-            core_info[i].permissions_list =
-               string_split(core_info[i].permissions, "|");
-         }
+   for (i = 0; i < contents.size; i++)
+   {
+      char info_path[PATH_MAX_LENGTH];
+      uint64_t info_size                    = 0;
+      uint64_t info_mtime                   = 0;
+      bool has_key                          = false;
+      const core_info_cache_entry_t *cached = NULL;
+      const char *base_path                 = contents.elems[i].data;
 
-         entry = config_get_entry(conf, "license");
+      info_path[0]                          = '\0';
 
-         if (entry && !string_is_empty(entry->value))
-         {
-            core_info[i].licenses      = strdup(entry->value);
-            core_info[i].licenses_list =
-               string_split(core_info[i].licenses, "|");
-         }
+      if (core_info_list_iterate(base_path, path_basedir,
+               info_path, sizeof(info_path)))
+      {
+         has_key = core_info_cache_get_file_key(
+               info_path, &info_size, &info_mtime);
 
-         entry = config_get_entry(conf, "categories");
+         if (has_key)
+            cached = core_info_cache_find(cache,
+                  path_basename(info_path), info_size, info_mtime);
 
-         if (entry && !string_is_empty(entry->value))
+         if (cached && core_info_cache_fill(&core_info[i], cache, cached))
+            num_cached++;
+         else
          {
-            core_info[i].categories      = strdup(entry->value);
-            core_info[i].categories_list =
-               string_split(core_info[i].categories, "|");
-         }
+            config_file_t *conf = NULL;
 
-         entry = config_get_entry(conf, "database");
+            /* Truncated entry - discard whatever was read */
+            if (cached)
+               core_info_free_fields(&core_info[i]);
 
-         if (entry && !string_is_empty(entry->value))
-         {
-            core_info[i].databases      = strdup(entry->value);
-            core_info[i].databases_list =
-               string_split(core_info[i].databases, "|");
+            if ((has_key || path_is_valid(info_path)) &&
+                  (conf = config_file_new_from_path_to_string(info_path)))
+            {
+               core_info_parse_config_file(&core_info[i], conf);
+               config_file_free(conf);
+               num_parsed++;
+            }
          }
 
-         entry = config_get_entry(conf, "notes");
-
-         if (entry && !string_is_empty(entry->value))
+         if (core_info[i].has_info)
          {
-            core_info[i].notes     = strdup(entry->value);
-            core_info[i].note_list =
-               string_split(core_info[i].notes, "|");
-         }
+            core_info_resolve_lists(&core_info[i]);
 
-         entry = config_get_entry(conf, "required_hw_api");
-
-         if (entry && !string_is_empty(entry->value))
-         {
-            core_info[i].required_hw_api      = strdup(entry->value);
-            core_info[i].required_hw_api_list =
-               string_split(core_info[i].required_hw_api, "|");
+            if (has_key)
+            {
+               core_info_cache_write_entry(&writer, &core_info[i],
+                     path_basename(info_path), info_size, info_mtime);
+               num_written++;
+            }
          }
-
-         entry = config_get_entry(conf, "description");
-
-         if (entry && !string_is_empty(entry->value))
-            core_info[i].description = strdup(entry->value);
-
-         if (config_get_bool(conf, "supports_no_game",
-                  &tmp_bool))
-            core_info[i].supports_no_game = tmp_bool;
-
-         if (config_get_bool(conf, "database_match_archive_member",
-                  &tmp_bool))
-            core_info[i].database_match_archive_member = tmp_bool;
-
-         if (config_get_bool(conf, "is_experimental",
-                  &tmp_bool))
-            core_info[i].is_experimental = tmp_bool;
-
-         core_info[i].config_data = conf;
       }
 
       if (!string_is_empty(base_path))
@@ -468,12 +975,52 @@ static core_info_list_t *core_info_list_new(const char *path,
       core_info[i].is_locked = core_info_get_core_lock(core_info[i].path, false);
    }
 
-   if (core_info_list)
+   /* Rewrite the cache whenever its contents no longer
+    * match the installed set of .info files */
+   if (     !string_is_empty(cache_path)
+         && !writer.error
+         && (num_parsed > 0
+            || !cache
+            || cache->num_entries != num_cached))
    {
-      core_info_list_resolve_all_extensions(core_info_list);
-      core_info_list_resolve_all_firmware(core_info_list);
+      uint32_t num_entries = (uint32_t)num_written;
+      memcpy(writer.data + 2 * sizeof(uint32_t),
+            &num_entries, sizeof(num_entries));
+
+      char tmp_path[PATH_MAX_LENGTH];
+
+      strlcpy(tmp_path, cache_path, sizeof(tmp_path));
+      strlcat(tmp_path, ".tmp", sizeof(tmp_path));
+
+      /* Write a new file and rename it into place, so that
+       * an interrupted write never leaves a truncated cache.
+       * The cache is optional - a read-only cache directory
+       * is not an error, so only log the failure */
+      if (filestream_write_file(tmp_path, writer.data,
+               (int64_t)writer.size))
+      {
+#ifdef _WIN32
+         /* rename() does not replace an existing file here */
+         filestream_delete(cache_path);
+#endif
+         if (filestream_rename(tmp_path, cache_path) != 0)
+         {
+            filestream_delete(tmp_path);
+            RARCH_LOG("[Core Info]: Could not replace core info cache: \"%s\".\n",
+                  cache_path);
+         }
+      }
+      else
+         RARCH_LOG("[Core Info]: Could not write core info cache: \"%s\".\n",
+               cache_path);
    }
 
+   free(writer.data);
+   core_info_cache_free(cache);
+
+   if (core_info_list)
+      core_info_list_resolve_all_extensions(core_info_list);
+
    string_list_deinitialize(&contents);
    return core_info_list;
 
@@ -651,8 +1198,8 @@ bool core_info_init_current_core(void)
    current->is_experimental               = false;
    current->is_locked                     = false;
    current->firmware_count                = 0;
+   current->has_info                      = false;
    current->path                          = NULL;
-   current->config_data                   = NULL;
    current->display_name                  = NULL;
    current->display_version               = NULL;
    current->core_name                     = NULL;
@@ -703,11 +1250,12 @@ void core_info_deinit_list(void)
 }
 
 bool core_info_init_list(const char *path_info, const char *dir_cores,
-      const char *exts, bool dir_show_hidden_files)
+      const char *dir_cache, const char *exts, bool dir_show_hidden_files)
 {
    core_info_state_t *p_coreinfo = coreinfo_get_ptr();
    if (!(p_coreinfo->curr_list = core_info_list_new(dir_cores,
                !string_is_empty(path_info) ? path_info : dir_cores,
+               dir_cache,
                exts,
                dir_show_hidden_files)))
       return false;
@@ -901,6 +1449,7 @@ void core_info_get_name(const char *path, char *s, size_t len,
 
    for (i = 0; i < contents.size; i++)
    {
+      char info_path[PATH_MAX_LENGTH];
       struct config_entry_list 
          *entry                       = NULL;
       config_file_t *conf             = NULL;
@@ -909,10 +1458,12 @@ void core_info_get_name(const char *path, char *s, size_t len,
       if (!string_is_equal(path_basename(current_path), core_path_basename))
          continue;
 
-      conf = core_info_list_iterate(contents.elems[i].data,
-               path_basedir);
+      info_path[0] = '\0';
 
-      if (!conf)
+      if (     !core_info_list_iterate(contents.elems[i].data,
+               path_basedir, info_path, sizeof(info_path))
+            || !path_is_valid(info_path)
+            || !(conf = config_file_new_from_path_to_string(info_path)))
          continue;
 
       if (get_display_name)
@@ -939,9 +1490,7 @@ size_t core_info_list_num_info_files(core_info_list_t *core_info_list)
 
    for (i = 0; i < core_info_list->count; i++)
    {
-      config_file_t *conf = (config_file_t*)
-         core_info_list->list[i].config_data;
-      num += !!conf;
+      num += core_info_list->list[i].has_info;
    }
 
    return num;
@@ -0,0 +1,386 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2020 - The RetroArch team
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <retro_inline.h>
+#include <features/features_cpu.h>
+#include <streams/file_stream.h>
+
+#ifdef HAVE_THREADS
+#include <rthreads/rthreads.h>
+#endif
+
+#include "frame_trace.h"
+#include "verbosity.h"
+
+enum frame_trace_phase
+{
+   FRAME_TRACE_PHASE_BEGIN = 0,
+   FRAME_TRACE_PHASE_END,
+   FRAME_TRACE_PHASE_INSTANT
+};
+
+typedef struct frame_trace_event
+{
+   retro_perf_tick_t ticks;
+   const char *name;
+   unsigned phase;
+} frame_trace_event_t;
+
+typedef struct frame_trace_buffer
+{
+   frame_trace_event_t *events;
+   const char *thread_name;
+#ifdef HAVE_THREADS
+   /* Only ever contended by an export */
+   slock_t *lock;
+   uintptr_t thread_id;
+#endif
+   uint64_t count;   /* events ever written; the ring holds the last ones */
+   unsigned id;
+} frame_trace_buffer_t;
+
+typedef struct frame_trace_state
+{
+   frame_trace_buffer_t *buffers[FRAME_TRACE_THREADS];
+#ifdef HAVE_THREADS
+#ifdef HAVE_THREAD_STORAGE
+   sthread_tls_t tls;
+#endif
+   slock_t *lock;
+#endif
+   /* Ticks and microseconds when tracing started, to convert one into
+    * the other on export */
+   retro_perf_tick_t base_ticks;
+   retro_time_t base_usec;
+   unsigned num_buffers;
+   bool enabled;
+} frame_trace_state_t;
+
+static frame_trace_state_t frame_trace_st;
+
+static frame_trace_buffer_t *frame_trace_buffer_new(
+      frame_trace_state_t *st)
+{
+   frame_trace_buffer_t *buf = NULL;
+
+#ifdef HAVE_THREADS
+   slock_lock(st->lock);
+#endif
+   if (st->num_buffers < FRAME_TRACE_THREADS)
+   {
+      buf = (frame_trace_buffer_t*)calloc(1, sizeof(*buf));
+      if (buf)
+      {
+         buf->events = (frame_trace_event_t*)
+            malloc(FRAME_TRACE_EVENTS * sizeof(*buf->events));
+#ifdef HAVE_THREADS
+         buf->lock   = slock_new();
+         if (!buf->lock)
+         {
+            free(buf->events);
+            buf->events = NULL;
+         }
+#endif
+         if (!buf->events)
+         {
+            free(buf);
+            buf = NULL;
+         }
+      }
+
+      if (buf)
+      {
+#ifdef HAVE_THREADS
+         buf->thread_id                   = sthread_get_current_thread_id();
+#endif
+         buf->id                          = st->num_buffers;
+         st->buffers[st->num_buffers++]   = buf;
+      }
+   }
+#ifdef HAVE_THREADS
+   slock_unlock(st->lock);
+#endif
+
+   return buf;
+}
+
+static frame_trace_buffer_t *frame_trace_get_buffer(void)
+{
+   frame_trace_state_t *st   = &frame_trace_st;
+   frame_trace_buffer_t *buf = NULL;
+
+#if defined(HAVE_THREADS) && defined(HAVE_THREAD_STORAGE)
+   if ((buf = (frame_trace_buffer_t*)sthread_tls_get(&st->tls)))
+      return buf;
+   if ((buf = frame_trace_buffer_new(st)))
+      sthread_tls_set(&st->tls, buf);
+#elif defined(HAVE_THREADS)
+   unsigned i;
+   uintptr_t thread_id = sthread_get_current_thread_id();
+
+   slock_lock(st->lock);
+   for (i = 0; i < st->num_buffers; i++)
+   {
+      if (st->buffers[i]->thread_id == thread_id)
+      {
+         buf = st->buffers[i];
+         break;
+      }
+   }
+   slock_unlock(st->lock);
+
+   if (!buf)
+      buf = frame_trace_buffer_new(st);
+#else
+   if (st->num_buffers)
+      return st->buffers[0];
+   buf = frame_trace_buffer_new(st);
+#endif
+
+   return buf;
+}
+
+static INLINE void frame_trace_push(const char *name, unsigned phase)
+{
+   frame_trace_event_t *ev;
+   frame_trace_buffer_t *buf = frame_trace_get_buffer();
+
+   if (!buf)
+      return;
+
+#ifdef HAVE_THREADS
+   slock_lock(buf->lock);
+#endif
+   ev        = &buf->events[buf->count % FRAME_TRACE_EVENTS];
+   ev->ticks = cpu_features_get_perf_counter();
+   ev->name  = name;
+   ev->phase = phase;
+   buf->count++;
+#ifdef HAVE_THREADS
+   slock_unlock(buf->lock);
+#endif
+}
+
+bool frame_trace_init(void)
+{
+   frame_trace_state_t *st = &frame_trace_st;
+
+   if (st->enabled)
+      return true;
+
+   memset(st, 0, sizeof(*st));
+#ifdef HAVE_THREADS
+   if (!(st->lock = slock_new()))
+      return false;
+#ifdef HAVE_THREAD_STORAGE
+   if (!sthread_tls_create(&st->tls))
+   {
+      slock_free(st->lock);
+      st->lock = NULL;
+      return false;
+   }
+#endif
+#endif
+   st->base_usec  = cpu_features_get_time_usec();
+   st->base_ticks = cpu_features_get_perf_counter();
+   st->enabled    = true;
+
+   frame_trace_set_thread_name("main");
+
+   return true;
+}
+
+void frame_trace_deinit(void)
+{
+   unsigned i;
+   frame_trace_state_t *st = &frame_trace_st;
+
+   if (!st->enabled)
+      return;
+
+   /* Stop new events first; threads still tracing must be gone by now */
+   st->enabled = false;
+
+   for (i = 0; i < st->num_buffers; i++)
+   {
+      frame_trace_buffer_t *buf = st->buffers[i];
+#ifdef HAVE_THREADS
+      slock_free(buf->lock);
+#endif
+      free(buf->events);
+      free(buf);
+   }
+
+#ifdef HAVE_THREADS
+#ifdef HAVE_THREAD_STORAGE
+   sthread_tls_delete(&st->tls);
+#endif
+   slock_free(st->lock);
+#endif
+
+   memset(st, 0, sizeof(*st));
+}
+
+bool frame_trace_is_enabled(void)
+{
+   return frame_trace_st.enabled;
+}
+
+void frame_trace_set_thread_name(const char *name)
+{
+   frame_trace_buffer_t *buf = NULL;
+
+   if (!frame_trace_st.enabled)
+      return;
+
+   if ((buf = frame_trace_get_buffer()))
+      buf->thread_name = name;
+}
+
+void frame_trace_begin(const char *name)
+{
+   if (frame_trace_st.enabled)
+      frame_trace_push(name, FRAME_TRACE_PHASE_BEGIN);
+}
+
+void frame_trace_end(const char *name)
+{
+   if (frame_trace_st.enabled)
+      frame_trace_push(name, FRAME_TRACE_PHASE_END);
+}
+
+void frame_trace_instant(const char *name)
+{
+   if (frame_trace_st.enabled)
+      frame_trace_push(name, FRAME_TRACE_PHASE_INSTANT);
+}
+
+static void frame_trace_export_buffer(RFILE *file,
+      frame_trace_buffer_t *buf, frame_trace_event_t *events,
+      double usec_per_tick, bool *first)
+{
+   static const char phases[] = { 'B', 'E', 'i' };
+   frame_trace_state_t *st    = &frame_trace_st;
+   uint64_t count, start, i;
+   unsigned depth             = 0;
+
+#ifdef HAVE_THREADS
+   slock_lock(buf->lock);
+#endif
+   count = buf->count;
+   start = count > FRAME_TRACE_EVENTS ? count - FRAME_TRACE_EVENTS : 0;
+   for (i = start; i < count; i++)
+      events[i - start] = buf->events[i % FRAME_TRACE_EVENTS];
+#ifdef HAVE_THREADS
+   slock_unlock(buf->lock);
+#endif
+
+   if (buf->thread_name)
+   {
+      filestream_printf(file,
+            "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+            "\"args\":{\"name\":\"%s\"}}",
+            *first ? "\n" : ",\n", buf->id, buf->thread_name);
+      *first = false;
+   }
+
+   for (i = 0; i < count - start; i++)
+   {
+      frame_trace_event_t *ev = &events[i];
+      double ts               = (double)st->base_usec +
+         (double)(int64_t)(ev->ticks - st->base_ticks) * usec_per_tick;
+
+      /* The ring may have overwritten the beginning of a scope */
+      if (ev->phase == FRAME_TRACE_PHASE_BEGIN)
+         depth++;
+      else if (ev->phase == FRAME_TRACE_PHASE_END)
+      {
+         if (!depth)
+            continue;
+         depth--;
+      }
+
+      filestream_printf(file,
+            "%s{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%u%s}",
+            *first ? "\n" : ",\n",
+            ev->name, phases[ev->phase], ts, buf->id,
+            ev->phase == FRAME_TRACE_PHASE_INSTANT ? ",\"s\":\"t\"" : "");
+      *first = false;
+   }
+}
+
+bool frame_trace_export(const char *path)
+{
+   unsigned i, num_buffers;
+   double usec_per_tick;
+   retro_perf_tick_t ticks;
+   retro_time_t usec;
+   bool first                  = true;
+   RFILE *file                 = NULL;
+   frame_trace_event_t *events = NULL;
+   frame_trace_state_t *st     = &frame_trace_st;
+
+   if (!st->enabled)
+      return false;
+
+   /* cpu_features_get_perf_counter() is not in any fixed unit on every
+    * platform, so measure it against the microsecond clock */
+   usec  = cpu_features_get_time_usec();
+   ticks = cpu_features_get_perf_counter();
+   if (ticks == st->base_ticks || usec == st->base_usec)
+      usec_per_tick = 0.001;
+   else
+      usec_per_tick = (double)(usec - st->base_usec)
+         / (double)(int64_t)(ticks - st->base_ticks);
+
+   if (!(events = (frame_trace_event_t*)
+            malloc(FRAME_TRACE_EVENTS * sizeof(*events))))
+      return false;
+
+   if (!(file = filestream_open(path,
+               RETRO_VFS_FILE_ACCESS_WRITE,
+               RETRO_VFS_FILE_ACCESS_HINT_NONE)))
+   {
+      RARCH_ERR("[Trace]: Failed to open \"%s\" for writing.\n", path);
+      free(events);
+      return false;
+   }
+
+   filestream_printf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+#ifdef HAVE_THREADS
+   slock_lock(st->lock);
+#endif
+   num_buffers = st->num_buffers;
+#ifdef HAVE_THREADS
+   slock_unlock(st->lock);
+#endif
+
+   /* Buffers are never removed while tracing, only appended */
+   for (i = 0; i < num_buffers; i++)
+      frame_trace_export_buffer(file, st->buffers[i], events,
+            usec_per_tick, &first);
+
+   filestream_printf(file, "\n]}\n");
+   filestream_close(file);
+   free(events);
+
+   RARCH_LOG("[Trace]: Wrote frame trace to \"%s\".\n", path);
+   return true;
+}
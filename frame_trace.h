@@ -0,0 +1,93 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2020 - The RetroArch team
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _FRAME_TRACE_H
+#define _FRAME_TRACE_H
+
+#include <boolean.h>
+#include <retro_common_api.h>
+
+RETRO_BEGIN_DECLS
+
+/* Frame tracing records begin/end events of named scopes into a ring
+ * buffer per thread, and exports the most recent ones as Chrome trace
+ * JSON (chrome://tracing, ui.perfetto.dev).
+ *
+ * Scope and thread names are stored by pointer and must therefore be
+ * string literals. While tracing is disabled every entry point returns
+ * after a single flag test. */
+
+/* Events kept per thread */
+#ifndef FRAME_TRACE_EVENTS
+#define FRAME_TRACE_EVENTS 65536
+#endif
+
+/* Threads that can be traced at once */
+#ifndef FRAME_TRACE_THREADS
+#define FRAME_TRACE_THREADS 32
+#endif
+
+bool frame_trace_init(void);
+
+void frame_trace_deinit(void);
+
+bool frame_trace_is_enabled(void);
+
+/**
+ * frame_trace_set_thread_name:
+ * @name               : name shown for the calling thread
+ *
+ * Names the calling thread in exported traces.
+ **/
+void frame_trace_set_thread_name(const char *name);
+
+void frame_trace_begin(const char *name);
+
+void frame_trace_end(const char *name);
+
+/**
+ * frame_trace_instant:
+ * @name               : name of the event
+ *
+ * Records a zero-length event, such as a frame boundary.
+ **/
+void frame_trace_instant(const char *name);
+
+/**
+ * frame_trace_export:
+ * @path               : file to write
+ *
+ * Writes every event still held in the ring buffers to @path as
+ * Chrome trace JSON. Safe to call while other threads keep tracing.
+ *
+ * Returns: true if the file was written, otherwise false.
+ **/
+bool frame_trace_export(const char *path);
+
+#define FRAME_TRACE_BEGIN(name) do \
+{ \
+   if (frame_trace_is_enabled()) \
+      frame_trace_begin(name); \
+} while (0)
+
+#define FRAME_TRACE_END(name) do \
+{ \
+   if (frame_trace_is_enabled()) \
+      frame_trace_end(name); \
+} while (0)
+
+RETRO_END_DECLS
+
+#endif
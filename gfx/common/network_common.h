@@ -18,6 +18,46 @@
 #ifndef __NETWORK_VIDEO_COMMON_H
 #define __NETWORK_VIDEO_COMMON_H
 
+/* Tiled protocol, built with NETWORK_VIDEO_TILES=1
+ *
+ * Instead of raw frames, every frame is sent as a header of big-endian
+ * uint32 words:
+ *
+ *    NETWORK_VIDEO_FRAME_MAGIC, frame number, width, height,
+ *    pixel format, tile size, number of tiles
+ *
+ * followed by that many tiles, each one:
+ *
+ *    tile index, encoding, payload size (big-endian uint32 words),
+ *    payload
+ *
+ * Tiles are numbered row by row, ceil(width / tile size) to a row. Only
+ * tiles that differ from the previous frame sent are included, unless
+ * the size changed since, in which case all are. A decoded payload is
+ * the pixels of the tile, 4 bytes each, row by row; tiles on the right
+ * and bottom edge are cut short by the frame size.
+ *
+ * Frames that the receiver cannot keep up with are dropped, never
+ * queued, so frame numbers may skip. */
+
+#define NETWORK_VIDEO_FRAME_MAGIC   0x52414E56 /* "RANV" */
+#define NETWORK_VIDEO_TILE_SIZE     64
+
+enum network_video_pixelformat
+{
+   NETWORK_VIDEO_PIXELFORMAT_RGBA8888 = 0,
+   NETWORK_VIDEO_PIXELFORMAT_BGRA8888,
+   NETWORK_VIDEO_PIXELFORMAT_RGB565
+};
+
+enum network_video_tile_encoding
+{
+   NETWORK_VIDEO_TILE_RAW = 0,
+   NETWORK_VIDEO_TILE_ZLIB
+};
+
+struct network_video_sender;
+
 typedef struct network
 {
    unsigned video_width;
@@ -27,6 +67,7 @@ typedef struct network
    char address[256];
    uint16_t port;
    int fd;
+   struct network_video_sender *sender;
 } network_video_t;
 
 #endif
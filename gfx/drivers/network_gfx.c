@@ -18,8 +18,18 @@
 #include <retro_miscellaneous.h>
 #include <retro_timers.h>
 #include <stdlib.h>
+#include <string.h>
 #include <compat/strl.h>
 
+#ifdef NETWORK_VIDEO_TILES
+#ifdef HAVE_THREADS
+#include <rthreads/rthreads.h>
+#endif
+#ifdef HAVE_ZLIB
+#include <streams/trans_stream.h>
+#endif
+#endif
+
 #ifdef HAVE_NETWORKING
 #include <net/net_compat.h>
 #include <net/net_socket.h>
@@ -45,12 +55,6 @@
 #define xstr(s) str(s)
 #define str(s) #s
 
-enum {
-   NETWORK_VIDEO_PIXELFORMAT_RGBA8888 = 0,
-   NETWORK_VIDEO_PIXELFORMAT_BGRA8888,
-   NETWORK_VIDEO_PIXELFORMAT_RGB565
-} network_video_pixelformat;
-
 static unsigned char *network_menu_frame = NULL;
 static unsigned network_menu_width       = 0;
 static unsigned network_menu_height      = 0;
@@ -63,6 +67,330 @@ static unsigned network_menu_bits        = 0;
 static bool network_rgb32                = false;
 static bool network_menu_rgb32           = false;
 static unsigned *network_video_temp_buf  = NULL;
+static size_t network_video_temp_size    = 0; /* in pixels */
+
+#ifdef NETWORK_VIDEO_TILES
+#define NETWORK_VIDEO_TILE_BYTES   (NETWORK_VIDEO_TILE_SIZE * NETWORK_VIDEO_TILE_SIZE * 4)
+/* Room for a tile that does not compress: zlib adds a few bytes per
+ * 16 KiB block, plus its header and trailer */
+#define NETWORK_VIDEO_TILE_BOUND   (NETWORK_VIDEO_TILE_BYTES + NETWORK_VIDEO_TILE_BYTES / 8 + 64)
+#define NETWORK_VIDEO_FRAME_HEADER (7 * 4)
+#define NETWORK_VIDEO_TILE_HEADER  (3 * 4)
+
+typedef struct network_video_frame
+{
+   unsigned *pixels;
+   size_t size;      /* in pixels */
+   unsigned width;
+   unsigned height;
+   unsigned pixfmt;
+} network_video_frame_t;
+
+struct network_video_sender
+{
+   uint8_t tile[NETWORK_VIDEO_TILE_BYTES];
+   network_video_frame_t prev;      /* last frame sent */
+   network_video_frame_t current;   /* frame being sent */
+#ifdef HAVE_THREADS
+   network_video_frame_t pending;   /* newest frame not yet taken */
+   sthread_t *thread;
+   slock_t *lock;
+   scond_t *cond;
+#endif
+#ifdef HAVE_ZLIB
+   const struct trans_stream_backend *zbackend;
+   void *zstream;
+#endif
+   uint8_t *packet;
+   size_t packet_size;
+   unsigned frame_count;
+   unsigned dropped;
+   int fd;
+#ifdef HAVE_THREADS
+   bool has_pending;
+   bool quit;
+#endif
+};
+
+static void network_video_put32(uint8_t *p, uint32_t v)
+{
+   p[0] = (uint8_t)(v >> 24);
+   p[1] = (uint8_t)(v >> 16);
+   p[2] = (uint8_t)(v >>  8);
+   p[3] = (uint8_t)(v      );
+}
+
+static void network_video_frame_swap(network_video_frame_t *a,
+      network_video_frame_t *b)
+{
+   network_video_frame_t tmp = *a;
+   *a                        = *b;
+   *b                        = tmp;
+}
+
+#ifdef HAVE_ZLIB
+/* Returns the compressed size, or 0 if compressing did not pay off */
+static uint32_t network_video_tile_compress(
+      struct network_video_sender *sender,
+      const uint8_t *in, uint32_t in_size, uint8_t *out)
+{
+   uint32_t rd, wn;
+   enum trans_stream_error err;
+
+   if (!sender->zstream)
+      return 0;
+
+   sender->zbackend->set_in(sender->zstream, in, in_size);
+   sender->zbackend->set_out(sender->zstream, out, NETWORK_VIDEO_TILE_BOUND);
+
+   if (  !sender->zbackend->trans(sender->zstream, true, &rd, &wn, &err)
+         || err != TRANS_STREAM_ERROR_NONE)
+   {
+      /* Left mid-stream, start over with a fresh one */
+      sender->zbackend->stream_free(sender->zstream);
+      if ((sender->zstream = sender->zbackend->stream_new()))
+         sender->zbackend->define(sender->zstream, "level", 1);
+      return 0;
+   }
+
+   return (wn < in_size) ? wn : 0;
+}
+#endif
+
+/* Encodes sender->current as tiles that changed since sender->prev,
+ * and sends them */
+static void network_video_sender_send(struct network_video_sender *sender)
+{
+   unsigned tx, ty;
+   uint8_t *out;
+   network_video_frame_t *cur  = &sender->current;
+   network_video_frame_t *prev = &sender->prev;
+   unsigned tiles_x            = (cur->width  + NETWORK_VIDEO_TILE_SIZE - 1)
+      / NETWORK_VIDEO_TILE_SIZE;
+   unsigned tiles_y            = (cur->height + NETWORK_VIDEO_TILE_SIZE - 1)
+      / NETWORK_VIDEO_TILE_SIZE;
+   unsigned num_tiles          = 0;
+   bool keyframe               = !prev->pixels
+      || prev->width  != cur->width
+      || prev->height != cur->height;
+   size_t needed               = NETWORK_VIDEO_FRAME_HEADER
+      + (size_t)tiles_x * tiles_y
+      * (NETWORK_VIDEO_TILE_HEADER + NETWORK_VIDEO_TILE_BOUND);
+
+   if (!cur->width || !cur->height)
+      return;
+
+   if (sender->packet_size < needed)
+   {
+      uint8_t *packet = (uint8_t*)realloc(sender->packet, needed);
+      if (!packet)
+         return;
+      sender->packet      = packet;
+      sender->packet_size = needed;
+   }
+
+   out = sender->packet + NETWORK_VIDEO_FRAME_HEADER;
+
+   for (ty = 0; ty < tiles_y; ty++)
+   {
+      unsigned y0 = ty * NETWORK_VIDEO_TILE_SIZE;
+      unsigned th = MIN(NETWORK_VIDEO_TILE_SIZE, cur->height - y0);
+
+      for (tx = 0; tx < tiles_x; tx++)
+      {
+         unsigned y;
+         uint32_t size;
+         unsigned encoding = NETWORK_VIDEO_TILE_RAW;
+         unsigned x0       = tx * NETWORK_VIDEO_TILE_SIZE;
+         unsigned tw       = MIN(NETWORK_VIDEO_TILE_SIZE, cur->width - x0);
+         size_t row_bytes  = tw * sizeof(*cur->pixels);
+         size_t offset     = (size_t)y0 * cur->width + x0;
+
+         if (!keyframe)
+         {
+            for (y = 0; y < th; y++)
+               if (memcmp(cur->pixels + offset + y * cur->width,
+                        prev->pixels + offset + y * cur->width, row_bytes))
+                  break;
+            if (y == th)
+               continue;
+         }
+
+         for (y = 0; y < th; y++)
+            memcpy(sender->tile + y * row_bytes,
+                  cur->pixels + offset + y * cur->width, row_bytes);
+         size = (uint32_t)(row_bytes * th);
+
+#ifdef HAVE_ZLIB
+         {
+            uint32_t packed = network_video_tile_compress(sender,
+                  sender->tile, size, out + NETWORK_VIDEO_TILE_HEADER);
+            if (packed)
+            {
+               encoding = NETWORK_VIDEO_TILE_ZLIB;
+               size     = packed;
+            }
+         }
+#endif
+         if (encoding == NETWORK_VIDEO_TILE_RAW)
+            memcpy(out + NETWORK_VIDEO_TILE_HEADER, sender->tile, size);
+
+         network_video_put32(out + 0, ty * tiles_x + tx);
+         network_video_put32(out + 4, encoding);
+         network_video_put32(out + 8, size);
+         out += NETWORK_VIDEO_TILE_HEADER + size;
+         num_tiles++;
+      }
+   }
+
+   network_video_put32(sender->packet +  0, NETWORK_VIDEO_FRAME_MAGIC);
+   network_video_put32(sender->packet +  4, sender->frame_count++);
+   network_video_put32(sender->packet +  8, cur->width);
+   network_video_put32(sender->packet + 12, cur->height);
+   network_video_put32(sender->packet + 16, cur->pixfmt);
+   network_video_put32(sender->packet + 20, NETWORK_VIDEO_TILE_SIZE);
+   network_video_put32(sender->packet + 24, num_tiles);
+
+   if (sender->fd > 0)
+      socket_send_all_blocking(sender->fd, sender->packet,
+            out - sender->packet, true);
+
+   /* What was just sent is what the next frame is diffed against */
+   network_video_frame_swap(prev, cur);
+}
+
+#ifdef HAVE_THREADS
+static void network_video_sender_thread(void *data)
+{
+   struct network_video_sender *sender = (struct network_video_sender*)data;
+
+   for (;;)
+   {
+      slock_lock(sender->lock);
+      while (!sender->has_pending && !sender->quit)
+         scond_wait(sender->cond, sender->lock);
+      if (sender->quit)
+      {
+         slock_unlock(sender->lock);
+         break;
+      }
+      network_video_frame_swap(&sender->current, &sender->pending);
+      sender->has_pending = false;
+      slock_unlock(sender->lock);
+
+      network_video_sender_send(sender);
+   }
+}
+#endif
+
+/* Hands a converted frame over to the sender, and gets another buffer
+ * back to convert the next one into. Never waits for the network: if
+ * the previous frame has not been picked up yet, it is dropped. */
+static void network_video_sender_submit(struct network_video_sender *sender,
+      unsigned **pixels, size_t *size,
+      unsigned width, unsigned height, unsigned pixfmt)
+{
+   network_video_frame_t *frame;
+
+#ifdef HAVE_THREADS
+   slock_lock(sender->lock);
+   if (sender->has_pending)
+      sender->dropped++;
+   frame = &sender->pending;
+#else
+   frame = &sender->current;
+#endif
+
+   {
+      unsigned *tmp_pixels = frame->pixels;
+      size_t tmp_size      = frame->size;
+      frame->pixels        = *pixels;
+      frame->size          = *size;
+      *pixels              = tmp_pixels;
+      *size                = tmp_size;
+   }
+   frame->width            = width;
+   frame->height           = height;
+   frame->pixfmt           = pixfmt;
+
+#ifdef HAVE_THREADS
+   sender->has_pending     = true;
+   scond_signal(sender->cond);
+   slock_unlock(sender->lock);
+#else
+   network_video_sender_send(sender);
+#endif
+}
+
+static void network_video_sender_free(struct network_video_sender *sender)
+{
+   if (!sender)
+      return;
+
+#ifdef HAVE_THREADS
+   if (sender->thread)
+   {
+      slock_lock(sender->lock);
+      sender->quit = true;
+      scond_signal(sender->cond);
+      slock_unlock(sender->lock);
+      sthread_join(sender->thread);
+   }
+   if (sender->cond)
+      scond_free(sender->cond);
+   if (sender->lock)
+      slock_free(sender->lock);
+   free(sender->pending.pixels);
+
+   if (sender->dropped)
+      RARCH_LOG("[network]: Dropped %u frames the receiver could not keep up with.\n",
+            sender->dropped);
+#endif
+#ifdef HAVE_ZLIB
+   if (sender->zstream)
+      sender->zbackend->stream_free(sender->zstream);
+#endif
+   free(sender->prev.pixels);
+   free(sender->current.pixels);
+   free(sender->packet);
+   free(sender);
+}
+
+static struct network_video_sender *network_video_sender_new(int fd)
+{
+   struct network_video_sender *sender = (struct network_video_sender*)
+      calloc(1, sizeof(*sender));
+
+   if (!sender)
+      return NULL;
+
+   sender->fd = fd;
+
+#ifdef HAVE_ZLIB
+   sender->zbackend = trans_stream_get_zlib_deflate_backend();
+   if ((sender->zstream = sender->zbackend->stream_new()))
+      sender->zbackend->define(sender->zstream, "level", 1);
+#endif
+
+#ifdef HAVE_THREADS
+   sender->lock   = slock_new();
+   sender->cond   = scond_new();
+   if (!sender->lock || !sender->cond)
+      goto error;
+   if (!(sender->thread = sthread_create(
+               network_video_sender_thread, sender)))
+      goto error;
+#endif
+
+   return sender;
+
+#ifdef HAVE_THREADS
+error:
+   network_video_sender_free(sender);
+   return NULL;
+#endif
+}
+#endif
 
 static void gfx_ctx_network_input_driver(
       const char *joypad_driver,
@@ -89,7 +417,7 @@ static void *network_gfx_init(const video_info_t *video,
    settings_t *settings                 = config_get_ptr();
    network_video_t *network             = (network_video_t*)calloc(1, sizeof(*network));
    bool video_font_enable               = settings->bools.video_font_enable;
-   const char *joypad_driver            = settings->arrays.joypad_driver;
+   const char *joypad_driver            = settings->arrays.input_joypad_driver;
 
    *input                               = NULL;
    *input_data                          = NULL;
@@ -105,7 +433,7 @@ static void *network_gfx_init(const video_info_t *video,
    gfx_ctx_network_input_driver(joypad_driver,
          input, input_data);
 
-   if (font_enable)
+   if (video_font_enable)
       font_driver_init_osd(network,
             video,
             false,
@@ -153,13 +481,22 @@ try_connect:
       goto try_connect;
    }
 
+#ifdef NETWORK_VIDEO_TILES
+   if (!(network->sender = network_video_sender_new(network->fd)))
+      goto error;
+#endif
+
    RARCH_LOG("[network]: Init complete.\n");
 
    return network;
 
 error:
    if (network)
+   {
+      if (network->fd >= 0)
+         socket_close(network->fd);
       free(network);
+   }
    return NULL;
 }
 
@@ -226,20 +563,23 @@ static bool network_gfx_frame(void *data, const void *frame,
 #endif
    }
 
-   if (     network->video_width != width 
-         || network->video_height != height)
+   network->video_width  = width;
+   network->video_height = height;
+
+   if (network_video_temp_size <
+         (size_t)network->screen_width * network->screen_height)
    {
-      network->video_width  = width;
-      network->video_height = height;
+      network_video_temp_size = (size_t)network->screen_width
+         * network->screen_height;
 
       if (network_video_temp_buf)
          free(network_video_temp_buf);
 
-      network_video_temp_buf = (unsigned*)
-         malloc(
-                 network->screen_width 
-               * network->screen_height 
-               * sizeof(unsigned));
+      network_video_temp_buf  = (unsigned*)
+         malloc(network_video_temp_size * sizeof(unsigned));
+
+      if (!network_video_temp_buf)
+         network_video_temp_size = 0;
    }
 
    if (bits == 16)
@@ -308,21 +648,33 @@ static bool network_gfx_frame(void *data, const void *frame,
          /* no temp buffer available yet */
       }
    }
-   else
+   else if (network_video_temp_buf)
    {
       /* Scale 32-bit RGBX8888 image to output geometry. */
       unsigned x, y;
 
-      for (y = 0; y < network->screen_height; y++)
+      if (     width  == network->screen_width
+            && height == network->screen_height)
+      {
+         /* Nothing to scale, only the pitch to drop */
+         for (y = 0; y < height; y++)
+            memcpy(network_video_temp_buf + width * y,
+                  (const uint8_t*)frame_to_copy + pitch * y,
+                  width * sizeof(unsigned));
+      }
+      else
       {
-         for (x = 0; x < network->screen_width; x++)
+         for (y = 0; y < network->screen_height; y++)
          {
-            /* scale incoming frame to fit the screen */
-            unsigned scaled_x = (width * x) / network->screen_width;
-            unsigned scaled_y = (height * y) / network->screen_height;
-            unsigned    pixel = ((unsigned*)frame_to_copy)[(pitch / (bits / 8)) * scaled_y + scaled_x];
+            for (x = 0; x < network->screen_width; x++)
+            {
+               /* scale incoming frame to fit the screen */
+               unsigned scaled_x = (width * x) / network->screen_width;
+               unsigned scaled_y = (height * y) / network->screen_height;
+               unsigned    pixel = ((unsigned*)frame_to_copy)[(pitch / (bits / 8)) * scaled_y + scaled_x];
 
-            network_video_temp_buf[network->screen_width * y + x] = pixel;
+               network_video_temp_buf[network->screen_width * y + x] = pixel;
+            }
          }
       }
 
@@ -330,10 +682,21 @@ static bool network_gfx_frame(void *data, const void *frame,
       frame_to_copy = network_video_temp_buf;
    }
 
-   if (draw && network->screen_width > 0 && network->screen_height > 0)
+   if (     draw
+         && network_video_temp_buf
+         && frame_to_copy == network_video_temp_buf
+         && network->screen_width > 0
+         && network->screen_height > 0)
    {
+#ifdef NETWORK_VIDEO_TILES
+      /* Diffing, compression and sending happen on the sender thread */
+      network_video_sender_submit(network->sender,
+            &network_video_temp_buf, &network_video_temp_size,
+            network->screen_width, network->screen_height, pixfmt);
+#else
       if (network->fd > 0)
          socket_send_all_blocking(network->fd, frame_to_copy, network->screen_width * network->screen_height * 4, true);
+#endif
    }
 
    if (msg)
@@ -374,11 +737,16 @@ static void network_gfx_free(void *data)
    if (network_video_temp_buf)
       free(network_video_temp_buf);
 
-   network_menu_frame     = NULL;
-   network_video_temp_buf = NULL;
+   network_menu_frame      = NULL;
+   network_video_temp_buf  = NULL;
+   network_video_temp_size = 0;
 
    font_driver_free_osd();
 
+#ifdef NETWORK_VIDEO_TILES
+   network_video_sender_free(network->sender);
+#endif
+
    if (network->fd >= 0)
       socket_close(network->fd);
 
@@ -19,6 +19,8 @@
 #include <string.h>
 
 #include <compat/strl.h>
+#include <file/file_path.h>
+#include <streams/file_stream.h>
 #include <gfx/scaler/scaler.h>
 #include <gfx/video_frame.h>
 #include <formats/image.h>
@@ -866,6 +868,167 @@ static void vulkan_init_resources(vk_t *vk)
    vulkan_init_command_buffers(vk);
 }
 
+/* Pipeline cache blobs larger than this are neither
+ * loaded nor written back to disk. */
+#define VULKAN_PIPELINE_CACHE_MAX_SIZE (32 * 1024 * 1024)
+
+/* Size of the header mandated by the Vulkan spec
+ * (VK_PIPELINE_CACHE_HEADER_VERSION_ONE):
+ * length, version, vendorID, deviceID, pipelineCacheUUID. */
+#define VULKAN_PIPELINE_CACHE_HEADER_SIZE (16 + VK_UUID_SIZE)
+
+static bool vulkan_pipeline_cache_path(vk_t *vk, char *s, size_t len)
+{
+   char file_name[64];
+   settings_t *settings = config_get_ptr();
+   const char *dir      = settings->paths.directory_cache;
+
+   if (!vk->context || string_is_empty(dir))
+      return false;
+
+   snprintf(file_name, sizeof(file_name),
+         "vulkan_pipeline_%08x_%08x.bin",
+         (unsigned)vk->context->gpu_properties.vendorID,
+         (unsigned)vk->context->gpu_properties.deviceID);
+   fill_pathname_join(s, dir, file_name, len);
+   return true;
+}
+
+static uint32_t vulkan_pipeline_cache_read_u32(const uint8_t *data)
+{
+   /* Header fields are stored in host byte order. */
+   uint32_t val;
+   memcpy(&val, data, sizeof(val));
+   return val;
+}
+
+/* Checks that a serialized pipeline cache was produced
+ * by the same driver/device we are running on. Anything
+ * else is stale and must not be handed to the driver. */
+static bool vulkan_pipeline_cache_is_valid(vk_t *vk,
+      const uint8_t *data, size_t size)
+{
+   const VkPhysicalDeviceProperties *props =
+      &vk->context->gpu_properties;
+
+   if (size < VULKAN_PIPELINE_CACHE_HEADER_SIZE)
+      return false;
+   if (vulkan_pipeline_cache_read_u32(data + 0)
+         < VULKAN_PIPELINE_CACHE_HEADER_SIZE)
+      return false;
+   if (vulkan_pipeline_cache_read_u32(data + 4)
+         != VK_PIPELINE_CACHE_HEADER_VERSION_ONE)
+      return false;
+   if (vulkan_pipeline_cache_read_u32(data + 8)  != props->vendorID)
+      return false;
+   if (vulkan_pipeline_cache_read_u32(data + 12) != props->deviceID)
+      return false;
+   if (memcmp(data + 16, props->pipelineCacheUUID, VK_UUID_SIZE) != 0)
+      return false;
+
+   return true;
+}
+
+static void vulkan_create_pipeline_cache(vk_t *vk)
+{
+   char path[PATH_MAX_LENGTH];
+   void *data                      = NULL;
+   int64_t size                    = 0;
+   VkPipelineCacheCreateInfo cache = {
+      VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO };
+
+   path[0] = '\0';
+
+   if (     vulkan_pipeline_cache_path(vk, path, sizeof(path))
+         && path_is_valid(path)
+         && path_get_size(path) <= VULKAN_PIPELINE_CACHE_MAX_SIZE
+         && filestream_read_file(path, &data, &size)
+         && data)
+   {
+      if (vulkan_pipeline_cache_is_valid(vk,
+               (const uint8_t*)data, (size_t)size))
+      {
+         cache.initialDataSize = (size_t)size;
+         cache.pInitialData    = data;
+      }
+      else
+      {
+         RARCH_WARN("[Vulkan]: Discarding stale pipeline cache: \"%s\".\n",
+               path);
+         filestream_delete(path);
+      }
+   }
+
+   if (vkCreatePipelineCache(vk->context->device,
+            &cache, NULL, &vk->pipelines.cache) != VK_SUCCESS
+         && cache.pInitialData)
+   {
+      /* Driver rejected the blob, start over with an empty cache. */
+      RARCH_WARN("[Vulkan]: Pipeline cache rejected by driver, discarding.\n");
+      cache.initialDataSize = 0;
+      cache.pInitialData    = NULL;
+      filestream_delete(path);
+      vkCreatePipelineCache(vk->context->device,
+            &cache, NULL, &vk->pipelines.cache);
+   }
+   else if (cache.pInitialData)
+      RARCH_LOG("[Vulkan]: Loaded pipeline cache (%u bytes): \"%s\".\n",
+            (unsigned)cache.initialDataSize, path);
+
+   if (data)
+      free(data);
+}
+
+static void vulkan_save_pipeline_cache(vk_t *vk)
+{
+   char path[PATH_MAX_LENGTH];
+   char tmp_path[PATH_MAX_LENGTH];
+   size_t size = 0;
+   void *data  = NULL;
+
+   if (!vk->context || vk->pipelines.cache == VK_NULL_HANDLE)
+      return;
+   if (!vulkan_pipeline_cache_path(vk, path, sizeof(path)))
+      return;
+
+   if (vkGetPipelineCacheData(vk->context->device,
+            vk->pipelines.cache, &size, NULL) != VK_SUCCESS || !size)
+      return;
+
+   if (size > VULKAN_PIPELINE_CACHE_MAX_SIZE)
+   {
+      RARCH_WARN("[Vulkan]: Pipeline cache too large to save (%u bytes).\n",
+            (unsigned)size);
+      filestream_delete(path);
+      return;
+   }
+
+   if (!(data = malloc(size)))
+      return;
+
+   if (     vkGetPipelineCacheData(vk->context->device,
+            vk->pipelines.cache, &size, data) == VK_SUCCESS
+         && vulkan_pipeline_cache_is_valid(vk, (const uint8_t*)data, size))
+   {
+      /* Write to a temporary file first so an interrupted
+       * write can never leave a truncated cache behind. */
+      strlcpy(tmp_path, path, sizeof(tmp_path));
+      strlcat(tmp_path, ".tmp", sizeof(tmp_path));
+
+      if (filestream_write_file(tmp_path, data, (int64_t)size))
+      {
+#ifdef _WIN32
+         /* rename() does not replace an existing file here */
+         filestream_delete(path);
+#endif
+         if (filestream_rename(tmp_path, path) != 0)
+            filestream_delete(tmp_path);
+      }
+   }
+
+   free(data);
+}
+
 static void vulkan_init_static_resources(vk_t *vk)
 {
    unsigned i;
@@ -873,17 +1036,13 @@ static void vulkan_init_static_resources(vk_t *vk)
    VkCommandPoolCreateInfo pool_info = {
       VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
 
-   /* Create the pipeline cache. */
-   VkPipelineCacheCreateInfo cache   = {
-      VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO };
-
    pool_info.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
 
    if (!vk->context)
       return;
 
-   vkCreatePipelineCache(vk->context->device,
-         &cache, NULL, &vk->pipelines.cache);
+   /* Create the pipeline cache. */
+   vulkan_create_pipeline_cache(vk);
 
    pool_info.queueFamilyIndex = vk->context->graphics_queue_index;
 
@@ -901,6 +1060,7 @@ static void vulkan_init_static_resources(vk_t *vk)
 static void vulkan_deinit_static_resources(vk_t *vk)
 {
    unsigned i;
+   vulkan_save_pipeline_cache(vk);
    vkDestroyPipelineCache(vk->context->device,
          vk->pipelines.cache, NULL);
    vulkan_destroy_texture(
@@ -1431,6 +1591,10 @@ static bool vulkan_set_shader(void *data,
       return false;
    }
 
+   /* New pipelines were just compiled for this preset,
+    * persist them so the next switch/startup is cheap. */
+   vulkan_save_pipeline_cache(vk);
+
    return true;
 }
 
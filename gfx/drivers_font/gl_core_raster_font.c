@@ -17,13 +17,13 @@
 
 #include <stdlib.h>
 
-#include <encodings/utf.h>
 #include <string/stdstring.h>
 #include <retro_math.h>
 #include <gfx/common/gl_core_common.h>
 
 #include "../common/gl_core_common.h"
 #include "../font_driver.h"
+#include "../font_run_cache.h"
 #include "../../configuration.h"
 #include "../../verbosity.h"
 
@@ -49,6 +49,8 @@ typedef struct
    const font_renderer_driver_t *font_driver;
    void *font_data;
    struct font_atlas *atlas;
+   font_run_cache_t *runs;
+   unsigned atlas_height;
 
    video_font_raster_block_t *block;
 } gl_core_raster_t;
@@ -60,6 +62,8 @@ static void gl_core_raster_font_free_font(void *data,
    if (!font)
       return;
 
+   font_run_cache_free(font->runs);
+
    if (font->font_driver && font->font_data)
       font->font_driver->free(font->font_data);
 
@@ -75,8 +79,31 @@ static void gl_core_raster_font_free_font(void *data,
    free(font);
 }
 
+/* The font renderer may add rows to the atlas. Texture coordinates
+ * already queued in the block are normalised to the old atlas
+ * height, so rescale them to the new one. */
+static void gl_core_raster_font_update_size(gl_core_raster_t *font)
+{
+   if (font->atlas->height == font->atlas_height)
+      return;
+
+   if (font->block && font->atlas_height)
+   {
+      unsigned i;
+      float *tex_coord = font->block->carr.coords.tex_coord;
+      float scale      = (float)font->atlas_height / font->atlas->height;
+
+      for (i = 0; i < font->block->carr.coords.vertices; i++)
+         tex_coord[2 * i + 1] *= scale;
+   }
+
+   font->atlas_height = font->atlas->height;
+}
+
 static bool gl_core_raster_font_upload_atlas(gl_core_raster_t *font)
 {
+   gl_core_raster_font_update_size(font);
+
    if (font->tex)
       glDeleteTextures(1, &font->tex);
    glGenTextures(1, &font->tex);
@@ -125,6 +152,13 @@ static void *gl_core_raster_font_init_font(void *data,
          font->gl->ctx_driver->make_current(false);
 
    font->atlas      = font->font_driver->get_atlas(font->font_data);
+   font->runs       = font_run_cache_new(font->font_driver,
+         font->font_data);
+
+   if (!font->runs)
+      goto error;
+
+   font->atlas->growable = true;
 
    if (!gl_core_raster_font_upload_atlas(font))
       goto error;
@@ -140,31 +174,16 @@ error:
 static int gl_core_get_message_width(void *data, const char *msg,
       unsigned msg_len, float scale)
 {
-   gl_core_raster_t *font   = (gl_core_raster_t*)data;
-   const char* msg_end = msg + msg_len;
-   int delta_x         = 0;
+   const font_run_t *run  = NULL;
+   gl_core_raster_t *font = (gl_core_raster_t*)data;
 
-   if (     !font
-         || !font->font_driver
-         || !font->font_driver->get_glyph
-         || !font->font_data )
+   if (!font || !font->runs)
       return 0;
 
-   while (msg < msg_end)
-   {
-      unsigned code                  = utf8_walk(&msg);
-      const struct font_glyph *glyph = font->font_driver->get_glyph(
-            font->font_data, code);
-
-      if (!glyph) /* Do something smarter here ... */
-         glyph = font->font_driver->get_glyph(font->font_data, '?');
-      if (!glyph)
-         continue;
-
-      delta_x += glyph->advance_x;
-   }
+   if (!(run = font_run_cache_get(font->runs, msg, msg_len)))
+      return 0;
 
-   return delta_x * scale;
+   return run->advance_x * scale;
 }
 
 static void gl_core_raster_font_draw_vertices(gl_core_raster_t *font,
@@ -210,47 +229,48 @@ static void gl_core_raster_font_render_line(
       GLfloat scale, const GLfloat color[4], GLfloat pos_x,
       GLfloat pos_y, unsigned text_align)
 {
-   unsigned i;
+   unsigned i, j;
    struct video_coords coords;
    GLfloat font_tex_coords[2 * 6 * MAX_MSG_LEN_CHUNK];
    GLfloat font_vertex[2 * 6 * MAX_MSG_LEN_CHUNK];
    GLfloat font_color[4 * 6 * MAX_MSG_LEN_CHUNK];
+   float inv_tex_size_x, inv_tex_size_y;
    gl_core_t *gl        = font->gl;
-   const char* msg_end  = msg + msg_len;
+   const font_run_t *run = font_run_cache_get(font->runs, msg, msg_len);
    int x                = roundf(pos_x * gl->vp.width);
    int y                = roundf(pos_y * gl->vp.height);
-   int delta_x          = 0;
-   int delta_y          = 0;
-   float inv_tex_size_x = 1.0f / font->atlas->width;
-   float inv_tex_size_y = 1.0f / font->atlas->height;
    float inv_win_width  = 1.0f / font->gl->vp.width;
    float inv_win_height = 1.0f / font->gl->vp.height;
 
+   if (!run)
+      return;
+
+   /* Laying out the run may have grown the atlas */
+   gl_core_raster_font_update_size(font);
+   inv_tex_size_x       = 1.0f / font->atlas->width;
+   inv_tex_size_y       = 1.0f / font->atlas->height;
+
    switch (text_align)
    {
       case TEXT_ALIGN_RIGHT:
-         x -= gl_core_get_message_width(font, msg, msg_len, scale);
+         x -= (int)(run->advance_x * scale);
          break;
       case TEXT_ALIGN_CENTER:
-         x -= gl_core_get_message_width(font, msg, msg_len, scale) / 2.0;
+         x -= (int)(run->advance_x * scale) / 2.0;
          break;
    }
 
-   while (msg < msg_end)
+   j = 0;
+   while (j < run->count)
    {
       i = 0;
-      while ((i < MAX_MSG_LEN_CHUNK) && (msg < msg_end))
+      while ((i < MAX_MSG_LEN_CHUNK) && (j < run->count))
       {
          int off_x, off_y, tex_x, tex_y, width, height;
-         unsigned                  code = utf8_walk(&msg);
-         const struct font_glyph *glyph = font->font_driver->get_glyph(
-               font->font_data, code);
-
-         if (!glyph) /* Do something smarter here ... */
-            glyph = font->font_driver->get_glyph(font->font_data, '?');
-
-         if (!glyph)
-            continue;
+         const font_run_glyph_t *run_glyph = &run->glyphs[j++];
+         const struct font_glyph *glyph    = &run_glyph->glyph;
+         int delta_x                       =  run_glyph->pen_x;
+         int delta_y                       = -run_glyph->pen_y;
 
          off_x  = glyph->draw_offset_x;
          off_y  = glyph->draw_offset_y;
@@ -268,9 +288,6 @@ static void gl_core_raster_font_render_line(
          GL_CORE_RASTER_FONT_EMIT(5, 1, 1); /* Bottom-right */
 
          i++;
-
-         delta_x += glyph->advance_x;
-         delta_y -= glyph->advance_y;
       }
 
       coords.tex_coord     = font_tex_coords;
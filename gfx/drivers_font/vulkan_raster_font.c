@@ -15,12 +15,12 @@
 
 #include <string.h>
 
-#include <encodings/utf.h>
 #include <compat/strl.h>
 
 #include "../common/vulkan_common.h"
 
 #include "../font_driver.h"
+#include "../font_run_cache.h"
 
 #include "../../configuration.h"
 
@@ -30,6 +30,7 @@ typedef struct
    void *font_data;
    struct font_atlas *atlas;
    const font_renderer_driver_t *font_driver;
+   font_run_cache_t *runs;
    struct vk_vertex *pv;
    struct vk_texture texture;
    struct vk_texture texture_optimal;
@@ -57,6 +58,30 @@ static INLINE void vulkan_raster_font_update_glyph(
    }
 }
 
+/* The atlas only gets dirty when a run is laid out, so copying
+ * the glyphs of that run is enough to bring the texture up to date */
+static INLINE void vulkan_raster_font_update_run(
+      vulkan_raster_t *font, const font_run_t *run)
+{
+   if(font->atlas->dirty)
+   {
+      unsigned i, row;
+      for (i = 0; i < run->count; i++)
+      {
+         const struct font_glyph *glyph = &run->glyphs[i].glyph;
+         for (row = glyph->atlas_offset_y; row < (glyph->atlas_offset_y + glyph->height); row++)
+         {
+            uint8_t *src = font->atlas->buffer + row * font->atlas->width + glyph->atlas_offset_x;
+            uint8_t *dst = (uint8_t*)font->texture.mapped + row * font->texture.stride + glyph->atlas_offset_x;
+            memcpy(dst, src, glyph->width);
+         }
+      }
+
+      font->atlas->dirty = false;
+      font->needs_update = true;
+   }
+}
+
 
 static void vulkan_raster_font_free_font(void *data, bool is_threaded)
 {
@@ -64,6 +89,8 @@ static void vulkan_raster_font_free_font(void *data, bool is_threaded)
    if (!font)
       return;
 
+   font_run_cache_free(font->runs);
+
    if (font->font_driver && font->font_data)
       font->font_driver->free(font->font_data);
 
@@ -107,6 +134,15 @@ static void *vulkan_raster_font_init_font(void *data,
    }
 
    font->atlas   = font->font_driver->get_atlas(font->font_data);
+   font->runs    = font_run_cache_new(font->font_driver, font->font_data);
+
+   if (!font->runs)
+   {
+      font->font_driver->free(font->font_data);
+      free(font);
+      return NULL;
+   }
+
    font->texture = vulkan_create_texture(font->vk, NULL,
          font->atlas->width, font->atlas->height, VK_FORMAT_R8_UNORM, font->atlas->buffer,
          NULL /*&swizzle*/, VULKAN_TEXTURE_STAGING);
@@ -128,33 +164,18 @@ static void *vulkan_raster_font_init_font(void *data,
 static int vulkan_get_message_width(void *data, const char *msg,
       unsigned msg_len, float scale)
 {
+   const font_run_t *run = NULL;
    vulkan_raster_t *font = (vulkan_raster_t*)data;
-   const char* msg_end   = msg + msg_len;
-   int delta_x           = 0;
 
-   if (     !font
-         || !font->font_driver
-         || !font->font_driver->get_glyph
-         || !font->font_data )
+   if (!font || !font->runs)
       return 0;
 
-   while (msg < msg_end)
-   {
-      uint32_t code                  = utf8_walk(&msg);
-      const struct font_glyph *glyph = font->font_driver->get_glyph(
-            font->font_data, code);
-
-      if (!glyph) /* Do something smarter here ... */
-         glyph = font->font_driver->get_glyph(font->font_data, '?');
+   if (!(run = font_run_cache_get(font->runs, msg, msg_len)))
+      return 0;
 
-      if (glyph)
-      {
-         vulkan_raster_font_update_glyph(font, glyph);
-         delta_x += glyph->advance_x;
-      }
-   }
+   vulkan_raster_font_update_run(font, run);
 
-   return delta_x * scale;
+   return run->advance_x * scale;
 }
 
 static void vulkan_raster_font_render_line(
@@ -162,13 +183,12 @@ static void vulkan_raster_font_render_line(
       float scale, const float color[4], float pos_x,
       float pos_y, unsigned text_align)
 {
+   unsigned i;
    struct vk_color vk_color;
    vk_t *vk             = font->vk;
-   const char* msg_end  = msg + msg_len;
+   const font_run_t *run = font_run_cache_get(font->runs, msg, msg_len);
    int x                = roundf(pos_x * vk->vp.width);
    int y                = roundf((1.0f - pos_y) * vk->vp.height);
-   int delta_x          = 0;
-   int delta_y          = 0;
    float inv_tex_size_x = 1.0f / font->texture.width;
    float inv_tex_size_y = 1.0f / font->texture.height;
    float inv_win_width  = 1.0f / font->vk->vp.width;
@@ -179,29 +199,27 @@ static void vulkan_raster_font_render_line(
    vk_color.b           = color[2];
    vk_color.a           = color[3];
 
+   if (!run)
+      return;
+
+   vulkan_raster_font_update_run(font, run);
+
    switch (text_align)
    {
       case TEXT_ALIGN_RIGHT:
-         x -= vulkan_get_message_width(font, msg, msg_len, scale);
+         x -= (int)(run->advance_x * scale);
          break;
       case TEXT_ALIGN_CENTER:
-         x -= vulkan_get_message_width(font, msg, msg_len, scale) / 2;
+         x -= (int)(run->advance_x * scale) / 2;
          break;
    }
 
-   while (msg < msg_end)
+   for (i = 0; i < run->count; i++)
    {
       int off_x, off_y, tex_x, tex_y, width, height;
-      unsigned code                  = utf8_walk(&msg);
-      const struct font_glyph *glyph =
-         font->font_driver->get_glyph(font->font_data, code);
-
-      if (!glyph) /* Do something smarter here ... */
-         glyph = font->font_driver->get_glyph(font->font_data, '?');
-      if (!glyph)
-         continue;
-
-      vulkan_raster_font_update_glyph(font, glyph);
+      const struct font_glyph *glyph = &run->glyphs[i].glyph;
+      int delta_x                    = run->glyphs[i].pen_x;
+      int delta_y                    = run->glyphs[i].pen_y;
 
       off_x  = glyph->draw_offset_x;
       off_y  = glyph->draw_offset_y;
@@ -228,9 +246,6 @@ static void vulkan_raster_font_render_line(
       }
 
       font->vertices += 6;
-
-      delta_x        += glyph->advance_x;
-      delta_y        += glyph->advance_y;
    }
 }
 
@@ -37,6 +37,8 @@
 #define FT_ATLAS_ROWS 16
 #define FT_ATLAS_COLS 16
 #define FT_ATLAS_SIZE (FT_ATLAS_ROWS * FT_ATLAS_COLS)
+/* Pages of FT_ATLAS_SIZE slots a growable atlas may have */
+#define FT_ATLAS_MAX_PAGES 8
 
 typedef struct freetype_atlas_slot
 {
@@ -51,8 +53,12 @@ typedef struct freetype_renderer
    FT_Library lib;                                   /* ptr alignment   */
    FT_Face face;                                     /* ptr alignment   */
    struct font_atlas atlas;                          /* ptr alignment   */
-   freetype_atlas_slot_t atlas_slots[FT_ATLAS_SIZE]; /* ptr alignment   */
+   freetype_atlas_slot_t* atlas_pages[FT_ATLAS_MAX_PAGES]; /* ptr alignment */
    freetype_atlas_slot_t* uc_map[0x100];             /* ptr alignment   */
+   unsigned num_pages;
+   unsigned free_slots; /* Never used slots at the end of the last page */
+   unsigned slot_width;
+   unsigned slot_height;
    unsigned usage_counter;
    struct font_line_metrics line_metrics;            /* float alignment */
 } ft_font_renderer_t;
@@ -67,11 +73,14 @@ static struct font_atlas *font_renderer_ft_get_atlas(void *data)
 
 static void font_renderer_ft_free(void *data)
 {
+   unsigned i;
    ft_font_renderer_t *handle = (ft_font_renderer_t*)data;
    if (!handle)
       return;
 
    free(handle->atlas.buffer);
+   for (i = 0; i < handle->num_pages; i++)
+      free(handle->atlas_pages[i]);
 
    if (handle->face)
       FT_Done_Face(handle->face);
@@ -80,29 +89,90 @@ static void font_renderer_ft_free(void *data)
    free(handle);
 }
 
+/* Appends a page of empty slots below the current atlas */
+static bool font_renderer_ft_add_page(ft_font_renderer_t *handle)
+{
+   unsigned x, y;
+   uint8_t *buffer             = NULL;
+   freetype_atlas_slot_t *page = NULL;
+   freetype_atlas_slot_t *slot = NULL;
+   unsigned page_y             = handle->atlas.height;
+   unsigned page_height        = handle->slot_height * FT_ATLAS_ROWS;
+
+   if (     handle->num_pages >= FT_ATLAS_MAX_PAGES
+         || page_y + page_height > FONT_ATLAS_MAX_HEIGHT)
+      return false;
+
+   if (!(page = (freetype_atlas_slot_t*)
+            calloc(FT_ATLAS_SIZE, sizeof(*page))))
+      return false;
+
+   if (!(buffer = (uint8_t*)realloc(handle->atlas.buffer,
+               handle->atlas.width * (page_y + page_height))))
+   {
+      free(page);
+      return false;
+   }
+
+   memset(buffer + handle->atlas.width * page_y, 0,
+         handle->atlas.width * page_height);
+
+   slot = page;
+   for (y = 0; y < FT_ATLAS_ROWS; y++)
+   {
+      for (x = 0; x < FT_ATLAS_COLS; x++)
+      {
+         slot->glyph.atlas_offset_x = x * handle->slot_width;
+         slot->glyph.atlas_offset_y = page_y + y * handle->slot_height;
+         slot++;
+      }
+   }
+
+   handle->atlas_pages[handle->num_pages++] = page;
+   handle->free_slots                       = FT_ATLAS_SIZE;
+   handle->atlas.buffer                     = buffer;
+   handle->atlas.height                     = page_y + page_height;
+   handle->atlas.dirty                      = true;
+
+   return true;
+}
+
 static freetype_atlas_slot_t* font_renderer_get_slot(ft_font_renderer_t *handle)
 {
-   int i, map_id;
-   unsigned oldest = 0;
+   unsigned i, page, map_id;
+   freetype_atlas_slot_t *oldest = handle->atlas_pages[0];
 
-   for (i = 1; i < FT_ATLAS_SIZE; i++)
-      if ((handle->usage_counter - handle->atlas_slots[i].last_used) >
-         (handle->usage_counter - handle->atlas_slots[oldest].last_used))
-         oldest = i;
+   /* Grow the atlas while it may, so glyphs of cached text runs
+    * never have to be evicted */
+   if (     handle->free_slots
+         || (handle->atlas.growable && font_renderer_ft_add_page(handle)))
+      return &handle->atlas_pages[handle->num_pages - 1]
+         [FT_ATLAS_SIZE - handle->free_slots--];
+
+   for (page = 0; page < handle->num_pages; page++)
+   {
+      freetype_atlas_slot_t *slots = handle->atlas_pages[page];
+      for (i = 0; i < FT_ATLAS_SIZE; i++)
+         if ((handle->usage_counter - slots[i].last_used) >
+            (handle->usage_counter - oldest->last_used))
+            oldest = &slots[i];
+   }
 
    /* remove from map */
-   map_id = handle->atlas_slots[oldest].charcode & 0xFF;
-   if (handle->uc_map[map_id] == &handle->atlas_slots[oldest])
-      handle->uc_map[map_id] = handle->atlas_slots[oldest].next;
+   map_id = oldest->charcode & 0xFF;
+   if (handle->uc_map[map_id] == oldest)
+      handle->uc_map[map_id] = oldest->next;
    else if (handle->uc_map[map_id])
    {
       freetype_atlas_slot_t* ptr = handle->uc_map[map_id];
-      while (ptr->next && ptr->next != &handle->atlas_slots[oldest])
+      while (ptr->next && ptr->next != oldest)
          ptr = ptr->next;
-      ptr->next = handle->atlas_slots[oldest].next;
+      ptr->next = oldest->next;
    }
 
-   return &handle->atlas_slots[oldest];
+   handle->atlas.generation++;
+
+   return oldest;
 }
 
 static const struct font_glyph *font_renderer_ft_get_glyph(
@@ -186,10 +256,21 @@ static bool font_renderer_create_atlas(ft_font_renderer_t *handle, float font_si
    if (!atlas_buffer)
       return false;
 
+   if (!(slot = (freetype_atlas_slot_t*)
+            calloc(FT_ATLAS_SIZE, sizeof(*slot))))
+   {
+      free(atlas_buffer);
+      return false;
+   }
+
    handle->atlas.buffer        = atlas_buffer;
    handle->atlas.width         = atlas_width;
    handle->atlas.height        = atlas_height;
-   slot                        = handle->atlas_slots;
+   handle->atlas_pages[0]      = slot;
+   handle->num_pages           = 1;
+   handle->free_slots          = FT_ATLAS_SIZE;
+   handle->slot_width          = max_width;
+   handle->slot_height         = max_height;
 
    for (y = 0; y < FT_ATLAS_ROWS; y++)
    {
@@ -41,6 +41,8 @@
 #define STB_UNICODE_ATLAS_ROWS 16
 #define STB_UNICODE_ATLAS_COLS 16
 #define STB_UNICODE_ATLAS_SIZE (STB_UNICODE_ATLAS_ROWS * STB_UNICODE_ATLAS_COLS)
+/* Pages of STB_UNICODE_ATLAS_SIZE slots a growable atlas may have */
+#define STB_UNICODE_ATLAS_MAX_PAGES 8
 
 typedef struct stb_unicode_atlas_slot
 {
@@ -55,10 +57,12 @@ typedef struct
    uint8_t *font_data;
    struct font_atlas atlas;               /* ptr alignment */
    stb_unicode_atlas_slot_t* uc_map[0x100];
-   stb_unicode_atlas_slot_t atlas_slots[STB_UNICODE_ATLAS_SIZE];
+   stb_unicode_atlas_slot_t* atlas_pages[STB_UNICODE_ATLAS_MAX_PAGES];
    stbtt_fontinfo info;                   /* ptr alignment */
    int max_glyph_width;
    int max_glyph_height;
+   unsigned num_pages;
+   unsigned free_slots; /* Never used slots at the end of the last page */
    unsigned usage_counter;
    float scale_factor;
    struct font_line_metrics line_metrics; /* float alignment */
@@ -72,36 +76,102 @@ static struct font_atlas *font_renderer_stb_unicode_get_atlas(void *data)
 
 static void font_renderer_stb_unicode_free(void *data)
 {
+   unsigned i;
    stb_unicode_font_renderer_t *self = (stb_unicode_font_renderer_t*)data;
 
    free(self->atlas.buffer);
+   for (i = 0; i < self->num_pages; i++)
+      free(self->atlas_pages[i]);
    free(self->font_data);
    free(self);
 }
 
+/* Appends a page of empty slots below the current atlas */
+static bool font_renderer_stb_unicode_add_page(
+      stb_unicode_font_renderer_t *handle)
+{
+   unsigned x, y;
+   uint8_t *buffer                = NULL;
+   stb_unicode_atlas_slot_t *page = NULL;
+   stb_unicode_atlas_slot_t *slot = NULL;
+   unsigned page_y                = handle->atlas.height;
+   unsigned page_height           = handle->max_glyph_height
+      * STB_UNICODE_ATLAS_ROWS;
+
+   if (     handle->num_pages >= STB_UNICODE_ATLAS_MAX_PAGES
+         || page_y + page_height > FONT_ATLAS_MAX_HEIGHT)
+      return false;
+
+   if (!(page = (stb_unicode_atlas_slot_t*)
+            calloc(STB_UNICODE_ATLAS_SIZE, sizeof(*page))))
+      return false;
+
+   if (!(buffer = (uint8_t*)realloc(handle->atlas.buffer,
+               handle->atlas.width * (page_y + page_height))))
+   {
+      free(page);
+      return false;
+   }
+
+   memset(buffer + handle->atlas.width * page_y, 0,
+         handle->atlas.width * page_height);
+
+   slot = page;
+   for (y = 0; y < STB_UNICODE_ATLAS_ROWS; y++)
+   {
+      for (x = 0; x < STB_UNICODE_ATLAS_COLS; x++)
+      {
+         slot->glyph.atlas_offset_x = x * handle->max_glyph_width;
+         slot->glyph.atlas_offset_y = page_y + y * handle->max_glyph_height;
+         slot++;
+      }
+   }
+
+   handle->atlas_pages[handle->num_pages++] = page;
+   handle->free_slots                       = STB_UNICODE_ATLAS_SIZE;
+   handle->atlas.buffer                     = buffer;
+   handle->atlas.height                     = page_y + page_height;
+   handle->atlas.dirty                      = true;
+
+   return true;
+}
+
 static stb_unicode_atlas_slot_t* font_renderer_stb_unicode_get_slot(stb_unicode_font_renderer_t *handle)
 {
-   int i, map_id;
-   unsigned oldest = 0;
+   unsigned i, page, map_id;
+   stb_unicode_atlas_slot_t *oldest = handle->atlas_pages[0];
+
+   /* Grow the atlas while it may, so glyphs of cached text runs
+    * never have to be evicted */
+   if (     handle->free_slots
+         || (handle->atlas.growable && font_renderer_stb_unicode_add_page(handle)))
+      return &handle->atlas_pages[handle->num_pages - 1]
+         [STB_UNICODE_ATLAS_SIZE - handle->free_slots--];
 
-   for (i = 1; i < STB_UNICODE_ATLAS_SIZE; i++)
-      if ((handle->usage_counter - handle->atlas_slots[i].last_used) >
-         (handle->usage_counter - handle->atlas_slots[oldest].last_used))
-         oldest = i;
+   for (page = 0; page < handle->num_pages; page++)
+   {
+      stb_unicode_atlas_slot_t *slots = handle->atlas_pages[page];
+      for (i = 0; i < STB_UNICODE_ATLAS_SIZE; i++)
+         if ((handle->usage_counter - slots[i].last_used) >
+            (handle->usage_counter - oldest->last_used))
+            oldest = &slots[i];
+   }
 
    /* remove from map */
-   map_id = handle->atlas_slots[oldest].charcode & 0xFF;
-   if (handle->uc_map[map_id] == &handle->atlas_slots[oldest])
-      handle->uc_map[map_id] = handle->atlas_slots[oldest].next;
+   map_id = oldest->charcode & 0xFF;
+   if (handle->uc_map[map_id] == oldest)
+      handle->uc_map[map_id] = oldest->next;
    else if (handle->uc_map[map_id])
    {
       stb_unicode_atlas_slot_t* ptr = handle->uc_map[map_id];
-      while (ptr->next && ptr->next != &handle->atlas_slots[oldest])
+      while (ptr->next && ptr->next != oldest)
          ptr = ptr->next;
-      ptr->next = handle->atlas_slots[oldest].next;
+      ptr->next = oldest->next;
    }
 
-   return &handle->atlas_slots[oldest];
+   handle->atlas.generation++;
+
+   return oldest;
 }
 
 static const struct font_glyph *font_renderer_stb_unicode_get_glyph(
@@ -203,7 +273,13 @@ static bool font_renderer_stb_unicode_create_atlas(
    if (!self->atlas.buffer)
       return false;
 
-   slot = self->atlas_slots;
+   if (!(slot = (stb_unicode_atlas_slot_t*)
+            calloc(STB_UNICODE_ATLAS_SIZE, sizeof(*slot))))
+      return false;
+
+   self->atlas_pages[0] = slot;
+   self->num_pages      = 1;
+   self->free_slots     = STB_UNICODE_ATLAS_SIZE;
 
    for (y = 0; y < STB_UNICODE_ATLAS_ROWS; y++)
    {
@@ -23,6 +23,7 @@
 
 #include "font_driver.h"
 #include "video_thread_wrapper.h"
+#include "gfx_display.h"
 
 #include "../retroarch.h"
 #include "../verbosity.h"
@@ -1055,6 +1056,9 @@ void font_driver_render_msg(
 #else
       char *new_msg = (char*)msg;
 #endif
+      /* Text may be drawn immediately, so pending
+       * display quads have to go first */
+      gfx_display_batch_flush();
       font->renderer->render_msg(data,
             font->renderer_data, new_msg, params);
 #ifdef HAVE_LANGEXTRA
@@ -1076,7 +1080,10 @@ void font_driver_flush(unsigned width, unsigned height, void *font_data)
 {
    font_data_t *font = (font_data_t*)(font_data ? font_data : video_font_driver);
    if (font && font->renderer && font->renderer->flush)
+   {
+      gfx_display_batch_flush();
       font->renderer->flush(width, height, font->renderer_data);
+   }
 }
 
 int font_driver_get_message_width(void *font_data,
@@ -55,12 +55,22 @@ struct font_glyph
    int advance_y;
 };
 
+/* Largest height a growable atlas may reach */
+#define FONT_ATLAS_MAX_HEIGHT 2048
+
 struct font_atlas
 {
    uint8_t *buffer; /* Alpha channel. */
    unsigned width;
    unsigned height;
+   /* Incremented whenever a glyph is evicted to make room
+    * for another one, which moves it out of the atlas. */
+   unsigned generation;
    bool dirty;
+   /* Set by font drivers that handle 'height' growing after
+    * init. Renderers may then add rows of glyph slots instead
+    * of evicting glyphs that are still in use. */
+   bool growable;
 };
 
 struct font_params
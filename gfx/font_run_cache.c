@@ -0,0 +1,269 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2020 - The RetroArch team
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <encodings/utf.h>
+
+#include "font_run_cache.h"
+
+/* Enough for every label of a menu page plus its
+ * sublabels, widgets and the OSD */
+#define FONT_RUN_CACHE_SIZE    512
+#define FONT_RUN_CACHE_BUCKETS 1024
+
+typedef struct font_run_entry
+{
+   struct font_run_entry *next;     /* Next entry in the bucket */
+   struct font_run_entry *lru_prev; /* More recently used */
+   struct font_run_entry *lru_next; /* Less recently used */
+   const char *msg;
+   font_run_t run;
+   uint32_t hash;
+   unsigned msg_len;
+} font_run_entry_t;
+
+struct font_run_cache
+{
+   const font_renderer_driver_t *font_driver;
+   void *font_data;
+   struct font_atlas *atlas;
+   font_run_entry_t *buckets[FONT_RUN_CACHE_BUCKETS];
+   font_run_entry_t *lru_head;
+   font_run_entry_t *lru_tail;
+   /* Run whose own glyphs got evicted while it was laid out.
+    * It is handed out once and never cached. */
+   font_run_entry_t *transient;
+   unsigned size;
+   unsigned generation;
+};
+
+static uint32_t font_run_cache_hash(const char *msg, unsigned msg_len)
+{
+   /* djb2 */
+   uint32_t hash         = 5381;
+   const uint8_t *s      = (const uint8_t*)msg;
+   const uint8_t *s_end  = s + msg_len;
+
+   while (s < s_end)
+      hash = ((hash << 5) + hash) + *s++;
+
+   return hash;
+}
+
+static void font_run_cache_unlink(font_run_cache_t *cache,
+      font_run_entry_t *entry)
+{
+   if (entry->lru_prev)
+      entry->lru_prev->lru_next = entry->lru_next;
+   else
+      cache->lru_head           = entry->lru_next;
+
+   if (entry->lru_next)
+      entry->lru_next->lru_prev = entry->lru_prev;
+   else
+      cache->lru_tail           = entry->lru_prev;
+}
+
+static void font_run_cache_push_front(font_run_cache_t *cache,
+      font_run_entry_t *entry)
+{
+   entry->lru_prev    = NULL;
+   entry->lru_next    = cache->lru_head;
+
+   if (cache->lru_head)
+      cache->lru_head->lru_prev = entry;
+   else
+      cache->lru_tail           = entry;
+
+   cache->lru_head    = entry;
+}
+
+static void font_run_cache_remove(font_run_cache_t *cache,
+      font_run_entry_t *entry)
+{
+   font_run_entry_t **link = &cache->buckets[
+      entry->hash & (FONT_RUN_CACHE_BUCKETS - 1)];
+
+   while (*link != entry)
+      link = &(*link)->next;
+   *link = entry->next;
+
+   font_run_cache_unlink(cache, entry);
+   cache->size--;
+   free(entry);
+}
+
+static void font_run_cache_clear(font_run_cache_t *cache)
+{
+   font_run_entry_t *entry = cache->lru_head;
+
+   while (entry)
+   {
+      font_run_entry_t *next = entry->lru_next;
+      free(entry);
+      entry                  = next;
+   }
+
+   memset(cache->buckets, 0, sizeof(cache->buckets));
+   cache->lru_head = NULL;
+   cache->lru_tail = NULL;
+   cache->size     = 0;
+}
+
+/* Glyphs may have moved in the atlas since the runs were laid out */
+static void font_run_cache_validate(font_run_cache_t *cache)
+{
+   if (cache->atlas && cache->atlas->generation != cache->generation)
+   {
+      font_run_cache_clear(cache);
+      cache->generation = cache->atlas->generation;
+   }
+}
+
+static font_run_entry_t *font_run_cache_layout(font_run_cache_t *cache,
+      const char *msg, unsigned msg_len)
+{
+   font_run_glyph_t *glyphs = NULL;
+   const char *msg_end      = msg + msg_len;
+   unsigned count           = 0;
+   int pen_x                = 0;
+   int pen_y                = 0;
+   /* Every code point takes at least one byte, so msg_len
+    * bounds the number of glyphs */
+   font_run_entry_t *entry  = (font_run_entry_t*)malloc(sizeof(*entry)
+         + msg_len * sizeof(*glyphs) + msg_len);
+
+   if (!entry)
+      return NULL;
+
+   glyphs     = (font_run_glyph_t*)(entry + 1);
+   entry->msg = (const char*)(glyphs + msg_len);
+   memcpy((char*)entry->msg, msg, msg_len);
+
+   while (msg < msg_end)
+   {
+      unsigned code                  = utf8_walk(&msg);
+      const struct font_glyph *glyph = cache->font_driver->get_glyph(
+            cache->font_data, code);
+
+      if (!glyph) /* Do something smarter here ... */
+         glyph = cache->font_driver->get_glyph(cache->font_data, '?');
+      if (!glyph)
+         continue;
+
+      glyphs[count].glyph = *glyph;
+      glyphs[count].pen_x = pen_x;
+      glyphs[count].pen_y = pen_y;
+      count++;
+
+      pen_x += glyph->advance_x;
+      pen_y += glyph->advance_y;
+   }
+
+   entry->run.glyphs    = glyphs;
+   entry->run.count     = count;
+   entry->run.advance_x = pen_x;
+   entry->run.advance_y = pen_y;
+   entry->msg_len       = msg_len;
+
+   return entry;
+}
+
+font_run_cache_t *font_run_cache_new(
+      const font_renderer_driver_t *font_driver, void *font_data)
+{
+   font_run_cache_t *cache = NULL;
+
+   if (!font_driver || !font_driver->get_glyph || !font_data)
+      return NULL;
+
+   if (!(cache = (font_run_cache_t*)calloc(1, sizeof(*cache))))
+      return NULL;
+
+   cache->font_driver = font_driver;
+   cache->font_data   = font_data;
+   if (font_driver->get_atlas)
+      cache->atlas    = font_driver->get_atlas(font_data);
+   if (cache->atlas)
+      cache->generation = cache->atlas->generation;
+
+   return cache;
+}
+
+void font_run_cache_free(font_run_cache_t *cache)
+{
+   if (!cache)
+      return;
+
+   font_run_cache_clear(cache);
+   free(cache->transient);
+   free(cache);
+}
+
+const font_run_t *font_run_cache_get(font_run_cache_t *cache,
+      const char *msg, unsigned msg_len)
+{
+   font_run_entry_t *entry = NULL;
+   uint32_t hash           = font_run_cache_hash(msg, msg_len);
+
+   if (cache->transient)
+   {
+      free(cache->transient);
+      cache->transient = NULL;
+   }
+
+   font_run_cache_validate(cache);
+
+   for (entry = cache->buckets[hash & (FONT_RUN_CACHE_BUCKETS - 1)];
+         entry; entry = entry->next)
+   {
+      if (     entry->hash    == hash
+            && entry->msg_len == msg_len
+            && !memcmp(entry->msg, msg, msg_len))
+      {
+         if (cache->lru_head != entry)
+         {
+            font_run_cache_unlink(cache, entry);
+            font_run_cache_push_front(cache, entry);
+         }
+         return &entry->run;
+      }
+   }
+
+   if (!(entry = font_run_cache_layout(cache, msg, msg_len)))
+      return NULL;
+
+   /* Laying out the run may have evicted glyphs of other runs,
+    * or even of this one */
+   if (cache->atlas && cache->atlas->generation != cache->generation)
+   {
+      font_run_cache_validate(cache);
+      cache->transient = entry;
+      return &entry->run;
+   }
+
+   if (cache->size >= FONT_RUN_CACHE_SIZE)
+      font_run_cache_remove(cache, cache->lru_tail);
+
+   entry->hash         = hash;
+   entry->next         = cache->buckets[hash & (FONT_RUN_CACHE_BUCKETS - 1)];
+   cache->buckets[hash & (FONT_RUN_CACHE_BUCKETS - 1)] = entry;
+   font_run_cache_push_front(cache, entry);
+   cache->size++;
+
+   return &entry->run;
+}
@@ -0,0 +1,75 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2020 - The RetroArch team
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __FONT_RUN_CACHE_H
+#define __FONT_RUN_CACHE_H
+
+#include <boolean.h>
+#include <retro_common_api.h>
+
+#include "font_driver.h"
+
+RETRO_BEGIN_DECLS
+
+/* Caches the glyph layout of strings drawn with one font, so
+ * raster font drivers do not have to decode UTF-8 and look up
+ * every glyph again each frame. Runs are evicted least recently
+ * used first, and all of them are dropped when the font renderer
+ * evicts a glyph from its atlas. */
+
+typedef struct font_run_glyph
+{
+   /* Copy of the glyph, taken when the run was laid out */
+   struct font_glyph glyph;
+   /* Sum of the advances of all preceding glyphs */
+   int pen_x;
+   int pen_y;
+} font_run_glyph_t;
+
+typedef struct font_run
+{
+   const font_run_glyph_t *glyphs;
+   unsigned count;
+   /* Sum of the advances of all glyphs */
+   int advance_x;
+   int advance_y;
+} font_run_t;
+
+typedef struct font_run_cache font_run_cache_t;
+
+font_run_cache_t *font_run_cache_new(
+      const font_renderer_driver_t *font_driver, void *font_data);
+
+void font_run_cache_free(font_run_cache_t *cache);
+
+/**
+ * font_run_cache_get:
+ * @cache              : run cache of the font
+ * @msg                : UTF-8 string, need not be terminated
+ * @msg_len            : length of @msg in bytes
+ *
+ * Looks up the run for @msg, laying it out first if it is not
+ * cached. Glyphs missing from the font are replaced by '?' and
+ * dropped if that is missing too.
+ *
+ * Returns: the run, valid until the next call, or NULL if memory
+ * ran out.
+ **/
+const font_run_t *font_run_cache_get(font_run_cache_t *cache,
+      const char *msg, unsigned msg_len);
+
+RETRO_END_DECLS
+
+#endif
@@ -23,6 +23,11 @@
 
 #define PARTICLES_COUNT            100
 
+/* Quads held by the draw batch before it has to be flushed.
+ * Each quad is stored as two triangles (6 vertices) */
+#define GFX_DISPLAY_BATCH_QUADS    256
+#define GFX_DISPLAY_BATCH_VERTICES (GFX_DISPLAY_BATCH_QUADS * 6)
+
 /* Number of pixels corner-to-corner on a 1080p
  * display:
  * > sqrt((1920 * 1920) + (1080 * 1080))
@@ -48,6 +53,31 @@ static float osk_dark[16] =  {
  * needs to be refactored */
 uintptr_t gfx_display_white_texture;
 
+typedef struct gfx_display_batch
+{
+   /* Vertex arena, allocated once for the lifetime of the program */
+   float vertex[GFX_DISPLAY_BATCH_VERTICES * 2];
+   float tex_coord[GFX_DISPLAY_BATCH_VERTICES * 2];
+   float color[GFX_DISPLAY_BATCH_VERTICES * 4];
+   void *userdata;
+   uintptr_t texture;
+   unsigned video_width;
+   unsigned video_height;
+   unsigned width;
+   unsigned height;
+   unsigned quads;
+   /* Draw calls and primitives since the last
+    * gfx_display_get_draw_stats() */
+   unsigned draw_calls;
+   unsigned primitives;
+   /* Wrap the draw in blend_begin()/blend_end(),
+    * as gfx_display_draw_quad() does */
+   bool blend;
+   bool active;
+} gfx_display_batch_t;
+
+static gfx_display_batch_t gfx_display_batch_st;
+
 static void *gfx_display_null_get_default_mvp(void *data) { return NULL; }
 static void gfx_display_null_blend_begin(void *data) { }
 static void gfx_display_null_blend_end(void *data) { }
@@ -101,7 +131,8 @@ gfx_display_ctx_driver_t gfx_display_ctx_null = {
    "null",
    false,
    NULL,
-   NULL
+   NULL,
+   true
 };
 
 /* Menu display drivers */
@@ -625,11 +656,202 @@ void gfx_display_coords_array_reset(void)
    p_dispca->coords.vertices         = 0;
 }
 
+void gfx_display_batch_flush(void)
+{
+   gfx_display_ctx_draw_t draw;
+   struct video_coords coords;
+   gfx_display_batch_t      *batch   = &gfx_display_batch_st;
+   gfx_display_t            *p_disp  = disp_get_ptr();
+   gfx_display_ctx_driver_t *dispctx = p_disp->dispctx;
+
+   if (!batch->quads)
+      return;
+
+   if (dispctx && dispctx->draw)
+   {
+      coords.vertices      = batch->quads * 6;
+      coords.vertex        = batch->vertex;
+      coords.tex_coord     = batch->tex_coord;
+      coords.lut_tex_coord = batch->tex_coord;
+      coords.color         = batch->color;
+
+      draw.x               = 0;
+      draw.y               = 0;
+      draw.width           = batch->width;
+      draw.height          = batch->height;
+      draw.coords          = &coords;
+      draw.matrix_data     = NULL;
+      draw.texture         = batch->texture;
+      draw.prim_type       = GFX_DISPLAY_PRIM_TRIANGLES;
+      draw.pipeline_id     = 0;
+      draw.scale_factor    = 1.0f;
+      draw.rotation        = 0.0f;
+
+      if (batch->blend && dispctx->blend_begin)
+         dispctx->blend_begin(batch->userdata);
+
+      dispctx->draw(&draw, batch->userdata,
+            batch->video_width, batch->video_height);
+
+      if (batch->blend && dispctx->blend_end)
+         dispctx->blend_end(batch->userdata);
+
+      batch->draw_calls++;
+   }
+
+   batch->quads = 0;
+}
+
+/* Appends a quad to the batch. @vertex holds the four corners in
+ * triangle strip order (BL, BR, TL, TR), normalised to a
+ * (0, 0, width, height) viewport; @tex_coord and @color are per corner,
+ * in the same order. Returns false if batching is not possible, in
+ * which case the caller has to draw the quad itself. */
+static bool gfx_display_batch_push(
+      void *userdata,
+      unsigned video_width, unsigned video_height,
+      unsigned width, unsigned height,
+      uintptr_t texture, bool blend,
+      const float *vertex, const float *tex_coord,
+      const float *color)
+{
+   /* Strip order to triangle list order, keeping
+    * the winding of both strip triangles */
+   static const unsigned char strip_to_list[6] = { 0, 1, 2, 2, 1, 3 };
+   unsigned i;
+   float *dst_vertex, *dst_tex_coord, *dst_color;
+   gfx_display_batch_t *batch = &gfx_display_batch_st;
+
+   if (!batch->active || !width || !height)
+      return false;
+
+   if (     batch->quads
+         && (   batch->texture      != texture
+             || batch->blend        != blend
+             || batch->userdata     != userdata
+             || batch->width        != width
+             || batch->height       != height
+             || batch->video_width  != video_width
+             || batch->video_height != video_height
+             || batch->quads        == GFX_DISPLAY_BATCH_QUADS))
+      gfx_display_batch_flush();
+
+   if (!batch->quads)
+   {
+      batch->userdata     = userdata;
+      batch->texture      = texture;
+      batch->blend        = blend;
+      batch->width        = width;
+      batch->height       = height;
+      batch->video_width  = video_width;
+      batch->video_height = video_height;
+   }
+
+   dst_vertex    = batch->vertex    + batch->quads * 6 * 2;
+   dst_tex_coord = batch->tex_coord + batch->quads * 6 * 2;
+   dst_color     = batch->color     + batch->quads * 6 * 4;
+
+   for (i = 0; i < 6; i++)
+   {
+      unsigned j          = strip_to_list[i];
+      dst_vertex[0]       = vertex[j * 2 + 0];
+      dst_vertex[1]       = vertex[j * 2 + 1];
+      dst_tex_coord[0]    = tex_coord[j * 2 + 0];
+      dst_tex_coord[1]    = tex_coord[j * 2 + 1];
+      if (color)
+      {
+         dst_color[0]     = color[j * 4 + 0];
+         dst_color[1]     = color[j * 4 + 1];
+         dst_color[2]     = color[j * 4 + 2];
+         dst_color[3]     = color[j * 4 + 3];
+      }
+      else
+      {
+         dst_color[0]     = 1.0f;
+         dst_color[1]     = 1.0f;
+         dst_color[2]     = 1.0f;
+         dst_color[3]     = 1.0f;
+      }
+      dst_vertex         += 2;
+      dst_tex_coord      += 2;
+      dst_color          += 4;
+   }
+
+   batch->quads++;
+   batch->primitives++;
+
+   return true;
+}
+
+/* Appends the default quad, scaled to the rectangle at
+ * (x, y, w, h) in bottom-up viewport pixels. */
+static bool gfx_display_batch_push_rect(
+      gfx_display_ctx_driver_t *dispctx,
+      void *userdata,
+      unsigned video_width, unsigned video_height,
+      unsigned width, unsigned height,
+      uintptr_t texture, bool blend,
+      float x, float y, float w, float h,
+      const float *color)
+{
+   unsigned i;
+   float vertex[8];
+   const float *default_vertex = NULL;
+
+   if (!gfx_display_batch_st.active)
+      return false;
+
+   /* Nothing would be drawn, see gfx_display_draw() */
+   if (w <= 0 || h <= 0)
+      return true;
+
+   default_vertex = dispctx->get_default_vertices();
+
+   for (i = 0; i < 4; i++)
+   {
+      vertex[i * 2 + 0] = (x + default_vertex[i * 2 + 0] * w) / width;
+      vertex[i * 2 + 1] = (y + default_vertex[i * 2 + 1] * h) / height;
+   }
+
+   return gfx_display_batch_push(userdata,
+         video_width, video_height, width, height,
+         texture, blend, vertex, dispctx->get_default_tex_coords(),
+         color);
+}
+
+void gfx_display_batch_begin(void)
+{
+   gfx_display_t            *p_disp  = disp_get_ptr();
+   gfx_display_ctx_driver_t *dispctx = p_disp->dispctx;
+   gfx_display_batch_t      *batch   = &gfx_display_batch_st;
+
+   gfx_display_batch_flush();
+   batch->active = dispctx && dispctx->batch_quads;
+}
+
+void gfx_display_batch_end(void)
+{
+   gfx_display_batch_flush();
+   gfx_display_batch_st.active = false;
+}
+
+void gfx_display_get_draw_stats(unsigned *draw_calls,
+      unsigned *primitives)
+{
+   gfx_display_batch_t *batch = &gfx_display_batch_st;
+
+   *draw_calls        = batch->draw_calls;
+   *primitives        = batch->primitives;
+   batch->draw_calls  = 0;
+   batch->primitives  = 0;
+}
+
 /* Begin blending operation */
 void gfx_display_blend_begin(void *data)
 {
    gfx_display_t            *p_disp  = disp_get_ptr();
    gfx_display_ctx_driver_t *dispctx = p_disp->dispctx;
+   gfx_display_batch_flush();
    if (dispctx && dispctx->blend_begin)
       dispctx->blend_begin(data);
 }
@@ -639,6 +861,7 @@ void gfx_display_blend_end(void *data)
 {
    gfx_display_t            *p_disp  = disp_get_ptr();
    gfx_display_ctx_driver_t *dispctx = p_disp->dispctx;
+   gfx_display_batch_flush();
    if (dispctx && dispctx->blend_end)
       dispctx->blend_end(data);
 }
@@ -651,6 +874,7 @@ void gfx_display_scissor_begin(void *userdata,
 {
    gfx_display_t            *p_disp  = disp_get_ptr();
    gfx_display_ctx_driver_t *dispctx = p_disp->dispctx;
+   gfx_display_batch_flush();
    if (dispctx && dispctx->scissor_begin)
    {
       if (y < 0)
@@ -699,6 +923,7 @@ void gfx_display_scissor_end(
 {
    gfx_display_t            *p_disp  = disp_get_ptr();
    gfx_display_ctx_driver_t *dispctx = p_disp->dispctx;
+   gfx_display_batch_flush();
    if (dispctx && dispctx->scissor_end)
       dispctx->scissor_end(userdata,
             video_width, video_height);
@@ -734,6 +959,7 @@ bool gfx_display_restore_clear_color(void)
    gfx_display_ctx_driver_t *dispctx = p_disp->dispctx;
    if (!dispctx || !dispctx->restore_clear_color)
       return false;
+   gfx_display_batch_flush();
    dispctx->restore_clear_color();
    return true;
 }
@@ -743,6 +969,7 @@ void gfx_display_clear_color(gfx_display_ctx_clearcolor_t *color, void *data)
 {
    gfx_display_t            *p_disp  = disp_get_ptr();
    gfx_display_ctx_driver_t *dispctx = p_disp->dispctx;
+   gfx_display_batch_flush();
    if (dispctx && dispctx->clear_color)
       dispctx->clear_color(color, data);
 }
@@ -761,7 +988,10 @@ void gfx_display_draw(gfx_display_ctx_draw_t *draw,
       return;
    if (draw->width <= 0)
       return;
+   gfx_display_batch_flush();
    dispctx->draw(draw, data, video_width, video_height);
+   gfx_display_batch_st.draw_calls++;
+   gfx_display_batch_st.primitives++;
 }
 
 void gfx_display_draw_blend(
@@ -782,6 +1012,8 @@ void gfx_display_draw_blend(
    gfx_display_blend_begin(data);
    dispctx->draw(draw, data, video_width, video_height);
    gfx_display_blend_end(data);
+   gfx_display_batch_st.draw_calls++;
+   gfx_display_batch_st.primitives++;
 }
 
 void gfx_display_draw_pipeline(
@@ -793,8 +1025,13 @@ void gfx_display_draw_pipeline(
    gfx_display_t            *p_disp  = disp_get_ptr();
    gfx_display_ctx_driver_t *dispctx = p_disp->dispctx;
    if (dispctx && draw && dispctx->draw_pipeline)
+   {
+      gfx_display_batch_flush();
       dispctx->draw_pipeline(draw, userdata,
             video_width, video_height);
+      gfx_display_batch_st.draw_calls++;
+      gfx_display_batch_st.primitives++;
+   }
 }
 
 void gfx_display_draw_bg(gfx_display_ctx_draw_t *draw,
@@ -872,12 +1109,20 @@ void gfx_display_draw_quad(
    gfx_display_t            *p_disp  = disp_get_ptr();
    gfx_display_ctx_driver_t *dispctx = p_disp->dispctx;
 
+   if (gfx_display_batch_push_rect(dispctx, data,
+            video_width, video_height, width, height,
+            gfx_display_white_texture, true,
+            x, (int)height - y - (int)h, w, h, color))
+      return;
+
    coords.vertices      = 4;
    coords.vertex        = NULL;
    coords.tex_coord     = NULL;
    coords.lut_tex_coord = NULL;
    coords.color         = color;
 
+   gfx_display_batch_flush();
+
    if (dispctx && dispctx->blend_begin)
       dispctx->blend_begin(data);
 
@@ -926,12 +1171,21 @@ void gfx_display_draw_polygon(
    vertex[6]             = x4 / (float)width;
    vertex[7]             = y4 / (float)height;
 
+   if (     gfx_display_batch_st.active
+         && gfx_display_batch_push(userdata,
+            video_width, video_height, width, height,
+            gfx_display_white_texture, true, vertex,
+            dispctx->get_default_tex_coords(), color))
+      return;
+
    coords.vertices      = 4;
    coords.vertex        = &vertex[0];
    coords.tex_coord     = NULL;
    coords.lut_tex_coord = NULL;
    coords.color         = color;
 
+   gfx_display_batch_flush();
+
    if (dispctx && dispctx->blend_begin)
       dispctx->blend_begin(userdata);
 
@@ -966,6 +1220,13 @@ void gfx_display_draw_texture(
    gfx_display_ctx_rotate_draw_t rotate_draw;
    struct video_coords coords;
    math_matrix_4x4 mymat;
+   gfx_display_t            *p_disp  = disp_get_ptr();
+
+   /* Unrotated and unscaled, so the default MVP applies */
+   if (gfx_display_batch_push_rect(p_disp->dispctx, userdata,
+            video_width, video_height, width, height,
+            texture, false, x, (int)height - y, w, h, color))
+      return;
 
    rotate_draw.matrix       = &mymat;
    rotate_draw.rotation     = 0.0;
@@ -994,6 +1255,24 @@ void gfx_display_draw_texture(
          video_width, video_height);
 }
 
+/* Draws a quad that is positioned by its vertices over the whole
+ * viewport with the default MVP, batching it if possible */
+static void gfx_display_draw_section(
+      gfx_display_ctx_draw_t *draw,
+      void *userdata,
+      unsigned video_width,
+      unsigned video_height)
+{
+   if (     gfx_display_batch_st.active
+         && gfx_display_batch_push(userdata,
+            video_width, video_height, draw->width, draw->height,
+            draw->texture, false, draw->coords->vertex,
+            draw->coords->tex_coord, draw->coords->color))
+      return;
+
+   gfx_display_draw(draw, userdata, video_width, video_height);
+}
+
 /* Draw the texture split into 9 sections, without scaling the corners.
  * The middle sections will only scale in the X axis, and the side
  * sections will only scale in the Y axis. */
@@ -1148,7 +1427,7 @@ void gfx_display_draw_texture_slice(
    tex_coord[6] = T_TR[0];
    tex_coord[7] = T_TR[1];
 
-   gfx_display_draw(&draw, userdata,
+   gfx_display_draw_section(&draw, userdata,
          video_width, video_height);
 
    /* top-middle section */
@@ -1170,7 +1449,7 @@ void gfx_display_draw_texture_slice(
    tex_coord[6] = T_TR[0] + tex_mid_width;
    tex_coord[7] = T_TR[1];
 
-   gfx_display_draw(&draw, userdata,
+   gfx_display_draw_section(&draw, userdata,
          video_width, video_height);
 
    /* top-right corner */
@@ -1192,7 +1471,7 @@ void gfx_display_draw_texture_slice(
    tex_coord[6] = T_TR[0] + tex_mid_width + tex_woff;
    tex_coord[7] = T_TR[1];
 
-   gfx_display_draw(&draw, userdata,
+   gfx_display_draw_section(&draw, userdata,
          video_width, video_height);
 
    /* middle-left section */
@@ -1214,7 +1493,7 @@ void gfx_display_draw_texture_slice(
    tex_coord[6] = T_TR[0];
    tex_coord[7] = T_TR[1] + tex_hoff;
 
-   gfx_display_draw(&draw, userdata,
+   gfx_display_draw_section(&draw, userdata,
          video_width, video_height);
 
    /* center section */
@@ -1236,7 +1515,7 @@ void gfx_display_draw_texture_slice(
    tex_coord[6] = T_TR[0] + tex_mid_width;
    tex_coord[7] = T_TR[1] + tex_hoff;
 
-   gfx_display_draw(&draw, userdata,
+   gfx_display_draw_section(&draw, userdata,
          video_width, video_height);
 
    /* middle-right section */
@@ -1258,7 +1537,7 @@ void gfx_display_draw_texture_slice(
    tex_coord[6] = T_TR[0] + tex_woff + tex_mid_width;
    tex_coord[7] = T_TR[1] + tex_hoff;
 
-   gfx_display_draw(&draw, userdata,
+   gfx_display_draw_section(&draw, userdata,
          video_width, video_height);
 
    /* bottom-left corner */
@@ -1280,7 +1559,7 @@ void gfx_display_draw_texture_slice(
    tex_coord[6] = T_TR[0];
    tex_coord[7] = T_TR[1] + tex_hoff + tex_mid_height;
 
-   gfx_display_draw(&draw, userdata,
+   gfx_display_draw_section(&draw, userdata,
          video_width, video_height);
 
    /* bottom-middle section */
@@ -1302,7 +1581,7 @@ void gfx_display_draw_texture_slice(
    tex_coord[6] = T_TR[0] + tex_mid_width;
    tex_coord[7] = T_TR[1] + tex_hoff + tex_mid_height;
 
-   gfx_display_draw(&draw, userdata,
+   gfx_display_draw_section(&draw, userdata,
          video_width, video_height);
 
    /* bottom-right corner */
@@ -1324,7 +1603,7 @@ void gfx_display_draw_texture_slice(
    tex_coord[6] = T_TR[0] + tex_woff + tex_mid_width;
    tex_coord[7] = T_TR[1] + tex_hoff + tex_mid_height;
 
-   gfx_display_draw(&draw, userdata,
+   gfx_display_draw_section(&draw, userdata,
          video_width, video_height);
 }
 
@@ -1384,6 +1663,8 @@ void gfx_display_draw_cursor(
    coords.lut_tex_coord = NULL;
    coords.color         = (const float*)color;
 
+   gfx_display_batch_flush();
+
    if (dispctx && dispctx->blend_begin)
       dispctx->blend_begin(userdata);
 
@@ -143,6 +143,10 @@ typedef struct gfx_display_ctx_driver
          int x, int y, unsigned width, unsigned height);
    void (*scissor_end)(void *data, unsigned video_width,
          unsigned video_height);
+   /* Set when draw() accepts GFX_DISPLAY_PRIM_TRIANGLES lists of any
+    * length, positioned over a (0, 0, width, height) viewport with the
+    * default MVP. Consecutive quads are then merged into one draw. */
+   bool batch_quads;
 } gfx_display_ctx_driver_t;
 
 struct gfx_display_ctx_draw
@@ -225,6 +229,22 @@ void gfx_display_free(void);
 
 void gfx_display_init(void);
 
+/* Draw batching: between gfx_display_batch_begin() and
+ * gfx_display_batch_end(), quads and textures drawn with the same
+ * texture and blend state are accumulated and submitted as a single
+ * draw. The batch is flushed whenever anything else touches the
+ * display driver, so draw order is always preserved. */
+void gfx_display_batch_begin(void);
+
+void gfx_display_batch_end(void);
+
+void gfx_display_batch_flush(void);
+
+/* Returns the number of draw calls sent to the display driver and the
+ * number of primitives they were built from since the last call. */
+void gfx_display_get_draw_stats(unsigned *draw_calls,
+      unsigned *primitives);
+
 void gfx_display_blend_begin(void *data);
 
 void gfx_display_blend_end(void *data);
@@ -23,6 +23,7 @@
 #include <features/features_cpu.h>
 #include <string/stdstring.h>
 #include <retro_miscellaneous.h>
+#include <rthreads/work_pool.h>
 
 #ifdef HAVE_CONFIG_H
 #include "../config.h"
@@ -60,48 +61,20 @@ struct rarch_softfilter
    unsigned threads;
 
 #ifdef HAVE_THREADS
-   struct filter_thread_data *thread_data;
+   work_pool_t *pool;
 #endif
 };
 
-#ifdef HAVE_THREADS
-#include <rthreads/rthreads.h>
+/* Filters are asked for this many work packets per thread, so that
+ * threads which finish their rows early can steal from the others. */
+#define SOFTFILTER_PACKETS_PER_THREAD 4
 
-struct filter_thread_data
-{
-   sthread_t *thread;
-   const struct softfilter_work_packet *packet;
-   scond_t *cond;
-   slock_t *lock;
-   void *userdata;
-   bool die;
-   bool done;
-};
-
-static void filter_thread_loop(void *data)
+#ifdef HAVE_THREADS
+static void softfilter_work(void *data, unsigned index)
 {
-   struct filter_thread_data *thr = (struct filter_thread_data*)data;
-
-   for (;;)
-   {
-      bool die;
-      slock_lock(thr->lock);
-      while (thr->done && !thr->die)
-         scond_wait(thr->cond, thr->lock);
-      die = thr->die;
-      slock_unlock(thr->lock);
-
-      if (die)
-         break;
-
-      if (thr->packet && thr->packet->work)
-         thr->packet->work(thr->userdata, thr->packet->thread_data);
-
-      slock_lock(thr->lock);
-      thr->done = true;
-      scond_signal(thr->cond);
-      slock_unlock(thr->lock);
-   }
+   rarch_softfilter_t *filt = (rarch_softfilter_t*)data;
+   filt->packets[index].work(filt->impl_data,
+         filt->packets[index].thread_data);
 }
 #endif
 
@@ -207,29 +180,34 @@ static bool create_softfilter_graph(rarch_softfilter_t *filt,
    filt->max_width = max_width;
    filt->max_height = max_height;
 
+   if (threads == RARCH_SOFTFILTER_THREADS_AUTO)
+      threads = cpu_features_get_core_amount();
+   if (!threads)
+      threads = 1;
+#ifndef HAVE_THREADS
+   threads = 1;
+#endif
+
    filt->impl_data = filt->impl->create(
          &softfilter_config, input_fmt, input_fmt, max_width, max_height,
-         threads != RARCH_SOFTFILTER_THREADS_AUTO ? threads :
-         cpu_features_get_core_amount(), cpu_features,
-         &userdata);
+         threads > 1 ? threads * SOFTFILTER_PACKETS_PER_THREAD : 1,
+         cpu_features, &userdata);
    if (!filt->impl_data)
    {
       RARCH_ERR("Failed to create softfilter state.\n");
       return false;
    }
 
-   threads = filt->impl->query_num_threads(filt->impl_data);
-   if (!threads)
+   /* Number of work packets the filter splits a frame into */
+   filt->threads = filt->impl->query_num_threads(filt->impl_data);
+   if (!filt->threads)
    {
       RARCH_ERR("Invalid number of threads.\n");
       return false;
    }
 
-   filt->threads = threads;
-   RARCH_LOG("Using %u threads for softfilter.\n", threads);
-
    filt->packets = (struct softfilter_work_packet*)
-      calloc(threads, sizeof(*filt->packets));
+      calloc(filt->threads, sizeof(*filt->packets));
    if (!filt->packets)
    {
       RARCH_ERR("Failed to allocate softfilter packets.\n");
@@ -239,29 +217,17 @@ static bool create_softfilter_graph(rarch_softfilter_t *filt,
 #ifdef HAVE_THREADS
    if (filt->threads > 1)
    {
-      filt->thread_data = (struct filter_thread_data*)
-         calloc(threads, sizeof(*filt->thread_data));
-      if (!filt->thread_data)
+      if (threads > filt->threads)
+         threads = filt->threads;
+      if (!(filt->pool = work_pool_new(threads - 1)))
          return false;
-
-      for (i = 0; i < threads; i++)
-      {
-         filt->thread_data[i].userdata = filt->impl_data;
-         filt->thread_data[i].done     = true;
-
-         filt->thread_data[i].lock     = slock_new();
-         if (!filt->thread_data[i].lock)
-            return false;
-         filt->thread_data[i].cond     = scond_new();
-         if (!filt->thread_data[i].cond)
-            return false;
-         filt->thread_data[i].thread   = sthread_create(
-               filter_thread_loop, &filt->thread_data[i]);
-         if (!filt->thread_data[i].thread)
-            return false;
-      }
+      threads = work_pool_num_threads(filt->pool);
    }
+   else
 #endif
+      threads = 1;
+
+   RARCH_LOG("Using %u threads for softfilter.\n", threads);
 
    return true;
 }
@@ -476,24 +442,7 @@ void rarch_softfilter_free(rarch_softfilter_t *filt)
 #endif
 
 #ifdef HAVE_THREADS
-   if (filt->threads > 1)
-   {
-      for (i = 0; i < filt->threads; i++)
-      {
-         if (!&filt->thread_data[i])
-            continue;
-         if (!filt->thread_data[i].thread)
-            continue;
-         slock_lock(filt->thread_data[i].lock);
-         filt->thread_data[i].die = true;
-         scond_signal(filt->thread_data[i].cond);
-         slock_unlock(filt->thread_data[i].lock);
-         sthread_join(filt->thread_data[i].thread);
-         slock_free(filt->thread_data[i].lock);
-         scond_free(filt->thread_data[i].cond);
-      }
-      free(filt->thread_data);
-   }
+   work_pool_free(filt->pool);
 #endif
 
    if (filt->conf)
@@ -539,32 +488,9 @@ void rarch_softfilter_process(rarch_softfilter_t *filt,
             output, output_stride, input, width, height, input_stride);
 
 #ifdef HAVE_THREADS
-   if (filt->threads > 1)
+   if (filt->pool)
    {
-      /* Fire off workers */
-      for (i = 0; i < filt->threads; i++)
-      {
-#if 0
-         RARCH_LOG("Firing off filter thread %u ...\n", i);
-#endif
-         filt->thread_data[i].packet = &filt->packets[i];
-         slock_lock(filt->thread_data[i].lock);
-         filt->thread_data[i].done = false;
-         scond_signal(filt->thread_data[i].cond);
-         slock_unlock(filt->thread_data[i].lock);
-      }
-
-      /* Wait for workers */
-      for (i = 0; i < filt->threads; i++)
-      {
-#if 0
-         RARCH_LOG("Waiting for filter thread %u ...\n", i);
-#endif
-         slock_lock(filt->thread_data[i].lock);
-         while (!filt->thread_data[i].done)
-            scond_wait(filt->thread_data[i].cond, filt->thread_data[i].lock);
-         slock_unlock(filt->thread_data[i].lock);
-      }
+      work_pool_run(filt->pool, softfilter_work, filt, filt->threads);
       return;
    }
 #endif
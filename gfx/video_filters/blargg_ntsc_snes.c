@@ -160,7 +160,7 @@ static void *blargg_ntsc_snes_generic_create(const struct softfilter_config *con
       return NULL;
    filt->workers = (struct softfilter_thread_data*)
       calloc(threads, sizeof(struct softfilter_thread_data));
-   filt->threads = 1;
+   filt->threads = threads;
    filt->in_fmt  = in_fmt;
    if (!filt->workers)
    {
@@ -200,14 +200,15 @@ static void blargg_ntsc_snes_render_rgb565(void *data, int width, int height,
       uint16_t *input, int pitch, uint16_t *output, int outpitch)
 {
    struct filter_data *filt = (struct filter_data*)data;
+   /* The burst phase advances by one every row,
+    * so pick it up where the previous band left off. */
+   int burst = (filt->burst + first) % snes_ntsc_burst_count;
    if(width <= 256 || !hires_blit)
-      retroarch_snes_ntsc_blit(filt->ntsc, input, pitch, filt->burst,
+      retroarch_snes_ntsc_blit(filt->ntsc, input, pitch, burst,
             width, height, output, outpitch * 2, first, last);
    else
-      retroarch_snes_ntsc_blit_hires(filt->ntsc, input, pitch, filt->burst,
+      retroarch_snes_ntsc_blit_hires(filt->ntsc, input, pitch, burst,
             width, height, output, outpitch * 2, first, last);
-
-   filt->burst ^= filt->burst_toggle;
 }
 
 static void blargg_ntsc_snes_rgb565(void *data, unsigned width, unsigned height,
@@ -244,6 +245,10 @@ static void blargg_ntsc_snes_generic_packets(void *data,
 {
    struct filter_data *filt = (struct filter_data*)data;
    unsigned i;
+
+   /* Once per frame, the bands may run in any order */
+   filt->burst ^= filt->burst_toggle;
+
    for (i = 0; i < filt->threads; i++)
    {
       struct softfilter_thread_data *thr =
@@ -46,8 +46,88 @@ struct filter_data
    unsigned threads;
    struct softfilter_thread_data *workers;
    unsigned in_fmt;
+   int use_simd;
 };
 
+/* Fills in output columns for input columns [1, end), eight at a
+ * time, and returns the first column left over. Same result as the
+ * inner loop of epx_generic_rgb565(), which handles the remainder. */
+#if defined(__SSE2__)
+#define EPX_SSE2
+#include <emmintrin.h>
+
+#define EPX_SSE2_SELECT(mask, a, b) \
+   _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b))
+
+static unsigned epx_simd_rgb565(const uint16_t *up, const uint16_t *src,
+      const uint16_t *down, uint16_t *out0, uint16_t *out1, unsigned end)
+{
+   unsigned x;
+   const __m128i ones = _mm_set1_epi32(-1);
+
+   for (x = 1; x + 8 <= end; x += 8)
+   {
+      __m128i D    = _mm_loadu_si128((const __m128i*)(up   + x));
+      __m128i A    = _mm_loadu_si128((const __m128i*)(src  + x - 1));
+      __m128i X    = _mm_loadu_si128((const __m128i*)(src  + x));
+      __m128i C    = _mm_loadu_si128((const __m128i*)(src  + x + 1));
+      __m128i B    = _mm_loadu_si128((const __m128i*)(down + x));
+      __m128i edge = _mm_andnot_si128(_mm_or_si128(
+               _mm_cmpeq_epi16(A, C), _mm_cmpeq_epi16(B, D)), ones);
+      __m128i p0   = EPX_SSE2_SELECT(
+            _mm_and_si128(edge, _mm_cmpeq_epi16(D, A)), D, X);
+      __m128i p1   = EPX_SSE2_SELECT(
+            _mm_and_si128(edge, _mm_cmpeq_epi16(C, D)), C, X);
+      __m128i p2   = EPX_SSE2_SELECT(
+            _mm_and_si128(edge, _mm_cmpeq_epi16(A, B)), A, X);
+      __m128i p3   = EPX_SSE2_SELECT(
+            _mm_and_si128(edge, _mm_cmpeq_epi16(B, C)), B, X);
+
+      _mm_storeu_si128((__m128i*)(out0 + (x << 1)),     _mm_unpacklo_epi16(p0, p1));
+      _mm_storeu_si128((__m128i*)(out0 + (x << 1) + 8), _mm_unpackhi_epi16(p0, p1));
+      _mm_storeu_si128((__m128i*)(out1 + (x << 1)),     _mm_unpacklo_epi16(p2, p3));
+      _mm_storeu_si128((__m128i*)(out1 + (x << 1) + 8), _mm_unpackhi_epi16(p2, p3));
+   }
+
+   return x;
+}
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define EPX_NEON
+#include <arm_neon.h>
+
+static unsigned epx_simd_rgb565(const uint16_t *up, const uint16_t *src,
+      const uint16_t *down, uint16_t *out0, uint16_t *out1, unsigned end)
+{
+   unsigned x;
+
+   for (x = 1; x + 8 <= end; x += 8)
+   {
+      uint16x8x2_t o0, o1;
+      uint16x8_t D    = vld1q_u16(up   + x);
+      uint16x8_t A    = vld1q_u16(src  + x - 1);
+      uint16x8_t X    = vld1q_u16(src  + x);
+      uint16x8_t C    = vld1q_u16(src  + x + 1);
+      uint16x8_t B    = vld1q_u16(down + x);
+      uint16x8_t edge = vmvnq_u16(vorrq_u16(
+               vceqq_u16(A, C), vceqq_u16(B, D)));
+
+      o0.val[0] = vbslq_u16(vandq_u16(edge, vceqq_u16(D, A)), D, X);
+      o0.val[1] = vbslq_u16(vandq_u16(edge, vceqq_u16(C, D)), C, X);
+      o1.val[0] = vbslq_u16(vandq_u16(edge, vceqq_u16(A, B)), A, X);
+      o1.val[1] = vbslq_u16(vandq_u16(edge, vceqq_u16(B, C)), B, X);
+
+      vst2q_u16(out0 + (x << 1), o0);
+      vst2q_u16(out1 + (x << 1), o1);
+   }
+
+   return x;
+}
+#endif
+
+#if defined(EPX_SSE2) || defined(EPX_NEON)
+#define EPX_SIMD
+#endif
+
 static unsigned epx_generic_input_fmts(void)
 {
    return SOFTFILTER_FMT_RGB565;
@@ -75,6 +155,11 @@ static void *epx_generic_create(const struct softfilter_config *config,
    (void)userdata;
    if (!filt)
       return NULL;
+#if defined(EPX_SSE2)
+   filt->use_simd = (simd & SOFTFILTER_SIMD_SSE2) ? 1 : 0;
+#elif defined(EPX_NEON)
+   filt->use_simd = (simd & SOFTFILTER_SIMD_NEON) ? 1 : 0;
+#endif
    filt->workers = (struct softfilter_thread_data*)
       calloc(threads, sizeof(struct softfilter_thread_data));
    filt->threads = 1;
@@ -107,7 +192,7 @@ static void epx_generic_destroy(void *data)
 }
 
 static void epx_generic_rgb565 (unsigned width, unsigned height,
-      int first, int lsat, uint16_t *src,
+      int first, int lsat, int use_simd, uint16_t *src,
       unsigned src_stride, uint16_t *dst, unsigned dst_stride)
 {
    uint16_t colorX, colorA, colorB, colorC, colorD;
@@ -146,7 +231,28 @@ static void epx_generic_rgb565 (unsigned width, unsigned height,
       dP1++;
       dP2++;
 
-      for (w = width - 2; w; w--)
+      w = width - 2;
+
+#ifdef EPX_SIMD
+      if (use_simd)
+      {
+         unsigned x = epx_simd_rgb565(src - src_stride, src,
+               src + src_stride, dst, dst + dst_stride, width - 1);
+         unsigned n = x - 1;
+
+         /* Pick up the scalar loop at column x */
+         colorX = src[x - 1];
+         colorC = src[x];
+         sP     = src + x;
+         lP    += n;
+         uP    += n;
+         dP1   += n;
+         dP2   += n;
+         w     -= n;
+      }
+#endif
+
+      for (; w; w--)
       {
          colorA = colorX;
          colorX = colorC;
@@ -198,6 +304,7 @@ static void epx_generic_rgb565 (unsigned width, unsigned height,
 
 static void epx_work_cb_rgb565(void *data, void *thread_data)
 {
+   struct filter_data *filt = (struct filter_data*)data;
    struct softfilter_thread_data *thr =
       (struct softfilter_thread_data*)thread_data;
    uint16_t *input = (uint16_t*)thr->in_data;
@@ -206,7 +313,7 @@ static void epx_work_cb_rgb565(void *data, void *thread_data)
    unsigned height = thr->height;
 
    epx_generic_rgb565(width, height,
-         thr->first, thr->last, input,
+         thr->first, thr->last, filt->use_simd, input,
          (unsigned)(thr->in_pitch / SOFTFILTER_BPP_RGB565),
          output,
          (unsigned)(thr->out_pitch / SOFTFILTER_BPP_RGB565));
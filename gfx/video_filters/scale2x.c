@@ -45,6 +45,7 @@ struct filter_data
    unsigned threads;
    struct softfilter_thread_data *workers;
    unsigned in_fmt;
+   int use_simd;
 };
 
 #define SCALE2X_GENERIC(typename_t, width, height, first, last, src, src_stride, dst, dst_stride, out0, out1) \
@@ -108,6 +109,172 @@ static void scale2x_generic_xrgb8888(unsigned width, unsigned height,
          src, src_stride, dst, dst_stride, out0, out1);
 }
 
+/* The SIMD paths produce the same output as SCALE2X_GENERIC,
+ * for the columns which have both neighbours in the row. */
+#if defined(__SSE2__)
+#define SCALE2X_SSE2
+#include <emmintrin.h>
+
+#define SCALE2X_SSE2_SELECT(mask, a, b) \
+   _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b))
+
+#define SCALE2X_SSE2_BLOCK(cmpeq, unpacklo, unpackhi, step) \
+   for (; x + step <= end; x += step) \
+   { \
+      __m128i A    = _mm_loadu_si128((const __m128i*)(up   + x)); \
+      __m128i B    = _mm_loadu_si128((const __m128i*)(src  + x - 1)); \
+      __m128i C    = _mm_loadu_si128((const __m128i*)(src  + x)); \
+      __m128i D    = _mm_loadu_si128((const __m128i*)(src  + x + 1)); \
+      __m128i E    = _mm_loadu_si128((const __m128i*)(down + x)); \
+      __m128i edge = _mm_andnot_si128( \
+            _mm_or_si128(cmpeq(A, E), cmpeq(B, D)), \
+            _mm_set1_epi32(-1)); \
+      __m128i e0   = SCALE2X_SSE2_SELECT( \
+            _mm_and_si128(edge, cmpeq(A, B)), A, C); \
+      __m128i e1   = SCALE2X_SSE2_SELECT( \
+            _mm_and_si128(edge, cmpeq(A, D)), A, C); \
+      __m128i e2   = SCALE2X_SSE2_SELECT( \
+            _mm_and_si128(edge, cmpeq(E, B)), E, C); \
+      __m128i e3   = SCALE2X_SSE2_SELECT( \
+            _mm_and_si128(edge, cmpeq(E, D)), E, C); \
+      _mm_storeu_si128((__m128i*)(out0 + (x << 1)),        unpacklo(e0, e1)); \
+      _mm_storeu_si128((__m128i*)(out0 + (x << 1) + step), unpackhi(e0, e1)); \
+      _mm_storeu_si128((__m128i*)(out1 + (x << 1)),        unpacklo(e2, e3)); \
+      _mm_storeu_si128((__m128i*)(out1 + (x << 1) + step), unpackhi(e2, e3)); \
+   }
+
+static unsigned scale2x_simd_rgb565(const uint16_t *up,
+      const uint16_t *src, const uint16_t *down,
+      uint16_t *out0, uint16_t *out1, unsigned x, unsigned end)
+{
+   SCALE2X_SSE2_BLOCK(_mm_cmpeq_epi16,
+         _mm_unpacklo_epi16, _mm_unpackhi_epi16, 8);
+   return x;
+}
+
+static unsigned scale2x_simd_xrgb8888(const uint32_t *up,
+      const uint32_t *src, const uint32_t *down,
+      uint32_t *out0, uint32_t *out1, unsigned x, unsigned end)
+{
+   SCALE2X_SSE2_BLOCK(_mm_cmpeq_epi32,
+         _mm_unpacklo_epi32, _mm_unpackhi_epi32, 4);
+   return x;
+}
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define SCALE2X_NEON
+#include <arm_neon.h>
+
+#define SCALE2X_NEON_BLOCK(type, vtype, x2type, sfx, step) \
+   for (; x + step <= end; x += step) \
+   { \
+      x2type o0, o1; \
+      vtype A    = vld1q_##sfx((const type*)(up   + x)); \
+      vtype B    = vld1q_##sfx((const type*)(src  + x - 1)); \
+      vtype C    = vld1q_##sfx((const type*)(src  + x)); \
+      vtype D    = vld1q_##sfx((const type*)(src  + x + 1)); \
+      vtype E    = vld1q_##sfx((const type*)(down + x)); \
+      vtype edge = vmvnq_##sfx(vorrq_##sfx( \
+               vceqq_##sfx(A, E), vceqq_##sfx(B, D))); \
+      o0.val[0]  = vbslq_##sfx(vandq_##sfx(edge, vceqq_##sfx(A, B)), A, C); \
+      o0.val[1]  = vbslq_##sfx(vandq_##sfx(edge, vceqq_##sfx(A, D)), A, C); \
+      o1.val[0]  = vbslq_##sfx(vandq_##sfx(edge, vceqq_##sfx(E, B)), E, C); \
+      o1.val[1]  = vbslq_##sfx(vandq_##sfx(edge, vceqq_##sfx(E, D)), E, C); \
+      vst2q_##sfx((type*)(out0 + (x << 1)), o0); \
+      vst2q_##sfx((type*)(out1 + (x << 1)), o1); \
+   }
+
+static unsigned scale2x_simd_rgb565(const uint16_t *up,
+      const uint16_t *src, const uint16_t *down,
+      uint16_t *out0, uint16_t *out1, unsigned x, unsigned end)
+{
+   SCALE2X_NEON_BLOCK(uint16_t, uint16x8_t, uint16x8x2_t, u16, 8);
+   return x;
+}
+
+static unsigned scale2x_simd_xrgb8888(const uint32_t *up,
+      const uint32_t *src, const uint32_t *down,
+      uint32_t *out0, uint32_t *out1, unsigned x, unsigned end)
+{
+   SCALE2X_NEON_BLOCK(uint32_t, uint32x4_t, uint32x4x2_t, u32, 4);
+   return x;
+}
+#endif
+
+#if defined(SCALE2X_SSE2) || defined(SCALE2X_NEON)
+#define SCALE2X_SIMD
+
+/* Fills in columns [x, end) of a pair of output rows.
+ * The left and right neighbours are clamped to width. */
+#define SCALE2X_ROW(typename_t, up, src, down, out0, out1, x, end, width) \
+   for (; x < end; ++x) \
+   { \
+      const typename_t A = up[x]; \
+      const typename_t B = (x > 0) ? src[x - 1] : src[x]; \
+      const typename_t C = src[x]; \
+      const typename_t D = (x < width - 1) ? src[x + 1] : src[x]; \
+      const typename_t E = down[x]; \
+      typename_t *o0     = out0 + (x << 1); \
+      typename_t *o1     = out1 + (x << 1); \
+      \
+      if (A != E && B != D) \
+      { \
+         o0[0] = (A == B ? A : C); \
+         o0[1] = (A == D ? A : C); \
+         o1[0] = (E == B ? E : C); \
+         o1[1] = (E == D ? E : C); \
+      } \
+      else \
+      { \
+         o0[0] = C; \
+         o0[1] = C; \
+         o1[0] = C; \
+         o1[1] = C; \
+      } \
+   }
+
+#define SCALE2X_SIMD_FRAME(typename_t, simd_row, width, height, first, last, src, src_stride, dst, dst_stride) \
+   for (y = 0; y < height; ++y) \
+   { \
+      const int prevline = ((y == 0) && first) ? 0 : src_stride; \
+      const int nextline = ((y == height - 1) && last) ? 0 : src_stride; \
+      const typename_t *up   = src - prevline; \
+      const typename_t *down = src + nextline; \
+      typename_t *out0       = dst; \
+      typename_t *out1       = dst + dst_stride; \
+      \
+      x = 0; \
+      if (width > 2) \
+      { \
+         SCALE2X_ROW(typename_t, up, src, down, out0, out1, x, 1, width); \
+         x = simd_row(up, src, down, out0, out1, 1, width - 1); \
+      } \
+      SCALE2X_ROW(typename_t, up, src, down, out0, out1, x, width, width); \
+      \
+      src += src_stride; \
+      dst += dst_stride << 1; \
+   }
+
+static void scale2x_simd_frame_rgb565(unsigned width, unsigned height,
+      int first, int last,
+      const uint16_t *src, unsigned src_stride,
+      uint16_t *dst, unsigned dst_stride)
+{
+   unsigned x, y;
+   SCALE2X_SIMD_FRAME(uint16_t, scale2x_simd_rgb565, width, height,
+         first, last, src, src_stride, dst, dst_stride);
+}
+
+static void scale2x_simd_frame_xrgb8888(unsigned width, unsigned height,
+      int first, int last,
+      const uint32_t *src, unsigned src_stride,
+      uint32_t *dst, unsigned dst_stride)
+{
+   unsigned x, y;
+   SCALE2X_SIMD_FRAME(uint32_t, scale2x_simd_xrgb8888, width, height,
+         first, last, src, src_stride, dst, dst_stride);
+}
+#endif
+
 static unsigned scale2x_generic_input_fmts(void)
 {
    return SOFTFILTER_FMT_XRGB8888 | SOFTFILTER_FMT_RGB565;
@@ -135,6 +302,11 @@ static void *scale2x_generic_create(const struct softfilter_config *config,
    (void)userdata;
    if (!filt)
       return NULL;
+#if defined(SCALE2X_SSE2)
+   filt->use_simd = (simd & SOFTFILTER_SIMD_SSE2) ? 1 : 0;
+#elif defined(SCALE2X_NEON)
+   filt->use_simd = (simd & SOFTFILTER_SIMD_NEON) ? 1 : 0;
+#endif
    filt->workers = (struct softfilter_thread_data*)
       calloc(threads, sizeof(struct softfilter_thread_data));
    filt->threads = 1;
@@ -175,6 +347,18 @@ static void scale2x_work_cb_xrgb8888(void *data, void *thread_data)
    unsigned width = thr->width;
    unsigned height = thr->height;
 
+#ifdef SCALE2X_SIMD
+   if (((struct filter_data*)data)->use_simd)
+   {
+      scale2x_simd_frame_xrgb8888(width, height,
+            thr->first, thr->last, input,
+            (unsigned)(thr->in_pitch / SOFTFILTER_BPP_XRGB8888),
+            output,
+            (unsigned)(thr->out_pitch / SOFTFILTER_BPP_XRGB8888));
+      return;
+   }
+#endif
+
    scale2x_generic_xrgb8888(width, height,
          thr->first, thr->last, input,
          (unsigned)(thr->in_pitch / SOFTFILTER_BPP_XRGB8888),
@@ -191,6 +375,18 @@ static void scale2x_work_cb_rgb565(void *data, void *thread_data)
    unsigned width = thr->width;
    unsigned height = thr->height;
 
+#ifdef SCALE2X_SIMD
+   if (((struct filter_data*)data)->use_simd)
+   {
+      scale2x_simd_frame_rgb565(width, height,
+            thr->first, thr->last, input,
+            (unsigned)(thr->in_pitch / SOFTFILTER_BPP_RGB565),
+            output,
+            (unsigned)(thr->out_pitch / SOFTFILTER_BPP_RGB565));
+      return;
+   }
+#endif
+
    scale2x_generic_rgb565(width, height,
          thr->first, thr->last, input,
          (unsigned)(thr->in_pitch / SOFTFILTER_BPP_RGB565),
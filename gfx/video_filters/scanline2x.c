@@ -44,8 +44,127 @@ struct filter_data
    unsigned threads;
    struct softfilter_thread_data *workers;
    unsigned in_fmt;
+   int use_simd;
 };
 
+/* Doubles input pixels [0, width) into a pair of output rows, the
+ * second one darkened, a vector at a time. Returns the first pixel
+ * left over. Each channel becomes (c >> 1) + (c >> 2) like in the
+ * scalar code; masking off the bits shifted in from the neighbouring
+ * channel keeps the sums from carrying into each other. */
+#if defined(__SSE2__)
+#define SCANLINE2X_SSE2
+#include <emmintrin.h>
+
+static unsigned scanline2x_simd_xrgb8888(const uint32_t *input,
+      uint32_t *out0, uint32_t *out1, unsigned width)
+{
+   unsigned x;
+   const __m128i mask1 = _mm_set1_epi32(0x7f7f7f7f);
+   const __m128i mask2 = _mm_set1_epi32(0x3f3f3f3f);
+
+   for (x = 0; x + 4 <= width; x += 4)
+   {
+      __m128i color    = _mm_loadu_si128((const __m128i*)(input + x));
+      __m128i scanline = _mm_add_epi32(
+            _mm_and_si128(_mm_srli_epi32(color, 1), mask1),
+            _mm_and_si128(_mm_srli_epi32(color, 2), mask2));
+
+      _mm_storeu_si128((__m128i*)(out0 + (x << 1)),
+            _mm_unpacklo_epi32(color, color));
+      _mm_storeu_si128((__m128i*)(out0 + (x << 1) + 4),
+            _mm_unpackhi_epi32(color, color));
+      _mm_storeu_si128((__m128i*)(out1 + (x << 1)),
+            _mm_unpacklo_epi32(scanline, scanline));
+      _mm_storeu_si128((__m128i*)(out1 + (x << 1) + 4),
+            _mm_unpackhi_epi32(scanline, scanline));
+   }
+
+   return x;
+}
+
+static unsigned scanline2x_simd_rgb565(const uint16_t *input,
+      uint16_t *out0, uint16_t *out1, unsigned width)
+{
+   unsigned x;
+   const __m128i mask1 = _mm_set1_epi16(0x7bcf);
+   const __m128i mask2 = _mm_set1_epi16(0x39c7);
+
+   for (x = 0; x + 8 <= width; x += 8)
+   {
+      __m128i color    = _mm_loadu_si128((const __m128i*)(input + x));
+      __m128i scanline = _mm_add_epi16(
+            _mm_and_si128(_mm_srli_epi16(color, 1), mask1),
+            _mm_and_si128(_mm_srli_epi16(color, 2), mask2));
+
+      _mm_storeu_si128((__m128i*)(out0 + (x << 1)),
+            _mm_unpacklo_epi16(color, color));
+      _mm_storeu_si128((__m128i*)(out0 + (x << 1) + 8),
+            _mm_unpackhi_epi16(color, color));
+      _mm_storeu_si128((__m128i*)(out1 + (x << 1)),
+            _mm_unpacklo_epi16(scanline, scanline));
+      _mm_storeu_si128((__m128i*)(out1 + (x << 1) + 8),
+            _mm_unpackhi_epi16(scanline, scanline));
+   }
+
+   return x;
+}
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define SCANLINE2X_NEON
+#include <arm_neon.h>
+
+static unsigned scanline2x_simd_xrgb8888(const uint32_t *input,
+      uint32_t *out0, uint32_t *out1, unsigned width)
+{
+   unsigned x;
+
+   for (x = 0; x + 4 <= width; x += 4)
+   {
+      uint32x4x2_t color, scanline;
+      /* Byte lanes, so nothing to mask */
+      uint8x16_t c = vld1q_u8((const uint8_t*)(input + x));
+
+      color.val[0]    = vreinterpretq_u32_u8(c);
+      color.val[1]    = color.val[0];
+      scanline.val[0] = vreinterpretq_u32_u8(
+            vaddq_u8(vshrq_n_u8(c, 1), vshrq_n_u8(c, 2)));
+      scanline.val[1] = scanline.val[0];
+      vst2q_u32(out0 + (x << 1), color);
+      vst2q_u32(out1 + (x << 1), scanline);
+   }
+
+   return x;
+}
+
+static unsigned scanline2x_simd_rgb565(const uint16_t *input,
+      uint16_t *out0, uint16_t *out1, unsigned width)
+{
+   unsigned x;
+   const uint16x8_t mask1 = vdupq_n_u16(0x7bcf);
+   const uint16x8_t mask2 = vdupq_n_u16(0x39c7);
+
+   for (x = 0; x + 8 <= width; x += 8)
+   {
+      uint16x8x2_t color, scanline;
+
+      color.val[0]    = vld1q_u16(input + x);
+      color.val[1]    = color.val[0];
+      scanline.val[0] = vaddq_u16(
+            vandq_u16(vshrq_n_u16(color.val[0], 1), mask1),
+            vandq_u16(vshrq_n_u16(color.val[0], 2), mask2));
+      scanline.val[1] = scanline.val[0];
+      vst2q_u16(out0 + (x << 1), color);
+      vst2q_u16(out1 + (x << 1), scanline);
+   }
+
+   return x;
+}
+#endif
+
+#if defined(SCANLINE2X_SSE2) || defined(SCANLINE2X_NEON)
+#define SCANLINE2X_SIMD
+#endif
+
 static unsigned scanline2x_generic_input_fmts(void)
 {
    return SOFTFILTER_FMT_XRGB8888 | SOFTFILTER_FMT_RGB565;
@@ -75,10 +194,17 @@ static void *scanline2x_generic_create(const struct softfilter_config *config,
    if (!filt) {
       return NULL;
    }
-   /* Apparently the code is not thread-safe,
-    * so force single threaded operation... */
-   filt->workers = (struct softfilter_thread_data*)calloc(1, sizeof(struct softfilter_thread_data));
-   filt->threads = 1;
+#if defined(SCANLINE2X_SSE2)
+   filt->use_simd = (simd & SOFTFILTER_SIMD_SSE2) ? 1 : 0;
+#elif defined(SCANLINE2X_NEON)
+   filt->use_simd = (simd & SOFTFILTER_SIMD_NEON) ? 1 : 0;
+#endif
+   /* Every input row maps to its own pair of output
+    * rows, so bands of rows can be filtered in parallel */
+   if (!threads)
+      threads = 1;
+   filt->workers = (struct softfilter_thread_data*)calloc(threads, sizeof(struct softfilter_thread_data));
+   filt->threads = threads;
    filt->in_fmt  = in_fmt;
    if (!filt->workers) {
       free(filt);
@@ -117,7 +243,18 @@ static void scanline2x_work_cb_xrgb8888(void *data, void *thread_data)
    for (y = 0; y < thr->height; ++y)
    {
       uint32_t *out_ptr = output;
-      for (x = 0; x < thr->width; ++x)
+
+      x = 0;
+#ifdef SCANLINE2X_SIMD
+      if (((struct filter_data*)data)->use_simd)
+      {
+         x        = scanline2x_simd_xrgb8888(input,
+               output, output + out_stride, thr->width);
+         out_ptr += x << 1;
+      }
+#endif
+
+      for (; x < thr->width; ++x)
       {
          /* Note: We process the 'padding' bits as though they
           * matter (they don't), since this deals with any potential
@@ -164,7 +301,18 @@ static void scanline2x_work_cb_rgb565(void *data, void *thread_data)
    for (y = 0; y < thr->height; ++y)
    {
       uint16_t *out_ptr = output;
-      for (x = 0; x < thr->width; ++x)
+
+      x = 0;
+#ifdef SCANLINE2X_SIMD
+      if (((struct filter_data*)data)->use_simd)
+      {
+         x        = scanline2x_simd_rgb565(input,
+               output, output + out_stride, thr->width);
+         out_ptr += x << 1;
+      }
+#endif
+
+      for (; x < thr->width; ++x)
       {
          uint16_t color          = *(input + x);
          uint8_t  r              = (color >> 11 & 0x1F);
@@ -199,27 +347,51 @@ static void scanline2x_generic_packets(void *data,
       void *output, size_t output_stride,
       const void *input, unsigned width, unsigned height, size_t input_stride)
 {
-   /* We are guaranteed single threaded operation
-    * (filt->threads = 1) so we don't need to loop
-    * over threads and can cull some code. This only
-    * makes the tiniest performance difference, but
-    * every little helps when running on an o3DS... */
    struct filter_data *filt = (struct filter_data*)data;
-   struct softfilter_thread_data *thr = (struct softfilter_thread_data*)&filt->workers[0];
-
-   thr->out_data = (uint8_t*)output;
-   thr->in_data = (const uint8_t*)input;
-   thr->out_pitch = output_stride;
-   thr->in_pitch = input_stride;
-   thr->width = width;
-   thr->height = height;
+   softfilter_work_t work = NULL;
+   unsigned i;
 
    if (filt->in_fmt == SOFTFILTER_FMT_XRGB8888) {
-      packets[0].work = scanline2x_work_cb_xrgb8888;
+      work = scanline2x_work_cb_xrgb8888;
    } else if (filt->in_fmt == SOFTFILTER_FMT_RGB565) {
-      packets[0].work = scanline2x_work_cb_rgb565;
+      work = scanline2x_work_cb_rgb565;
+   }
+
+   /* When single threaded, skip the band arithmetic. This only
+    * makes the tiniest performance difference, but
+    * every little helps when running on an o3DS... */
+   if (filt->threads == 1)
+   {
+      struct softfilter_thread_data *thr = (struct softfilter_thread_data*)&filt->workers[0];
+
+      thr->out_data = (uint8_t*)output;
+      thr->in_data = (const uint8_t*)input;
+      thr->out_pitch = output_stride;
+      thr->in_pitch = input_stride;
+      thr->width = width;
+      thr->height = height;
+
+      packets[0].work = work;
+      packets[0].thread_data = thr;
+      return;
+   }
+
+   for (i = 0; i < filt->threads; i++)
+   {
+      struct softfilter_thread_data *thr = (struct softfilter_thread_data*)&filt->workers[i];
+      unsigned y_start = (height * i) / filt->threads;
+      unsigned y_end = (height * (i + 1)) / filt->threads;
+
+      thr->out_data = (uint8_t*)output + ((y_start * output_stride) << 1);
+      thr->in_data = (const uint8_t*)input + y_start * input_stride;
+      thr->out_pitch = output_stride;
+      thr->in_pitch = input_stride;
+      thr->width = width;
+      thr->height = y_end - y_start;
+
+      packets[i].work = work;
+      packets[i].thread_data = thr;
    }
-   packets[0].thread_data = thr;
 }
 
 static const struct softfilter_implementation scanline2x_generic = {
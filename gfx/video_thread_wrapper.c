@@ -29,6 +29,7 @@
 
 #include "../retroarch.h"
 #include "../verbosity.h"
+#include "../frame_trace.h"
 
 enum thread_cmd
 {
@@ -567,6 +568,8 @@ static void video_thread_loop(void *data)
 {
    thread_video_t *thr = (thread_video_t*)data;
 
+   frame_trace_set_thread_name("video");
+
    for (;;)
    {
       thread_packet_t pkt;
@@ -613,11 +616,13 @@ static void video_thread_loop(void *data)
              * rid of this */
             video_driver_build_info(&video_info);
 
+            FRAME_TRACE_BEGIN("video_frame");
             ret = thr->driver->frame(thr->driver_data,
                   thr->frame.buffer, thr->frame.width, thr->frame.height,
                   thr->frame.count,
                   thr->frame.pitch, *thr->frame.msg ? thr->frame.msg : NULL,
                   &video_info);
+            FRAME_TRACE_END("video_frame");
          }
 
          slock_unlock(thr->frame.lock);
@@ -64,6 +64,8 @@
 #endif
 
 #include "../verbosity.c"
+#include "../frame_trace.c"
+#include "../benchmark.c"
 
 #if defined(HAVE_LOGGER) && !defined(ANDROID)
 #include "../network/net_logger.c"
@@ -571,6 +573,7 @@ FONTS
 
 #include "../gfx/drivers_font_renderer/bitmapfont.c"
 #include "../gfx/font_driver.c"
+#include "../gfx/font_run_cache.c"
 
 #if defined(HAVE_D3D9) && defined(HAVE_D3DX)
 #include "../gfx/drivers_font/d3d_w32_font.c"
@@ -1250,6 +1253,8 @@ THREAD
 #endif
 
 #include "../libretro-common/rthreads/rthreads.c"
+#include "../libretro-common/rthreads/tpool.c"
+#include "../libretro-common/rthreads/work_pool.c"
 #include "../gfx/video_thread_wrapper.c"
 #include "../audio/audio_thread_wrapper.c"
 #endif
@@ -1266,7 +1271,9 @@ NETPLAY
 #include "../network/netplay/netplay_init.c"
 #include "../network/netplay/netplay_io.c"
 #include "../network/netplay/netplay_keyboard.c"
+#include "../network/netplay/netplay_relay.c"
 #include "../network/netplay/netplay_sync.c"
+#include "../network/netplay/netplay_udp.c"
 #include "../network/netplay/netplay_discovery.c"
 #include "../network/netplay/netplay_buf.c"
 #include "../network/netplay/netplay_room_parse.c"
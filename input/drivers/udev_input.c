@@ -66,6 +66,13 @@
 #include <string/stdstring.h>
 #include <retro_miscellaneous.h>
 
+#if defined(HAVE_THREADS) && defined(HAVE_EPOLL)
+#define UDEV_READER_THREAD
+#include <rthreads/rthreads.h>
+#include <retro_timers.h>
+#include <features/features_cpu.h>
+#endif
+
 #include "../input_keymaps.h"
 
 #include "../common/linux_common.h"
@@ -80,6 +87,9 @@
 
 #define UDEV_MAX_KEYS (KEY_MAX + 7) / 8
 
+/* Events the reader thread can hold before poll applies them */
+#define UDEV_EVENT_QUEUE_SIZE 4096
+
 typedef struct udev_input udev_input_t;
 
 typedef struct udev_input_device udev_input_device_t;
@@ -121,8 +131,17 @@ struct udev_input_device
    udev_input_mouse_t mouse;
    enum udev_input_dev_type type;
    char devnode[PATH_MAX_LENGTH];
+   /* Are event times on the same (monotonic) clock as
+    * cpu_features_get_time_usec? */
+   bool monotonic;
 };
 
+typedef struct
+{
+   udev_input_device_t *device; /* NULL once the device is gone */
+   struct input_event event;
+} udev_input_event_t;
+
 typedef void (*device_handle_cb)(void *data,
       const struct input_event *event, udev_input_device_t *dev);
 
@@ -141,11 +160,33 @@ struct udev_input
 
    uint8_t state[UDEV_MAX_KEYS];
 
+#ifdef UDEV_READER_THREAD
+   /* Reader thread, and the events it has read that poll hasn't
+    * applied yet. The lock also covers the device list. */
+   sthread_t *reader;
+   slock_t *reader_lock;
+   udev_input_event_t *queue;
+   unsigned queue_head;
+   unsigned queue_count;
+   int wake_fd[2];
+   bool reader_quit;
+#endif
+
 #ifdef UDEV_XKB_HANDLING
    bool xkb_handling;
 #endif
 };
 
+#ifdef UDEV_READER_THREAD
+#define UDEV_LOCK(udev) do { \
+   if ((udev)->reader_lock) slock_lock((udev)->reader_lock); } while (0)
+#define UDEV_UNLOCK(udev) do { \
+   if ((udev)->reader_lock) slock_unlock((udev)->reader_lock); } while (0)
+#else
+#define UDEV_LOCK(udev)
+#define UDEV_UNLOCK(udev)
+#endif
+
 #ifdef UDEV_XKB_HANDLING
 int init_xkb(int fd, size_t size);
 void free_xkb(void);
@@ -503,6 +544,16 @@ static bool udev_input_add_device(udev_input_t *udev,
 
    strlcpy(device->devnode, devnode, sizeof(device->devnode));
 
+#if defined(UDEV_READER_THREAD) && defined(EVIOCSCLOCKID)
+   /* Queued events are applied as of the moment of polling, which
+    * needs their times on our clock */
+   if (udev->reader_lock)
+   {
+      int clk           = CLOCK_MONOTONIC;
+      device->monotonic = ioctl(fd, EVIOCSCLOCKID, &clk) == 0;
+   }
+#endif
+
    /* UDEV_INPUT_MOUSE may report in absolute coords too */
    if (type == UDEV_INPUT_MOUSE || type == UDEV_INPUT_TOUCHPAD )
    {
@@ -535,14 +586,19 @@ static bool udev_input_add_device(udev_input_t *udev,
       }
    }
 
+   UDEV_LOCK(udev);
    tmp = ( udev_input_device_t**)realloc(udev->devices,
          (udev->num_devices + 1) * sizeof(*udev->devices));
 
    if (!tmp)
+   {
+      UDEV_UNLOCK(udev);
       goto error;
+   }
 
    tmp[udev->num_devices++] = device;
    udev->devices            = tmp;
+   UDEV_UNLOCK(udev);
 
 #if defined(HAVE_EPOLL)
    event.events             = EPOLLIN;
@@ -577,19 +633,211 @@ static void udev_input_remove_device(udev_input_t *udev, const char *devnode)
 {
    unsigned i;
 
+   UDEV_LOCK(udev);
    for (i = 0; i < udev->num_devices; i++)
    {
       if (!string_is_equal(devnode, udev->devices[i]->devnode))
          continue;
 
+#ifdef UDEV_READER_THREAD
+      if (udev->queue)
+      {
+         unsigned j;
+         for (j = 0; j < udev->queue_count; j++)
+         {
+            udev_input_event_t *queued = &udev->queue[
+               (udev->queue_head + j) % UDEV_EVENT_QUEUE_SIZE];
+            if (queued->device == udev->devices[i])
+               queued->device = NULL;
+         }
+      }
+#endif
+
       close(udev->devices[i]->fd);
       free(udev->devices[i]);
       memmove(udev->devices + i, udev->devices + i + 1,
             (udev->num_devices - (i + 1)) * sizeof(*udev->devices));
       udev->num_devices--;
    }
+   UDEV_UNLOCK(udev);
+}
+
+#ifdef UDEV_READER_THREAD
+/* Must be called with the lock held. Returns false if the queue
+ * filled up before the device ran dry. */
+static bool udev_input_reader_read(udev_input_t *udev,
+      udev_input_device_t *device)
+{
+   for (;;)
+   {
+      int j, len;
+      struct input_event input_events[32];
+      unsigned space = UDEV_EVENT_QUEUE_SIZE - udev->queue_count;
+
+      if (!space)
+         return false;
+      if (space > ARRAY_SIZE(input_events))
+         space = ARRAY_SIZE(input_events);
+
+      len = read(device->fd, input_events, space * sizeof(*input_events));
+      if (len <= 0)
+         return true;
+
+      len /= sizeof(*input_events);
+      for (j = 0; j < len; j++)
+      {
+         udev_input_event_t *queued = &udev->queue[
+            (udev->queue_head + udev->queue_count++) % UDEV_EVENT_QUEUE_SIZE];
+         queued->device = device;
+         queued->event  = input_events[j];
+      }
+   }
+}
+
+static void udev_input_reader_thread(void *data)
+{
+   udev_input_t *udev = (udev_input_t*)data;
+
+   for (;;)
+   {
+      int i, ret;
+      bool full = false;
+      struct epoll_event events[32];
+
+      /* Block until there's something to read, or we're woken to quit */
+      ret = epoll_wait(udev->fd, events, ARRAY_SIZE(events), -1);
+      if (ret < 0 && errno != EINTR)
+         break;
+
+      slock_lock(udev->reader_lock);
+      if (udev->reader_quit)
+      {
+         slock_unlock(udev->reader_lock);
+         break;
+      }
+
+      for (i = 0; i < ret; i++)
+      {
+         unsigned k;
+         udev_input_device_t *device = (udev_input_device_t*)
+            events[i].data.ptr;
+
+         if (!device)
+         {
+            char buf[16];
+            while (read(udev->wake_fd[0], buf, sizeof(buf)) > 0);
+            continue;
+         }
+
+         /* The device may have been removed since epoll_wait returned */
+         for (k = 0; k < udev->num_devices; k++)
+            if (udev->devices[k] == device)
+               break;
+         if (k == udev->num_devices)
+            continue;
+
+         if (!udev_input_reader_read(udev, device))
+            full = true;
+      }
+      slock_unlock(udev->reader_lock);
+
+      /* Leave the rest in the kernel until poll catches up */
+      if (full)
+         retro_sleep(1);
+   }
 }
 
+/* Apply queued events that happened up to now, in order */
+static void udev_input_reader_apply(udev_input_t *udev)
+{
+   retro_time_t now = cpu_features_get_time_usec();
+
+   for (;;)
+   {
+      unsigned j, n = 0;
+      udev_input_event_t batch[64];
+
+      slock_lock(udev->reader_lock);
+      while (n < ARRAY_SIZE(batch) && udev->queue_count)
+      {
+         udev_input_event_t *queued = &udev->queue[udev->queue_head];
+         if (     queued->device
+               && queued->device->monotonic
+               && (retro_time_t)queued->event.time.tv_sec * 1000000
+                  + queued->event.time.tv_usec > now)
+            break;
+         if (queued->device)
+            batch[n++]    = *queued;
+         udev->queue_head = (udev->queue_head + 1) % UDEV_EVENT_QUEUE_SIZE;
+         udev->queue_count--;
+      }
+      slock_unlock(udev->reader_lock);
+
+      for (j = 0; j < n; j++)
+         batch[j].device->handle_cb(udev, &batch[j].event, batch[j].device);
+
+      if (n < ARRAY_SIZE(batch))
+         break;
+   }
+}
+
+/* Set up what the reader thread needs before devices are opened, so
+ * that they get opened for it */
+static bool udev_input_reader_prepare(udev_input_t *udev)
+{
+   struct epoll_event event;
+
+   udev->wake_fd[0] = udev->wake_fd[1] = -1;
+
+   if (pipe(udev->wake_fd) < 0)
+      return false;
+   fcntl(udev->wake_fd[0], F_SETFL, O_NONBLOCK);
+   fcntl(udev->wake_fd[1], F_SETFL, O_NONBLOCK);
+
+   event.events   = EPOLLIN;
+   event.data.ptr = NULL;
+   if (epoll_ctl(udev->fd, EPOLL_CTL_ADD, udev->wake_fd[0], &event) < 0)
+      return false;
+
+   udev->queue       = (udev_input_event_t*)malloc(
+         UDEV_EVENT_QUEUE_SIZE * sizeof(*udev->queue));
+   udev->reader_lock = slock_new();
+
+   return udev->queue && udev->reader_lock;
+}
+
+static void udev_input_reader_free(udev_input_t *udev)
+{
+   if (udev->reader)
+   {
+      slock_lock(udev->reader_lock);
+      udev->reader_quit = true;
+      slock_unlock(udev->reader_lock);
+      if (write(udev->wake_fd[1], "", 1) < 0) { }
+      sthread_join(udev->reader);
+      udev->reader = NULL;
+   }
+
+   if (udev->reader_lock)
+      slock_free(udev->reader_lock);
+   udev->reader_lock = NULL;
+
+   free(udev->queue);
+   udev->queue       = NULL;
+   udev->queue_count = 0;
+
+   if (udev->wake_fd[0] >= 0)
+   {
+      if (udev->fd >= 0)
+         epoll_ctl(udev->fd, EPOLL_CTL_DEL, udev->wake_fd[0], NULL);
+      close(udev->wake_fd[0]);
+   }
+   if (udev->wake_fd[1] >= 0)
+      close(udev->wake_fd[1]);
+   udev->wake_fd[0] = udev->wake_fd[1] = -1;
+}
+#endif
+
 static void udev_input_handle_hotplug(udev_input_t *udev)
 {
    device_handle_cb cb;
@@ -741,6 +989,14 @@ static void udev_input_poll(void *data)
    while (udev->monitor && udev_input_poll_hotplug_available(udev->monitor))
       udev_input_handle_hotplug(udev);
 
+#ifdef UDEV_READER_THREAD
+   if (udev->reader)
+   {
+      udev_input_reader_apply(udev);
+      return;
+   }
+#endif
+
 #if defined(HAVE_EPOLL)
    ret = epoll_wait(udev->fd, events, ARRAY_SIZE(events), 0);
 #elif defined(HAVE_KQUEUE)
@@ -1220,6 +1476,10 @@ static void udev_input_free(void *data)
    if (!data || !udev)
       return;
 
+#ifdef UDEV_READER_THREAD
+   udev_input_reader_free(udev);
+#endif
+
    if (udev->fd >= 0)
       close(udev->fd);
 
@@ -1308,6 +1568,11 @@ static void *udev_input_init(const char *joypad_driver)
    if (!udev)
       return NULL;
 
+#ifdef UDEV_READER_THREAD
+   udev->wake_fd[0]     = -1;
+   udev->wake_fd[1]     = -1;
+#endif
+
    udev->udev = udev_new();
    if (!udev->udev)
       goto error;
@@ -1339,6 +1604,17 @@ static void *udev_input_init(const char *joypad_driver)
 
    udev->fd  = fd;
 
+#ifdef UDEV_READER_THREAD
+   if (config_get_ptr()->bools.input_udev_reader_thread)
+   {
+      if (!udev_input_reader_prepare(udev))
+      {
+         RARCH_WARN("[udev]: Couldn't set up the reader thread.\n");
+         udev_input_reader_free(udev);
+      }
+   }
+#endif
+
    if (!open_devices(udev, UDEV_INPUT_KEYBOARD, udev_handle_keyboard))
       goto error;
 
@@ -1348,6 +1624,18 @@ static void *udev_input_init(const char *joypad_driver)
    if (!open_devices(udev, UDEV_INPUT_TOUCHPAD, udev_handle_mouse))
       goto error;
 
+#ifdef UDEV_READER_THREAD
+   if (udev->reader_lock)
+   {
+      udev->reader = sthread_create(udev_input_reader_thread, udev);
+      if (!udev->reader)
+      {
+         RARCH_WARN("[udev]: Couldn't start the reader thread.\n");
+         udev_input_reader_free(udev);
+      }
+   }
+#endif
+
    /* If using KMS and we forgot this,
     * we could lock ourselves out completely. */
    if (!udev->num_devices)
@@ -1420,6 +1420,10 @@ MSG_HASH(
    MENU_ENUM_LABEL_INPUT_POLL_TYPE_BEHAVIOR,
    "input_poll_type_behavior"
    )
+MSG_HASH(
+   MENU_ENUM_LABEL_INPUT_UDEV_READER_THREAD,
+   "input_udev_reader_thread"
+   )
 MSG_HASH(
    MENU_ENUM_LABEL_INPUT_PREFER_FRONT_TOUCH,
    "input_prefer_front_touch"
@@ -1808,6 +1812,14 @@ MSG_HASH(
    MENU_ENUM_LABEL_NETPLAY_STATELESS_MODE,
    "netplay_stateless_mode"
    )
+MSG_HASH(
+   MENU_ENUM_LABEL_NETPLAY_UDP_INPUT,
+   "netplay_udp_input"
+   )
+MSG_HASH(
+   MENU_ENUM_LABEL_NETPLAY_SPECTATOR_RELAY,
+   "netplay_spectator_relay"
+   )
 MSG_HASH(
    MENU_ENUM_LABEL_NETPLAY_TCP_UDP_PORT,
    "netplay_tcp_udp_port"
@@ -3000,6 +3012,10 @@ MSG_HASH(
    MENU_ENUM_LABEL_VIDEO_FRAME_DELAY,
    "video_frame_delay"
    )
+MSG_HASH(
+   MENU_ENUM_LABEL_VIDEO_FRAME_DELAY_AUTO,
+   "video_frame_delay_auto"
+   )
 MSG_HASH(
    MENU_ENUM_LABEL_VIDEO_SHADER_DELAY,
    "video_shader_delay"
@@ -1646,6 +1646,14 @@ MSG_HASH(
    MENU_ENUM_SUBLABEL_VIDEO_FRAME_DELAY,
    "Reduces latency at the cost of a higher risk of video stuttering. Adds a delay after V-Sync (in ms)."
    )
+MSG_HASH(
+   MENU_ENUM_LABEL_VALUE_VIDEO_FRAME_DELAY_AUTO,
+   "Automatic Frame Delay"
+   )
+MSG_HASH(
+   MENU_ENUM_SUBLABEL_VIDEO_FRAME_DELAY_AUTO,
+   "Pick the frame delay from the measured core run time, and back off quickly when frames run late. A Frame Delay that is set becomes the upper limit."
+   )
 MSG_HASH(
    MENU_ENUM_LABEL_VALUE_VIDEO_HARD_SYNC,
    "Hard GPU Sync"
@@ -1986,6 +1994,14 @@ MSG_HASH(
    MENU_ENUM_SUBLABEL_INPUT_POLL_TYPE_BEHAVIOR,
    "Influence how input polling is done in RetroArch. Setting it to 'Early' or 'Late' can result in less latency, depending on your configuration."
    )
+MSG_HASH(
+   MENU_ENUM_LABEL_VALUE_INPUT_UDEV_READER_THREAD,
+   "Threaded udev Input"
+   )
+MSG_HASH(
+   MENU_ENUM_SUBLABEL_INPUT_UDEV_READER_THREAD,
+   "Read keyboard and mouse events on a separate thread with the udev input driver, so each poll sees input as of that moment, in order. Applies when the input driver starts."
+   )
 MSG_HASH(
    MENU_ENUM_LABEL_VALUE_INPUT_REMAP_BINDS_ENABLE,
    "Remap Controls for This Core"
@@ -4723,6 +4739,22 @@ MSG_HASH(
    MENU_ENUM_SUBLABEL_NETPLAY_STATELESS_MODE,
    "Start netplay in a mode not requiring save states. A very fast network is required, but no rewinding is performed, so there will be no netplay jitter."
    )
+MSG_HASH(
+   MENU_ENUM_LABEL_VALUE_NETPLAY_UDP_INPUT,
+   "UDP Input"
+   )
+MSG_HASH(
+   MENU_ENUM_SUBLABEL_NETPLAY_UDP_INPUT,
+   "Also send input over UDP, with each packet repeating the last few frames. A lost packet no longer stalls input behind a TCP resend. Not used through a relay server."
+   )
+MSG_HASH(
+   MENU_ENUM_LABEL_VALUE_NETPLAY_SPECTATOR_RELAY,
+   "Spectator Relay"
+   )
+MSG_HASH(
+   MENU_ENUM_SUBLABEL_NETPLAY_SPECTATOR_RELAY,
+   "Send to spectators from a separate thread. Their stream is built once and shared, which lets the host serve many more spectators."
+   )
 MSG_HASH(
    MENU_ENUM_LABEL_VALUE_NETPLAY_CHECK_FRAMES,
    "Netplay Check Frames"
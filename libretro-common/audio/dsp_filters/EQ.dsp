@@ -7,11 +7,16 @@ filter0 = eq
 # Lower values will allow better frequency resolution, but more ripple.
 # eq_window_beta = 4.0
 
-# The block size on which FFT is done.
-# Too high value requires more processing as well as longer latency but
+# The length of the filter.
+# Too high value requires more processing but
 # allows finer-grained control over the spectrum.
 # eq_block_size_log2 = 8
 
+# The filter is applied in partitions of this size, which sets the latency.
+# Smaller partitions lower the latency but cost more processing.
+# Values above eq_block_size_log2 are clamped to it.
+# eq_partition_size_log2 = 6
+
 # An array of which frequencies to control.
 # You can create an arbitrary amount of these sampling points.
 # The EQ will try to create a frequency response which fits well to these points.
@@ -31,17 +31,27 @@
 
 #include "fft/fft.c"
 
+/* The filter is split into partitions of block_size taps, and each
+ * one is convolved in the frequency domain with the matching block
+ * of past input (uniformly partitioned overlap-save). Latency is one
+ * partition instead of the whole filter length.
+ *
+ * Both channels go through one complex FFT, left as the real part
+ * and right as the imaginary part. The filter is real, so the two
+ * never mix. */
 struct eq_data
 {
    fft_t *fft;
    float buffer[8 * 1024];
 
-   float *save;
-   float *block;
-   fft_complex_t *filter;
+   fft_complex_t *block;    /* Previous and current input block. */
+   fft_complex_t *spectra;  /* Spectra of the last num_partitions blocks. */
+   fft_complex_t *filter;   /* Spectrum of every filter partition. */
    fft_complex_t *fftblock;
    unsigned block_size;
    unsigned block_ptr;
+   unsigned num_partitions;
+   unsigned spectrum_ptr;
 };
 
 struct eq_gain
@@ -57,8 +67,8 @@ static void eq_free(void *data)
       return;
 
    fft_free(eq->fft);
-   free(eq->save);
    free(eq->block);
+   free(eq->spectra);
    free(eq->fftblock);
    free(eq->filter);
    free(eq);
@@ -86,35 +96,50 @@ static void eq_process(void *data, struct dspfilter_output *output,
       if (input_frames < write_avail)
          write_avail = input_frames;
 
-      memcpy(eq->block + eq->block_ptr * 2, in, write_avail * 2 * sizeof(float));
+      memcpy(eq->block + eq->block_size + eq->block_ptr, in,
+            write_avail * 2 * sizeof(float));
 
       in += write_avail * 2;
       input_frames -= write_avail;
       eq->block_ptr += write_avail;
 
-      // Convolve a new block.
+      /* Convolve a new block. */
       if (eq->block_ptr == eq->block_size)
       {
-         unsigned i, c;
+         unsigned i;
+         unsigned fft_size = 2 * eq->block_size;
+         fft_complex_t *spectrum = eq->spectra
+            + eq->spectrum_ptr * fft_size;
+
+         fft_process_forward_complex(eq->fft, spectrum, eq->block, 1);
 
-         for (c = 0; c < 2; c++)
+         /* Newest block against the first partition,
+          * the one before against the second, and so on. */
+         memset(eq->fftblock, 0, fft_size * sizeof(*eq->fftblock));
+         for (i = 0; i < eq->num_partitions; i++)
          {
-            fft_process_forward(eq->fft, eq->fftblock, eq->block + c, 2);
-            for (i = 0; i < 2 * eq->block_size; i++)
-               eq->fftblock[i] = fft_complex_mul(eq->fftblock[i], eq->filter[i]);
-            fft_process_inverse(eq->fft, out + c, eq->fftblock, 2);
+            unsigned index = (eq->spectrum_ptr + eq->num_partitions - i)
+               % eq->num_partitions;
+            fft_multiply_accumulate(eq->fftblock,
+                  eq->spectra + index * fft_size,
+                  eq->filter + i * fft_size, fft_size);
          }
 
-         // Overlap add method, so add in saved block now.
-         for (i = 0; i < 2 * eq->block_size; i++)
-            out[i] += eq->save[i];
+         fft_process_inverse_complex(eq->fft,
+               eq->fftblock, eq->fftblock, 1);
+
+         /* Overlap save method, the first half is wrapped around. */
+         memcpy(out, eq->fftblock + eq->block_size,
+               eq->block_size * 2 * sizeof(float));
 
-         // Save block for later.
-         memcpy(eq->save, out + 2 * eq->block_size, 2 * eq->block_size * sizeof(float));
+         /* Current block becomes the previous one. */
+         memcpy(eq->block, eq->block + eq->block_size,
+               eq->block_size * sizeof(*eq->block));
 
          out += eq->block_size * 2;
          output->frames += eq->block_size;
          eq->block_ptr = 0;
+         eq->spectrum_ptr = (eq->spectrum_ptr + 1) % eq->num_partitions;
       }
    }
 }
@@ -195,22 +220,25 @@ static void create_filter(struct eq_data *eq, unsigned size_log2,
       struct eq_gain *gains, unsigned num_gains, double beta, const char *filter_path)
 {
    int i;
-   int half_block_size = eq->block_size >> 1;
+   unsigned filter_size = 1 << size_log2;
+   int half_block_size = filter_size >> 1;
    double window_mod = 1.0 / kaiser_window_function(0.0, beta);
 
    fft_t *fft = fft_new(size_log2);
-   float *time_filter = (float*)calloc(eq->block_size * 2 + 1, sizeof(*time_filter));
-   if (!fft || !time_filter)
+   float *time_filter = (float*)calloc(filter_size * 2 + 1, sizeof(*time_filter));
+   float *partition = (float*)calloc(eq->block_size * 2, sizeof(*partition));
+   fft_complex_t *response = (fft_complex_t*)calloc(filter_size + 1, sizeof(*response));
+   if (!fft || !time_filter || !partition || !response)
       goto end;
 
    /* Make sure bands are in correct order. */
    qsort(gains, num_gains, sizeof(*gains), gains_cmp);
 
    /* Compute desired filter response. */
-   generate_response(eq->filter, gains, num_gains, half_block_size);
+   generate_response(response, gains, num_gains, half_block_size);
 
    /* Get equivalent time-domain filter. */
-   fft_process_inverse(fft, time_filter, eq->filter, 1);
+   fft_process_inverse(fft, time_filter, response, 1);
 
    /* ifftshift() to create the correct linear phase filter.
     * The filter response was designed with zero phase, which
@@ -225,10 +253,10 @@ static void create_filter(struct eq_data *eq, unsigned size_log2,
    }
 
    /* Apply a window to smooth out the frequency repsonse. */
-   for (i = 0; i < (int)eq->block_size; i++)
+   for (i = 0; i < (int)filter_size; i++)
    {
       /* Kaiser window. */
-      double phase = (double)i / eq->block_size;
+      double phase = (double)i / filter_size;
       phase = 2.0 * (phase - 0.5);
       time_filter[i] *= window_mod * kaiser_window_function(phase, beta);
    }
@@ -240,22 +268,30 @@ static void create_filter(struct eq_data *eq, unsigned size_log2,
       FILE *file = fopen(filter_path, "w");
       if (file)
       {
-         for (i = 0; i < (int)eq->block_size - 1; i++)
+         for (i = 0; i < (int)filter_size - 1; i++)
             fprintf(file, "%.8f\n", time_filter[i + 1]);
          fclose(file);
       }
    }
 #endif
 
-   /* Padded FFT to create our FFT filter.
+   /* Padded FFT of each partition to create our FFT filter.
     * Make our even-length filter odd by discarding the first coefficient.
     * For some interesting reason, this allows us to design an odd-length linear phase filter.
     */
-   fft_process_forward(eq->fft, eq->filter, time_filter + 1, 1);
+   for (i = 0; i < (int)eq->num_partitions; i++)
+   {
+      memcpy(partition, time_filter + 1 + i * eq->block_size,
+            eq->block_size * sizeof(*partition));
+      fft_process_forward(eq->fft, eq->filter + i * 2 * eq->block_size,
+            partition, 1);
+   }
 
 end:
    fft_free(fft);
    free(time_filter);
+   free(partition);
+   free(response);
 }
 
 static void *eq_init(const struct dspfilter_info *info,
@@ -263,7 +299,7 @@ static void *eq_init(const struct dspfilter_info *info,
 {
    float *frequencies, *gain;
    unsigned num_freq, num_gain, i, size;
-   int size_log2;
+   int size_log2, partition_log2;
    float beta;
    struct eq_gain *gains = NULL;
    char *filter_path = NULL;
@@ -276,7 +312,12 @@ static void *eq_init(const struct dspfilter_info *info,
    config->get_float(userdata, "window_beta", &beta, 4.0f);
 
    config->get_int(userdata, "block_size_log2", &size_log2, 8);
-   size = 1 << size_log2;
+   config->get_int(userdata, "partition_size_log2", &partition_log2, 6);
+   if (partition_log2 < 1)
+      partition_log2 = 1;
+   if (partition_log2 > size_log2)
+      partition_log2 = size_log2;
+   size = 1 << partition_log2;
 
    config->get_float_array(userdata, "frequencies", &frequencies, &num_freq, default_freq, 2);
    config->get_float_array(userdata, "gains", &gain, &num_gain, default_gain, 2);
@@ -301,19 +342,22 @@ static void *eq_init(const struct dspfilter_info *info,
    config->free(frequencies);
    config->free(gain);
 
-   eq->block_size = size;
+   eq->block_size     = size;
+   eq->num_partitions = 1 << (size_log2 - partition_log2);
 
-   eq->save     = (float*)calloc(    size, 2 * sizeof(*eq->save));
-   eq->block    = (float*)calloc(2 * size, 2 * sizeof(*eq->block));
+   eq->block    = (fft_complex_t*)calloc(2 * size, sizeof(*eq->block));
    eq->fftblock = (fft_complex_t*)calloc(2 * size, sizeof(*eq->fftblock));
-   eq->filter   = (fft_complex_t*)calloc(2 * size, sizeof(*eq->filter));
+   eq->spectra  = (fft_complex_t*)calloc(2 * size * eq->num_partitions,
+         sizeof(*eq->spectra));
+   eq->filter   = (fft_complex_t*)calloc(2 * size * eq->num_partitions,
+         sizeof(*eq->filter));
 
-   /* Use an FFT which is twice the block size with zero-padding
+   /* Use an FFT which is twice the partition size with zero-padding
     * to make circular convolution => proper convolution.
     */
-   eq->fft = fft_new(size_log2 + 1);
+   eq->fft = fft_new(partition_log2 + 1);
 
-   if (!eq->fft || !eq->fftblock || !eq->save || !eq->block || !eq->filter)
+   if (!eq->fft || !eq->fftblock || !eq->spectra || !eq->block || !eq->filter)
       goto error;
 
    create_filter(eq, size_log2, gains, num_gain, beta, filter_path);
@@ -27,6 +27,13 @@
 
 #include <retro_miscellaneous.h>
 
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define FFT_NEON
+#endif
+
 struct fft
 {
    fft_complex_t *interleave_buffer;
@@ -140,6 +147,20 @@ static void butterfly(fft_complex_t *a, fft_complex_t *b, fft_complex_t mod)
    *a  = fft_complex_add(*a, mod);
 }
 
+#if defined(__SSE__)
+/* Multiplies two pairs of interleaved complex numbers,
+ * with the same rounding as fft_complex_mul(). */
+static INLINE __m128 fft_sse_complex_mul(__m128 a, __m128 b)
+{
+   const __m128 sign = _mm_set_ps(0.0f, -0.0f, 0.0f, -0.0f);
+   __m128 a_real     = _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 0, 0));
+   __m128 a_imag     = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 1, 1));
+   __m128 b_swap     = _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 3, 0, 1));
+   return _mm_add_ps(_mm_mul_ps(a_real, b),
+         _mm_xor_ps(_mm_mul_ps(a_imag, b_swap), sign));
+}
+#endif
+
 static void butterflies(fft_complex_t *butterfly_buf,
       const fft_complex_t *phase_lut,
       int phase_dir, unsigned step_size, unsigned samples)
@@ -148,7 +169,65 @@ static void butterflies(fft_complex_t *butterfly_buf,
    for (i = 0; i < samples; i += step_size << 1)
    {
       int phase_step = (int)samples * phase_dir / (int)step_size;
-      for (j = i; j < i + step_size; j++)
+
+      j = i;
+#if defined(__SSE__)
+      /* Two butterflies at a time, the twiddle factors
+       * are strided through the phase table. */
+      if (step_size >= 2)
+      {
+         for (; j < i + step_size; j += 2)
+         {
+            const fft_complex_t *mod = &phase_lut[phase_step * (int)(j - i)];
+            __m128 t = _mm_loadh_pi(
+                  _mm_loadl_pi(_mm_setzero_ps(), (const __m64*)mod),
+                  (const __m64*)(mod + phase_step));
+            __m128 a = _mm_loadu_ps(&butterfly_buf[j].real);
+            __m128 b = _mm_loadu_ps(&butterfly_buf[j + step_size].real);
+
+            t = fft_sse_complex_mul(t, b);
+            _mm_storeu_ps(&butterfly_buf[j + step_size].real,
+                  _mm_sub_ps(a, t));
+            _mm_storeu_ps(&butterfly_buf[j].real, _mm_add_ps(a, t));
+         }
+      }
+#elif defined(FFT_NEON)
+      /* Four butterflies at a time on deinterleaved
+       * real and imaginary parts. */
+      if (step_size >= 4)
+      {
+         for (; j < i + step_size; j += 4)
+         {
+            float32x4x2_t a, b, t, mod;
+            const fft_complex_t *lut = &phase_lut[phase_step * (int)(j - i)];
+            fft_complex_t tw[4];
+
+            tw[0] = lut[0];
+            tw[1] = lut[phase_step];
+            tw[2] = lut[2 * phase_step];
+            tw[3] = lut[3 * phase_step];
+            t     = vld2q_f32(&tw[0].real);
+
+            a = vld2q_f32(&butterfly_buf[j].real);
+            b = vld2q_f32(&butterfly_buf[j + step_size].real);
+
+            mod.val[0] = vsubq_f32(vmulq_f32(t.val[0], b.val[0]),
+                  vmulq_f32(t.val[1], b.val[1]));
+            mod.val[1] = vaddq_f32(vmulq_f32(t.val[1], b.val[0]),
+                  vmulq_f32(t.val[0], b.val[1]));
+
+            b.val[0] = vsubq_f32(a.val[0], mod.val[0]);
+            b.val[1] = vsubq_f32(a.val[1], mod.val[1]);
+            a.val[0] = vaddq_f32(a.val[0], mod.val[0]);
+            a.val[1] = vaddq_f32(a.val[1], mod.val[1]);
+
+            vst2q_f32(&butterfly_buf[j + step_size].real, b);
+            vst2q_f32(&butterfly_buf[j].real, a);
+         }
+      }
+#endif
+
+      for (; j < i + step_size; j++)
          butterfly(&butterfly_buf[j], &butterfly_buf[j + step_size],
                phase_lut[phase_step * (int)(j - i)]);
    }
@@ -202,3 +281,61 @@ void fft_process_inverse(fft_t *fft,
 
    resolve_float(out, fft->interleave_buffer, samples, 1.0f / samples, step);
 }
+
+void fft_process_inverse_complex(fft_t *fft,
+      fft_complex_t *out, const fft_complex_t *in, unsigned step)
+{
+   unsigned i, step_size;
+   unsigned samples = fft->size;
+   float gain       = 1.0f / samples;
+
+   interleave_complex(fft->bitinverse_buffer, fft->interleave_buffer,
+         in, samples, 1);
+
+   for (step_size = 1; step_size < samples; step_size <<= 1)
+   {
+      butterflies(fft->interleave_buffer,
+            fft->phase_lut + samples,
+            1, step_size, samples);
+   }
+
+   for (i = 0; i < samples; i++, out += step)
+   {
+      out->real = gain * fft->interleave_buffer[i].real;
+      out->imag = gain * fft->interleave_buffer[i].imag;
+   }
+}
+
+void fft_multiply_accumulate(fft_complex_t *out,
+      const fft_complex_t *a, const fft_complex_t *b, unsigned samples)
+{
+   unsigned i = 0;
+
+#if defined(__SSE__)
+   for (; i + 2 <= samples; i += 2)
+   {
+      __m128 prod = fft_sse_complex_mul(
+            _mm_loadu_ps(&a[i].real), _mm_loadu_ps(&b[i].real));
+      _mm_storeu_ps(&out[i].real,
+            _mm_add_ps(_mm_loadu_ps(&out[i].real), prod));
+   }
+#elif defined(FFT_NEON)
+   for (; i + 4 <= samples; i += 4)
+   {
+      float32x4x2_t va = vld2q_f32(&a[i].real);
+      float32x4x2_t vb = vld2q_f32(&b[i].real);
+      float32x4x2_t vo = vld2q_f32(&out[i].real);
+
+      vo.val[0] = vaddq_f32(vo.val[0], vsubq_f32(
+               vmulq_f32(va.val[0], vb.val[0]),
+               vmulq_f32(va.val[1], vb.val[1])));
+      vo.val[1] = vaddq_f32(vo.val[1], vaddq_f32(
+               vmulq_f32(va.val[1], vb.val[0]),
+               vmulq_f32(va.val[0], vb.val[1])));
+      vst2q_f32(&out[i].real, vo);
+   }
+#endif
+
+   for (; i < samples; i++)
+      out[i] = fft_complex_add(out[i], fft_complex_mul(a[i], b[i]));
+}
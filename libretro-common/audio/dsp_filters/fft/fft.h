@@ -41,4 +41,11 @@ void fft_process_forward(fft_t *fft,
 void fft_process_inverse(fft_t *fft,
       float *out, const fft_complex_t *in, unsigned step);
 
+void fft_process_inverse_complex(fft_t *fft,
+      fft_complex_t *out, const fft_complex_t *in, unsigned step);
+
+/* out[i] += a[i] * b[i] */
+void fft_multiply_accumulate(fft_complex_t *out,
+      const fft_complex_t *a, const fft_complex_t *b, unsigned samples);
+
 #endif
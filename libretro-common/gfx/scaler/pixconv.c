@@ -35,14 +35,68 @@
 
 #ifdef SCALER_NO_SIMD
 #undef __SSE2__
+#undef __SSSE3__
+#undef __AVX2__
 #endif
 
-#if defined(__SSE2__)
+/* SIMD paths are picked at build time from the target
+ * ISA, there is no run-time dispatch. A default x86-64
+ * build only gets the SSE2 paths, the SSSE3 and AVX2
+ * ones need -mssse3/-mavx2 (or -march=native). */
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__SSE2__)
 #include <emmintrin.h>
 #elif defined(__MMX__)
 #include <mmintrin.h>
 #endif
 
+#if !defined(SCALER_NO_SIMD) && !defined(__SSE2__) && (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#define SCALER_NEON
+#include <arm_neon.h>
+#endif
+
+#ifdef SCALER_NEON
+/* Widen 5/6/4-bit channels to 8 bits by replicating
+ * their top bits into the vacated low bits */
+static INLINE uint8x8_t conv_expand5_neon(uint8x8_t c)
+{
+   return vorr_u8(vshl_n_u8(c, 3), vshr_n_u8(c, 2));
+}
+
+static INLINE uint8x8_t conv_expand6_neon(uint8x8_t c)
+{
+   return vorr_u8(vshl_n_u8(c, 2), vshr_n_u8(c, 4));
+}
+
+static INLINE uint8x8_t conv_expand4_neon(uint8x8_t c)
+{
+   return vorr_u8(vshl_n_u8(c, 4), c);
+}
+
+/* Splits 8 RGB565 pixels into 8-bit channels */
+static INLINE void conv_rgb565_split_neon(uint16x8_t in,
+      uint8x8_t *r, uint8x8_t *g, uint8x8_t *b)
+{
+   *r = conv_expand5_neon(vmovn_u16(vshrq_n_u16(in, 11)));
+   *g = conv_expand6_neon(vmovn_u16(vandq_u16(
+               vshrq_n_u16(in, 5), vdupq_n_u16(0x3f))));
+   *b = conv_expand5_neon(vmovn_u16(vandq_u16(in, vdupq_n_u16(0x1f))));
+}
+
+/* Splits 8 0RGB1555 pixels into 8-bit channels */
+static INLINE void conv_0rgb1555_split_neon(uint16x8_t in,
+      uint8x8_t *r, uint8x8_t *g, uint8x8_t *b)
+{
+   const uint16x8_t mask = vdupq_n_u16(0x1f);
+   *r = conv_expand5_neon(vmovn_u16(vandq_u16(vshrq_n_u16(in, 10), mask)));
+   *g = conv_expand5_neon(vmovn_u16(vandq_u16(vshrq_n_u16(in,  5), mask)));
+   *b = conv_expand5_neon(vmovn_u16(vandq_u16(in, mask)));
+}
+#endif
+
 void conv_rgb565_0rgb1555(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
@@ -55,6 +109,10 @@ void conv_rgb565_0rgb1555(void *output_, const void *input_,
    int max_width           = width - 7;
    const __m128i hi_mask   = _mm_set1_epi16(0x7fe0);
    const __m128i lo_mask   = _mm_set1_epi16(0x1f);
+#elif defined(SCALER_NEON)
+   int max_width           = width - 7;
+   const uint16x8_t hi_mask = vdupq_n_u16(0x7fe0);
+   const uint16x8_t lo_mask = vdupq_n_u16(0x1f);
 #endif
 
    for (h = 0; h < height;
@@ -65,10 +123,18 @@ void conv_rgb565_0rgb1555(void *output_, const void *input_,
       for (; w < max_width; w += 8)
       {
          const __m128i in = _mm_loadu_si128((const __m128i*)(input + w));
-         __m128i hi = _mm_and_si128(_mm_slli_epi16(in, 1), hi_mask);
+         __m128i hi = _mm_and_si128(_mm_srli_epi16(in, 1), hi_mask);
          __m128i lo = _mm_and_si128(in, lo_mask);
          _mm_storeu_si128((__m128i*)(output + w), _mm_or_si128(hi, lo));
       }
+#elif defined(SCALER_NEON)
+      for (; w < max_width; w += 8)
+      {
+         const uint16x8_t in = vld1q_u16(input + w);
+         uint16x8_t hi       = vandq_u16(vshrq_n_u16(in, 1), hi_mask);
+         uint16x8_t lo       = vandq_u16(in, lo_mask);
+         vst1q_u16(output + w, vorrq_u16(hi, lo));
+      }
 #endif
 
       for (; w < width; w++)
@@ -96,6 +162,12 @@ void conv_0rgb1555_rgb565(void *output_, const void *input_,
          (int16_t)((0x1f << 11) | (0x1f << 6)));
    const __m128i lo_mask   = _mm_set1_epi16(0x1f);
    const __m128i glow_mask = _mm_set1_epi16(1 << 5);
+#elif defined(SCALER_NEON)
+   int max_width              = width - 7;
+
+   const uint16x8_t hi_mask   = vdupq_n_u16((0x1f << 11) | (0x1f << 6));
+   const uint16x8_t lo_mask   = vdupq_n_u16(0x1f);
+   const uint16x8_t glow_mask = vdupq_n_u16(1 << 5);
 #endif
 
    for (h = 0; h < height;
@@ -112,6 +184,15 @@ void conv_0rgb1555_rgb565(void *output_, const void *input_,
          _mm_storeu_si128((__m128i*)(output + w),
                _mm_or_si128(rg, _mm_or_si128(b, glow)));
       }
+#elif defined(SCALER_NEON)
+      for (; w < max_width; w += 8)
+      {
+         const uint16x8_t in = vld1q_u16(input + w);
+         uint16x8_t rg       = vandq_u16(vshlq_n_u16(in, 1), hi_mask);
+         uint16x8_t b        = vandq_u16(in, lo_mask);
+         uint16x8_t glow     = vandq_u16(vshrq_n_u16(in, 4), glow_mask);
+         vst1q_u16(output + w, vorrq_u16(rg, vorrq_u16(b, glow)));
+      }
 #endif
 
       for (; w < width; w++)
@@ -140,6 +221,8 @@ void conv_0rgb1555_argb8888(void *output_, const void *input_,
    const __m128i mul15_hi    = _mm_set1_epi16(0x0210);
    const __m128i a           = _mm_set1_epi16(0x00ff);
 
+   int max_width = width - 7;
+#elif defined(SCALER_NEON)
    int max_width = width - 7;
 #endif
 
@@ -175,6 +258,15 @@ void conv_0rgb1555_argb8888(void *output_, const void *input_,
          _mm_storeu_si128((__m128i*)(output + w + 0), res_lo);
          _mm_storeu_si128((__m128i*)(output + w + 4), res_hi);
       }
+#elif defined(SCALER_NEON)
+      for (; w < max_width; w += 8)
+      {
+         uint8x8x4_t res;
+         conv_0rgb1555_split_neon(vld1q_u16(input + w),
+               &res.val[2], &res.val[1], &res.val[0]);
+         res.val[3] = vdup_n_u8(0xff);
+         vst4_u8((uint8_t*)(output + w), res);
+      }
 #endif
 
       for (; w < width; w++)
@@ -210,6 +302,17 @@ void conv_rgb565_argb8888(void *output_, const void *input_,
    const __m128i a          = _mm_set1_epi16(0x00ff);
 
    int max_width            = width - 7;
+#if defined(__AVX2__)
+   const __m256i pix_mask_r_256 = _mm256_set1_epi16(0x1f << 10);
+   const __m256i pix_mask_g_256 = _mm256_set1_epi16(0x3f <<  5);
+   const __m256i pix_mask_b_256 = _mm256_set1_epi16(0x1f <<  5);
+   const __m256i mul16_r_256    = _mm256_set1_epi16(0x0210);
+   const __m256i mul16_g_256    = _mm256_set1_epi16(0x2080);
+   const __m256i mul16_b_256    = _mm256_set1_epi16(0x4200);
+   const __m256i a_256          = _mm256_set1_epi16(0x00ff);
+
+   int max_width_256            = width - 15;
+#endif
 #elif defined(__MMX__)
    const __m64 pix_mask_r = _mm_set1_pi16(0x1f << 10);
    const __m64 pix_mask_g = _mm_set1_pi16(0x3f << 5);
@@ -220,6 +323,8 @@ void conv_rgb565_argb8888(void *output_, const void *input_,
    const __m64 a          = _mm_set1_pi16(0x00ff);
 
    int max_width            = width - 3;
+#elif defined(SCALER_NEON)
+   int max_width            = width - 7;
 #endif
 
    for (h = 0; h < height;
@@ -227,6 +332,32 @@ void conv_rgb565_argb8888(void *output_, const void *input_,
    {
       int w = 0;
 #if defined(__SSE2__)
+#if defined(__AVX2__)
+      for (; w < max_width_256; w += 16)
+      {
+         __m256i res_lo, res_hi;
+         const __m256i in = _mm256_loadu_si256((const __m256i*)(input + w));
+         __m256i        r = _mm256_and_si256(_mm256_srli_epi16(in, 1), pix_mask_r_256);
+         __m256i        g = _mm256_and_si256(in, pix_mask_g_256);
+         __m256i        b = _mm256_and_si256(_mm256_slli_epi16(in, 5), pix_mask_b_256);
+
+         r                = _mm256_mulhi_epi16(r, mul16_r_256);
+         g                = _mm256_mulhi_epi16(g, mul16_g_256);
+         b                = _mm256_mulhi_epi16(b, mul16_b_256);
+
+         res_lo           = _mm256_or_si256(_mm256_unpacklo_epi8(b, g),
+               _mm256_slli_si256(_mm256_unpacklo_epi8(r, a_256), 2));
+         res_hi           = _mm256_or_si256(_mm256_unpackhi_epi8(b, g),
+               _mm256_slli_si256(_mm256_unpackhi_epi8(r, a_256), 2));
+
+         /* Unpacks operate within 128-bit lanes,
+          * so restore pixel order on store */
+         _mm256_storeu_si256((__m256i*)(output + w + 0),
+               _mm256_permute2x128_si256(res_lo, res_hi, 0x20));
+         _mm256_storeu_si256((__m256i*)(output + w + 8),
+               _mm256_permute2x128_si256(res_lo, res_hi, 0x31));
+      }
+#endif
       for (; w < max_width; w += 8)
       {
          __m128i res_lo, res_hi;
@@ -282,6 +413,15 @@ void conv_rgb565_argb8888(void *output_, const void *input_,
       }
 
       _mm_empty();
+#elif defined(SCALER_NEON)
+      for (; w < max_width; w += 8)
+      {
+         uint8x8x4_t res;
+         conv_rgb565_split_neon(vld1q_u16(input + w),
+               &res.val[2], &res.val[1], &res.val[0]);
+         res.val[3] = vdup_n_u8(0xff);
+         vst4_u8((uint8_t*)(output + w), res);
+      }
 #endif
 
       for (; w < width; w++)
@@ -315,6 +455,8 @@ void conv_rgb565_abgr8888(void *output_, const void *input_,
    const __m128i mul16_b    = _mm_set1_epi16(0x4200);
    const __m128i a          = _mm_set1_epi16(0x00ff);
     int max_width            = width - 7;
+#elif defined(SCALER_NEON)
+   int max_width            = width - 7;
 #endif
     for (h = 0; h < height;
          h++, output += out_stride >> 2, input += in_stride >> 1)
@@ -332,10 +474,11 @@ void conv_rgb565_abgr8888(void *output_, const void *input_,
          r                = _mm_mulhi_epi16(r, mul16_r);
          g                = _mm_mulhi_epi16(g, mul16_g);
          b                = _mm_mulhi_epi16(b, mul16_b);
-         res_lo_bg        = _mm_unpacklo_epi8(b, g);
-         res_hi_bg        = _mm_unpackhi_epi8(b, g);
-         res_lo_ra        = _mm_unpacklo_epi8(r, a);
-         res_hi_ra        = _mm_unpackhi_epi8(r, a);
+         /* Same as RGB565 -> ARGB8888, with R and B swapped */
+         res_lo_bg        = _mm_unpacklo_epi8(r, g);
+         res_hi_bg        = _mm_unpackhi_epi8(r, g);
+         res_lo_ra        = _mm_unpacklo_epi8(b, a);
+         res_hi_ra        = _mm_unpackhi_epi8(b, a);
          res_lo           = _mm_or_si128(res_lo_bg,
                _mm_slli_si128(res_lo_ra, 2));
          res_hi           = _mm_or_si128(res_hi_bg,
@@ -343,6 +486,15 @@ void conv_rgb565_abgr8888(void *output_, const void *input_,
          _mm_storeu_si128((__m128i*)(output + w + 0), res_lo);
          _mm_storeu_si128((__m128i*)(output + w + 4), res_hi);
       }
+#elif defined(SCALER_NEON)
+      for (; w < max_width; w += 8)
+      {
+         uint8x8x4_t res;
+         conv_rgb565_split_neon(vld1q_u16(input + w),
+               &res.val[0], &res.val[1], &res.val[2]);
+         res.val[3] = vdup_n_u8(0xff);
+         vst4_u8((uint8_t*)(output + w), res);
+      }
 #endif
        for (; w < width; w++)
       {
@@ -394,7 +546,12 @@ void conv_rgba4444_argb8888(void *output_, const void *input_,
    const uint16_t *input = (const uint16_t*)input_;
    uint32_t *output      = (uint32_t*)output_;
 
-#if defined(__MMX__)
+#if defined(__SSE2__)
+   const __m128i nibble_mask = _mm_set1_epi16(0xf);
+   const __m128i mul4        = _mm_set1_epi16(0x11);
+
+   int max_width             = width - 7;
+#elif defined(__MMX__)
    const __m64 pix_mask_r = _mm_set1_pi16(0xf << 10);
    const __m64 pix_mask_g = _mm_set1_pi16(0xf << 8);
    const __m64 pix_mask_b = _mm_set1_pi16(0xf << 8);
@@ -404,13 +561,39 @@ void conv_rgba4444_argb8888(void *output_, const void *input_,
    const __m64 a          = _mm_set1_pi16(0x00ff);
 
    int max_width            = width - 3;
+#elif defined(SCALER_NEON)
+   int max_width            = width - 7;
 #endif
 
    for (h = 0; h < height;
          h++, output += out_stride >> 2, input += in_stride >> 1)
    {
       int w = 0;
-#if defined(__MMX__)
+#if defined(__SSE2__)
+      for (; w < max_width; w += 8)
+      {
+         __m128i bg, ra;
+         const __m128i in = _mm_loadu_si128((const __m128i*)(input + w));
+         __m128i        r = _mm_srli_epi16(in, 12);
+         __m128i        g = _mm_and_si128(_mm_srli_epi16(in, 8), nibble_mask);
+         __m128i        b = _mm_and_si128(_mm_srli_epi16(in, 4), nibble_mask);
+         __m128i        a = _mm_and_si128(in, nibble_mask);
+
+         /* Expand 4 -> 8 bits: c * 0x11 == (c << 4) | c */
+         r                = _mm_mullo_epi16(r, mul4);
+         g                = _mm_mullo_epi16(g, mul4);
+         b                = _mm_mullo_epi16(b, mul4);
+         a                = _mm_mullo_epi16(a, mul4);
+
+         bg               = _mm_or_si128(b, _mm_slli_epi16(g, 8));
+         ra               = _mm_or_si128(r, _mm_slli_epi16(a, 8));
+
+         _mm_storeu_si128((__m128i*)(output + w + 0),
+               _mm_unpacklo_epi16(bg, ra));
+         _mm_storeu_si128((__m128i*)(output + w + 4),
+               _mm_unpackhi_epi16(bg, ra));
+      }
+#elif defined(__MMX__)
       for (; w < max_width; w += 4)
       {
          __m64 res_lo, res_hi;
@@ -439,6 +622,19 @@ void conv_rgba4444_argb8888(void *output_, const void *input_,
       }
 
       _mm_empty();
+#elif defined(SCALER_NEON)
+      for (; w < max_width; w += 8)
+      {
+         uint8x8x4_t res;
+         const uint16x8_t in = vld1q_u16(input + w);
+         uint8x8_t        hi = vshrn_n_u16(in, 8); /* RRRRGGGG */
+         uint8x8_t        lo = vmovn_u16(in);      /* BBBBAAAA */
+         res.val[0]          = conv_expand4_neon(vshr_n_u8(lo, 4));
+         res.val[1]          = conv_expand4_neon(vand_u8(hi, vdup_n_u8(0xf)));
+         res.val[2]          = conv_expand4_neon(vshr_n_u8(hi, 4));
+         res.val[3]          = conv_expand4_neon(vand_u8(lo, vdup_n_u8(0xf)));
+         vst4_u8((uint8_t*)(output + w), res);
+      }
 #endif
 
       for (; w < width; w++)
@@ -462,14 +658,50 @@ void conv_rgba4444_rgb565(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
 {
-   int h, w;
+   int h;
    const uint16_t *input = (const uint16_t*)input_;
    uint16_t *output      = (uint16_t*)output_;
 
+#if defined(__SSE2__)
+   const __m128i r_mask  = _mm_set1_epi16((int16_t)0xf000);
+   const __m128i g_mask  = _mm_set1_epi16(0xf << 7);
+   const __m128i b_mask  = _mm_set1_epi16(0xf << 1);
+
+   int max_width         = width - 7;
+#elif defined(SCALER_NEON)
+   const uint16x8_t r_mask = vdupq_n_u16(0xf000);
+   const uint16x8_t g_mask = vdupq_n_u16(0xf << 7);
+   const uint16x8_t b_mask = vdupq_n_u16(0xf << 1);
+
+   int max_width         = width - 7;
+#endif
+
    for (h = 0; h < height;
          h++, output += out_stride >> 1, input += in_stride >> 1)
    {
-      for (w = 0; w < width; w++)
+      int w = 0;
+#if defined(__SSE2__)
+      for (; w < max_width; w += 8)
+      {
+         const __m128i in = _mm_loadu_si128((const __m128i*)(input + w));
+         __m128i        r = _mm_and_si128(in, r_mask);
+         __m128i        g = _mm_and_si128(_mm_srli_epi16(in, 1), g_mask);
+         __m128i        b = _mm_and_si128(_mm_srli_epi16(in, 3), b_mask);
+         _mm_storeu_si128((__m128i*)(output + w),
+               _mm_or_si128(r, _mm_or_si128(g, b)));
+      }
+#elif defined(SCALER_NEON)
+      for (; w < max_width; w += 8)
+      {
+         const uint16x8_t in = vld1q_u16(input + w);
+         uint16x8_t        r = vandq_u16(in, r_mask);
+         uint16x8_t        g = vandq_u16(vshrq_n_u16(in, 1), g_mask);
+         uint16x8_t        b = vandq_u16(vshrq_n_u16(in, 3), b_mask);
+         vst1q_u16(output + w, vorrq_u16(r, vorrq_u16(g, b)));
+      }
+#endif
+
+      for (; w < width; w++)
       {
          uint32_t col = input[w];
          uint32_t r   = (col >> 12) & 0xf;
@@ -544,6 +776,8 @@ void conv_0rgb1555_bgr24(void *output_, const void *input_,
    const __m128i a           = _mm_set1_epi16(0x00ff);
 
    int max_width             = width - 15;
+#elif defined(SCALER_NEON)
+   int max_width             = width - 7;
 #endif
 
    for (h = 0; h < height;
@@ -595,6 +829,14 @@ void conv_0rgb1555_bgr24(void *output_, const void *input_,
          /* Non-POT pixel sizes for the loss */
          store_bgr24_sse2(out, res_lo0, res_hi0, res_lo1, res_hi1);
       }
+#elif defined(SCALER_NEON)
+      for (; w < max_width; w += 8, out += 24)
+      {
+         uint8x8x3_t res;
+         conv_0rgb1555_split_neon(vld1q_u16(input + w),
+               &res.val[2], &res.val[1], &res.val[0]);
+         vst3_u8(out, res);
+      }
 #endif
 
       for (; w < width; w++)
@@ -632,6 +874,8 @@ void conv_rgb565_bgr24(void *output_, const void *input_,
    const __m128i a          = _mm_set1_epi16(0x00ff);
 
    int max_width            = width - 15;
+#elif defined(SCALER_NEON)
+   int max_width            = width - 7;
 #endif
 
    for (h = 0; h < height; h++, output += out_stride, input += in_stride >> 1)
@@ -680,6 +924,14 @@ void conv_rgb565_bgr24(void *output_, const void *input_,
 
          store_bgr24_sse2(out, res_lo0, res_hi0, res_lo1, res_hi1);
       }
+#elif defined(SCALER_NEON)
+      for (; w < max_width; w += 8, out += 24)
+      {
+         uint8x8x3_t res;
+         conv_rgb565_split_neon(vld1q_u16(input + w),
+               &res.val[2], &res.val[1], &res.val[0]);
+         vst3_u8(out, res);
+      }
 #endif
 
       for (; w < width; w++)
@@ -703,15 +955,48 @@ void conv_bgr24_argb8888(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
 {
-   int h, w;
+   int h;
    const uint8_t *input = (const uint8_t*)input_;
    uint32_t *output     = (uint32_t*)output_;
 
+#if defined(__SSSE3__)
+   const __m128i shuf   = _mm_setr_epi8(
+         0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+   const __m128i a      = _mm_set1_epi32((int)0xff000000u);
+
+   /* Each 16 byte load consumes only 4 pixels (12 bytes),
+    * so stop early enough not to read past the end of the row */
+   int max_width        = width - 5;
+#elif defined(SCALER_NEON)
+   int max_width        = width - 7;
+#endif
+
    for (h = 0; h < height;
          h++, output += out_stride >> 2, input += in_stride)
    {
       const uint8_t *inp = input;
-      for (w = 0; w < width; w++)
+      int              w = 0;
+#if defined(__SSSE3__)
+      for (; w < max_width; w += 4, inp += 12)
+      {
+         const __m128i in = _mm_loadu_si128((const __m128i*)inp);
+         _mm_storeu_si128((__m128i*)(output + w),
+               _mm_or_si128(_mm_shuffle_epi8(in, shuf), a));
+      }
+#elif defined(SCALER_NEON)
+      for (; w < max_width; w += 8, inp += 24)
+      {
+         uint8x8x4_t res;
+         const uint8x8x3_t in = vld3_u8(inp);
+         res.val[0]           = in.val[0];
+         res.val[1]           = in.val[1];
+         res.val[2]           = in.val[2];
+         res.val[3]           = vdup_n_u8(0xff);
+         vst4_u8((uint8_t*)(output + w), res);
+      }
+#endif
+
+      for (; w < width; w++)
       {
          uint32_t b = *inp++;
          uint32_t g = *inp++;
@@ -725,14 +1010,63 @@ void conv_bgr24_rgb565(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
 {
-   int h, w;
+   int h;
    const uint8_t *input = (const uint8_t*)input_;
    uint16_t *output     = (uint16_t*)output_;
+
+#if defined(__SSSE3__)
+   const __m128i shuf   = _mm_setr_epi8(
+         0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+   const __m128i r_mask = _mm_set1_epi32(0xf800);
+   const __m128i g_mask = _mm_set1_epi32(0x07e0);
+   const __m128i b_mask = _mm_set1_epi32(0x001f);
+
+   /* Second 16 byte load starts 12 bytes in - stop early
+    * enough not to read past the end of the row */
+   int max_width        = width - 9;
+#elif defined(SCALER_NEON)
+   int max_width        = width - 7;
+#endif
+
    for (h = 0; h < height;
          h++, output += out_stride, input += in_stride)
    {
       const uint8_t *inp = input;
-      for (w = 0; w < width; w++)
+      int              w = 0;
+#if defined(__SSSE3__)
+      for (; w < max_width; w += 8, inp += 24)
+      {
+         __m128i lo = _mm_shuffle_epi8(
+               _mm_loadu_si128((const __m128i*)(inp +  0)), shuf);
+         __m128i hi = _mm_shuffle_epi8(
+               _mm_loadu_si128((const __m128i*)(inp + 12)), shuf);
+
+         lo = _mm_or_si128(_mm_and_si128(_mm_srli_epi32(lo, 8), r_mask),
+               _mm_or_si128(_mm_and_si128(_mm_srli_epi32(lo, 5), g_mask),
+                  _mm_and_si128(_mm_srli_epi32(lo, 3), b_mask)));
+         hi = _mm_or_si128(_mm_and_si128(_mm_srli_epi32(hi, 8), r_mask),
+               _mm_or_si128(_mm_and_si128(_mm_srli_epi32(hi, 5), g_mask),
+                  _mm_and_si128(_mm_srli_epi32(hi, 3), b_mask)));
+
+         /* Sign extend so that the saturating pack
+          * keeps all 16 bits intact */
+         lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+         hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+
+         _mm_storeu_si128((__m128i*)(output + w), _mm_packs_epi32(lo, hi));
+      }
+#elif defined(SCALER_NEON)
+      for (; w < max_width; w += 8, inp += 24)
+      {
+         const uint8x8x3_t in = vld3_u8(inp);
+         uint16x8_t         r = vshll_n_u8(vand_u8(in.val[2], vdup_n_u8(0xf8)), 8);
+         uint16x8_t         g = vshll_n_u8(vand_u8(in.val[1], vdup_n_u8(0xfc)), 3);
+         uint16x8_t         b = vmovl_u8(vshr_n_u8(in.val[0], 3));
+         vst1q_u16(output + w, vorrq_u16(r, vorrq_u16(g, b)));
+      }
+#endif
+
+      for (; w < width; w++)
       {
          uint16_t b = *inp++;
          uint16_t g = *inp++;
@@ -747,14 +1081,52 @@ void conv_argb8888_0rgb1555(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
 {
-   int h, w;
+   int h;
    const uint32_t *input = (const uint32_t*)input_;
    uint16_t *output      = (uint16_t*)output_;
 
+#if defined(__SSE2__)
+   const __m128i r_mask  = _mm_set1_epi32(0x1f << 10);
+   const __m128i g_mask  = _mm_set1_epi32(0x1f <<  5);
+   const __m128i b_mask  = _mm_set1_epi32(0x1f);
+
+   int max_width         = width - 7;
+#elif defined(SCALER_NEON)
+   int max_width         = width - 7;
+#endif
+
    for (h = 0; h < height;
          h++, output += out_stride >> 1, input += in_stride >> 2)
    {
-      for (w = 0; w < width; w++)
+      int w = 0;
+#if defined(__SSE2__)
+      for (; w < max_width; w += 8)
+      {
+         __m128i lo = _mm_loadu_si128((const __m128i*)(input + w + 0));
+         __m128i hi = _mm_loadu_si128((const __m128i*)(input + w + 4));
+
+         lo = _mm_or_si128(_mm_and_si128(_mm_srli_epi32(lo, 9), r_mask),
+               _mm_or_si128(_mm_and_si128(_mm_srli_epi32(lo, 6), g_mask),
+                  _mm_and_si128(_mm_srli_epi32(lo, 3), b_mask)));
+         hi = _mm_or_si128(_mm_and_si128(_mm_srli_epi32(hi, 9), r_mask),
+               _mm_or_si128(_mm_and_si128(_mm_srli_epi32(hi, 6), g_mask),
+                  _mm_and_si128(_mm_srli_epi32(hi, 3), b_mask)));
+
+         /* Results fit in 15 bits, so a signed pack is exact */
+         _mm_storeu_si128((__m128i*)(output + w), _mm_packs_epi32(lo, hi));
+      }
+#elif defined(SCALER_NEON)
+      for (; w < max_width; w += 8)
+      {
+         const uint8x8x4_t in = vld4_u8((const uint8_t*)(input + w));
+         uint16x8_t         r = vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 3)), 10);
+         uint16x8_t         g = vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 3)),  5);
+         uint16x8_t         b = vmovl_u8(vshr_n_u8(in.val[0], 3));
+         vst1q_u16(output + w, vorrq_u16(r, vorrq_u16(g, b)));
+      }
+#endif
+
+      for (; w < width; w++)
       {
          uint32_t col = input[w];
          uint16_t r   = (col >> 19) & 0x1f;
@@ -775,6 +1147,8 @@ void conv_argb8888_bgr24(void *output_, const void *input_,
 
 #if defined(__SSE2__)
    int max_width = width - 15;
+#elif defined(SCALER_NEON)
+   int max_width = width - 7;
 #endif
 
    for (h = 0; h < height;
@@ -791,6 +1165,16 @@ void conv_argb8888_bgr24(void *output_, const void *input_,
          __m128i l3 = _mm_loadu_si128((const __m128i*)(input + w + 12));
          store_bgr24_sse2(out, l0, l1, l2, l3);
       }
+#elif defined(SCALER_NEON)
+      for (; w < max_width; w += 8, out += 24)
+      {
+         uint8x8x3_t res;
+         const uint8x8x4_t in = vld4_u8((const uint8_t*)(input + w));
+         res.val[0]           = in.val[0];
+         res.val[1]           = in.val[1];
+         res.val[2]           = in.val[2];
+         vst3_u8(out, res);
+      }
 #endif
 
       for (; w < width; w++)
@@ -828,6 +1212,8 @@ void conv_abgr8888_bgr24(void *output_, const void *input_,
 
 #if defined(__SSE2__)
    int max_width = width - 15;
+#elif defined(SCALER_NEON)
+   int max_width = width - 7;
 #endif
 
    for (h = 0; h < height;
@@ -848,6 +1234,16 @@ void conv_abgr8888_bgr24(void *output_, const void *input_,
          d = conv_shuffle_rb_epi32(d);
          store_bgr24_sse2(out, a, b, c, d);
       }
+#elif defined(SCALER_NEON)
+      for (; w < max_width; w += 8, out += 24)
+      {
+         uint8x8x3_t res;
+         const uint8x8x4_t in = vld4_u8((const uint8_t*)(input + w));
+         res.val[0]           = in.val[2];
+         res.val[1]           = in.val[1];
+         res.val[2]           = in.val[0];
+         vst3_u8(out, res);
+      }
 #endif
 
       for (; w < width; w++)
@@ -864,14 +1260,65 @@ void conv_argb8888_abgr8888(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
 {
-   int h, w;
+   int h;
    const uint32_t *input = (const uint32_t*)input_;
    uint32_t *output      = (uint32_t*)output_;
 
+#if defined(__SSE2__)
+   const __m128i ag_mask = _mm_set1_epi32((int)0xff00ff00u);
+   const __m128i r_mask  = _mm_set1_epi32(0x00ff0000);
+   const __m128i b_mask  = _mm_set1_epi32(0x000000ff);
+
+   int max_width         = width - 3;
+#if defined(__AVX2__)
+   const __m256i ag_mask_256 = _mm256_set1_epi32((int)0xff00ff00u);
+   const __m256i r_mask_256  = _mm256_set1_epi32(0x00ff0000);
+   const __m256i b_mask_256  = _mm256_set1_epi32(0x000000ff);
+
+   int max_width_256         = width - 7;
+#endif
+#elif defined(SCALER_NEON)
+   int max_width         = width - 7;
+#endif
+
    for (h = 0; h < height;
          h++, output += out_stride >> 2, input += in_stride >> 2)
    {
-      for (w = 0; w < width; w++)
+      int w = 0;
+#if defined(__SSE2__)
+#if defined(__AVX2__)
+      for (; w < max_width_256; w += 8)
+      {
+         const __m256i in = _mm256_loadu_si256((const __m256i*)(input + w));
+         __m256i       ag = _mm256_and_si256(in, ag_mask_256);
+         __m256i        r = _mm256_and_si256(_mm256_slli_epi32(in, 16), r_mask_256);
+         __m256i        b = _mm256_and_si256(_mm256_srli_epi32(in, 16), b_mask_256);
+         _mm256_storeu_si256((__m256i*)(output + w),
+               _mm256_or_si256(ag, _mm256_or_si256(r, b)));
+      }
+#endif
+      for (; w < max_width; w += 4)
+      {
+         const __m128i in = _mm_loadu_si128((const __m128i*)(input + w));
+         __m128i       ag = _mm_and_si128(in, ag_mask);
+         __m128i        r = _mm_and_si128(_mm_slli_epi32(in, 16), r_mask);
+         __m128i        b = _mm_and_si128(_mm_srli_epi32(in, 16), b_mask);
+         _mm_storeu_si128((__m128i*)(output + w),
+               _mm_or_si128(ag, _mm_or_si128(r, b)));
+      }
+#elif defined(SCALER_NEON)
+      for (; w < max_width; w += 8)
+      {
+         uint8x8_t tmp;
+         uint8x8x4_t px = vld4_u8((const uint8_t*)(input + w));
+         tmp            = px.val[0];
+         px.val[0]      = px.val[2];
+         px.val[2]      = tmp;
+         vst4_u8((uint8_t*)(output + w), px);
+      }
+#endif
+
+      for (; w < width; w++)
       {
          uint32_t col = input[w];
          output[w]    = ((col << 16) & 0xff0000) |
@@ -910,6 +1357,9 @@ void conv_yuyv_argb8888(void *output_, const void *input_,
    const __m128i v_g_mul       = _mm_set1_epi16(YUV_MAT_V_G);
    const __m128i a             = _mm_cmpeq_epi16(
          _mm_setzero_si128(), _mm_setzero_si128());
+#elif defined(SCALER_NEON)
+   const int16x8_t chroma_offset = vdupq_n_s16(128);
+   const int16x8_t round_offset  = vdupq_n_s16(YUV_OFFSET);
 #endif
 
    for (h = 0; h < height; h++, output += out_stride >> 2, input += in_stride)
@@ -1001,6 +1451,46 @@ void conv_yuyv_argb8888(void *output_, const void *input_,
          _mm_storeu_si128((__m128i*)(dst +  8), res2);
          _mm_storeu_si128((__m128i*)(dst + 12), res3);
       }
+#elif defined(SCALER_NEON)
+      /* Each loop processes 16 pixels. */
+      for (; w + 16 <= width; w += 16, src += 32, dst += 16)
+      {
+         uint8x8x2_t r, g, b;
+         uint8x8x4_t res;
+         /* [Y0, Y2, ...], [U0, U1, ...], [Y1, Y3, ...], [V0, V1, ...] */
+         const uint8x8x4_t yuv = vld4_u8(src);
+         int16x8_t y0 = vmulq_n_s16(vreinterpretq_s16_u16(vmovl_u8(yuv.val[0])), YUV_MAT_Y);
+         int16x8_t y1 = vmulq_n_s16(vreinterpretq_s16_u16(vmovl_u8(yuv.val[2])), YUV_MAT_Y);
+         int16x8_t u  = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(yuv.val[1])), chroma_offset);
+         int16x8_t v  = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(yuv.val[3])), chroma_offset);
+
+         /* Chroma contributions are shared by each pixel pair */
+         int16x8_t r_uv = vaddq_s16(vmulq_n_s16(v, YUV_MAT_V_R), round_offset);
+         int16x8_t g_uv = vaddq_s16(vaddq_s16(vmulq_n_s16(u, YUV_MAT_U_G),
+                  vmulq_n_s16(v, YUV_MAT_V_G)), round_offset);
+         int16x8_t b_uv = vaddq_s16(vmulq_n_s16(u, YUV_MAT_U_B), round_offset);
+
+         /* Shift and saturate into 8-bit, then
+          * interleave even and odd pixels */
+         r = vzip_u8(vqshrun_n_s16(vaddq_s16(y0, r_uv), YUV_SHIFT),
+               vqshrun_n_s16(vaddq_s16(y1, r_uv), YUV_SHIFT));
+         g = vzip_u8(vqshrun_n_s16(vaddq_s16(y0, g_uv), YUV_SHIFT),
+               vqshrun_n_s16(vaddq_s16(y1, g_uv), YUV_SHIFT));
+         b = vzip_u8(vqshrun_n_s16(vaddq_s16(y0, b_uv), YUV_SHIFT),
+               vqshrun_n_s16(vaddq_s16(y1, b_uv), YUV_SHIFT));
+
+         res.val[3] = vdup_n_u8(0xff);
+
+         res.val[0] = b.val[0];
+         res.val[1] = g.val[0];
+         res.val[2] = r.val[0];
+         vst4_u8((uint8_t*)(dst + 0), res);
+
+         res.val[0] = b.val[1];
+         res.val[1] = g.val[1];
+         res.val[2] = r.val[1];
+         vst4_u8((uint8_t*)(dst + 8), res);
+      }
 #endif
 
       /* Finish off the rest (if any) in C. */
@@ -30,6 +30,29 @@
 #include <gfx/scaler/filter.h>
 #include <gfx/scaler/pixconv.h>
 
+#ifdef HAVE_THREADS
+#include <retro_miscellaneous.h>
+#include <rthreads/tpool.h>
+
+#define SCALER_MAX_THREADS 8
+
+/* Fewest output rows worth handing to another thread */
+#define SCALER_MIN_SLICE_ROWS 16
+
+struct scaler_slice
+{
+   const struct scaler_ctx *ctx;
+   const void *input;
+   const void *input_frame;
+   void *output;
+   void *output_frame;
+   int input_stride;
+   int output_stride;
+   int first;
+   int last;
+};
+#endif
+
 static bool allocate_frames(struct scaler_ctx *ctx)
 {
    uint64_t *scaled_frame = NULL;
@@ -261,6 +284,12 @@ bool scaler_ctx_gen_filter(struct scaler_ctx *ctx)
 
       if (!scaler_gen_filter(ctx))
          return false;
+
+#ifdef HAVE_THREADS
+      /* Only the generic filter path is split over threads */
+      if (ctx->threads > 1 && !ctx->scaler_special)
+         ctx->pool = tpool_create(MIN(ctx->threads, SCALER_MAX_THREADS) - 1);
+#endif
    }
 
    return true;
@@ -268,6 +297,11 @@ bool scaler_ctx_gen_filter(struct scaler_ctx *ctx)
 
 void scaler_ctx_gen_reset(struct scaler_ctx *ctx)
 {
+#ifdef HAVE_THREADS
+   if (ctx->pool)
+      tpool_destroy(ctx->pool);
+   ctx->pool                = NULL;
+#endif
    if (ctx->horiz.filter)
       free(ctx->horiz.filter);
    if (ctx->horiz.filter_pos)
@@ -305,6 +339,119 @@ void scaler_ctx_gen_reset(struct scaler_ctx *ctx)
    ctx->output.stride       = 0;
 }
 
+#ifdef HAVE_THREADS
+/* Converts and horizontally scales input rows [first, last) */
+static void scaler_slice_horiz(void *data)
+{
+   struct scaler_slice *slice   = (struct scaler_slice*)data;
+   const struct scaler_ctx *ctx = slice->ctx;
+   int rows                     = slice->last - slice->first;
+
+   if (rows <= 0)
+      return;
+
+   if (ctx->in_fmt != SCALER_FMT_ARGB8888)
+      ctx->in_pixconv(
+            (uint8_t*)ctx->input.frame + slice->first * ctx->input.stride,
+            (const uint8_t*)slice->input + slice->first * ctx->in_stride,
+            ctx->in_width, rows,
+            ctx->input.stride, ctx->in_stride);
+
+   scaler_argb8888_horiz_rows(ctx, slice->input_frame,
+         slice->input_stride, slice->first, slice->last);
+}
+
+/* Vertically scales and converts output rows [first, last) */
+static void scaler_slice_vert(void *data)
+{
+   struct scaler_slice *slice   = (struct scaler_slice*)data;
+   const struct scaler_ctx *ctx = slice->ctx;
+   int rows                     = slice->last - slice->first;
+
+   if (rows <= 0)
+      return;
+
+   scaler_argb8888_vert_rows(ctx, slice->output_frame,
+         slice->output_stride, slice->first, slice->last);
+
+   if (ctx->out_fmt != SCALER_FMT_ARGB8888)
+      ctx->out_pixconv(
+            (uint8_t*)slice->output + slice->first * ctx->out_stride,
+            (const uint8_t*)ctx->output.frame
+            + slice->first * ctx->output.stride,
+            ctx->out_width, rows,
+            ctx->out_stride, ctx->output.stride);
+}
+
+static void scaler_ctx_run_slices(struct scaler_ctx *ctx,
+      struct scaler_slice *slices, unsigned count, int rows,
+      void (*func)(void*))
+{
+   unsigned i;
+
+   for (i = 0; i < count; i++)
+   {
+      slices[i].first = (int)((int64_t)rows * i       / count);
+      slices[i].last  = (int)((int64_t)rows * (i + 1) / count);
+   }
+
+   for (i = 1; i < count; i++)
+      if (!tpool_add_work(ctx->pool, func, &slices[i]))
+         func(&slices[i]);
+
+   /* The calling thread takes the first slice itself */
+   func(&slices[0]);
+   tpool_wait(ctx->pool);
+}
+
+static bool scaler_ctx_scale_threaded(struct scaler_ctx *ctx,
+      void *output, const void *input)
+{
+   unsigned i;
+   struct scaler_slice slices[SCALER_MAX_THREADS];
+   unsigned count = MIN(ctx->threads, SCALER_MAX_THREADS);
+
+   if (     !ctx->pool
+         || ctx->scaler_special
+         || ctx->out_height < (int)(count * SCALER_MIN_SLICE_ROWS))
+      return false;
+
+   for (i = 0; i < count; i++)
+   {
+      struct scaler_slice *slice = &slices[i];
+
+      slice->ctx           = ctx;
+      slice->input         = input;
+      slice->input_frame   = input;
+      slice->input_stride  = ctx->in_stride;
+      slice->output        = output;
+      slice->output_frame  = output;
+      slice->output_stride = ctx->out_stride;
+
+      if (ctx->in_fmt != SCALER_FMT_ARGB8888)
+      {
+         slice->input_frame   = ctx->input.frame;
+         slice->input_stride  = ctx->input.stride;
+      }
+
+      if (ctx->out_fmt != SCALER_FMT_ARGB8888)
+      {
+         slice->output_frame  = ctx->output.frame;
+         slice->output_stride = ctx->output.stride;
+      }
+   }
+
+   /* Every output row reads several input rows, so all of them
+    * have to be through the horizontal pass first */
+   scaler_ctx_run_slices(ctx, slices, count,
+         ctx->scaled.height, scaler_slice_horiz);
+   scaler_ctx_run_slices(ctx, slices, count,
+         ctx->out_height,    scaler_slice_vert);
+
+   return true;
+}
+#endif
+
 /**
  * scaler_ctx_scale:
  * @ctx          : pointer to scaler context object.
@@ -321,6 +468,11 @@ void scaler_ctx_scale(struct scaler_ctx *ctx,
    int input_stride        = ctx->in_stride;
    int output_stride       = ctx->out_stride;
 
+#ifdef HAVE_THREADS
+   if (ctx->threads > 1 && scaler_ctx_scale_threaded(ctx, output, input))
+      return;
+#endif
+
    if (ctx->in_fmt != SCALER_FMT_ARGB8888)
    {
       ctx->in_pixconv(ctx->input.frame, input,
@@ -349,7 +501,7 @@ void scaler_ctx_scale(struct scaler_ctx *ctx,
       if (ctx->scaler_horiz)
          ctx->scaler_horiz(ctx, input_frame, input_stride);
       if (ctx->scaler_vert)
-         ctx->scaler_vert (ctx, output, output_stride);
+         ctx->scaler_vert (ctx, output_frame, output_stride);
    }
 
    if (ctx->out_fmt != SCALER_FMT_ARGB8888)
@@ -26,15 +26,23 @@
 
 #ifdef SCALER_NO_SIMD
 #undef __SSE2__
+#undef __AVX2__
 #endif
 
-#if defined(__SSE2__)
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
 #include <emmintrin.h>
 #ifdef _WIN32
 #include <intrin.h>
 #endif
 #endif
 
+#if !defined(SCALER_NO_SIMD) && !defined(__SSE2__) && (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#define SCALER_NEON
+#include <arm_neon.h>
+#endif
+
 /* ARGB8888 scaler is split in two:
  *
  * First, horizontal scaler is applied.
@@ -60,177 +68,415 @@
  *
  * The C version of scalers perform the exact same operations as the
  * SIMD code for testing purposes.
+ *
+ * The vertical filter is the same for a whole output row, so the SIMD
+ * versions of it work on 8 pixels at a time. The horizontal filter
+ * differs per pixel; it is applied to 4 pixels at a time, two of which
+ * share a register.
  */
 
-void scaler_argb8888_vert(const struct scaler_ctx *ctx, void *output_, int stride)
+#ifdef SCALER_NEON
+/* NEON has no mulhi, but a widening multiply and a narrowing
+ * shift do the same */
+static INLINE int16x8_t scaler_neon_mulhi(int16x8_t a, int16x8_t b)
+{
+   return vcombine_s16(
+         vshrn_n_s32(vmull_s16(vget_low_s16(a),  vget_low_s16(b)),  16),
+         vshrn_n_s32(vmull_s16(vget_high_s16(a), vget_high_s16(b)), 16));
+}
+
+static INLINE int16x8_t scaler_neon_expand(const uint32_t *pixels)
+{
+   return vshlq_n_s16(vreinterpretq_s16_u16(
+            vmovl_u8(vld1_u8((const uint8_t*)pixels))), 7);
+}
+#endif
+
+#if !defined(__SSE2__) && !defined(SCALER_NEON)
+static void scaler_argb8888_vert_pixel_c(const struct scaler_ctx *ctx,
+      const uint64_t *input_base, const int16_t *filter_vert,
+      uint32_t *output, int w)
+{
+   int y;
+   const uint64_t *input_base_y = input_base + w;
+   int16_t res_a                = 0;
+   int16_t res_r                = 0;
+   int16_t res_g                = 0;
+   int16_t res_b                = 0;
+
+   for (y = 0; y < ctx->vert.filter_len; y++,
+         input_base_y += (ctx->scaled.stride >> 3))
+   {
+      uint64_t col   = *input_base_y;
+
+      int16_t a      = (col >> 48) & 0xffff;
+      int16_t r      = (col >> 32) & 0xffff;
+      int16_t g      = (col >> 16) & 0xffff;
+      int16_t b      = (col >>  0) & 0xffff;
+
+      int16_t coeff  = filter_vert[y];
+
+      res_a         += (a * coeff) >> 16;
+      res_r         += (r * coeff) >> 16;
+      res_g         += (g * coeff) >> 16;
+      res_b         += (b * coeff) >> 16;
+   }
+
+   res_a           >>= (7 - 2 - 2);
+   res_r           >>= (7 - 2 - 2);
+   res_g           >>= (7 - 2 - 2);
+   res_b           >>= (7 - 2 - 2);
+
+   output[w]         =
+      (clamp_8bit(res_a) << 24) |
+      (clamp_8bit(res_r) << 16) |
+      (clamp_8bit(res_g) << 8)  |
+      (clamp_8bit(res_b) << 0);
+}
+#endif
+
+void scaler_argb8888_vert_rows(const struct scaler_ctx *ctx,
+      void *output_, int stride, int first, int last)
 {
    int h, w, y;
    const uint64_t      *input = ctx->scaled.frame;
-   uint32_t           *output = (uint32_t*)output_;
+   uint32_t           *output = (uint32_t*)((uint8_t*)output_
+         + first * stride);
+   const int     input_stride = ctx->scaled.stride >> 3;
+   const int16_t *filter_vert = ctx->vert.filter
+      + first * ctx->vert.filter_stride;
 
-   const int16_t *filter_vert = ctx->vert.filter;
-
-   for (h = 0; h < ctx->out_height; h++,
+   for (h = first; h < last; h++,
          filter_vert += ctx->vert.filter_stride, output += stride >> 2)
    {
       const uint64_t *input_base = input + ctx->vert.filter_pos[h]
-         * (ctx->scaled.stride >> 3);
+         * input_stride;
+
+      w = 0;
 
-      for (w = 0; w < ctx->out_width; w++)
+      /* Rows of the scaled frame are padded to a multiple of 8 pixels,
+       * so only the stores need to stay within out_width */
+#if defined(__AVX2__)
+      for (; w + 8 <= ctx->out_width; w += 8)
       {
          const uint64_t *input_base_y = input_base + w;
-#if defined(__SSE2__)
-         __m128i final;
-         __m128i res = _mm_setzero_si128();
+         __m256i res0                 = _mm256_setzero_si256();
+         __m256i res1                 = _mm256_setzero_si256();
 
-         for (y = 0; (y + 1) < ctx->vert.filter_len; y += 2,
-               input_base_y += (ctx->scaled.stride >> 2))
+         for (y = 0; y < ctx->vert.filter_len; y++,
+               input_base_y += input_stride)
          {
-            __m128i coeff = _mm_set_epi64x(filter_vert[y + 1] * 0x0001000100010001ll, filter_vert[y + 0] * 0x0001000100010001ll);
-            __m128i col   = _mm_set_epi64x(input_base_y[ctx->scaled.stride >> 3], input_base_y[0]);
+            __m256i coeff = _mm256_set1_epi16(filter_vert[y]);
 
-            res           = _mm_adds_epi16(_mm_mulhi_epi16(col, coeff), res);
+            res0 = _mm256_adds_epi16(_mm256_mulhi_epi16(_mm256_loadu_si256(
+                        (const __m256i*)(input_base_y + 0)), coeff), res0);
+            res1 = _mm256_adds_epi16(_mm256_mulhi_epi16(_mm256_loadu_si256(
+                        (const __m256i*)(input_base_y + 4)), coeff), res1);
          }
 
-         for (; y < ctx->vert.filter_len; y++, input_base_y += (ctx->scaled.stride >> 3))
-         {
-            __m128i coeff = _mm_set_epi64x(0, filter_vert[y] * 0x0001000100010001ll);
-            __m128i col   = _mm_set_epi64x(0, input_base_y[0]);
+         res0 = _mm256_srai_epi16(res0, (7 - 2 - 2));
+         res1 = _mm256_srai_epi16(res1, (7 - 2 - 2));
 
-            res           = _mm_adds_epi16(_mm_mulhi_epi16(col, coeff), res);
-         }
+         /* Packing works per 128-bit lane; put the pixels back in order */
+         _mm256_storeu_si256((__m256i*)(output + w),
+               _mm256_permute4x64_epi64(_mm256_packus_epi16(res0, res1),
+                  _MM_SHUFFLE(3, 1, 2, 0)));
+      }
+#elif defined(__SSE2__)
+      for (; w + 8 <= ctx->out_width; w += 8)
+      {
+         const uint64_t *input_base_y = input_base + w;
+         __m128i res0                 = _mm_setzero_si128();
+         __m128i res1                 = _mm_setzero_si128();
+         __m128i res2                 = _mm_setzero_si128();
+         __m128i res3                 = _mm_setzero_si128();
 
-         res       = _mm_adds_epi16(_mm_srli_si128(res, 8), res);
-         res       = _mm_srai_epi16(res, (7 - 2 - 2));
+         for (y = 0; y < ctx->vert.filter_len; y++,
+               input_base_y += input_stride)
+         {
+            __m128i coeff = _mm_set1_epi16(filter_vert[y]);
+
+            res0 = _mm_adds_epi16(_mm_mulhi_epi16(_mm_loadu_si128(
+                        (const __m128i*)(input_base_y + 0)), coeff), res0);
+            res1 = _mm_adds_epi16(_mm_mulhi_epi16(_mm_loadu_si128(
+                        (const __m128i*)(input_base_y + 2)), coeff), res1);
+            res2 = _mm_adds_epi16(_mm_mulhi_epi16(_mm_loadu_si128(
+                        (const __m128i*)(input_base_y + 4)), coeff), res2);
+            res3 = _mm_adds_epi16(_mm_mulhi_epi16(_mm_loadu_si128(
+                        (const __m128i*)(input_base_y + 6)), coeff), res3);
+         }
 
-         final     = _mm_packus_epi16(res, res);
+         res0 = _mm_srai_epi16(res0, (7 - 2 - 2));
+         res1 = _mm_srai_epi16(res1, (7 - 2 - 2));
+         res2 = _mm_srai_epi16(res2, (7 - 2 - 2));
+         res3 = _mm_srai_epi16(res3, (7 - 2 - 2));
 
-         output[w] = _mm_cvtsi128_si32(final);
-#else
-         int16_t res_a = 0;
-         int16_t res_r = 0;
-         int16_t res_g = 0;
-         int16_t res_b = 0;
+         _mm_storeu_si128((__m128i*)(output + w + 0),
+               _mm_packus_epi16(res0, res1));
+         _mm_storeu_si128((__m128i*)(output + w + 4),
+               _mm_packus_epi16(res2, res3));
+      }
+#elif defined(SCALER_NEON)
+      for (; w + 8 <= ctx->out_width; w += 8)
+      {
+         const uint64_t *input_base_y = input_base + w;
+         int16x8_t res0               = vdupq_n_s16(0);
+         int16x8_t res1               = vdupq_n_s16(0);
+         int16x8_t res2               = vdupq_n_s16(0);
+         int16x8_t res3               = vdupq_n_s16(0);
 
          for (y = 0; y < ctx->vert.filter_len; y++,
-               input_base_y += (ctx->scaled.stride >> 3))
+               input_base_y += input_stride)
          {
-            uint64_t col   = *input_base_y;
+            const int16_t *col = (const int16_t*)input_base_y;
+            int16x8_t coeff    = vdupq_n_s16(filter_vert[y]);
+
+            res0 = vqaddq_s16(scaler_neon_mulhi(vld1q_s16(col +  0), coeff), res0);
+            res1 = vqaddq_s16(scaler_neon_mulhi(vld1q_s16(col +  8), coeff), res1);
+            res2 = vqaddq_s16(scaler_neon_mulhi(vld1q_s16(col + 16), coeff), res2);
+            res3 = vqaddq_s16(scaler_neon_mulhi(vld1q_s16(col + 24), coeff), res3);
+         }
 
-            int16_t a      = (col >> 48) & 0xffff;
-            int16_t r      = (col >> 32) & 0xffff;
-            int16_t g      = (col >> 16) & 0xffff;
-            int16_t b      = (col >>  0) & 0xffff;
+         vst1_u8((uint8_t*)(output + w + 0),
+               vqmovun_s16(vshrq_n_s16(res0, (7 - 2 - 2))));
+         vst1_u8((uint8_t*)(output + w + 2),
+               vqmovun_s16(vshrq_n_s16(res1, (7 - 2 - 2))));
+         vst1_u8((uint8_t*)(output + w + 4),
+               vqmovun_s16(vshrq_n_s16(res2, (7 - 2 - 2))));
+         vst1_u8((uint8_t*)(output + w + 6),
+               vqmovun_s16(vshrq_n_s16(res3, (7 - 2 - 2))));
+      }
+#endif
 
-            int16_t coeff  = filter_vert[y];
+      for (; w < ctx->out_width; w++)
+      {
+#if defined(__SSE2__)
+         const uint64_t *input_base_y = input_base + w;
+         __m128i res                  = _mm_setzero_si128();
 
-            res_a         += (a * coeff) >> 16;
-            res_r         += (r * coeff) >> 16;
-            res_g         += (g * coeff) >> 16;
-            res_b         += (b * coeff) >> 16;
-         }
+         for (y = 0; y < ctx->vert.filter_len; y++,
+               input_base_y += input_stride)
+            res = _mm_adds_epi16(_mm_mulhi_epi16(_mm_loadl_epi64(
+                        (const __m128i*)input_base_y),
+                     _mm_set1_epi16(filter_vert[y])), res);
 
-         res_a           >>= (7 - 2 - 2);
-         res_r           >>= (7 - 2 - 2);
-         res_g           >>= (7 - 2 - 2);
-         res_b           >>= (7 - 2 - 2);
+         res       = _mm_srai_epi16(res, (7 - 2 - 2));
+         output[w] = _mm_cvtsi128_si32(_mm_packus_epi16(res, res));
+#elif defined(SCALER_NEON)
+         const uint64_t *input_base_y = input_base + w;
+         int16x8_t res                = vdupq_n_s16(0);
+
+         for (y = 0; y < ctx->vert.filter_len; y++,
+               input_base_y += input_stride)
+            res = vqaddq_s16(scaler_neon_mulhi(vcombine_s16(
+                        vld1_s16((const int16_t*)input_base_y),
+                        vdup_n_s16(0)), vdupq_n_s16(filter_vert[y])), res);
 
-         output[w]         =
-            (clamp_8bit(res_a) << 24) |
-            (clamp_8bit(res_r) << 16) |
-            (clamp_8bit(res_g) << 8)  |
-            (clamp_8bit(res_b) << 0);
+         output[w] = vget_lane_u32(vreinterpret_u32_u8(
+                  vqmovun_s16(vshrq_n_s16(res, (7 - 2 - 2)))), 0);
+#else
+         scaler_argb8888_vert_pixel_c(ctx, input_base, filter_vert,
+               output, w);
 #endif
       }
    }
 }
 
-void scaler_argb8888_horiz(const struct scaler_ctx *ctx, const void *input_, int stride)
+void scaler_argb8888_vert(const struct scaler_ctx *ctx, void *output_, int stride)
 {
-   int h, w, x;
-   const uint32_t *input = (uint32_t*)input_;
-   uint64_t *output      = ctx->scaled.frame;
+   scaler_argb8888_vert_rows(ctx, output_, stride, 0, ctx->out_height);
+}
 
-   for (h = 0; h < ctx->scaled.height; h++, input += stride >> 2,
-         output += ctx->scaled.stride >> 3)
+#if !defined(__SSE2__) && !defined(SCALER_NEON)
+static void scaler_argb8888_horiz_pixel_c(const struct scaler_ctx *ctx,
+      const uint32_t *input, const int16_t *filter_horiz,
+      uint64_t *output, int w)
+{
+   int x;
+   const uint32_t *input_base_x = input + ctx->horiz.filter_pos[w];
+   int16_t res_a                = 0;
+   int16_t res_r                = 0;
+   int16_t res_g                = 0;
+   int16_t res_b                = 0;
+
+   for (x = 0; x < ctx->horiz.filter_len; x++)
    {
-      const int16_t *filter_horiz = ctx->horiz.filter;
+      uint32_t col   = input_base_x[x];
 
-      for (w = 0; w < ctx->scaled.width; w++,
-            filter_horiz += ctx->horiz.filter_stride)
-      {
-         const uint32_t *input_base_x = input + ctx->horiz.filter_pos[w];
-#if defined(__SSE2__)
-         __m128i res = _mm_setzero_si128();
-#ifndef __x86_64__
-         union
-         {
-            uint32_t *u32;
-            uint64_t *u64;
-         } u;
+      int16_t a      = (col >> (24 - 7)) & (0xff << 7);
+      int16_t r      = (col >> (16 - 7)) & (0xff << 7);
+      int16_t g      = (col >> ( 8 - 7)) & (0xff << 7);
+      int16_t b      = (col << ( 0 + 7)) & (0xff << 7);
+
+      int16_t coeff  = filter_horiz[x];
+
+      res_a         += (a * coeff) >> 16;
+      res_r         += (r * coeff) >> 16;
+      res_g         += (g * coeff) >> 16;
+      res_b         += (b * coeff) >> 16;
+   }
+
+   output[w]         = (
+         (uint64_t)res_a  << 48)  |
+      ((uint64_t)res_r << 32)  |
+      ((uint64_t)res_g << 16)  |
+      ((uint64_t)res_b << 0);
+}
 #endif
-         for (x = 0; (x + 1) < ctx->horiz.filter_len; x += 2)
-         {
-            __m128i coeff = _mm_set_epi64x(filter_horiz[x + 1] * 0x0001000100010001ll, filter_horiz[x + 0] * 0x0001000100010001ll);
 
-            __m128i col   = _mm_unpacklo_epi8(_mm_set_epi64x(0,
-                     ((uint64_t)input_base_x[x + 1] << 32) | input_base_x[x + 0]), _mm_setzero_si128());
+#if defined(__SSE2__)
+/* Returns the filtered pixel in both halves of the register,
+ * each half holding the sum of every other tap */
+static INLINE __m128i scaler_argb8888_horiz_sse2(
+      const uint32_t *input_base_x, const int16_t *filter_horiz, int len)
+{
+   int x;
+   __m128i res = _mm_setzero_si128();
 
-            col           = _mm_slli_epi16(col, 7);
-            res           = _mm_adds_epi16(_mm_mulhi_epi16(col, coeff), res);
-         }
+   for (x = 0; (x + 1) < len; x += 2)
+   {
+      __m128i coeff = _mm_unpacklo_epi64(
+            _mm_set1_epi16(filter_horiz[x + 0]),
+            _mm_set1_epi16(filter_horiz[x + 1]));
+      __m128i col   = _mm_unpacklo_epi8(_mm_loadl_epi64(
+               (const __m128i*)(input_base_x + x)), _mm_setzero_si128());
+
+      col           = _mm_slli_epi16(col, 7);
+      res           = _mm_adds_epi16(_mm_mulhi_epi16(col, coeff), res);
+   }
 
-         for (; x < ctx->horiz.filter_len; x++)
-         {
-            __m128i coeff = _mm_set_epi64x(0, filter_horiz[x] * 0x0001000100010001ll);
-            __m128i col   = _mm_unpacklo_epi8(_mm_set_epi32(0, 0, 0, input_base_x[x]), _mm_setzero_si128());
+   for (; x < len; x++)
+   {
+      __m128i coeff = _mm_set1_epi16(filter_horiz[x]);
+      __m128i col   = _mm_unpacklo_epi8(_mm_cvtsi32_si128(
+               input_base_x[x]), _mm_setzero_si128());
 
-            col           = _mm_slli_epi16(col, 7);
-            res           = _mm_adds_epi16(_mm_mulhi_epi16(col, coeff), res);
-         }
+      col           = _mm_slli_epi16(col, 7);
+      res           = _mm_adds_epi16(_mm_mulhi_epi16(col, coeff), res);
+   }
 
-         res              = _mm_adds_epi16(_mm_srli_si128(res, 8), res);
+   return res;
+}
+#elif defined(SCALER_NEON)
+static INLINE int16x8_t scaler_argb8888_horiz_neon(
+      const uint32_t *input_base_x, const int16_t *filter_horiz, int len)
+{
+   int x;
+   int16x8_t res = vdupq_n_s16(0);
 
-#ifdef __x86_64__
-         output[w]        = _mm_cvtsi128_si64(res);
-#else /* 32-bit doesn't have si64. Do it in two steps. */
-         u.u64    = output + w;
-         u.u32[0] = _mm_cvtsi128_si32(res);
-         u.u32[1] = _mm_cvtsi128_si32(_mm_srli_si128(res, 4));
-#endif
-#else
-         int16_t res_a = 0;
-         int16_t res_r = 0;
-         int16_t res_g = 0;
-         int16_t res_b = 0;
+   for (x = 0; (x + 1) < len; x += 2)
+   {
+      int16x8_t coeff = vcombine_s16(
+            vdup_n_s16(filter_horiz[x + 0]),
+            vdup_n_s16(filter_horiz[x + 1]));
 
-         for (x = 0; x < ctx->horiz.filter_len; x++)
-         {
-            uint32_t col   = input_base_x[x];
+      res = vqaddq_s16(scaler_neon_mulhi(
+               scaler_neon_expand(input_base_x + x), coeff), res);
+   }
 
-            int16_t a      = (col >> (24 - 7)) & (0xff << 7);
-            int16_t r      = (col >> (16 - 7)) & (0xff << 7);
-            int16_t g      = (col >> ( 8 - 7)) & (0xff << 7);
-            int16_t b      = (col << ( 0 + 7)) & (0xff << 7);
+   for (; x < len; x++)
+   {
+      /* The pixel lands in both halves; only the low one is weighted */
+      int16x8_t coeff = vcombine_s16(
+            vdup_n_s16(filter_horiz[x]), vdup_n_s16(0));
+      int16x8_t col   = vshlq_n_s16(vreinterpretq_s16_u16(vmovl_u8(
+                  vreinterpret_u8_u32(vdup_n_u32(input_base_x[x])))), 7);
 
-            int16_t coeff  = filter_horiz[x];
+      res = vqaddq_s16(scaler_neon_mulhi(col, coeff), res);
+   }
 
-            res_a         += (a * coeff) >> 16;
-            res_r         += (r * coeff) >> 16;
-            res_g         += (g * coeff) >> 16;
-            res_b         += (b * coeff) >> 16;
-         }
+   return res;
+}
+#endif
+
+void scaler_argb8888_horiz_rows(const struct scaler_ctx *ctx,
+      const void *input_, int stride, int first, int last)
+{
+   int h, w;
+   const uint32_t *input = (const uint32_t*)((const uint8_t*)input_
+         + first * stride);
+   uint64_t *output      = ctx->scaled.frame
+      + first * (ctx->scaled.stride >> 3);
+   const int len         = ctx->horiz.filter_len;
+   const int fstride     = ctx->horiz.filter_stride;
+
+   for (h = first; h < last; h++, input += stride >> 2,
+         output += ctx->scaled.stride >> 3)
+   {
+      const int16_t *filter_horiz = ctx->horiz.filter;
+
+      w = 0;
 
-         output[w]         = (
-               (uint64_t)res_a  << 48)  |
-               ((uint64_t)res_r << 32)  |
-               ((uint64_t)res_g << 16)  |
-               ((uint64_t)res_b << 0);
+#if defined(__SSE2__)
+      for (; w + 4 <= ctx->scaled.width; w += 4,
+            filter_horiz += 4 * fstride)
+      {
+         const int *pos = ctx->horiz.filter_pos + w;
+         __m128i res0   = scaler_argb8888_horiz_sse2(input + pos[0],
+               filter_horiz + 0 * fstride, len);
+         __m128i res1   = scaler_argb8888_horiz_sse2(input + pos[1],
+               filter_horiz + 1 * fstride, len);
+         __m128i res2   = scaler_argb8888_horiz_sse2(input + pos[2],
+               filter_horiz + 2 * fstride, len);
+         __m128i res3   = scaler_argb8888_horiz_sse2(input + pos[3],
+               filter_horiz + 3 * fstride, len);
+
+         /* Fold the halves of two pixels at once */
+         _mm_storeu_si128((__m128i*)(output + w + 0), _mm_adds_epi16(
+                  _mm_unpacklo_epi64(res0, res1),
+                  _mm_unpackhi_epi64(res0, res1)));
+         _mm_storeu_si128((__m128i*)(output + w + 2), _mm_adds_epi16(
+                  _mm_unpacklo_epi64(res2, res3),
+                  _mm_unpackhi_epi64(res2, res3)));
+      }
+#elif defined(SCALER_NEON)
+      for (; w + 4 <= ctx->scaled.width; w += 4,
+            filter_horiz += 4 * fstride)
+      {
+         const int *pos = ctx->horiz.filter_pos + w;
+         int16x8_t res0 = scaler_argb8888_horiz_neon(input + pos[0],
+               filter_horiz + 0 * fstride, len);
+         int16x8_t res1 = scaler_argb8888_horiz_neon(input + pos[1],
+               filter_horiz + 1 * fstride, len);
+         int16x8_t res2 = scaler_argb8888_horiz_neon(input + pos[2],
+               filter_horiz + 2 * fstride, len);
+         int16x8_t res3 = scaler_argb8888_horiz_neon(input + pos[3],
+               filter_horiz + 3 * fstride, len);
+
+         vst1q_s16((int16_t*)(output + w + 0), vqaddq_s16(
+                  vcombine_s16(vget_low_s16(res0),  vget_low_s16(res1)),
+                  vcombine_s16(vget_high_s16(res0), vget_high_s16(res1))));
+         vst1q_s16((int16_t*)(output + w + 2), vqaddq_s16(
+                  vcombine_s16(vget_low_s16(res2),  vget_low_s16(res3)),
+                  vcombine_s16(vget_high_s16(res2), vget_high_s16(res3))));
+      }
+#endif
+
+      for (; w < ctx->scaled.width; w++, filter_horiz += fstride)
+      {
+#if defined(__SSE2__)
+         __m128i res = scaler_argb8888_horiz_sse2(
+               input + ctx->horiz.filter_pos[w], filter_horiz, len);
+         _mm_storel_epi64((__m128i*)(output + w),
+               _mm_adds_epi16(_mm_srli_si128(res, 8), res));
+#elif defined(SCALER_NEON)
+         int16x8_t res = scaler_argb8888_horiz_neon(
+               input + ctx->horiz.filter_pos[w], filter_horiz, len);
+         vst1_s16((int16_t*)(output + w),
+               vqadd_s16(vget_low_s16(res), vget_high_s16(res)));
+#else
+         scaler_argb8888_horiz_pixel_c(ctx, input, filter_horiz,
+               output, w);
 #endif
       }
    }
 }
 
+void scaler_argb8888_horiz(const struct scaler_ctx *ctx, const void *input_, int stride)
+{
+   scaler_argb8888_horiz_rows(ctx, input_, stride, 0, ctx->scaled.height);
+}
+
 void scaler_argb8888_point_special(const struct scaler_ctx *ctx,
       void *output_, const void *input_,
       int out_width, int out_height,
@@ -59,6 +59,8 @@ struct scaler_filter
    int      filter_stride;
 };
 
+struct tpool;
+
 struct scaler_ctx
 {
    void (*scaler_horiz)(const struct scaler_ctx*,
@@ -73,6 +75,9 @@ struct scaler_ctx
    void (*direct_pixconv)(void*, const void*, int, int, int, int);
    struct scaler_filter horiz, vert;   /* ptr alignment */
 
+   /* Worker threads, created by scaler_ctx_gen_filter() */
+   struct tpool *pool;
+
    struct
    {
       uint32_t *frame;
@@ -105,6 +110,10 @@ struct scaler_ctx
    enum scaler_pix_fmt out_fmt;
    enum scaler_type scaler_type;
 
+   /* Threads to split scaling over, counting the calling one.
+    * 0 or 1 scales on the calling thread only. */
+   unsigned threads;
+
    bool unscaled;
 };
 
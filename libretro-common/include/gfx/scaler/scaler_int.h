@@ -35,6 +35,14 @@ void scaler_argb8888_vert(const struct scaler_ctx *ctx,
 void scaler_argb8888_horiz(const struct scaler_ctx *ctx,
       const void *input, int stride);
 
+/* Same as above, for output rows [first, last) only. The
+ * input and output pointers still point at the first row. */
+void scaler_argb8888_vert_rows(const struct scaler_ctx *ctx,
+      void *output, int stride, int first, int last);
+
+void scaler_argb8888_horiz_rows(const struct scaler_ctx *ctx,
+      const void *input, int stride, int first, int last);
+
 void scaler_argb8888_point_special(const struct scaler_ctx *ctx,
       void *output, const void *input,
       int out_width, int out_height,
@@ -44,6 +44,17 @@ void net_http_connection_free(struct http_connection_t *conn);
 
 void net_http_connection_set_user_agent(struct http_connection_t* conn, const char* user_agent);
 
+/* Asks the server to keep the connection open once the
+ * transfer is complete. Finished connections are parked
+ * in a small pool and reused by later keep-alive requests
+ * to the same host, which skips the TCP (and TLS) handshake.
+ *
+ * The pool is not thread safe: only enable this for
+ * connections that are never driven from more than one
+ * thread at a time. */
+void net_http_connection_set_keep_alive(struct http_connection_t *conn,
+      bool keep_alive);
+
 const char *net_http_connection_url(struct http_connection_t *conn);
 
 struct http_t *net_http_new(struct http_connection_t *conn);
@@ -67,9 +78,14 @@ bool net_http_error(struct http_t *state);
  * If the status is not 20x and accept_error is false, it returns NULL. */
 uint8_t* net_http_data(struct http_t *state, size_t* len, bool accept_error);
 
-/* Cleans up all memory. */
+/* Cleans up all memory. Keep-alive connections that
+ * completed successfully are returned to the pool. */
 void net_http_delete(struct http_t *state);
 
+/* Closes all idle keep-alive connections. Call this once no
+ * keep-alive request can be running any more. */
+void net_http_pool_clear(void);
+
 /* URL Encode a string */
 void net_http_urlencode(char **dest, const char *source);
 
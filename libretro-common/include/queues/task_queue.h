@@ -60,6 +60,8 @@ typedef void (*retro_task_queue_msg_t)(retro_task_t *task,
 
 typedef bool (*retro_task_retriever_t)(retro_task_t *task, void *data);
 
+typedef void (*retro_task_trace_t)(retro_task_t *task, bool begin);
+
 typedef bool (*retro_task_condition_fn_t)(void *data);
 
 typedef struct
@@ -252,6 +254,11 @@ void task_queue_deinit(void);
  * This must only be called from the main thread. */
 void task_queue_init(bool threaded, retro_task_queue_msg_t msg_push);
 
+/* Sets a function called by the worker thread right
+ * before (begin = true) and after (begin = false) it
+ * runs a task handler, for profiling. NULL disables it. */
+void task_queue_set_trace_cb(retro_task_trace_t trace);
+
 /* Allocates and inits a new retro_task_t */
 retro_task_t *task_init(void);
 
@@ -0,0 +1,86 @@
+/* Copyright  (C) 2010-2020 The RetroArch team
+ *
+ * ---------------------------------------------------------------------------------------
+ * The following license statement only applies to this file (work_pool.h).
+ * ---------------------------------------------------------------------------------------
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __LIBRETRO_SDK_WORK_POOL_H__
+#define __LIBRETRO_SDK_WORK_POOL_H__
+
+#include <retro_common_api.h>
+
+RETRO_BEGIN_DECLS
+
+/* A pool of worker threads for splitting per-frame work, such as the
+ * rows of an image, into many small tasks.
+ *
+ * Every participant, the calling thread included, starts on its own
+ * contiguous range of tasks, and steals from the ranges of the others
+ * once it runs out. Idle workers spin for a short while before going to
+ * sleep, so back-to-back runs do not pay for waking them up again.
+ *
+ * Without thread support, or on compilers without atomics, a pool has
+ * no workers and runs everything on the calling thread. */
+
+typedef struct work_pool work_pool_t;
+
+/**
+ * (*work_pool_func_t):
+ * @data          : Argument given to work_pool_run().
+ * @index         : Index of the task to run.
+ **/
+typedef void (*work_pool_func_t)(void *data, unsigned index);
+
+/**
+ * work_pool_new:
+ * @threads       : Number of worker threads, not counting the
+ *                  thread that calls work_pool_run().
+ *
+ * Returns: pool, or NULL on failure.
+ **/
+work_pool_t *work_pool_new(unsigned threads);
+
+void work_pool_free(work_pool_t *pool);
+
+/**
+ * work_pool_num_threads:
+ * @pool          : Pool, or NULL.
+ *
+ * Returns: number of threads that take part in a run, counting the
+ * calling thread.
+ **/
+unsigned work_pool_num_threads(work_pool_t *pool);
+
+/**
+ * work_pool_run:
+ * @pool          : Pool, or NULL to run every task on the calling thread.
+ * @func          : Function to call for every task.
+ * @data          : Argument to pass to @func.
+ * @count         : Number of tasks.
+ *
+ * Calls @func once for every index in [0, @count), spread over the
+ * pool, and returns when all calls have returned. A pool runs one
+ * batch at a time, so only one thread may call this on a pool.
+ **/
+void work_pool_run(work_pool_t *pool, work_pool_func_t func,
+      void *data, unsigned count);
+
+RETRO_END_DECLS
+
+#endif
@@ -35,6 +35,7 @@
 #include <string.h>
 #include <retro_common_api.h>
 #include <retro_miscellaneous.h>
+#include <features/features_cpu.h>
 
 enum
 {
@@ -53,6 +54,13 @@ enum
    T_CHUNK
 };
 
+/* Maximum number of idle keep-alive connections */
+#define HTTP_POOL_SIZE              8
+/* Idle connections older than this are closed
+ * rather than reused - most servers drop idle
+ * keep-alive connections after a few seconds */
+#define HTTP_POOL_IDLE_TIMEOUT_USEC (15 * 1000000)
+
 struct http_socket_state_t
 {
    void *ssl_ctx;
@@ -60,17 +68,39 @@ struct http_socket_state_t
    bool ssl;
 };
 
+struct http_pool_entry_t
+{
+   char *domain;
+   struct http_socket_state_t sock_state; /* ptr alignment */
+   retro_time_t idle_since;
+   int port;
+};
+
+struct http_request_buf_t
+{
+   char *data;
+   size_t len;
+   size_t size;
+   bool error;
+};
+
 struct http_t
 {
    char *data;
+   char *domain;
+   char *request;
    struct http_socket_state_t sock_state; /* ptr alignment */
    size_t pos;
    size_t len;
    size_t buflen;
+   size_t request_len;
    int status;
+   int port;
    char part;
    char bodytype;
    bool error;
+   bool keep_alive;
+   bool reused;
 };
 
 struct http_connection_t
@@ -85,8 +115,18 @@ struct http_connection_t
    char* useragentcopy;
    struct http_socket_state_t sock_state; /* ptr alignment */
    int port;
+   bool keep_alive;
 };
 
+/* Idle keep-alive connections, see net_http_connection_set_keep_alive()
+ * > There is no lock: this is only safe as long as every connection
+ *   that enables keep-alive is used from a single thread at a time.
+ *   In RetroArch only the HTTP tasks do, and they all run on the
+ *   task queue thread
+ * > net_http_pool_clear() must only be called once nothing else can
+ *   start or finish a request, e.g. after task_queue_deinit() */
+static struct http_pool_entry_t http_pool[HTTP_POOL_SIZE];
+
 /* URL Encode a string
    caller is responsible for deleting the destination buffer */
 void net_http_urlencode(char **dest, const char *source)
@@ -412,16 +452,17 @@ void net_http_urlencode_full(char *dest,
    free (tmp);
 }
 
-static int net_http_new_socket(struct http_connection_t *conn)
+static int net_http_new_socket(struct http_socket_state_t *sock_state,
+      const char *domain, int port)
 {
    int ret;
    struct addrinfo *addr = NULL, *next_addr = NULL;
    int fd                = socket_init(
-         (void**)&addr, conn->port, conn->domain, SOCKET_TYPE_STREAM);
+         (void**)&addr, port, domain, SOCKET_TYPE_STREAM);
 #ifdef HAVE_SSL
-   if (conn->sock_state.ssl)
+   if (sock_state->ssl)
    {
-      if (!(conn->sock_state.ssl_ctx = ssl_socket_init(fd, conn->domain)))
+      if (!(sock_state->ssl_ctx = ssl_socket_init(fd, domain)))
          return -1;
    }
 #endif
@@ -431,15 +472,15 @@ static int net_http_new_socket(struct http_connection_t *conn)
    while (fd >= 0)
    {
 #ifdef HAVE_SSL
-      if (conn->sock_state.ssl)
+      if (sock_state->ssl)
       {
-         ret = ssl_socket_connect(conn->sock_state.ssl_ctx,
+         ret = ssl_socket_connect(sock_state->ssl_ctx,
                (void*)next_addr, true, true);
 
          if (ret >= 0)
             break;
 
-         ssl_socket_close(conn->sock_state.ssl_ctx);
+         ssl_socket_close(sock_state->ssl_ctx);
       }
       else
 #endif
@@ -458,32 +499,208 @@ static int net_http_new_socket(struct http_connection_t *conn)
    if (addr)
       freeaddrinfo_retro(addr);
 
-   conn->sock_state.fd = fd;
+   sock_state->fd = fd;
 
    return fd;
 }
 
-static void net_http_send_str(
-      struct http_socket_state_t *sock_state, bool *error, const char *text)
+static void net_http_close_socket(struct http_socket_state_t *sock_state)
 {
-   size_t text_size;
-   if (*error)
+   if (sock_state->fd < 0)
       return;
-   text_size = strlen(text);
+
+   socket_close(sock_state->fd);
+#ifdef HAVE_SSL
+   if (sock_state->ssl && sock_state->ssl_ctx)
+   {
+      ssl_socket_free(sock_state->ssl_ctx);
+      sock_state->ssl_ctx = NULL;
+   }
+#endif
+   sock_state->fd = -1;
+}
+
+static bool net_http_send_data(
+      struct http_socket_state_t *sock_state, const char *data, size_t len)
+{
 #ifdef HAVE_SSL
    if (sock_state->ssl)
+      return ssl_socket_send_all_blocking(
+            sock_state->ssl_ctx, data, len, true);
+#endif
+   return socket_send_all_blocking(sock_state->fd, data, len, true);
+}
+
+static void net_http_request_append(
+      struct http_request_buf_t *request, const char *text)
+{
+   size_t text_size;
+
+   if (request->error)
+      return;
+
+   text_size = strlen(text);
+
+   if (request->len + text_size + 1 > request->size)
    {
-      if (!ssl_socket_send_all_blocking(
-               sock_state->ssl_ctx, text, text_size, true))
-         *error = true;
+      size_t size = request->size ? request->size : 512;
+      char *tmp   = NULL;
+
+      while (size < request->len + text_size + 1)
+         size *= 2;
+
+      if (!(tmp = (char*)realloc(request->data, size)))
+      {
+         request->error = true;
+         return;
+      }
+
+      request->data = tmp;
+      request->size = size;
    }
+
+   memcpy(request->data + request->len, text, text_size + 1);
+   request->len += text_size;
+}
+
+/* An idle keep-alive connection must have nothing
+ * to read; EOF means the server hung up and any
+ * other data would be a protocol error */
+static bool net_http_pool_entry_is_alive(struct http_pool_entry_t *entry)
+{
+   retro_time_t now = cpu_features_get_time_usec();
+
+   if (now - entry->idle_since > HTTP_POOL_IDLE_TIMEOUT_USEC)
+      return false;
+
+   if (!entry->sock_state.ssl)
+   {
+      uint8_t buf[16];
+      bool error     = false;
+      ssize_t newlen = socket_receive_all_nonblocking(
+            entry->sock_state.fd, &error, buf, sizeof(buf));
+
+      if (newlen < 0)
+         return false;
+
+      /* Trailing CRLF after a chunked body is harmless */
+      while (newlen > 0)
+      {
+         if (buf[newlen - 1] != '\r' && buf[newlen - 1] != '\n')
+            return false;
+         newlen--;
+      }
+   }
+#ifdef MSG_PEEK
    else
+   {
+      /* Reading would consume TLS records, so only peek
+       * at the raw socket. Anything pending (most likely
+       * a close_notify alert) means it cannot be reused */
+      char c;
+      ssize_t ret = recv(entry->sock_state.fd, &c, 1, MSG_PEEK);
+
+      if (ret >= 0 || !isagain((int)ret))
+         return false;
+   }
+#endif
+
+   return true;
+}
+
+static void net_http_pool_entry_free(struct http_pool_entry_t *entry)
+{
+   net_http_close_socket(&entry->sock_state);
+   free(entry->domain);
+   entry->domain = NULL;
+}
+
+/* Takes a live idle connection to the given host
+ * out of the pool, if there is one */
+static bool net_http_pool_acquire(const char *domain, int port, bool ssl,
+      struct http_socket_state_t *sock_state)
+{
+   size_t i;
+
+   for (i = 0; i < HTTP_POOL_SIZE; i++)
+   {
+      struct http_pool_entry_t *entry = &http_pool[i];
+
+      if (     !entry->domain
+            || entry->port           != port
+            || entry->sock_state.ssl != ssl
+            || !string_is_equal_case_insensitive(entry->domain, domain))
+         continue;
+
+      if (!net_http_pool_entry_is_alive(entry))
+      {
+         net_http_pool_entry_free(entry);
+         continue;
+      }
+
+      *sock_state   = entry->sock_state;
+      free(entry->domain);
+      entry->domain = NULL;
+      return true;
+   }
+
+   return false;
+}
+
+/* Hands a connection back to the pool. When the pool
+ * is full, the connection that has been idle for the
+ * longest time is closed to make room */
+static void net_http_pool_release(const char *domain, int port,
+      struct http_socket_state_t *sock_state)
+{
+   size_t i;
+   struct http_pool_entry_t *slot = NULL;
+
+#ifndef MSG_PEEK
+   /* A stale TLS connection cannot be detected
+    * without peeking at the socket, so don't pool it */
+   if (sock_state->ssl)
+   {
+      net_http_close_socket(sock_state);
+      return;
+   }
 #endif
+
+   for (i = 0; i < HTTP_POOL_SIZE; i++)
    {
-      if (!socket_send_all_blocking(
-               sock_state->fd, text, text_size, true))
-         *error = true;
+      struct http_pool_entry_t *entry = &http_pool[i];
+
+      if (!entry->domain)
+      {
+         slot = entry;
+         break;
+      }
+
+      if (!slot || entry->idle_since < slot->idle_since)
+         slot = entry;
    }
+
+   if (slot->domain)
+      net_http_pool_entry_free(slot);
+
+   if (!(slot->domain = strdup(domain)))
+   {
+      net_http_close_socket(sock_state);
+      return;
+   }
+
+   slot->sock_state = *sock_state;
+   slot->port       = port;
+   slot->idle_since = cpu_features_get_time_usec();
+}
+
+void net_http_pool_clear(void)
+{
+   size_t i;
+
+   for (i = 0; i < HTTP_POOL_SIZE; i++)
+      if (http_pool[i].domain)
+         net_http_pool_entry_free(&http_pool[i]);
 }
 
 struct http_connection_t *net_http_connection_new(const char *url,
@@ -510,6 +727,7 @@ struct http_connection_t *net_http_connection_new(const char *url,
    conn->postdatacopy      = NULL;
    conn->useragentcopy     = NULL;
    conn->port              = 0;
+   conn->keep_alive        = false;
    conn->sock_state.fd     = 0;
    conn->sock_state.ssl    = false;
    conn->sock_state.ssl_ctx= NULL;
@@ -677,43 +895,61 @@ void net_http_connection_set_user_agent(
    conn->useragentcopy = user_agent ? strdup(user_agent) : NULL;
 }
 
+void net_http_connection_set_keep_alive(
+      struct http_connection_t *conn, bool keep_alive)
+{
+   conn->keep_alive = keep_alive;
+}
+
 const char *net_http_connection_url(struct http_connection_t *conn)
 {
    return conn->urlcopy;
 }
 
-struct http_t *net_http_new(struct http_connection_t *conn)
+static bool net_http_reconnect(struct http_t *state)
 {
-   bool error            = false;
-   int fd                = -1;
-   struct http_t *state  = NULL;
+   net_http_close_socket(&state->sock_state);
 
-   if (!conn)
-      goto error;
+   state->reused = false;
+   state->error  = false;
 
-   fd = net_http_new_socket(conn);
+   if (net_http_new_socket(&state->sock_state,
+            state->domain, state->port) < 0)
+      return false;
 
-   if (fd < 0)
-      goto error;
+   return net_http_send_data(&state->sock_state,
+         state->request, state->request_len);
+}
+
+struct http_t *net_http_new(struct http_connection_t *conn)
+{
+   struct http_request_buf_t request = {0};
+   bool reused                       = false;
+   int fd                            = -1;
+   struct http_t *state              = NULL;
 
-   error = false;
+   if (!conn)
+      goto error;
 
-   /* This is a bit lazy, but it works. */
+   /* Build the whole request up front, so it goes out
+    * in a single send and can be replayed if a pooled
+    * connection turns out to be stale.
+    * This is a bit lazy, but it works. */
    if (conn->methodcopy)
    {
-      net_http_send_str(&conn->sock_state, &error, conn->methodcopy);
-      net_http_send_str(&conn->sock_state, &error, " /");
+      net_http_request_append(&request, conn->methodcopy);
+      net_http_request_append(&request, " /");
    }
    else
    {
-      net_http_send_str(&conn->sock_state, &error, "GET /");
+      net_http_request_append(&request, "GET /");
    }
 
-   net_http_send_str(&conn->sock_state, &error, conn->location);
-   net_http_send_str(&conn->sock_state, &error, " HTTP/1.1\r\n");
+   net_http_request_append(&request, conn->location);
+   net_http_request_append(&request, " HTTP/1.1\r\n");
 
-   net_http_send_str(&conn->sock_state, &error, "Host: ");
-   net_http_send_str(&conn->sock_state, &error, conn->domain);
+   net_http_request_append(&request, "Host: ");
+   net_http_request_append(&request, conn->domain);
 
    if (!conn->port)
    {
@@ -722,17 +958,17 @@ struct http_t *net_http_new(struct http_connection_t *conn)
       portstr[0] = '\0';
 
       snprintf(portstr, sizeof(portstr), ":%i", conn->port);
-      net_http_send_str(&conn->sock_state, &error, portstr);
+      net_http_request_append(&request, portstr);
    }
 
-   net_http_send_str(&conn->sock_state, &error, "\r\n");
+   net_http_request_append(&request, "\r\n");
 
    /* This is not being set anywhere yet */
    if (conn->contenttypecopy)
    {
-      net_http_send_str(&conn->sock_state, &error, "Content-Type: ");
-      net_http_send_str(&conn->sock_state, &error, conn->contenttypecopy);
-      net_http_send_str(&conn->sock_state, &error, "\r\n");
+      net_http_request_append(&request, "Content-Type: ");
+      net_http_request_append(&request, conn->contenttypecopy);
+      net_http_request_append(&request, "\r\n");
    }
 
    if (conn->methodcopy && (string_is_equal(conn->methodcopy, "POST")))
@@ -744,10 +980,10 @@ struct http_t *net_http_new(struct http_connection_t *conn)
          goto error;
 
       if (!conn->contenttypecopy)
-         net_http_send_str(&conn->sock_state, &error,
+         net_http_request_append(&request,
                "Content-Type: application/x-www-form-urlencoded\r\n");
 
-      net_http_send_str(&conn->sock_state, &error, "Content-Length: ");
+      net_http_request_append(&request, "Content-Length: ");
 
       post_len = strlen(conn->postdatacopy);
 #ifdef _WIN32
@@ -762,43 +998,76 @@ struct http_t *net_http_new(struct http_connection_t *conn)
 
       len_str[len] = '\0';
 
-      net_http_send_str(&conn->sock_state, &error, len_str);
-      net_http_send_str(&conn->sock_state, &error, "\r\n");
+      net_http_request_append(&request, len_str);
+      net_http_request_append(&request, "\r\n");
 
       free(len_str);
    }
 
-   net_http_send_str(&conn->sock_state, &error, "User-Agent: ");
+   net_http_request_append(&request, "User-Agent: ");
    if (conn->useragentcopy)
-      net_http_send_str(&conn->sock_state, &error, conn->useragentcopy);
+      net_http_request_append(&request, conn->useragentcopy);
    else
-      net_http_send_str(&conn->sock_state, &error, "libretro");
-   net_http_send_str(&conn->sock_state, &error, "\r\n");
+      net_http_request_append(&request, "libretro");
+   net_http_request_append(&request, "\r\n");
 
-   net_http_send_str(&conn->sock_state, &error, "Connection: close\r\n");
-   net_http_send_str(&conn->sock_state, &error, "\r\n");
+   if (conn->keep_alive)
+      net_http_request_append(&request, "Connection: keep-alive\r\n");
+   else
+      net_http_request_append(&request, "Connection: close\r\n");
+   net_http_request_append(&request, "\r\n");
 
    if (conn->methodcopy && (string_is_equal(conn->methodcopy, "POST")))
-      net_http_send_str(&conn->sock_state, &error, conn->postdatacopy);
+      net_http_request_append(&request, conn->postdatacopy);
 
-   if (error)
+   if (request.error)
       goto error;
 
-   state             = (struct http_t*)malloc(sizeof(struct http_t));
-   state->sock_state = conn->sock_state;
-   state->status     = -1;
-   state->data       = NULL;
-   state->part       = P_HEADER_TOP;
-   state->bodytype   = T_FULL;
-   state->error      = false;
-   state->pos        = 0;
-   state->len        = 0;
-   state->buflen     = 512;
-   state->data       = (char*)malloc(state->buflen);
-
-   if (!state->data)
+   if (conn->keep_alive)
+      reused = net_http_pool_acquire(conn->domain, conn->port,
+            conn->sock_state.ssl, &conn->sock_state);
+
+   fd = reused
+      ? conn->sock_state.fd
+      : net_http_new_socket(&conn->sock_state, conn->domain, conn->port);
+
+   if (fd < 0)
       goto error;
 
+   state              = (struct http_t*)malloc(sizeof(struct http_t));
+   if (!state)
+      goto error;
+
+   state->sock_state  = conn->sock_state;
+   state->domain      = strdup(conn->domain);
+   state->request     = request.data;
+   state->request_len = request.len;
+   state->port        = conn->port;
+   state->keep_alive  = conn->keep_alive;
+   state->reused      = reused;
+   state->status      = -1;
+   state->data        = NULL;
+   state->part        = P_HEADER_TOP;
+   state->bodytype    = T_FULL;
+   state->error       = false;
+   state->pos         = 0;
+   state->len         = 0;
+   state->buflen      = 512;
+   state->data        = (char*)malloc(state->buflen);
+   request.data       = NULL;
+
+   if (!state->data || !state->domain)
+      goto error;
+
+   if (!net_http_send_data(&state->sock_state,
+            state->request, state->request_len))
+   {
+      /* The server may have dropped a pooled
+       * connection - retry once on a fresh one */
+      if (!state->reused || !net_http_reconnect(state))
+         goto error;
+   }
+
    return state;
 
 error:
@@ -812,11 +1081,17 @@ error:
       conn->contenttypecopy = NULL;
       conn->postdatacopy = NULL;
    }
+   if (state)
+      fd = state->sock_state.fd;
 #ifdef HAVE_SSL
-   if (conn && conn->sock_state.ssl && conn->sock_state.ssl_ctx && fd >= 0)
+   if (conn && conn->sock_state.ssl && fd >= 0)
    {
-      ssl_socket_close(conn->sock_state.ssl_ctx);
-      ssl_socket_free(conn->sock_state.ssl_ctx);
+      void *ssl_ctx = state ? state->sock_state.ssl_ctx : conn->sock_state.ssl_ctx;
+      if (ssl_ctx)
+      {
+         ssl_socket_close(ssl_ctx);
+         ssl_socket_free(ssl_ctx);
+      }
       conn->sock_state.ssl_ctx = NULL;
    }
 #else
@@ -824,7 +1099,13 @@ error:
       socket_close(fd);
 #endif
    if (state)
+   {
+      free(state->data);
+      free(state->domain);
+      free(state->request);
       free(state);
+   }
+   free(request.data);
    return NULL;
 }
 
@@ -861,7 +1142,16 @@ bool net_http_update(struct http_t *state, size_t* progress, size_t* total)
       }
 
       if (newlen < 0)
+      {
+         /* A pooled connection the server already closed
+          * fails before the first response byte arrives */
+         if (     state->reused
+               && state->part == P_HEADER_TOP
+               && state->pos  == 0
+               && net_http_reconnect(state))
+            return false;
          goto fail;
+      }
 
       if (state->pos + newlen >= state->buflen - 64)
       {
@@ -885,14 +1175,25 @@ bool net_http_update(struct http_t *state, size_t* progress, size_t* total)
 
          if (state->part == P_HEADER_TOP)
          {
-            if (strncmp(state->data, "HTTP/1.", STRLEN_CONST("HTTP/1."))!=0)
-               goto fail;
-            state->status = (int)strtoul(state->data 
-                  + STRLEN_CONST("HTTP/1.1 "), NULL, 10);
-            state->part   = P_HEADER;
+            /* Skip stray CRLFs left over from a previous
+             * response on a kept-alive connection */
+            if (state->data[0] != '\0')
+            {
+               if (strncmp(state->data, "HTTP/1.", STRLEN_CONST("HTTP/1."))!=0)
+                  goto fail;
+               /* HTTP/1.0 servers close the connection by default */
+               if (state->data[STRLEN_CONST("HTTP/1.")] == '0')
+                  state->keep_alive = false;
+               state->status = (int)strtoul(state->data 
+                     + STRLEN_CONST("HTTP/1.1 "), NULL, 10);
+               state->part   = P_HEADER;
+            }
          }
          else
          {
+            if (string_is_equal_case_insensitive(state->data,
+                     "Connection: close"))
+               state->keep_alive = false;
             if (!strncmp(state->data, "Content-Length: ",
                      STRLEN_CONST("Content-Length: ")))
             {
@@ -1097,15 +1398,18 @@ void net_http_delete(struct http_t *state)
 
    if (state->sock_state.fd >= 0)
    {
-      socket_close(state->sock_state.fd);
-#ifdef HAVE_SSL
-      if (state->sock_state.ssl && state->sock_state.ssl_ctx)
-      {
-         ssl_socket_free(state->sock_state.ssl_ctx);
-         state->sock_state.ssl_ctx = NULL;
-      }
-#endif
+      /* Only a response whose end was determined from
+       * its framing leaves the connection reusable */
+      if (     state->keep_alive
+            && state->part     == P_DONE
+            && state->bodytype != T_FULL)
+         net_http_pool_release(state->domain, state->port,
+               &state->sock_state);
+      else
+         net_http_close_socket(&state->sock_state);
    }
+   free(state->domain);
+   free(state->request);
    free(state);
 }
 
@@ -59,6 +59,7 @@ struct retro_task_impl
 
 /* TODO/FIXME - static globals */
 static retro_task_queue_msg_t msg_push_bak  = NULL;
+static retro_task_trace_t task_trace        = NULL;
 static task_queue_t tasks_running           = {NULL, NULL};
 static task_queue_t tasks_finished          = {NULL, NULL};
 
@@ -504,7 +505,11 @@ static void threaded_worker(void *userdata)
 
       slock_unlock(running_lock);
 
+      if (task_trace)
+         task_trace(task, true);
       task->handler(task);
+      if (task_trace)
+         task_trace(task, false);
 
       slock_lock(property_lock);
       finished = task->finished;
@@ -627,6 +632,11 @@ void task_queue_init(bool threaded, retro_task_queue_msg_t msg_push)
    impl_current->init();
 }
 
+void task_queue_set_trace_cb(retro_task_trace_t trace)
+{
+   task_trace = trace;
+}
+
 void task_queue_set_threaded(void)
 {
    task_threaded_enable = true;
@@ -0,0 +1,336 @@
+/* Copyright  (C) 2010-2020 The RetroArch team
+ *
+ * ---------------------------------------------------------------------------------------
+ * The following license statement only applies to this file (work_pool.c).
+ * ---------------------------------------------------------------------------------------
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <boolean.h>
+
+#ifdef HAVE_THREADS
+#include <rthreads/rthreads.h>
+#endif
+#include <rthreads/work_pool.h>
+
+#if defined(_MSC_VER) && _MSC_VER >= 1400
+#include <windows.h>
+#endif
+
+#if defined(HAVE_THREADS) && defined(__GNUC__) && defined(__ATOMIC_SEQ_CST)
+#define WORK_POOL_ATOMICS
+typedef unsigned work_pool_atomic_t;
+#define WORK_POOL_LOAD(p)         __atomic_load_n((p), __ATOMIC_SEQ_CST)
+#define WORK_POOL_STORE(p, v)     __atomic_store_n((p), (v), __ATOMIC_SEQ_CST)
+#define WORK_POOL_FETCH_ADD(p, v) __atomic_fetch_add((p), (v), __ATOMIC_SEQ_CST)
+#define WORK_POOL_FETCH_SUB(p, v) __atomic_fetch_sub((p), (v), __ATOMIC_SEQ_CST)
+#if defined(__i386__) || defined(__x86_64__)
+#define WORK_POOL_RELAX()         __builtin_ia32_pause()
+#else
+#define WORK_POOL_RELAX()         __asm__ __volatile__("" ::: "memory")
+#endif
+#elif defined(HAVE_THREADS) && defined(_MSC_VER) && _MSC_VER >= 1400
+#define WORK_POOL_ATOMICS
+typedef volatile LONG work_pool_atomic_t;
+#define WORK_POOL_LOAD(p)         ((unsigned)InterlockedCompareExchange((p), 0, 0))
+#define WORK_POOL_STORE(p, v)     InterlockedExchange((p), (LONG)(v))
+#define WORK_POOL_FETCH_ADD(p, v) ((unsigned)InterlockedExchangeAdd((p), (LONG)(v)))
+#define WORK_POOL_FETCH_SUB(p, v) ((unsigned)InterlockedExchangeAdd((p), -(LONG)(v)))
+#define WORK_POOL_RELAX()         YieldProcessor()
+#endif
+
+/* How long an idle thread busy-waits before it goes to sleep.
+ * Per-frame batches usually arrive back to back, and a thread that
+ * is still spinning starts on the next one without a wakeup. */
+#define WORK_POOL_SPIN_COUNT 4096
+
+/* Keeps the task counters of different threads apart,
+ * so claiming a task does not bounce cachelines around. */
+#define WORK_POOL_CACHELINE  64
+
+struct work_pool;
+
+typedef struct work_pool_slot
+{
+   struct work_pool *pool;
+#ifdef WORK_POOL_ATOMICS
+   work_pool_atomic_t next;  /* Next unclaimed task in this range. */
+#else
+   unsigned next;
+#endif
+   unsigned end;             /* One past the last task in this range. */
+   unsigned index;
+   char pad[WORK_POOL_CACHELINE];
+} work_pool_slot_t;
+
+struct work_pool
+{
+   work_pool_slot_t *slots;  /* One task range per participant,
+                                the calling thread is slot 0. */
+#ifdef WORK_POOL_ATOMICS
+   sthread_t **threads;
+   slock_t *lock;
+   scond_t *wake_cond;       /* Signalled when a batch starts. */
+   scond_t *done_cond;       /* Signalled when the last worker is done. */
+   work_pool_atomic_t generation;
+   work_pool_atomic_t pending;  /* Workers still busy with the batch. */
+   work_pool_atomic_t sleeping; /* Workers waiting on wake_cond. */
+   bool stop;
+#endif
+   work_pool_func_t func;
+   void *data;
+   unsigned num;             /* Participants, the calling thread included. */
+};
+
+/* Runs tasks from the participant's own range first,
+ * then steals whatever is left in the ranges of the others. */
+static void work_pool_drain(struct work_pool *pool, unsigned self)
+{
+   unsigned i;
+   unsigned num = pool->num;
+
+   for (i = 0; i < num; i++)
+   {
+      unsigned victim        = self + i;
+      work_pool_slot_t *slot = NULL;
+
+      if (victim >= num)
+         victim -= num;
+      slot = &pool->slots[victim];
+
+      for (;;)
+      {
+#ifdef WORK_POOL_ATOMICS
+         unsigned idx = WORK_POOL_FETCH_ADD(&slot->next, 1);
+#else
+         unsigned idx = slot->next++;
+#endif
+         if (idx >= slot->end)
+            break;
+         pool->func(pool->data, idx);
+      }
+   }
+}
+
+#ifdef WORK_POOL_ATOMICS
+static void work_pool_worker(void *userdata)
+{
+   work_pool_slot_t *slot = (work_pool_slot_t*)userdata;
+   struct work_pool *pool = slot->pool;
+   unsigned seen          = 0;
+
+   for (;;)
+   {
+      unsigned spins = WORK_POOL_SPIN_COUNT;
+
+      while (WORK_POOL_LOAD(&pool->generation) == seen && spins--)
+         WORK_POOL_RELAX();
+
+      if (WORK_POOL_LOAD(&pool->generation) == seen)
+      {
+         slock_lock(pool->lock);
+         WORK_POOL_FETCH_ADD(&pool->sleeping, 1);
+         while (WORK_POOL_LOAD(&pool->generation) == seen)
+            scond_wait(pool->wake_cond, pool->lock);
+         WORK_POOL_FETCH_SUB(&pool->sleeping, 1);
+         slock_unlock(pool->lock);
+      }
+
+      seen = WORK_POOL_LOAD(&pool->generation);
+      if (pool->stop)
+         break;
+
+      work_pool_drain(pool, slot->index);
+
+      /* The caller checks pending under the lock before it sleeps,
+       * so taking the lock here means the signal cannot get lost. */
+      if (WORK_POOL_FETCH_SUB(&pool->pending, 1) == 1)
+      {
+         slock_lock(pool->lock);
+         scond_signal(pool->done_cond);
+         slock_unlock(pool->lock);
+      }
+   }
+}
+#endif
+
+work_pool_t *work_pool_new(unsigned threads)
+{
+   unsigned i;
+   struct work_pool *pool = (struct work_pool*)calloc(1, sizeof(*pool));
+
+   if (!pool)
+      return NULL;
+
+#ifndef WORK_POOL_ATOMICS
+   threads = 0;
+#endif
+
+   pool->num   = threads + 1;
+   pool->slots = (work_pool_slot_t*)calloc(pool->num, sizeof(*pool->slots));
+   if (!pool->slots)
+   {
+      free(pool);
+      return NULL;
+   }
+
+   for (i = 0; i < pool->num; i++)
+   {
+      pool->slots[i].pool  = pool;
+      pool->slots[i].index = i;
+   }
+
+#ifdef WORK_POOL_ATOMICS
+   if (!threads)
+      return pool;
+
+   pool->lock      = slock_new();
+   pool->wake_cond = scond_new();
+   pool->done_cond = scond_new();
+   pool->threads   = (sthread_t**)calloc(threads, sizeof(*pool->threads));
+
+   if (!pool->lock || !pool->wake_cond || !pool->done_cond || !pool->threads)
+      goto error;
+
+   for (i = 0; i < threads; i++)
+   {
+      if (!(pool->threads[i] = sthread_create(
+                  work_pool_worker, &pool->slots[i + 1])))
+      {
+         /* Keep the workers that did start */
+         pool->num = i + 1;
+         break;
+      }
+   }
+
+   return pool;
+
+error:
+   work_pool_free(pool);
+   return NULL;
+#else
+   return pool;
+#endif
+}
+
+void work_pool_free(work_pool_t *pool)
+{
+   if (!pool)
+      return;
+
+#ifdef WORK_POOL_ATOMICS
+   if (pool->threads)
+   {
+      unsigned i;
+
+      if (pool->lock)
+      {
+         slock_lock(pool->lock);
+         pool->stop = true;
+         WORK_POOL_FETCH_ADD(&pool->generation, 1);
+         scond_broadcast(pool->wake_cond);
+         slock_unlock(pool->lock);
+      }
+
+      for (i = 0; i + 1 < pool->num; i++)
+         if (pool->threads[i])
+            sthread_join(pool->threads[i]);
+      free(pool->threads);
+   }
+
+   if (pool->done_cond)
+      scond_free(pool->done_cond);
+   if (pool->wake_cond)
+      scond_free(pool->wake_cond);
+   if (pool->lock)
+      slock_free(pool->lock);
+#endif
+
+   free(pool->slots);
+   free(pool);
+}
+
+unsigned work_pool_num_threads(work_pool_t *pool)
+{
+   return pool ? pool->num : 1;
+}
+
+void work_pool_run(work_pool_t *pool, work_pool_func_t func,
+      void *data, unsigned count)
+{
+   unsigned i;
+
+   if (!pool || pool->num < 2 || count < 2)
+   {
+      for (i = 0; i < count; i++)
+         func(data, i);
+      return;
+   }
+
+   pool->func = func;
+   pool->data = data;
+
+   for (i = 0; i < pool->num; i++)
+   {
+      pool->slots[i].end  = (unsigned)((uint64_t)count
+            * (i + 1) / pool->num);
+#ifdef WORK_POOL_ATOMICS
+      WORK_POOL_STORE(&pool->slots[i].next, (unsigned)(
+               (uint64_t)count * i / pool->num));
+#else
+      pool->slots[i].next = (unsigned)(
+            (uint64_t)count * i / pool->num);
+#endif
+   }
+
+#ifdef WORK_POOL_ATOMICS
+   {
+      unsigned spins = WORK_POOL_SPIN_COUNT;
+
+      /* A worker only moves on to the next batch once it has left
+       * this one, so the ranges above are never reset under it. */
+      WORK_POOL_STORE(&pool->pending, pool->num - 1);
+      WORK_POOL_FETCH_ADD(&pool->generation, 1);
+
+      if (WORK_POOL_LOAD(&pool->sleeping))
+      {
+         slock_lock(pool->lock);
+         scond_broadcast(pool->wake_cond);
+         slock_unlock(pool->lock);
+      }
+
+      work_pool_drain(pool, 0);
+
+      while (WORK_POOL_LOAD(&pool->pending) && spins--)
+         WORK_POOL_RELAX();
+
+      if (WORK_POOL_LOAD(&pool->pending))
+      {
+         slock_lock(pool->lock);
+         while (WORK_POOL_LOAD(&pool->pending))
+            scond_wait(pool->done_cond, pool->lock);
+         slock_unlock(pool->lock);
+      }
+   }
+#else
+   work_pool_drain(pool, 0);
+#endif
+}
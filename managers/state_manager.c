@@ -219,7 +219,7 @@ static size_t find_same(const uint16_t *a, const uint16_t *b)
 
 /* Returns the maximum compressed size of a savestate.
  * It is very likely to compress to far less. */
-static size_t state_manager_raw_maxsize(size_t uncomp)
+size_t state_manager_raw_maxsize(size_t uncomp)
 {
    /* bytes covered by a compressed block */
    const int maxcblkcover = UINT16_MAX * sizeof(uint16_t);
@@ -235,7 +235,7 @@ static size_t state_manager_raw_maxsize(size_t uncomp)
  * See state_manager_raw_compress for information about this.
  * When you're done with it, send it to free().
  */
-static void *state_manager_raw_alloc(size_t len, uint16_t uniq)
+void *state_manager_raw_alloc(size_t len, uint16_t uniq)
 {
    size_t  len16 = (len + sizeof(uint16_t) - 1) & -sizeof(uint16_t);
    uint16_t *ret = (uint16_t*)calloc(len16 + sizeof(uint16_t) * 4 + 16, 1);
@@ -264,7 +264,7 @@ static void *state_manager_raw_alloc(size_t len, uint16_t uniq)
  * 'patch' must be size 'state_manager_raw_maxsize(len)' or more.
  * Returns the number of bytes actually written to 'patch'.
  */
-static size_t state_manager_raw_compress(const void *src,
+size_t state_manager_raw_compress(const void *src,
       const void *dst, size_t len, void *patch)
 {
    const uint16_t  *old16 = (const uint16_t*)src;
@@ -331,7 +331,7 @@ static size_t state_manager_raw_compress(const void *src,
  * If the given arguments do not match a previous call to
  * state_manager_raw_compress(), anything at all can happen.
  */
-static void state_manager_raw_decompress(const void *patch,
+void state_manager_raw_decompress(const void *patch,
       size_t patchlen, void *data, size_t datalen)
 {
    uint16_t         *out16 = (uint16_t*)data;
@@ -373,6 +373,59 @@ static void state_manager_raw_decompress(const void *patch,
    }
 }
 
+/*
+ * Checks that 'patch' is a well-formed patch for a buffer of 'datalen'
+ * bytes, i.e. that applying it with state_manager_raw_decompress()
+ * will neither read past 'patchlen' nor write past 'datalen'.
+ *
+ * Only needed for patches that did not come from
+ * state_manager_raw_compress() in this process.
+ */
+bool state_manager_raw_patch_valid(const void *patch,
+      size_t patchlen, size_t datalen)
+{
+   const uint16_t *patch16 = (const uint16_t*)patch;
+   size_t num16s           = patchlen / sizeof(uint16_t);
+   size_t out16            = 0;
+   size_t max16            = (datalen + sizeof(uint16_t) - 1)
+      / sizeof(uint16_t);
+   size_t pos              = 0;
+
+   for (;;)
+   {
+      uint16_t numchanged;
+
+      if (pos >= num16s)
+         return false;
+      numchanged = patch16[pos++];
+
+      if (numchanged)
+      {
+         if (pos + 1 + numchanged > num16s)
+            return false;
+         out16 += patch16[pos++];
+         if (out16 + numchanged > max16)
+            return false;
+         pos   += numchanged;
+         out16 += numchanged;
+      }
+      else
+      {
+         uint32_t numunchanged;
+
+         if (pos + 2 > num16s)
+            return false;
+         numunchanged = patch16[pos] | (patch16[pos + 1] << 16);
+         if (!numunchanged)
+            return true;
+         pos   += 2;
+         out16 += numunchanged;
+         if (out16 > max16)
+            return false;
+      }
+   }
+}
+
 /* The start offsets point to 'nextstart' of any given compressed frame.
  * Each uint16 is stored native endian; anything that claims any other
  * endianness refers to the endianness of this specific item.
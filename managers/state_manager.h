@@ -44,6 +44,20 @@ bool state_manager_check_rewind(bool pressed,
       unsigned rewind_granularity, bool is_paused,
       char *s, size_t len, unsigned *time);
 
+/* Raw savestate delta codec, shared by the rewind buffer and netplay. */
+size_t state_manager_raw_maxsize(size_t uncomp);
+
+void *state_manager_raw_alloc(size_t len, uint16_t uniq);
+
+size_t state_manager_raw_compress(const void *src,
+      const void *dst, size_t len, void *patch);
+
+void state_manager_raw_decompress(const void *patch,
+      size_t patchlen, void *data, size_t datalen);
+
+bool state_manager_raw_patch_valid(const void *patch,
+      size_t patchlen, size_t datalen);
+
 RETRO_END_DECLS
 
 #endif
@@ -2635,7 +2635,9 @@ static int action_ok_menu_wallpaper_load(const char *path,
 
    filebrowser_clear_type();
 
-   settings->uints.menu_xmb_shader_pipeline = XMB_SHADER_PIPELINE_WALLPAPER;
+   configuration_set_uint(settings,
+         settings->uints.menu_xmb_shader_pipeline,
+         XMB_SHADER_PIPELINE_WALLPAPER);
    return generic_action_ok(path, label, type, idx, entry_idx,
          ACTION_OK_LOAD_WALLPAPER, MSG_UNKNOWN);
 }
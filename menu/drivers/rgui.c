@@ -22,6 +22,14 @@
 #include <string.h>
 #include <limits.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define RGUI_SSE2
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define RGUI_NEON
+#endif
+
 #include <string/stdstring.h>
 #include <lists/file_list.h>
 #include <lists/string_list.h>
@@ -94,6 +102,16 @@
 
 #define RGUI_BATTERY_WARN_THRESHOLD 20
 
+/* Maximum number of text rows (title + menu entries +
+ * footer) for which redraw state is tracked. Larger
+ * terminals always redraw the entire framebuffer */
+#define RGUI_MAX_DIRTY_ROWS 64
+
+/* FNV-1a parameters, used to fingerprint the contents
+ * of each text row */
+#define RGUI_ROW_HASH_SEED  2166136261u
+#define RGUI_ROW_HASH_PRIME 16777619u
+
 typedef struct
 {
    unsigned start_x;
@@ -586,10 +604,13 @@ typedef struct
 
    uint32_t thumbnail_queue_size;
    uint32_t left_thumbnail_queue_size;
+   uint32_t row_hash[RGUI_MAX_DIRTY_ROWS];
 
    rgui_particle_t particles[RGUI_NUM_PARTICLES]; /* float alignment */
 
    int16_t scroll_y;
+   int16_t cursor_x;
+   int16_t cursor_y;
    rgui_colors_t colors;   /* int16_t alignment */
 
    struct scaler_ctx image_scaler;
@@ -603,6 +624,8 @@ typedef struct
    bool font_lut[RGUI_NUM_FONT_GLYPHS_EXTENDED][FONT_WIDTH * FONT_HEIGHT];
    bool bg_modified;
    bool force_redraw;
+   bool rows_valid;
+   bool cursor_drawn;
    bool mouse_show;
    bool ignore_resize_events;
    bool bg_thickness;
@@ -953,6 +976,17 @@ static frame_buf_t rgui_upscale_buf = {
    0
 };
 
+/* Range of framebuffer lines modified since the
+ * menu texture was last uploaded */
+typedef struct
+{
+   unsigned y_start;
+   unsigned y_end;
+   bool upscale_valid;
+} rgui_dirty_rows_t;
+
+static rgui_dirty_rows_t rgui_dirty_rows = {0};
+
 /* ==============================
  * pixel format conversion START
  * ============================== */
@@ -2048,6 +2082,108 @@ static void rgui_render_background(void)
    }
 }
 
+/* ==============================
+ * Dirty row tracking START
+ * ============================== */
+
+static void rgui_mark_dirty_rows(unsigned y, unsigned height)
+{
+   unsigned y_end = y + height;
+
+   y_end = (y_end < rgui_frame_buf.height) ? y_end : rgui_frame_buf.height;
+
+   if (y >= y_end)
+      return;
+
+   if (rgui_dirty_rows.y_end <= rgui_dirty_rows.y_start)
+   {
+      rgui_dirty_rows.y_start = y;
+      rgui_dirty_rows.y_end   = y_end;
+      return;
+   }
+
+   if (y < rgui_dirty_rows.y_start)
+      rgui_dirty_rows.y_start = y;
+   if (y_end > rgui_dirty_rows.y_end)
+      rgui_dirty_rows.y_end   = y_end;
+}
+
+/* Copies 'height' lines of the background buffer
+ * (starting at 'y') to the framebuffer, erasing
+ * whatever was previously drawn there */
+static void rgui_restore_background_rows(unsigned y, unsigned height)
+{
+   size_t line_size = rgui_frame_buf.width * sizeof(uint16_t);
+   unsigned y_end   = y + height;
+
+   if (!rgui_frame_buf.data || !rgui_background_buf.data)
+      return;
+
+   /* Sanity check */
+   if ((rgui_frame_buf.width  != rgui_background_buf.width) ||
+       (rgui_frame_buf.height != rgui_background_buf.height))
+      return;
+
+   y_end = (y_end < rgui_frame_buf.height) ? y_end : rgui_frame_buf.height;
+
+   if (y >= y_end)
+      return;
+
+   memcpy(rgui_frame_buf.data      + (y * rgui_frame_buf.width),
+          rgui_background_buf.data + (y * rgui_frame_buf.width),
+          (y_end - y) * line_size);
+
+   rgui_mark_dirty_rows(y, y_end - y);
+}
+
+static uint32_t rgui_row_hash(uint32_t hash, const void *data, size_t len)
+{
+   const uint8_t *ptr = (const uint8_t*)data;
+
+   while (len--)
+      hash = (hash ^ *ptr++) * RGUI_ROW_HASH_PRIME;
+
+   return hash;
+}
+
+static uint32_t rgui_row_hash_string(uint32_t hash, const char *str)
+{
+   return rgui_row_hash(hash, str, strlen(str) + 1);
+}
+
+static uint32_t rgui_row_hash_uint(uint32_t hash, unsigned value)
+{
+   return rgui_row_hash(hash, &value, sizeof(value));
+}
+
+/* Called before a text row is drawn. Returns false if
+ * the row is unchanged since the last frame, in which
+ * case the existing framebuffer contents may be reused.
+ * Otherwise, when performing a partial redraw, the
+ * background beneath the row is restored so that it
+ * may be drawn afresh */
+static bool rgui_begin_row(rgui_t *rgui, unsigned row, unsigned y,
+      uint32_t hash, bool full_redraw)
+{
+   if (row >= RGUI_MAX_DIRTY_ROWS)
+      return true;
+
+   if (!full_redraw)
+   {
+      if (rgui->row_hash[row] == hash)
+         return false;
+
+      rgui_restore_background_rows(y, FONT_HEIGHT_STRIDE);
+   }
+
+   rgui->row_hash[row] = hash;
+   return true;
+}
+
+/* ==============================
+ * Dirty row tracking END
+ * ============================== */
+
 static void rgui_render_fs_thumbnail(rgui_t *rgui)
 {
    if (fs_thumbnail.is_valid && rgui_frame_buf.data && fs_thumbnail.data)
@@ -3428,6 +3564,8 @@ static void rgui_render(void *data,
    bool menu_core_enable          = settings->bools.menu_core_enable;
    bool menu_timedate_enable      = settings->bools.menu_timedate_enable;
    bool current_display_cb        = false;
+   bool cursor_visible            = false;
+   bool full_redraw               = false;
 
    bool show_fs_thumbnail         =
          rgui->show_fs_thumbnail &&
@@ -3471,6 +3609,24 @@ static void rgui_render(void *data,
    fb_size_changed = (rgui->last_width  != fb_width) || 
                      (rgui->last_height != fb_height);
 
+   cursor_visible  = rgui->mouse_show && video_fullscreen && menu_mouse_enable;
+
+   /* Only text rows that have changed since the last frame
+    * are normally redrawn. Anything that draws across row
+    * boundaries (or invalidates the background) requires
+    * the entire framebuffer to be regenerated */
+   full_redraw     = rgui->force_redraw || rgui->bg_modified ||
+                     fb_size_changed || !rgui->rows_valid ||
+                     (rgui->particle_effect != RGUI_PARTICLE_EFFECT_NONE) ||
+                     current_display_cb || show_fs_thumbnail ||
+                     (rgui->is_playlist && rgui_inline_thumbnails) ||
+                     !string_is_empty(rgui->msgbox) ||
+                     ((rgui_term_layout.height + 2) > RGUI_MAX_DIRTY_ROWS) ||
+                     (cursor_visible != rgui->cursor_drawn) ||
+                     (cursor_visible &&
+                        ((rgui->pointer.x != rgui->cursor_x) ||
+                         (rgui->pointer.y != rgui->cursor_y)));
+
 #if defined(GEKKO)
    /* Wii gfx driver changes menu framebuffer size at
     * will... If a change is detected, all texture buffers
@@ -3496,7 +3652,6 @@ static void rgui_render(void *data,
    if (rgui->bg_modified)
       rgui->bg_modified = false;
 
-   gfx_display_set_framebuffer_dirty_flag();
    gfx_animation_ctl(MENU_ANIMATION_CTL_CLEAR_ACTIVE, NULL);
 
    rgui->force_redraw        = false;
@@ -3560,12 +3715,16 @@ static void rgui_render(void *data,
       menu_entries_ctl(MENU_ENTRIES_CTL_SET_START, &start);
    }
 
-   /* Render background */
-   rgui_render_background();
+   if (full_redraw)
+   {
+      /* Render background */
+      rgui_render_background();
+      rgui_mark_dirty_rows(0, fb_height);
 
-   /* Render particle effect, if required */
-   if (rgui->particle_effect != RGUI_PARTICLE_EFFECT_NONE)
-      rgui_render_particle_effect(rgui);
+      /* Render particle effect, if required */
+      if (rgui->particle_effect != RGUI_PARTICLE_EFFECT_NONE)
+         rgui_render_particle_effect(rgui);
+   }
 
    /* We use a single ticker for all text animations,
     * with the following configuration: */
@@ -3668,6 +3827,21 @@ static void rgui_render(void *data,
       unsigned thumbnail_panel_width = 0;
       unsigned term_mid_point        = 0;
       size_t powerstate_len          = 0;
+      unsigned powerstate_x          = 0;
+      unsigned footer_y              = (rgui_term_layout.height * FONT_HEIGHT_STRIDE) +
+                                       rgui_term_layout.start_y + 2;
+      unsigned row                   = 1;
+      enum rgui_symbol_type
+         powerstate_symbol           = RGUI_SYMBOL_CHARGING;
+      uint16_t powerstate_color      = 0;
+      uint32_t row_hash              = RGUI_ROW_HASH_SEED;
+      char percent_str[12];
+      char footer_buf[MENU_SUBLABEL_MAX_LENGTH];
+      char timedate[16];
+
+      percent_str[0]                 = '\0';
+      footer_buf[0]                  = '\0';
+      timedate[0]                    = '\0';
 
       /* Cache mini thumbnail related parameters, if required */
       if (show_mini_thumbnails)
@@ -3697,9 +3871,6 @@ static void rgui_render(void *data,
       if (menu_battery_level_enable)
       {
          gfx_display_ctx_powerstate_t powerstate;
-         char percent_str[12];
-
-         percent_str[0] = '\0';
 
          powerstate.s   = percent_str;
          powerstate.len = sizeof(percent_str);
@@ -3712,9 +3883,7 @@ static void rgui_render(void *data,
 
             if (powerstate_len > 0)
             {
-               unsigned powerstate_x;
-               enum rgui_symbol_type powerstate_symbol;
-               uint16_t powerstate_color = (powerstate.percent > RGUI_BATTERY_WARN_THRESHOLD || powerstate.charging) 
+               powerstate_color = (powerstate.percent > RGUI_BATTERY_WARN_THRESHOLD || powerstate.charging) 
                   ? rgui->colors.title_color 
                   : rgui->colors.hover_color;
 
@@ -3743,15 +3912,6 @@ static void rgui_render(void *data,
                powerstate_len += 2;
                powerstate_x    = (unsigned)(term_end_x - (powerstate_len * FONT_WIDTH_STRIDE));
 
-               /* Draw symbol */
-               blit_symbol(fb_width, powerstate_x, title_y, powerstate_symbol,
-                           powerstate_color, rgui->colors.shadow_color);
-
-               /* Print text */
-               blit_line(rgui, fb_width,
-                     powerstate_x + (2 * FONT_WIDTH_STRIDE), title_y,
-                     percent_str, powerstate_color, rgui->colors.shadow_color);
-
                /* Final length of battery indicator is 'powerstate_len' + a
                 * spacer of 3 characters */
                powerstate_len += 3;
@@ -3802,8 +3962,34 @@ static void rgui_render(void *data,
          if (title_len > title_max_len - (powerstate_len - 5))
             title_x -= (powerstate_len - 5) * FONT_WIDTH_STRIDE / 2;
 
-      blit_line(rgui, fb_width, title_x, title_y,
-            title_buf, rgui->colors.title_color, rgui->colors.shadow_color);
+      row_hash = rgui_row_hash_string(RGUI_ROW_HASH_SEED, title_buf);
+      row_hash = rgui_row_hash_uint(row_hash, title_x);
+      row_hash = rgui_row_hash_uint(row_hash, rgui->colors.title_color);
+      if (powerstate_len > 0)
+      {
+         row_hash = rgui_row_hash_string(row_hash, percent_str);
+         row_hash = rgui_row_hash_uint(row_hash, powerstate_x);
+         row_hash = rgui_row_hash_uint(row_hash, powerstate_symbol);
+         row_hash = rgui_row_hash_uint(row_hash, powerstate_color);
+      }
+
+      if (rgui_begin_row(rgui, 0, title_y, row_hash, full_redraw))
+      {
+         if (powerstate_len > 0)
+         {
+            /* Draw battery symbol */
+            blit_symbol(fb_width, powerstate_x, title_y, powerstate_symbol,
+                        powerstate_color, rgui->colors.shadow_color);
+
+            /* Print battery text */
+            blit_line(rgui, fb_width,
+                  powerstate_x + (2 * FONT_WIDTH_STRIDE), title_y,
+                  percent_str, powerstate_color, rgui->colors.shadow_color);
+         }
+
+         blit_line(rgui, fb_width, title_x, title_y,
+               title_buf, rgui->colors.title_color, rgui->colors.shadow_color);
+      }
 
       /* Print menu entries */
       x = rgui_term_layout.start_x;
@@ -3824,9 +4010,15 @@ static void rgui_render(void *data,
          bool entry_selected                         = (i == selection);
          uint16_t entry_color                        = entry_selected ?
                rgui->colors.hover_color : rgui->colors.normal_color;
+         unsigned entry_title_x_offset               = 0;
+
+         row = 1 + (unsigned)(i - new_start);
 
          if (i > (selection + 100))
+         {
+            rgui_begin_row(rgui, row, y, RGUI_ROW_HASH_SEED, full_redraw);
             continue;
+         }
 
          entry_title_buf[0] = '\0';
          type_str_buf[0]    = '\0';
@@ -3945,9 +4137,47 @@ static void rgui_render(void *data,
             gfx_animation_ticker(&ticker);
          }
 
+         entry_title_x_offset = ticker_x_offset;
+
+         /* Format entry value string, if required */
+         if (entry_value_type == RGUI_ENTRY_VALUE_TEXT)
+         {
+            if (use_smooth_ticker)
+            {
+               ticker_smooth.field_width = entry_value_len * FONT_WIDTH_STRIDE;
+               ticker_smooth.src_str     = entry_value;
+               ticker_smooth.dst_str     = type_str_buf;
+               ticker_smooth.dst_str_len = sizeof(type_str_buf);
+               ticker_smooth.x_offset    = &ticker_x_offset;
+
+               gfx_animation_ticker_smooth(&ticker_smooth);
+            }
+            else
+            {
+               ticker.s        = type_str_buf;
+               ticker.len      = entry_value_len;
+               ticker.str      = entry_value;
+
+               gfx_animation_ticker(&ticker);
+            }
+         }
+
+         /* Skip drawing if row is unchanged */
+         row_hash = rgui_row_hash_string(RGUI_ROW_HASH_SEED, entry_title_buf);
+         row_hash = rgui_row_hash_string(row_hash, type_str_buf);
+         row_hash = rgui_row_hash_uint(row_hash, entry_title_x_offset);
+         row_hash = rgui_row_hash_uint(row_hash, ticker_x_offset);
+         row_hash = rgui_row_hash_uint(row_hash, entry_value_len);
+         row_hash = rgui_row_hash_uint(row_hash, entry_value_type);
+         row_hash = rgui_row_hash_uint(row_hash, entry_color);
+         row_hash = rgui_row_hash_uint(row_hash, entry_selected);
+
+         if (!rgui_begin_row(rgui, row, y, row_hash, full_redraw))
+            continue;
+
          /* Print entry title */
          blit_line(rgui, fb_width,
-               ticker_x_offset + x + (2 * FONT_WIDTH_STRIDE), y,
+               entry_title_x_offset + x + (2 * FONT_WIDTH_STRIDE), y,
                entry_title_buf,
                entry_color, rgui->colors.shadow_color);
 
@@ -3955,26 +4185,6 @@ static void rgui_render(void *data,
          switch (entry_value_type)
          {
             case RGUI_ENTRY_VALUE_TEXT:
-               /* Format entry value string */
-               if (use_smooth_ticker)
-               {
-                  ticker_smooth.field_width = entry_value_len * FONT_WIDTH_STRIDE;
-                  ticker_smooth.src_str     = entry_value;
-                  ticker_smooth.dst_str     = type_str_buf;
-                  ticker_smooth.dst_str_len = sizeof(type_str_buf);
-                  ticker_smooth.x_offset    = &ticker_x_offset;
-
-                  gfx_animation_ticker_smooth(&ticker_smooth);
-               }
-               else
-               {
-                  ticker.s        = type_str_buf;
-                  ticker.len      = entry_value_len;
-                  ticker.str      = entry_value;
-
-                  gfx_animation_ticker(&ticker);
-               }
-
                /* Print entry value */
                blit_line(rgui,
                      fb_width,
@@ -4012,6 +4222,11 @@ static void rgui_render(void *data,
                   entry_color, rgui->colors.shadow_color);
       }
 
+      /* Erase any rows left over from a longer list */
+      for (row = 1 + (unsigned)(end > new_start ? end - new_start : 0);
+           row <= rgui_term_layout.height; row++, y += FONT_HEIGHT_STRIDE)
+         rgui_begin_row(rgui, row, y, RGUI_ROW_HASH_SEED, full_redraw);
+
       /* Draw mini thumbnails, if required */
       if (show_mini_thumbnails)
       {
@@ -4022,45 +4237,34 @@ static void rgui_render(void *data,
             rgui_render_mini_thumbnail(rgui, &mini_left_thumbnail, GFX_THUMBNAIL_LEFT);
       }
 
-      /* Print menu sublabel/core name (if required) */
+      /* Format menu sublabel/core name (if required) */
       if (menu_show_sublabels && !string_is_empty(rgui->menu_sublabel))
       {
-         char sublabel_buf[MENU_SUBLABEL_MAX_LENGTH];
-         sublabel_buf[0] = '\0';
-
          if (use_smooth_ticker)
          {
             ticker_smooth.selected    = true;
             ticker_smooth.field_width = core_name_len * FONT_WIDTH_STRIDE;
             ticker_smooth.src_str     = rgui->menu_sublabel;
-            ticker_smooth.dst_str     = sublabel_buf;
-            ticker_smooth.dst_str_len = sizeof(sublabel_buf);
+            ticker_smooth.dst_str     = footer_buf;
+            ticker_smooth.dst_str_len = sizeof(footer_buf);
             ticker_smooth.x_offset    = &ticker_x_offset;
 
             gfx_animation_ticker_smooth(&ticker_smooth);
          }
          else
          {
-            ticker.s        = sublabel_buf;
+            ticker.s        = footer_buf;
             ticker.len      = core_name_len;
             ticker.str      = rgui->menu_sublabel;
             ticker.selected = true;
 
             gfx_animation_ticker(&ticker);
          }
-
-         blit_line(rgui,
-               fb_width,
-               ticker_x_offset + rgui_term_layout.start_x + FONT_WIDTH_STRIDE,
-               (rgui_term_layout.height * FONT_HEIGHT_STRIDE) +
-               rgui_term_layout.start_y + 2, sublabel_buf,
-               rgui->colors.hover_color, rgui->colors.shadow_color);
       }
       else if (menu_core_enable)
       {
          char core_title[64];
-         char core_title_buf[64];
-         core_title[0] = core_title_buf[0] = '\0';
+         core_title[0] = '\0';
 
          menu_entries_get_core_title(core_title, sizeof(core_title));
 
@@ -4069,37 +4273,27 @@ static void rgui_render(void *data,
             ticker_smooth.selected    = true;
             ticker_smooth.field_width = core_name_len * FONT_WIDTH_STRIDE;
             ticker_smooth.src_str     = core_title;
-            ticker_smooth.dst_str     = core_title_buf;
-            ticker_smooth.dst_str_len = sizeof(core_title_buf);
+            ticker_smooth.dst_str     = footer_buf;
+            ticker_smooth.dst_str_len = sizeof(footer_buf);
             ticker_smooth.x_offset    = &ticker_x_offset;
 
             gfx_animation_ticker_smooth(&ticker_smooth);
          }
          else
          {
-            ticker.s        = core_title_buf;
+            ticker.s        = footer_buf;
             ticker.len      = core_name_len;
             ticker.str      = core_title;
             ticker.selected = true;
 
             gfx_animation_ticker(&ticker);
          }
-
-         blit_line(rgui,
-               fb_width,
-               ticker_x_offset + rgui_term_layout.start_x + FONT_WIDTH_STRIDE,
-               (rgui_term_layout.height * FONT_HEIGHT_STRIDE) +
-               rgui_term_layout.start_y + 2, core_title_buf,
-               rgui->colors.hover_color, rgui->colors.shadow_color);
       }
 
-      /* Print clock (if required) */
+      /* Format clock (if required) */
       if (menu_timedate_enable)
       {
          gfx_display_ctx_datetime_t datetime;
-         char timedate[16];
-
-         timedate[0]             = '\0';
 
          datetime.s              = timedate;
          datetime.len            = sizeof(timedate);
@@ -4107,13 +4301,30 @@ static void rgui_render(void *data,
          datetime.date_separator = MENU_TIMEDATE_DATE_SEPARATOR_HYPHEN;
 
          menu_display_timedate(&datetime);
+      }
 
-         blit_line(rgui,
-               fb_width,
-               timedate_x,
-               (rgui_term_layout.height * FONT_HEIGHT_STRIDE) +
-               rgui_term_layout.start_y + 2, timedate,
-               rgui->colors.hover_color, rgui->colors.shadow_color);
+      row_hash = rgui_row_hash_string(RGUI_ROW_HASH_SEED, footer_buf);
+      row_hash = rgui_row_hash_string(row_hash, timedate);
+      row_hash = rgui_row_hash_uint(row_hash, ticker_x_offset);
+
+      if (rgui_begin_row(rgui, rgui_term_layout.height + 1,
+               footer_y, row_hash, full_redraw))
+      {
+         /* Print menu sublabel/core name */
+         if (!string_is_empty(footer_buf))
+            blit_line(rgui,
+                  fb_width,
+                  ticker_x_offset + rgui_term_layout.start_x + FONT_WIDTH_STRIDE,
+                  footer_y, footer_buf,
+                  rgui->colors.hover_color, rgui->colors.shadow_color);
+
+         /* Print clock */
+         if (!string_is_empty(timedate))
+            blit_line(rgui,
+                  fb_width,
+                  timedate_x,
+                  footer_y, timedate,
+                  rgui->colors.hover_color, rgui->colors.shadow_color);
       }
    }
 
@@ -4124,14 +4335,27 @@ static void rgui_render(void *data,
       rgui->force_redraw = true;
    }
 
-   if (rgui->mouse_show)
+   /* Note: if the cursor has not moved, it is simply
+    * redrawn over any rows that have been updated */
+   if (cursor_visible)
    {
-      bool cursor_visible   = video_fullscreen 
-         && menu_mouse_enable;
-
-      if (cursor_visible)
-         rgui_blit_cursor(rgui);
+      rgui_blit_cursor(rgui);
+      rgui_mark_dirty_rows(
+            (rgui->pointer.y > 5) ? (unsigned)(rgui->pointer.y - 5) : 0, 11);
+      rgui->cursor_x = rgui->pointer.x;
+      rgui->cursor_y = rgui->pointer.y;
    }
+
+   rgui->cursor_drawn = cursor_visible;
+
+   /* On-screen keyboard and fullscreen thumbnail views
+    * do not track rows, so the next list view must
+    * be drawn in full */
+   rgui->rows_valid   = !current_display_cb && !show_fs_thumbnail;
+
+   /* Only upload the menu texture if something changed */
+   if (rgui_dirty_rows.y_end > rgui_dirty_rows.y_start)
+      gfx_display_set_framebuffer_dirty_flag();
 }
 
 static void rgui_framebuffer_free(void)
@@ -4209,7 +4433,9 @@ static void rgui_set_video_config(rgui_t *rgui,
    if (!settings)
       return;
    
-   settings->uints.video_aspect_ratio_idx = video_settings->aspect_ratio_idx;
+   configuration_set_uint(settings,
+         settings->uints.video_aspect_ratio_idx,
+         video_settings->aspect_ratio_idx);
    custom_vp->width                       = video_settings->viewport.width;
    custom_vp->height                      = video_settings->viewport.height;
    custom_vp->x                           = video_settings->viewport.x;
@@ -4760,10 +4986,46 @@ static void rgui_free(void *data)
    gfx_animation_unset_update_time_cb();
 }
 
+/* Nearest neighbour upscaling of a single framebuffer line */
+static void rgui_upscale_line(uint16_t *dst, const uint16_t *src,
+      unsigned out_width, uint32_t x_ratio)
+{
+   unsigned x_dst = 0;
+
+   /* 2x horizontal scaling is by far the most common
+    * case, and reduces to repeating each pixel */
+   if (x_ratio == 0x8000)
+   {
+#if defined(RGUI_SSE2)
+      for (; x_dst + 16 <= out_width; x_dst += 16)
+      {
+         __m128i in = _mm_loadu_si128((const __m128i*)(src + (x_dst >> 1)));
+         _mm_storeu_si128((__m128i*)(dst + x_dst),     _mm_unpacklo_epi16(in, in));
+         _mm_storeu_si128((__m128i*)(dst + x_dst + 8), _mm_unpackhi_epi16(in, in));
+      }
+#elif defined(RGUI_NEON)
+      for (; x_dst + 16 <= out_width; x_dst += 16)
+      {
+         uint16x8x2_t out;
+         out.val[0] = vld1q_u16(src + (x_dst >> 1));
+         out.val[1] = out.val[0];
+         vst2q_u16(dst + x_dst, out);
+      }
+#endif
+      for (; x_dst < out_width; x_dst++)
+         dst[x_dst] = src[x_dst >> 1];
+      return;
+   }
+
+   for (; x_dst < out_width; x_dst++)
+      dst[x_dst] = src[(x_dst * x_ratio) >> 16];
+}
+
 static void rgui_set_texture(void)
 {
    size_t fb_pitch;
    unsigned fb_width, fb_height;
+   unsigned dirty_y_start, dirty_y_end;
    settings_t            *settings = config_get_ptr();
    unsigned internal_upscale_level = settings->uints.menu_rgui_internal_upscale_level;
 
@@ -4775,8 +5037,16 @@ static void rgui_set_texture(void)
 
    gfx_display_unset_framebuffer_dirty_flag();
 
+   /* Consume the set of lines modified since the
+    * last upload */
+   dirty_y_start           = rgui_dirty_rows.y_start;
+   dirty_y_end             = rgui_dirty_rows.y_end;
+   rgui_dirty_rows.y_start = 0;
+   rgui_dirty_rows.y_end   = 0;
+
    if (internal_upscale_level == RGUI_UPSCALE_NONE)
    {
+      rgui_dirty_rows.upscale_valid = false;
       video_driver_set_texture_frame(rgui_frame_buf.data,
          false, fb_width, fb_height, 1.0f);
    }
@@ -4790,6 +5060,7 @@ static void rgui_set_texture(void)
        * than the menu framebuffer, no scaling is required */
       if ((vp.width <= fb_width) && (vp.height <= fb_height))
       {
+         rgui_dirty_rows.upscale_valid = false;
          video_driver_set_texture_frame(rgui_frame_buf.data,
             false, fb_width, fb_height, 1.0f);
       }
@@ -4798,8 +5069,8 @@ static void rgui_set_texture(void)
          unsigned out_width;
          unsigned out_height;
          uint32_t x_ratio, y_ratio;
-         unsigned x_src, y_src;
-         unsigned x_dst, y_dst;
+         unsigned y_src, y_dst;
+         unsigned last_y_src = UINT_MAX;
          
          /* Determine output size */
          if (internal_upscale_level == RGUI_UPSCALE_AUTO)
@@ -4827,6 +5098,7 @@ static void rgui_set_texture(void)
                rgui_upscale_buf.data = NULL;
             }
             
+            rgui_dirty_rows.upscale_valid = false;
             rgui_upscale_buf.data = (uint16_t*)
                calloc(out_width * out_height, sizeof(uint16_t));
             if (!rgui_upscale_buf.data)
@@ -4849,15 +5121,35 @@ static void rgui_set_texture(void)
          x_ratio = ((fb_width  << 16) / out_width);
          y_ratio = ((fb_height << 16) / out_height);
 
+         /* If the upscaling buffer holds the previous
+          * frame, only modified lines need to be redone */
+         if (!rgui_dirty_rows.upscale_valid)
+         {
+            dirty_y_start = 0;
+            dirty_y_end   = fb_height;
+         }
+
          for (y_dst = 0; y_dst < out_height; y_dst++)
          {
+            uint16_t *dst = rgui_upscale_buf.data + (y_dst * out_width);
+
             y_src = (y_dst * y_ratio) >> 16;
-            for (x_dst = 0; x_dst < out_width; x_dst++)
-            {
-               x_src = (x_dst * x_ratio) >> 16;
-               rgui_upscale_buf.data[(y_dst * out_width) + x_dst] = rgui_frame_buf.data[(y_src * fb_width) + x_src];
-            }
+
+            if ((y_src < dirty_y_start) || (y_src >= dirty_y_end))
+               continue;
+
+            /* Successive output lines sampling the same
+             * source line are identical */
+            if (y_src == last_y_src)
+               memcpy(dst, dst - out_width, out_width * sizeof(uint16_t));
+            else
+               rgui_upscale_line(dst, rgui_frame_buf.data + (y_src * fb_width),
+                     out_width, x_ratio);
+
+            last_y_src = y_src;
          }
+
+         rgui_dirty_rows.upscale_valid = true;
          
          /* Draw upscaled texture */
          video_driver_set_texture_frame(rgui_upscale_buf.data,
@@ -5601,6 +5893,11 @@ static void rgui_toggle(void *userdata, bool menu_on)
       free(rgui_upscale_buf.data);
       rgui_upscale_buf.data = NULL;
    }
+
+   /* Menu texture may have been replaced while the
+    * menu was off - cannot rely on partial updates */
+   if (menu_on)
+      rgui->force_redraw = true;
 }
 
 static void rgui_context_reset(void *data, bool is_threaded)
@@ -5615,6 +5912,8 @@ static void rgui_context_reset(void *data, bool is_threaded)
       gfx_display_allocate_white_texture();
 #endif
    video_driver_monitor_reset();
+
+   rgui->force_redraw = true;
 }
 
 static void rgui_context_destroy(void *data)
@@ -10747,6 +10747,22 @@ static bool setting_append_list(
             menu_settings_list_current_add_range(list, list_info, 0, 15, 1, true, true);
             SETTINGS_DATA_LIST_CURRENT_ADD_FLAGS(list, list_info, SD_FLAG_LAKKA_ADVANCED);
 
+            CONFIG_BOOL(
+                  list, list_info,
+                  &settings->bools.video_frame_delay_auto,
+                  MENU_ENUM_LABEL_VIDEO_FRAME_DELAY_AUTO,
+                  MENU_ENUM_LABEL_VALUE_VIDEO_FRAME_DELAY_AUTO,
+                  DEFAULT_FRAME_DELAY_AUTO,
+                  MENU_ENUM_LABEL_VALUE_OFF,
+                  MENU_ENUM_LABEL_VALUE_ON,
+                  &group_info,
+                  &subgroup_info,
+                  parent_group,
+                  general_write_handler,
+                  general_read_handler,
+                  SD_FLAG_NONE);
+            SETTINGS_DATA_LIST_CURRENT_ADD_FLAGS(list, list_info, SD_FLAG_LAKKA_ADVANCED);
+
             CONFIG_UINT(
                   list, list_info,
                   &settings->uints.video_shader_delay,
@@ -11528,6 +11544,24 @@ static bool setting_append_list(
             menu_settings_list_current_add_range(list, list_info, 0, 2, 1, true, true);
             SETTINGS_DATA_LIST_CURRENT_ADD_FLAGS(list, list_info, SD_FLAG_LAKKA_ADVANCED);
 
+#ifdef HAVE_UDEV
+            CONFIG_BOOL(
+                  list, list_info,
+                  &settings->bools.input_udev_reader_thread,
+                  MENU_ENUM_LABEL_INPUT_UDEV_READER_THREAD,
+                  MENU_ENUM_LABEL_VALUE_INPUT_UDEV_READER_THREAD,
+                  input_udev_reader_thread,
+                  MENU_ENUM_LABEL_VALUE_OFF,
+                  MENU_ENUM_LABEL_VALUE_ON,
+                  &group_info,
+                  &subgroup_info,
+                  parent_group,
+                  general_write_handler,
+                  general_read_handler,
+                  SD_FLAG_NONE);
+            SETTINGS_DATA_LIST_CURRENT_ADD_FLAGS(list, list_info, SD_FLAG_ADVANCED);
+#endif
+
 #ifdef GEKKO
             CONFIG_UINT(
                   list, list_info,
@@ -16997,6 +17031,40 @@ static bool setting_append_list(
                   SD_FLAG_NONE);
             SETTINGS_DATA_LIST_CURRENT_ADD_FLAGS(list, list_info, SD_FLAG_ADVANCED);
 
+            CONFIG_BOOL(
+                  list, list_info,
+                  &settings->bools.netplay_udp_input,
+                  MENU_ENUM_LABEL_NETPLAY_UDP_INPUT,
+                  MENU_ENUM_LABEL_VALUE_NETPLAY_UDP_INPUT,
+                  netplay_udp_input,
+                  MENU_ENUM_LABEL_VALUE_OFF,
+                  MENU_ENUM_LABEL_VALUE_ON,
+                  &group_info,
+                  &subgroup_info,
+                  parent_group,
+                  general_write_handler,
+                  general_read_handler,
+                  SD_FLAG_NONE);
+            SETTINGS_DATA_LIST_CURRENT_ADD_FLAGS(list, list_info, SD_FLAG_ADVANCED);
+
+#ifdef HAVE_THREADS
+            CONFIG_BOOL(
+                  list, list_info,
+                  &settings->bools.netplay_spectator_relay,
+                  MENU_ENUM_LABEL_NETPLAY_SPECTATOR_RELAY,
+                  MENU_ENUM_LABEL_VALUE_NETPLAY_SPECTATOR_RELAY,
+                  netplay_spectator_relay,
+                  MENU_ENUM_LABEL_VALUE_OFF,
+                  MENU_ENUM_LABEL_VALUE_ON,
+                  &group_info,
+                  &subgroup_info,
+                  parent_group,
+                  general_write_handler,
+                  general_read_handler,
+                  SD_FLAG_NONE);
+            SETTINGS_DATA_LIST_CURRENT_ADD_FLAGS(list, list_info, SD_FLAG_ADVANCED);
+#endif
+
             CONFIG_INT(
                   list, list_info,
                   &settings->ints.netplay_check_frames,
@@ -938,6 +938,7 @@ enum msg_hash_enums
    MENU_LABEL(INPUT_ICADE_ENABLE),
    MENU_LABEL(INPUT_ALL_USERS_CONTROL_MENU),
    MENU_LABEL(INPUT_POLL_TYPE_BEHAVIOR),
+   MENU_LABEL(INPUT_UDEV_READER_THREAD),
    MENU_LABEL(INPUT_UNIFIED_MENU_CONTROLS),
 
    MENU_LABEL(QUIT_PRESS_TWICE),
@@ -968,6 +969,7 @@ enum msg_hash_enums
    MENU_LABEL(VIDEO_GPU_SCREENSHOT),
    MENU_LABEL(VIDEO_BLACK_FRAME_INSERTION),
    MENU_LABEL(VIDEO_FRAME_DELAY),
+   MENU_LABEL(VIDEO_FRAME_DELAY_AUTO),
    MENU_LABEL(VIDEO_SHADER_DELAY),
    MENU_LABEL(VIDEO_VSYNC),
    MENU_LABEL(VIDEO_ADAPTIVE_VSYNC),
@@ -1738,6 +1740,8 @@ enum msg_hash_enums
    MENU_LABEL(NETPLAY_ALLOW_SLAVES),
    MENU_LABEL(NETPLAY_REQUIRE_SLAVES),
    MENU_LABEL(NETPLAY_STATELESS_MODE),
+   MENU_LABEL(NETPLAY_UDP_INPUT),
+   MENU_LABEL(NETPLAY_SPECTATOR_RELAY),
    MENU_LABEL(NETPLAY_CHECK_FRAMES),
    MENU_LABEL(NETPLAY_INPUT_LATENCY_FRAMES_MIN),
    MENU_LABEL(NETPLAY_INPUT_LATENCY_FRAMES_RANGE),
@@ -64,6 +64,7 @@ bool netplay_init_socket_buffer(
       return false;
    sbuf->bufsz = size;
    sbuf->start = sbuf->read = sbuf->end = 0;
+   sbuf->relay = NULL;
    return true;
 }
 
@@ -150,6 +151,8 @@ bool netplay_send(
       /* Can only be that this is simply too big 
        * for our buffer, in which case we just 
        * need to do a blocking send */
+      if (sbuf->relay)
+         return netplay_relay_push(sbuf->relay, buf, len);
       if (!socket_send_all_blocking(sockfd, buf, len, false))
          return false;
       return true;
@@ -191,6 +194,10 @@ bool netplay_send_flush(struct socket_buffer *sbuf, int sockfd, bool block)
    if (buf_used(sbuf) == 0)
       return true;
 
+   /* The relay thread does the actual sending for relayed spectators */
+   if (sbuf->relay)
+      return netplay_relay_flush(sbuf);
+
    if (sbuf->end > sbuf->start)
    {
       /* Usual case: Everything's in order */
@@ -53,11 +53,22 @@ bool netplay_delta_frame_ready(netplay_t *netplay, struct delta_frame *delta,
        * so we can't overwrite it! */
       if (netplay->other_frame_count <= delta->frame)
          return false;
+
+      /* Nor the checkpoint that replay would start from */
+      if (netplay->checkpoint_frames_max > 1)
+      {
+         size_t ckpt_ptr     = netplay->other_ptr;
+         uint32_t ckpt_frame = netplay->other_frame_count;
+         if (netplay_delta_frame_checkpoint(netplay, &ckpt_ptr, &ckpt_frame) &&
+               ckpt_frame <= delta->frame)
+            return false;
+      }
    }
 
-   delta->used  = true;
-   delta->frame = frame;
-   delta->crc   = 0;
+   delta->used       = true;
+   delta->frame      = frame;
+   delta->crc        = 0;
+   delta->have_state = false;
 
    for (i = 0; i < MAX_INPUT_DEVICES; i++)
    {
@@ -85,6 +96,48 @@ uint32_t netplay_delta_frame_crc(netplay_t *netplay,
          netplay->state_size);
 }
 
+/**
+ * netplay_delta_frame_checkpoint
+ *
+ * Find the newest serialized frame at or before the given ptr and frame,
+ * i.e., the frame a replay from there has to start from, and store it back.
+ *
+ * Returns: True if such a frame is still in the buffer, false otherwise.
+ */
+bool netplay_delta_frame_checkpoint(netplay_t *netplay, size_t *ptr,
+   uint32_t *frame_count)
+{
+   size_t i;
+   size_t cur     = *ptr;
+   uint32_t frame = *frame_count;
+
+   for (i = 0; i < netplay->buffer_size; i++)
+   {
+      struct delta_frame *delta = &netplay->buffer[cur];
+
+      if (delta->used && delta->frame == frame)
+      {
+         if (delta->have_state)
+         {
+            *ptr         = cur;
+            *frame_count = frame;
+            return true;
+         }
+      }
+      /* The starting frame may not be prepared yet, but anything older
+       * must be intact */
+      else if (i > 0)
+         return false;
+
+      if (frame == 0)
+         return false;
+      cur = PREV_PTR(cur);
+      frame--;
+   }
+
+   return false;
+}
+
 /*
  * Free an input state list
  */
@@ -238,7 +238,8 @@ bool netplay_handshake_init_send(netplay_t *netplay,
 
    header[0] = htonl(NETPLAY_MAGIC);
    header[1] = htonl(netplay_platform_magic());
-   header[2] = htonl(NETPLAY_COMPRESSION_SUPPORTED);
+   header[2] = htonl(NETPLAY_COMPRESSION_SUPPORTED
+         | (netplay->udp_fd >= 0 ? NETPLAY_FEATURE_UDP_INPUT : 0));
    header[3] = 0;
    header[4] = htonl(NETPLAY_PROTOCOL_VERSION);
    header[5] = htonl(netplay_impl_magic());
@@ -370,6 +371,10 @@ bool netplay_handshake_init(netplay_t *netplay,
 
    /* Check what compression is supported */
    compression  = ntohl(header[2]);
+
+   connection->udp_supported = (compression & NETPLAY_FEATURE_UDP_INPUT)
+      && netplay->udp_fd >= 0;
+   connection->udp_active    = false;
    compression &= NETPLAY_COMPRESSION_SUPPORTED;
 
    if (compression & NETPLAY_COMPRESSION_ZLIB)
@@ -398,6 +403,13 @@ bool netplay_handshake_init(netplay_t *netplay,
    if (!ctrans->decompression_backend)
       ctrans->decompression_backend = ctrans->compression_backend->reverse;
 
+   /* Deltas are native-endian 16-bit words, so only use them between
+    * peers of the same endianness */
+   connection->savestate_delta     = (compression & NETPLAY_COMPRESSION_DELTA)
+      && netplay->savestate_ref
+      && !netplay_endian_mismatch(local_pmagic, remote_pmagic);
+   connection->savestate_ref_valid = false;
+
    /* Allocate our compression stream */
    if (!ctrans->compression_stream)
    {
@@ -677,6 +689,10 @@ static bool netplay_handshake_sync(netplay_t *netplay,
    autosave_unlock();
 #endif
 
+   /* Offer the UDP input channel */
+   if (connection->udp_supported && !netplay_udp_announce(netplay, connection))
+      return false;
+
    /* Now we're ready! */
    connection->mode = NETPLAY_CONNECTION_SPECTATING;
    netplay_handshake_ready(netplay, connection);
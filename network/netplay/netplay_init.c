@@ -31,6 +31,7 @@
 #include "netplay_discovery.h"
 
 #include "../../autosave.h"
+#include "../../managers/state_manager.h"
 #include "../../retroarch.h"
 
 #if defined(AF_INET6) && !defined(HAVE_SOCKET_LEGACY) && !defined(_3DS)
@@ -304,6 +305,29 @@ static bool netplay_init_serialization(netplay_t *netplay)
       return false;
    }
 
+   /* Delta transfer is optional; without these buffers we simply always
+    * send full savestates */
+   if (!netplay->savestate_ref)
+   {
+      netplay->savestate_ref   = (uint8_t*)
+         state_manager_raw_alloc(netplay->state_size, 0);
+      netplay->savestate_cur   = (uint8_t*)
+         state_manager_raw_alloc(netplay->state_size, 1);
+      netplay->savestate_patch = (uint8_t*)malloc(
+            state_manager_raw_maxsize(netplay->state_size));
+
+      if (!netplay->savestate_ref || !netplay->savestate_cur ||
+            !netplay->savestate_patch)
+      {
+         free(netplay->savestate_ref);
+         free(netplay->savestate_cur);
+         free(netplay->savestate_patch);
+         netplay->savestate_ref   = NULL;
+         netplay->savestate_cur   = NULL;
+         netplay->savestate_patch = NULL;
+      }
+   }
+
    return true;
 }
 
@@ -331,6 +355,7 @@ bool netplay_try_init_serialization(netplay_t *netplay)
 
    if (!core_serialize(&serial_info))
       return false;
+   netplay->buffer[netplay->run_ptr].have_state = true;
 
    /* Once initialized, we no longer exhibit this quirk */
    netplay->quirks &= ~((uint64_t) NETPLAY_QUIRK_INITIALIZATION);
@@ -384,6 +409,9 @@ static bool netplay_init_buffers(netplay_t *netplay)
    if (netplay->is_server)
       netplay->buffer_size *= 2;
 
+   /* Replays may have to start up to a checkpoint interval further back */
+   netplay->buffer_size += netplay->checkpoint_frames_max - 1;
+
    delta_frames = (struct delta_frame*)calloc(netplay->buffer_size,
          sizeof(*delta_frames));
 
@@ -405,8 +433,11 @@ static bool netplay_init_buffers(netplay_t *netplay)
  * @port                 : Port of server.
  * @stateless_mode       : Shall we use stateless mode?
  * @check_frames         : Frequency with which to check CRCs.
+ * @checkpoint_frames    : Maximum interval between savestate checkpoints.
  * @cb                   : Libretro callbacks.
  * @nat_traversal        : If true, attempt NAT traversal.
+ * @udp_input            : If true, offer the UDP input channel.
+ * @spectator_relay      : If true, send to spectators from a relay thread.
  * @nick                 : Nickname of user.
  * @quirks               : Netplay quirks required for this session.
  *
@@ -416,15 +447,17 @@ static bool netplay_init_buffers(netplay_t *netplay)
  * Returns: new netplay data.
  */
 netplay_t *netplay_new(void *direct_host, const char *server, uint16_t port,
-   bool stateless_mode, int check_frames,
-   const struct retro_callbacks *cb, bool nat_traversal, const char *nick,
-   uint64_t quirks)
+   bool stateless_mode, int check_frames, unsigned checkpoint_frames,
+   const struct retro_callbacks *cb, bool nat_traversal, bool udp_input,
+   bool spectator_relay,
+   const char *nick, uint64_t quirks)
 {
    netplay_t *netplay = (netplay_t*)calloc(1, sizeof(*netplay));
    if (!netplay)
       return NULL;
 
    netplay->listen_fd            = -1;
+   netplay->udp_fd               = -1;
    netplay->tcp_port             = port;
    netplay->cbs                  = *cb;
    netplay->is_server            = (direct_host == NULL && server == NULL);
@@ -432,6 +465,10 @@ netplay_t *netplay_new(void *direct_host, const char *server, uint16_t port,
    netplay->nat_traversal        = netplay->is_server ? nat_traversal : false;
    netplay->stateless_mode       = stateless_mode;
    netplay->check_frames         = check_frames;
+   netplay->checkpoint_frames_max = checkpoint_frames < 1 ? 1 :
+      checkpoint_frames > NETPLAY_MAX_CHECKPOINT_FRAMES ?
+      NETPLAY_MAX_CHECKPOINT_FRAMES : checkpoint_frames;
+   netplay->checkpoint_frames    = 1;
    netplay->crc_validity_checked = false;
    netplay->crcs_valid           = true;
    netplay->quirks               = quirks;
@@ -461,6 +498,17 @@ netplay_t *netplay_new(void *direct_host, const char *server, uint16_t port,
       return NULL;
    }
 
+   /* Input over UDP is an optional extra; TCP carries everything anyway */
+   if (udp_input && !netplay_udp_init(netplay))
+      RARCH_WARN("[netplay] Could not open the UDP input channel.\n");
+
+   if (netplay->is_server && spectator_relay)
+   {
+      netplay->relay = netplay_relay_new();
+      if (!netplay->relay)
+         RARCH_WARN("[netplay] Could not start the spectator relay.\n");
+   }
+
    if (!netplay_init_buffers(netplay))
    {
       free(netplay);
@@ -532,17 +580,23 @@ void netplay_free(netplay_t *netplay)
    if (netplay->listen_fd >= 0)
       socket_close(netplay->listen_fd);
 
+   netplay_udp_deinit(netplay);
+
    for (i = 0; i < netplay->connections_size; i++)
    {
       struct netplay_connection *connection = &netplay->connections[i];
       if (connection->active)
       {
+         netplay_relay_detach(connection, false);
          socket_close(connection->fd);
          netplay_deinit_socket_buffer(&connection->send_packet_buffer);
          netplay_deinit_socket_buffer(&connection->recv_packet_buffer);
       }
    }
 
+   if (netplay->relay)
+      netplay_relay_free(netplay->relay);
+
    if (netplay->connections && netplay->connections != &netplay->one_connection)
       free(netplay->connections);
 
@@ -560,6 +614,10 @@ void netplay_free(netplay_t *netplay)
    if (netplay->zbuffer)
       free(netplay->zbuffer);
 
+   free(netplay->savestate_ref);
+   free(netplay->savestate_cur);
+   free(netplay->savestate_patch);
+
    if (netplay->compress_nil.compression_stream)
    {
       netplay->compress_nil.compression_backend->stream_free(netplay->compress_nil.compression_stream);
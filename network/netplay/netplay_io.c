@@ -21,6 +21,7 @@
 
 #include <boolean.h>
 #include <compat/strl.h>
+#include <encodings/crc32.h>
 
 #include "netplay_private.h"
 
@@ -28,6 +29,7 @@
 #include "../../retroarch.h"
 #include "../../command.h"
 #include "../../tasks/tasks_internal.h"
+#include "../../managers/state_manager.h"
 
 #ifdef HAVE_DISCORD
 #include "../discord.h"
@@ -138,8 +140,10 @@ void netplay_hangup(netplay_t *netplay,
    RARCH_LOG("[netplay] %s\n", dmsg);
    runloop_msg_queue_push(dmsg, 1, 180, false, NULL, MESSAGE_QUEUE_ICON_DEFAULT, MESSAGE_QUEUE_CATEGORY_INFO);
 
+   netplay_relay_detach(connection, false);
    socket_close(connection->fd);
-   connection->active = false;
+   connection->active     = false;
+   connection->udp_active = false;
    netplay_deinit_socket_buffer(&connection->send_packet_buffer);
    netplay_deinit_socket_buffer(&connection->recv_packet_buffer);
 
@@ -228,22 +232,20 @@ void netplay_delayed_state_change(netplay_t *netplay)
    }
 }
 
-/* Send the specified input data */
-static bool send_input_frame(netplay_t *netplay, struct delta_frame *dframe,
-      struct netplay_connection *only, struct netplay_connection *except,
-      uint32_t client_num, bool slave)
+/**
+ * netplay_pack_input
+ *
+ * Write a client's input for a frame, in network byte order, as carried by
+ * NETPLAY_CMD_INPUT after the frame and client number.
+ *
+ * Returns the number of words written.
+ */
+size_t netplay_pack_input(netplay_t *netplay, struct delta_frame *dframe,
+      uint32_t client_num, bool slave, uint32_t *buffer, size_t size)
 {
-#define BUFSZ 16 /* FIXME: Arbitrary restriction */
-   uint32_t buffer[BUFSZ], devices, device;
-   size_t bufused, i;
+   uint32_t devices, device;
+   size_t bufused = 0, i;
 
-   /* Set up the basic buffer */
-   bufused = 4;
-   buffer[0] = htonl(NETPLAY_CMD_INPUT);
-   buffer[2] = htonl(dframe->frame);
-   buffer[3] = htonl(client_num);
-
-   /* Add the device data */
    devices = netplay->client_devices[client_num];
    for (device = 0; device < MAX_INPUT_DEVICES; device++)
    {
@@ -255,14 +257,47 @@ static bool send_input_frame(netplay_t *netplay, struct delta_frame *dframe,
          istate = istate->next;
       if (!istate)
          continue;
-      if (bufused + istate->size >= BUFSZ)
+      if (bufused + istate->size >= size)
          continue; /* FIXME: More severe? */
       for (i = 0; i < istate->size; i++)
          buffer[bufused+i] = htonl(istate->data[i]);
       bufused += istate->size;
    }
+
+   return bufused;
+}
+
+#define BUFSZ 16 /* FIXME: Arbitrary restriction */
+
+/* Write a complete NETPLAY_CMD_INPUT for the specified input data */
+static size_t pack_input_frame(netplay_t *netplay, struct delta_frame *dframe,
+      uint32_t client_num, bool slave, uint32_t *buffer)
+{
+   size_t bufused;
+
+   /* Set up the basic buffer */
+   buffer[0] = htonl(NETPLAY_CMD_INPUT);
+   buffer[2] = htonl(dframe->frame);
+   buffer[3] = htonl(client_num);
+
+   /* Add the device data */
+   bufused = 4 + netplay_pack_input(netplay, dframe, client_num, slave,
+         buffer + 4, BUFSZ - 4);
    buffer[1] = htonl((bufused-2) * sizeof(uint32_t));
 
+   return bufused;
+}
+
+/* Send the specified input data */
+static bool send_input_frame(netplay_t *netplay, struct delta_frame *dframe,
+      struct netplay_connection *only, struct netplay_connection *except,
+      uint32_t client_num, bool slave)
+{
+   uint32_t buffer[BUFSZ];
+   size_t bufused, i;
+
+   bufused = pack_input_frame(netplay, dframe, client_num, slave, buffer);
+
 #ifdef DEBUG_NETPLAY_STEPS
    RARCH_LOG("[netplay] Sending input for client %u\n", (unsigned) client_num);
    print_state(netplay);
@@ -296,7 +331,6 @@ static bool send_input_frame(netplay_t *netplay, struct delta_frame *dframe,
    }
 
    return true;
-#undef BUFSZ
 }
 
 /**
@@ -358,9 +392,88 @@ bool netplay_send_cur_input(netplay_t *netplay,
          false))
       return false;
 
+   /* And the same input, with some history, over UDP if we can */
+   if (connection->udp_active)
+      netplay_udp_send_input(netplay, connection);
+
    return true;
 }
 
+/**
+ * netplay_send_cur_input_relayed
+ *
+ * Hand spectators to or back from the spectator relay as their modes change,
+ * then send the current input frame to all relayed spectators at once.
+ */
+void netplay_send_cur_input_relayed(netplay_t *netplay)
+{
+   uint32_t buffer[(MAX_CLIENTS + 1) * BUFSZ];
+   struct delta_frame *dframe        = &netplay->buffer[netplay->self_ptr];
+   struct netplay_relay_chunk *chunk = NULL;
+   size_t bufused                    = 0;
+   uint32_t from_client;
+   size_t i;
+
+   if (!netplay->relay)
+      return;
+
+   for (i = 0; i < netplay->connections_size; i++)
+   {
+      struct netplay_connection *connection = &netplay->connections[i];
+      bool relayed = connection->send_packet_buffer.relay != NULL;
+      bool want    = connection->active &&
+         connection->mode == NETPLAY_CONNECTION_SPECTATING;
+
+      if (want && !relayed)
+         netplay_relay_attach(netplay->relay, connection);
+      else if (!want && relayed &&
+            !netplay_relay_detach(connection, true))
+         netplay_hangup(netplay, connection);
+   }
+
+   /* Spectators get the same as netplay_send_cur_input would send each of
+    * them: everybody's input, and a NOINPUT if we're not playing */
+   for (from_client = 1; from_client < MAX_CLIENTS; from_client++)
+   {
+      if ((netplay->connected_players & (1<<from_client)) &&
+            dframe->have_real[from_client])
+         bufused += pack_input_frame(netplay, dframe, from_client, false,
+               buffer + bufused);
+   }
+
+   if (netplay->self_mode == NETPLAY_CONNECTION_PLAYING)
+      bufused += pack_input_frame(netplay, dframe,
+            netplay->self_client_num, false, buffer + bufused);
+   else
+   {
+      buffer[bufused++] = htonl(NETPLAY_CMD_NOINPUT);
+      buffer[bufused++] = htonl(sizeof(uint32_t));
+      buffer[bufused++] = htonl(netplay->self_frame_count);
+   }
+
+   for (i = 0; i < netplay->connections_size; i++)
+   {
+      struct netplay_connection *connection = &netplay->connections[i];
+      if (!connection->active || !connection->send_packet_buffer.relay)
+         continue;
+
+      if (!chunk)
+      {
+         chunk = netplay_relay_chunk_new(bufused * sizeof(uint32_t));
+         if (!chunk)
+            break;
+         memcpy(chunk->data, buffer, bufused * sizeof(uint32_t));
+      }
+
+      if (!netplay_relay_send(connection, chunk))
+         netplay_hangup(netplay, connection);
+   }
+
+   if (chunk)
+      netplay_relay_chunk_unref(netplay->relay, chunk);
+}
+#undef BUFSZ
+
 /**
  * netplay_send_raw_cmd
  *
@@ -482,6 +595,59 @@ bool netplay_cmd_request_savestate(netplay_t *netplay)
       NETPLAY_CMD_REQUEST_SAVESTATE, NULL, 0);
 }
 
+/**
+ * netplay_cmd_request_full_savestate
+ *
+ * Ask a peer to resend its state in full, because we could not apply its
+ * savestate delta.
+ */
+static bool netplay_cmd_request_full_savestate(netplay_t *netplay,
+      struct netplay_connection *connection)
+{
+   uint32_t payload = htonl(NETPLAY_CMD_REQUEST_SAVESTATE_BIT_FULL);
+
+   connection->savestate_ref_valid = false;
+   if (!netplay->is_server)
+      netplay->savestate_request_outstanding = true;
+   return netplay_send_raw_cmd(netplay, connection,
+      NETPLAY_CMD_REQUEST_SAVESTATE, &payload, sizeof(payload));
+}
+
+/**
+ * netplay_savestate_ref_update
+ * @netplay              : pointer to netplay object
+ * @state                : the savestate now shared with our peers
+ * @connection           : the only peer holding it, or NULL for all
+ *                         connected peers
+ *
+ * Remember a savestate exchanged with our peers as the reference against
+ * which later savestates are sent as deltas.
+ */
+void netplay_savestate_ref_update(netplay_t *netplay, const void *state,
+      struct netplay_connection *connection)
+{
+   size_t i;
+
+   if (!netplay->savestate_ref)
+      return;
+
+   memcpy(netplay->savestate_ref, state, netplay->state_size);
+   netplay->savestate_ref_crc = encoding_crc32(0L,
+         (const unsigned char*)netplay->savestate_ref, netplay->state_size);
+
+   for (i = 0; i < netplay->connections_size; i++)
+   {
+      struct netplay_connection *conn = &netplay->connections[i];
+      if (connection)
+         conn->savestate_ref_valid = (conn == connection);
+      else
+         conn->savestate_ref_valid = conn->active &&
+            conn->mode >= NETPLAY_CONNECTION_CONNECTED;
+      conn->savestate_ref_valid = conn->savestate_ref_valid
+         && conn->savestate_delta;
+   }
+}
+
 /**
  * netplay_cmd_mode
  *
@@ -1543,13 +1709,16 @@ static bool netplay_get_cmd(netplay_t *netplay,
             if (buffer[0] <= netplay->other_frame_count)
             {
                /* We've already replayed up to this frame, so we can check it
-                * directly */
-               uint32_t local_crc = netplay_delta_frame_crc(
-                     netplay, &netplay->buffer[tmp_ptr]);
+                * directly, if we kept its state */
+               if (netplay->buffer[tmp_ptr].have_state)
+               {
+                  uint32_t local_crc = netplay_delta_frame_crc(
+                        netplay, &netplay->buffer[tmp_ptr]);
 
-               /* Problem! */
-               if (buffer[1] != local_crc)
-                  netplay_cmd_request_savestate(netplay);
+                  /* Problem! */
+                  if (buffer[1] != local_crc)
+                     netplay_cmd_request_savestate(netplay);
+               }
             }
             else
             {
@@ -1561,16 +1730,40 @@ static bool netplay_get_cmd(netplay_t *netplay,
          }
 
       case NETPLAY_CMD_REQUEST_SAVESTATE:
+         /* Peers that negotiated deltas may ask for a full state */
+         if (cmd_size)
+         {
+            uint32_t flags;
+
+            if (cmd_size != sizeof(flags))
+            {
+               RARCH_ERR("NETPLAY_CMD_REQUEST_SAVESTATE received an unexpected payload size.\n");
+               return netplay_cmd_nak(netplay, connection);
+            }
+
+            RECV(&flags, sizeof(flags))
+            {
+               RARCH_ERR("Failed to receive NETPLAY_CMD_REQUEST_SAVESTATE payload.\n");
+               return netplay_cmd_nak(netplay, connection);
+            }
+
+            if (ntohl(flags) & NETPLAY_CMD_REQUEST_SAVESTATE_BIT_FULL)
+               connection->savestate_ref_valid = false;
+         }
+
          /* Delay until next frame so we don't send the savestate after the
           * input */
          netplay->force_send_savestate = true;
          break;
 
       case NETPLAY_CMD_LOAD_SAVESTATE:
+      case NETPLAY_CMD_LOAD_SAVESTATE_DELTA:
       case NETPLAY_CMD_RESET:
          {
             uint32_t frame;
             uint32_t isize;
+            uint32_t ref_crc;
+            size_t header_size;
             uint32_t rd, wn;
             uint32_t client;
             uint32_t load_frame_count;
@@ -1622,14 +1815,23 @@ static bool netplay_get_cmd(netplay_t *netplay,
              * too many places. */
 
             /* Check the payload size */
-            if ((cmd == NETPLAY_CMD_LOAD_SAVESTATE &&
-                 (cmd_size < 2*sizeof(uint32_t) || cmd_size > netplay->zbuffer_size + 2*sizeof(uint32_t))) ||
+            header_size = (cmd == NETPLAY_CMD_LOAD_SAVESTATE_DELTA)
+               ? 3*sizeof(uint32_t) : 2*sizeof(uint32_t);
+            if ((cmd != NETPLAY_CMD_RESET &&
+                 (cmd_size < header_size || cmd_size > netplay->zbuffer_size + header_size)) ||
                 (cmd == NETPLAY_CMD_RESET && cmd_size != sizeof(uint32_t)))
             {
                RARCH_ERR("CMD_LOAD_SAVESTATE received an unexpected payload size.\n");
                return netplay_cmd_nak(netplay, connection);
             }
 
+            if (cmd == NETPLAY_CMD_LOAD_SAVESTATE_DELTA &&
+                  (!connection->savestate_delta || !netplay->savestate_ref))
+            {
+               RARCH_ERR("CMD_LOAD_SAVESTATE_DELTA received without delta support.\n");
+               return netplay_cmd_nak(netplay, connection);
+            }
+
             RECV(&frame, sizeof(frame))
             {
                RARCH_ERR("CMD_LOAD_SAVESTATE failed to receive savestate frame.\n");
@@ -1661,8 +1863,11 @@ static bool netplay_get_cmd(netplay_t *netplay,
             }
 
             /* Now we switch based on whether we're loading a state or resetting */
-            if (cmd == NETPLAY_CMD_LOAD_SAVESTATE)
+            if (cmd != NETPLAY_CMD_RESET)
             {
+               uint8_t *target = (uint8_t*)netplay->buffer[load_ptr].state;
+               size_t target_size = netplay->state_size;
+
                RECV(&isize, sizeof(isize))
                {
                   RARCH_ERR("CMD_LOAD_SAVESTATE failed to receive inflated size.\n");
@@ -1676,7 +1881,19 @@ static bool netplay_get_cmd(netplay_t *netplay,
                   return netplay_cmd_nak(netplay, connection);
                }
 
-               RECV(netplay->zbuffer, cmd_size - 2*sizeof(uint32_t))
+               if (cmd == NETPLAY_CMD_LOAD_SAVESTATE_DELTA)
+               {
+                  RECV(&ref_crc, sizeof(ref_crc))
+                  {
+                     RARCH_ERR("CMD_LOAD_SAVESTATE failed to receive reference CRC.\n");
+                     return netplay_cmd_nak(netplay, connection);
+                  }
+                  ref_crc     = ntohl(ref_crc);
+                  target      = netplay->savestate_patch;
+                  target_size = state_manager_raw_maxsize(netplay->state_size);
+               }
+
+               RECV(netplay->zbuffer, cmd_size - header_size)
                {
                   RARCH_ERR("CMD_LOAD_SAVESTATE failed to receive savestate.\n");
                   return netplay_cmd_nak(netplay, connection);
@@ -1692,13 +1909,41 @@ static bool netplay_get_cmd(netplay_t *netplay,
                      ctrans = &netplay->compress_nil;
                }
                ctrans->decompression_backend->set_in(ctrans->decompression_stream,
-                  netplay->zbuffer, cmd_size - 2*sizeof(uint32_t));
+                  netplay->zbuffer, (uint32_t)(cmd_size - header_size));
                ctrans->decompression_backend->set_out(ctrans->decompression_stream,
-                  (uint8_t*)netplay->buffer[load_ptr].state,
-                  (unsigned)netplay->state_size);
+                  target, (uint32_t)target_size);
                ctrans->decompression_backend->trans(ctrans->decompression_stream,
                   true, &rd, &wn, NULL);
 
+               if (cmd == NETPLAY_CMD_LOAD_SAVESTATE_DELTA)
+               {
+                  /* The delta is only meaningful against the exact state
+                   * the sender used; if a load crossed this one in flight,
+                   * our references differ and we need the full state */
+                  if (!connection->savestate_ref_valid ||
+                        ref_crc != netplay->savestate_ref_crc ||
+                        !state_manager_raw_patch_valid(netplay->savestate_patch,
+                           wn, netplay->state_size))
+                  {
+                     RARCH_WARN("[netplay] Savestate delta does not match our reference, requesting full state.\n");
+                     if (!netplay_cmd_request_full_savestate(netplay,
+                              connection))
+                        return false;
+                     break;
+                  }
+
+                  state_manager_raw_decompress(netplay->savestate_patch, wn,
+                        netplay->savestate_ref, netplay->state_size);
+                  memcpy(netplay->buffer[load_ptr].state,
+                        netplay->savestate_ref, netplay->state_size);
+               }
+
+               netplay->buffer[load_ptr].have_state = true;
+
+               /* This is now the state we share with this peer */
+               netplay_savestate_ref_update(netplay,
+                     netplay->buffer[load_ptr].state, connection);
+
                /* Force a rewind to the relevant frame */
                netplay->force_rewind = true;
             }
@@ -1753,6 +1998,33 @@ static bool netplay_get_cmd(netplay_t *netplay,
             break;
          }
 
+      case NETPLAY_CMD_UDP_INPUT:
+         {
+            uint32_t payload[2];
+
+            if (netplay->is_server || !connection->udp_supported)
+            {
+               RARCH_ERR("Unexpected NETPLAY_CMD_UDP_INPUT.\n");
+               return netplay_cmd_nak(netplay, connection);
+            }
+
+            if (cmd_size != sizeof(payload))
+            {
+               RARCH_ERR("NETPLAY_CMD_UDP_INPUT received an unexpected payload size.\n");
+               return netplay_cmd_nak(netplay, connection);
+            }
+
+            RECV(payload, sizeof(payload))
+            {
+               RARCH_ERR("Failed to receive NETPLAY_CMD_UDP_INPUT payload.\n");
+               return netplay_cmd_nak(netplay, connection);
+            }
+
+            netplay_udp_connect(netplay, connection, ntohl(payload[0]),
+                  (uint16_t)ntohl(payload[1]));
+            break;
+         }
+
       case NETPLAY_CMD_PAUSE:
          {
             char msg[512], nick[NETPLAY_NICK_LEN];
@@ -1877,6 +2149,9 @@ int netplay_poll_net_input(netplay_t *netplay, bool block)
    if (max_fd == 0)
       return 0;
 
+   if (netplay->udp_fd >= max_fd)
+      max_fd = netplay->udp_fd + 1;
+
    netplay->timeout_cnt = 0;
 
    do
@@ -1885,6 +2160,10 @@ int netplay_poll_net_input(netplay_t *netplay, bool block)
 
       netplay->timeout_cnt++;
 
+      /* Early input from the UDP channel */
+      if (netplay->udp_fd >= 0)
+         netplay_udp_poll(netplay);
+
       /* Read input from each connection */
       for (i = 0; i < netplay->connections_size; i++)
       {
@@ -1915,6 +2194,8 @@ int netplay_poll_net_input(netplay_t *netplay, bool block)
                if (connection->active)
                   FD_SET(connection->fd, &fds);
             }
+            if (netplay->udp_fd >= 0)
+               FD_SET(netplay->udp_fd, &fds);
 
             if (socket_select(max_fd, &fds, NULL, NULL, &tv) < 0)
                return -1;
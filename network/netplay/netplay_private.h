@@ -54,6 +54,19 @@ typedef uint32_t client_bitmap_t;
 
 #define NETPLAY_MAX_STALL_FRAMES       60
 #define NETPLAY_FRAME_RUN_TIME_WINDOW  120
+
+/* Upper bound on the savestate checkpoint interval, and how many frames
+ * without a replay we wait before widening it again */
+#define NETPLAY_MAX_CHECKPOINT_FRAMES  8
+
+/* UDP input channel: datagram magic ("RAUP"), frames of input history
+ * repeated in every datagram, the most input words per frame we carry, and
+ * how many frames of received input we keep per client */
+#define NETPLAY_UDP_MAGIC              0x52415550
+#define NETPLAY_UDP_INPUT_HISTORY      8
+#define NETPLAY_UDP_MAX_INPUT_WORDS    16
+#define NETPLAY_UDP_INPUT_RING         64
+#define NETPLAY_CHECKPOINT_QUIET_FRAMES 120
 #define NETPLAY_MAX_REQ_STALL_TIME     60
 #define NETPLAY_MAX_REQ_STALL_FREQUENCY 120
 
@@ -88,11 +101,16 @@ typedef uint32_t client_bitmap_t;
    (RETRO_SERIALIZATION_QUIRK_PLATFORM_DEPENDENT)
 
 /* Compression protocols supported */
-#define NETPLAY_COMPRESSION_ZLIB (1<<0)
+#define NETPLAY_COMPRESSION_ZLIB  (1<<0)
+/* Savestates may be sent as a delta against the last shared state */
+#define NETPLAY_COMPRESSION_DELTA (1<<1)
+/* Other capabilities, advertised in the same handshake word */
+#define NETPLAY_FEATURE_UDP_INPUT (1<<16)
 #if HAVE_ZLIB
-#define NETPLAY_COMPRESSION_SUPPORTED NETPLAY_COMPRESSION_ZLIB
+#define NETPLAY_COMPRESSION_SUPPORTED \
+   (NETPLAY_COMPRESSION_ZLIB | NETPLAY_COMPRESSION_DELTA)
 #else
-#define NETPLAY_COMPRESSION_SUPPORTED 0
+#define NETPLAY_COMPRESSION_SUPPORTED NETPLAY_COMPRESSION_DELTA
 #endif
 
 enum netplay_cmd
@@ -166,6 +184,14 @@ enum netplay_cmd
    /* Sends over cheats enabled on client (unsupported) */
    NETPLAY_CMD_CHEATS         = 0x0047,
 
+   /* Send a savestate as a delta against the last state both sides
+    * exchanged (only if NETPLAY_COMPRESSION_DELTA was negotiated) */
+   NETPLAY_CMD_LOAD_SAVESTATE_DELTA = 0x0048,
+
+   /* Announce the UDP input channel: token and UDP port (server to client,
+    * only if both sides advertised NETPLAY_FEATURE_UDP_INPUT) */
+   NETPLAY_CMD_UDP_INPUT      = 0x0049,
+
    /* Misc. commands */
 
    /* Sends multiple config requests over,
@@ -183,6 +209,7 @@ enum netplay_cmd
 #define NETPLAY_CMD_MODE_BIT_YOU       (1U<<31)
 #define NETPLAY_CMD_MODE_BIT_PLAYING   (1U<<30)
 #define NETPLAY_CMD_MODE_BIT_SLAVE     (1U<<29)
+#define NETPLAY_CMD_REQUEST_SAVESTATE_BIT_FULL (1U<<31)
 
 /* These are the reasons given for mode changes to be rejected */
 enum netplay_cmd_mode_reasons
@@ -296,7 +323,8 @@ struct delta_frame
    /* The real input */
    netplay_input_state_t real_input[MAX_INPUT_DEVICES]; /* ptr alignment */
 
-   /* The serialized state of the core at this frame, before input */
+   /* The serialized state of the core at this frame, before input. Only
+    * meaningful if have_state is set. */
    void *state;
 
    uint32_t frame;
@@ -311,12 +339,35 @@ struct delta_frame
    /* Have we read local input? */
    bool have_local;
 
+   /* Is state a serialization of this frame (i.e., a checkpoint)? */
+   bool have_state;
+
    /* Have we read the real (remote) input? */
    bool have_real[MAX_CLIENTS];
 
    bool used; /* a bit derpy, but this is how we know if the delta's been used at all */
 };
 
+/* A frame of a client's input received over the UDP input channel */
+struct netplay_udp_input
+{
+   uint32_t frame;
+   uint32_t size; /* in words, 0 if unused */
+   uint32_t data[NETPLAY_UDP_MAX_INPUT_WORDS];
+};
+
+/* A refcounted piece of outgoing stream, shared by the spectators it is
+ * queued for */
+struct netplay_relay_chunk
+{
+   size_t refcount;
+   size_t size;
+   unsigned char data[1];
+};
+
+struct netplay_relay;
+struct netplay_relay_peer;
+
 struct socket_buffer
 {
    unsigned char *data;
@@ -324,6 +375,10 @@ struct socket_buffer
    size_t start;
    size_t end;
    size_t read;
+
+   /* If set, flushing hands the data to the spectator relay instead of
+    * writing it to the socket */
+   struct netplay_relay_peer *relay;
 };
 
 /* Each connection gets a connection struct */
@@ -349,6 +404,14 @@ struct netplay_connection
    /* What compression does this peer support? */
    uint32_t compression_supported;
 
+   /* Token identifying this connection's UDP input datagrams */
+   uint32_t udp_token;
+
+   /* Where to send UDP input datagrams (learned from the first datagram on
+    * the server) */
+   struct sockaddr_storage udp_addr;
+   socklen_t udp_addr_len;
+
    /* For the server: When was the last time we requested this client to stall?
     * For the client: How many frames of stall do we have left? */
    uint32_t stall_frame;
@@ -371,6 +434,17 @@ struct netplay_connection
    /* Is this connection allowed to play (server only)? */
    bool can_play;
 
+   /* Does this peer accept savestate deltas? */
+   bool savestate_delta;
+
+   /* Does this peer hold our savestate reference (savestate_ref)? */
+   bool savestate_ref_valid;
+
+   /* Did this peer advertise NETPLAY_FEATURE_UDP_INPUT, and do we know
+    * where to send its datagrams? */
+   bool udp_supported;
+   bool udp_active;
+
    /* Is this connection buffer in use? */
    bool active;
 };
@@ -403,6 +477,9 @@ struct netplay
    /* TCP connection for listening (server only) */
    int listen_fd;
 
+   /* UDP socket for the input channel, or -1 */
+   int udp_fd;
+
    /* Our client number */
    uint32_t self_client_num;
 
@@ -453,6 +530,15 @@ struct netplay
    uint8_t *zbuffer;
    size_t zbuffer_size;
 
+   /* The last savestate exchanged with our peers, the state being sent
+    * and the delta between them, for NETPLAY_CMD_LOAD_SAVESTATE_DELTA.
+    * NULL if deltas are unavailable. */
+   uint8_t *savestate_ref;
+   uint8_t *savestate_cur;
+   uint8_t *savestate_patch;
+   size_t savestate_patch_size;
+   uint32_t savestate_ref_crc;
+
    /* The size of our packet buffers */
    size_t packet_buffer_size;
 
@@ -503,6 +589,12 @@ struct netplay
    /* Frequency with which to check CRCs */
    int check_frames;
 
+   /* Savestate checkpoint interval: the configured maximum, the one in
+    * use, and how many frames have passed since the last replay */
+   uint32_t checkpoint_frames_max;
+   uint32_t checkpoint_frames;
+   uint32_t checkpoint_quiet;
+
    /* How far behind did we fall? */
    uint32_t catch_up_behind;
 
@@ -515,6 +607,16 @@ struct netplay
    /* TCP port (only set if serving) */
    uint16_t tcp_port;
 
+   /* Port of our UDP input socket */
+   uint16_t udp_port;
+
+   /* Input received over UDP, NETPLAY_UDP_INPUT_RING frames per client.
+    * Only used to predict input TCP hasn't delivered yet. */
+   struct netplay_udp_input *udp_input;
+
+   /* Spectator relay (server only), if enabled */
+   struct netplay_relay *relay;
+
    /* The sharing mode for each device */
    uint8_t device_share_modes[MAX_INPUT_DEVICES];
 
@@ -670,6 +772,17 @@ bool netplay_delta_frame_ready(netplay_t *netplay, struct delta_frame *delta,
  */
 uint32_t netplay_delta_frame_crc(netplay_t *netplay, struct delta_frame *delta);
 
+/**
+ * netplay_delta_frame_checkpoint
+ *
+ * Find the newest serialized frame at or before the given ptr and frame,
+ * i.e., the frame a replay from there has to start from, and store it back.
+ *
+ * Returns: True if such a frame is still in the buffer, false otherwise.
+ */
+bool netplay_delta_frame_checkpoint(netplay_t *netplay, size_t *ptr,
+   uint32_t *frame_count);
+
 /**
  * netplay_delta_frame_free
  *
@@ -784,8 +897,11 @@ bool netplay_wait_and_init_serialization(netplay_t *netplay);
  * @port                 : Port of server.
  * @stateless_mode       : Shall we run in stateless mode?
  * @check_frames         : Frequency with which to check CRCs.
+ * @checkpoint_frames    : Maximum interval between savestate checkpoints.
  * @cb                   : Libretro callbacks.
  * @nat_traversal        : If true, attempt NAT traversal.
+ * @udp_input            : If true, offer the UDP input channel.
+ * @spectator_relay      : If true, send to spectators from a relay thread.
  * @nick                 : Nickname of user.
  * @quirks               : Netplay quirks required for this session.
  *
@@ -795,9 +911,10 @@ bool netplay_wait_and_init_serialization(netplay_t *netplay);
  * Returns: new netplay data.
  */
 netplay_t *netplay_new(void *direct_host, const char *server, uint16_t port,
-   bool stateless_mode, int check_frames,
-   const struct retro_callbacks *cb, bool nat_traversal, const char *nick,
-   uint64_t quirks);
+   bool stateless_mode, int check_frames, unsigned checkpoint_frames,
+   const struct retro_callbacks *cb, bool nat_traversal, bool udp_input,
+   bool spectator_relay,
+   const char *nick, uint64_t quirks);
 
 /**
  * netplay_free
@@ -826,6 +943,17 @@ void netplay_hangup(netplay_t *netplay, struct netplay_connection *connection);
  */
 void netplay_delayed_state_change(netplay_t *netplay);
 
+/**
+ * netplay_pack_input
+ *
+ * Write a client's input for a frame, in network byte order, as carried by
+ * NETPLAY_CMD_INPUT after the frame and client number.
+ *
+ * Returns the number of words written.
+ */
+size_t netplay_pack_input(netplay_t *netplay, struct delta_frame *dframe,
+   uint32_t client_num, bool slave, uint32_t *buffer, size_t size);
+
 /**
  * netplay_send_cur_input
  *
@@ -836,6 +964,14 @@ void netplay_delayed_state_change(netplay_t *netplay);
 bool netplay_send_cur_input(netplay_t *netplay,
    struct netplay_connection *connection);
 
+/**
+ * netplay_send_cur_input_relayed
+ *
+ * Hand spectators to or back from the spectator relay as their modes change,
+ * then send the current input frame to all relayed spectators at once.
+ */
+void netplay_send_cur_input_relayed(netplay_t *netplay);
+
 /**
  * netplay_send_raw_cmd
  *
@@ -871,6 +1007,15 @@ bool netplay_cmd_crc(netplay_t *netplay, struct delta_frame *delta);
  */
 bool netplay_cmd_request_savestate(netplay_t *netplay);
 
+/**
+ * netplay_savestate_ref_update
+ *
+ * Remember the savestate now shared with our peers as the reference for
+ * savestate deltas. If @connection is given, only that peer holds it.
+ */
+void netplay_savestate_ref_update(netplay_t *netplay, const void *state,
+      struct netplay_connection *connection);
+
 /**
  * netplay_cmd_mode
  *
@@ -943,6 +1088,95 @@ uint32_t netplay_key_hton(unsigned key);
  * netplay_key_hton */
 void netplay_key_hton_init(void);
 
+/***************************************************************
+ * NETPLAY-RELAY.C
+ **************************************************************/
+
+/**
+ * netplay_relay_new
+ *
+ * Create the spectator relay and start its thread.
+ *
+ * Returns the relay, or NULL on failure.
+ */
+struct netplay_relay *netplay_relay_new(void);
+
+/**
+ * netplay_relay_free
+ *
+ * Stop the relay thread and free the relay. Spectators must have been
+ * detached.
+ */
+void netplay_relay_free(struct netplay_relay *relay);
+
+/**
+ * netplay_relay_chunk_new
+ *
+ * Allocate a chunk of the given size to fill and hand to
+ * netplay_relay_send. The caller holds the only reference.
+ */
+struct netplay_relay_chunk *netplay_relay_chunk_new(size_t size);
+
+/**
+ * netplay_relay_chunk_unref
+ *
+ * Drop a reference to a chunk.
+ */
+void netplay_relay_chunk_unref(struct netplay_relay *relay,
+      struct netplay_relay_chunk *chunk);
+
+/**
+ * netplay_relay_attach
+ *
+ * Hand a connection's outgoing stream over to the relay thread.
+ *
+ * Returns true on success.
+ */
+bool netplay_relay_attach(struct netplay_relay *relay,
+      struct netplay_connection *connection);
+
+/**
+ * netplay_relay_detach
+ *
+ * Take a connection's outgoing stream back from the relay thread. If keep is
+ * set, whatever the relay hasn't sent yet is put back in the connection's
+ * socket buffer; otherwise it's discarded.
+ *
+ * Returns false if keep was set but the connection broke.
+ */
+bool netplay_relay_detach(struct netplay_connection *connection, bool keep);
+
+/**
+ * netplay_relay_push
+ *
+ * Queue a private copy of the given data for a relayed connection.
+ *
+ * Returns false if the connection broke or fell too far behind.
+ */
+bool netplay_relay_push(struct netplay_relay_peer *peer,
+      const void *data, size_t len);
+
+/**
+ * netplay_relay_flush
+ *
+ * Move whatever is in a relayed connection's socket buffer onto its relay
+ * queue.
+ *
+ * Returns false if the connection broke or fell too far behind.
+ */
+bool netplay_relay_flush(struct socket_buffer *sbuf);
+
+/**
+ * netplay_relay_send
+ *
+ * Queue a shared chunk for a relayed connection, after anything already in
+ * its socket buffer.
+ *
+ * Returns false if the connection broke or fell too far behind.
+ */
+bool netplay_relay_send(struct netplay_connection *connection,
+      struct netplay_relay_chunk *chunk);
+
 /***************************************************************
  * NETPLAY-SYNC.C
  **************************************************************/
@@ -986,4 +1220,68 @@ bool netplay_sync_pre_frame(netplay_t *netplay);
  */
 void netplay_sync_post_frame(netplay_t *netplay, bool stalled);
 
+/***************************************************************
+ * NETPLAY-UDP.C
+ **************************************************************/
+
+/**
+ * netplay_udp_init
+ *
+ * Open the UDP input channel socket, next to our TCP socket.
+ *
+ * Returns true on success.
+ */
+bool netplay_udp_init(netplay_t *netplay);
+
+/**
+ * netplay_udp_deinit
+ *
+ * Close the UDP input channel.
+ */
+void netplay_udp_deinit(netplay_t *netplay);
+
+/**
+ * netplay_udp_announce
+ *
+ * Tell a client where to send its UDP input datagrams (server only).
+ *
+ * Returns false if the connection broke.
+ */
+bool netplay_udp_announce(netplay_t *netplay,
+   struct netplay_connection *connection);
+
+/**
+ * netplay_udp_connect
+ *
+ * Handle a server's NETPLAY_CMD_UDP_INPUT announcement (client only).
+ */
+void netplay_udp_connect(netplay_t *netplay,
+   struct netplay_connection *connection, uint32_t token, uint16_t port);
+
+/**
+ * netplay_udp_send_input
+ *
+ * Send our recent input history to a connection over UDP.
+ */
+void netplay_udp_send_input(netplay_t *netplay,
+   struct netplay_connection *connection);
+
+/**
+ * netplay_udp_poll
+ *
+ * Read all pending UDP input datagrams.
+ */
+void netplay_udp_poll(netplay_t *netplay);
+
+/**
+ * netplay_udp_predict
+ *
+ * Fetch a device's input for a frame from the UDP input channel, for use
+ * until the same input arrives over TCP.
+ *
+ * Returns true if data was filled in.
+ */
+bool netplay_udp_predict(netplay_t *netplay, uint32_t client_num,
+   uint32_t frame, uint32_t device, uint32_t *data, uint32_t dsize);
+
 #endif
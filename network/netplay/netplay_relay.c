@@ -0,0 +1,470 @@
+/*  RetroArch - A frontend for libretro.
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* The spectator relay.
+ *
+ * Spectators all receive the same stream: everybody's input, and the
+ * occasional savestate. Rather than copying that stream into every
+ * spectator's socket buffer and writing it out from the main thread, the
+ * server serializes it once into a refcounted chunk and queues a reference
+ * per spectator. A relay thread writes the queues out as the sockets allow.
+ *
+ * Anything else sent to a relayed spectator still goes through its
+ * socket_buffer as usual; flushing the buffer just moves its contents onto
+ * the spectator's queue, so the stream stays in order. */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <net/net_compat.h>
+#include <net/net_socket.h>
+
+#ifdef HAVE_THREADS
+#include <rthreads/rthreads.h>
+#endif
+
+#include "netplay_private.h"
+
+/* A spectator that falls this far behind is dropped */
+#define NETPLAY_RELAY_MAX_BACKLOG (32 * 1024 * 1024)
+
+/* How long the relay thread waits on sockets before checking for new data
+ * for the others */
+#define NETPLAY_RELAY_SELECT_USEC 1000
+
+#ifdef HAVE_THREADS
+struct netplay_relay_entry
+{
+   struct netplay_relay_chunk *chunk;
+   struct netplay_relay_entry *next;
+};
+
+struct netplay_relay_peer
+{
+   struct netplay_relay *relay;
+   struct netplay_relay_peer *next;
+
+   /* Queued chunks, and how much of the first has been sent */
+   struct netplay_relay_entry *head, *tail;
+   size_t offset;
+   size_t backlog;
+
+   int fd;
+   bool failed;
+};
+
+struct netplay_relay
+{
+   sthread_t *thread;
+   slock_t *lock;
+   scond_t *cond;
+   struct netplay_relay_peer *peers;
+
+   /* Counts the relay thread's selects. While one is running, the sockets
+    * it was given must stay open. */
+   unsigned select_count;
+   bool selecting;
+   bool quit;
+};
+
+/* Must be called with the lock held */
+static void netplay_relay_unref_locked(struct netplay_relay_chunk *chunk)
+{
+   if (--chunk->refcount == 0)
+      free(chunk);
+}
+
+/* Must be called with the lock held */
+static void netplay_relay_pop_locked(struct netplay_relay_peer *peer)
+{
+   struct netplay_relay_entry *entry = peer->head;
+
+   peer->backlog -= entry->chunk->size - peer->offset;
+   peer->offset   = 0;
+   peer->head     = entry->next;
+   if (!peer->head)
+      peer->tail  = NULL;
+
+   netplay_relay_unref_locked(entry->chunk);
+   free(entry);
+}
+
+/* Must be called with the lock held */
+static bool netplay_relay_queue_locked(struct netplay_relay_peer *peer,
+      struct netplay_relay_chunk *chunk)
+{
+   struct netplay_relay_entry *entry;
+
+   if (peer->failed || peer->backlog + chunk->size > NETPLAY_RELAY_MAX_BACKLOG)
+      return false;
+
+   entry = (struct netplay_relay_entry*)malloc(sizeof(*entry));
+   if (!entry)
+      return false;
+
+   chunk->refcount++;
+   entry->chunk   = chunk;
+   entry->next    = NULL;
+   if (peer->tail)
+      peer->tail->next = entry;
+   else
+      peer->head       = entry;
+   peer->tail     = entry;
+   peer->backlog += chunk->size;
+
+   return true;
+}
+
+/* Write out as much of a peer's queue as its socket takes. Must be called
+ * with the lock held. Returns true if data is left over. */
+static bool netplay_relay_write_locked(struct netplay_relay_peer *peer)
+{
+   while (peer->head && !peer->failed)
+   {
+      struct netplay_relay_chunk *chunk = peer->head->chunk;
+      ssize_t sent = socket_send_all_nonblocking(peer->fd,
+            chunk->data + peer->offset, chunk->size - peer->offset, true);
+
+      if (sent < 0)
+         peer->failed = true;
+      else if ((size_t)sent < chunk->size - peer->offset)
+      {
+         peer->offset  += sent;
+         peer->backlog -= sent;
+         return true;
+      }
+      else
+         netplay_relay_pop_locked(peer);
+   }
+
+   return false;
+}
+
+static void netplay_relay_thread(void *data)
+{
+   struct netplay_relay *relay = (struct netplay_relay*)data;
+
+   slock_lock(relay->lock);
+   while (!relay->quit)
+   {
+      struct netplay_relay_peer *peer;
+      struct timeval tv;
+      fd_set fds;
+      int max_fd = -1;
+
+      FD_ZERO(&fds);
+      for (peer = relay->peers; peer; peer = peer->next)
+      {
+         if (!netplay_relay_write_locked(peer))
+            continue;
+         FD_SET(peer->fd, &fds);
+         if (peer->fd > max_fd)
+            max_fd = peer->fd;
+      }
+
+      if (max_fd < 0)
+      {
+         /* Nothing blocked, so wait for more data */
+         scond_wait(relay->cond, relay->lock);
+         continue;
+      }
+
+      /* Wait for the blocked sockets, but not for long, as new data may
+       * have come in for the others */
+      relay->select_count++;
+      relay->selecting = true;
+      slock_unlock(relay->lock);
+      tv.tv_sec  = 0;
+      tv.tv_usec = NETPLAY_RELAY_SELECT_USEC;
+      socket_select(max_fd + 1, NULL, &fds, NULL, &tv);
+      slock_lock(relay->lock);
+      relay->selecting = false;
+
+      /* Wake netplay_relay_detach, which may be waiting for this select
+       * to let go of its socket */
+      scond_broadcast(relay->cond);
+   }
+   slock_unlock(relay->lock);
+}
+
+/**
+ * netplay_relay_new
+ *
+ * Create the spectator relay and start its thread.
+ *
+ * Returns the relay, or NULL on failure.
+ */
+struct netplay_relay *netplay_relay_new(void)
+{
+   struct netplay_relay *relay = (struct netplay_relay*)
+      calloc(1, sizeof(*relay));
+   if (!relay)
+      return NULL;
+
+   relay->lock = slock_new();
+   relay->cond = scond_new();
+   if (!relay->lock || !relay->cond)
+      goto error;
+
+   relay->thread = sthread_create(netplay_relay_thread, relay);
+   if (!relay->thread)
+      goto error;
+
+   return relay;
+
+error:
+   if (relay->cond)
+      scond_free(relay->cond);
+   if (relay->lock)
+      slock_free(relay->lock);
+   free(relay);
+   return NULL;
+}
+
+/**
+ * netplay_relay_free
+ *
+ * Stop the relay thread and free the relay. Spectators must have been
+ * detached.
+ */
+void netplay_relay_free(struct netplay_relay *relay)
+{
+   slock_lock(relay->lock);
+   relay->quit = true;
+   scond_signal(relay->cond);
+   slock_unlock(relay->lock);
+
+   sthread_join(relay->thread);
+   scond_free(relay->cond);
+   slock_free(relay->lock);
+   free(relay);
+}
+
+/**
+ * netplay_relay_chunk_new
+ *
+ * Allocate a chunk of the given size to fill and hand to
+ * netplay_relay_send. The caller holds the only reference.
+ */
+struct netplay_relay_chunk *netplay_relay_chunk_new(size_t size)
+{
+   struct netplay_relay_chunk *chunk = (struct netplay_relay_chunk*)
+      malloc(sizeof(*chunk) + size);
+   if (!chunk)
+      return NULL;
+   chunk->refcount = 1;
+   chunk->size     = size;
+   return chunk;
+}
+
+/**
+ * netplay_relay_chunk_unref
+ *
+ * Drop a reference to a chunk.
+ */
+void netplay_relay_chunk_unref(struct netplay_relay *relay,
+      struct netplay_relay_chunk *chunk)
+{
+   slock_lock(relay->lock);
+   netplay_relay_unref_locked(chunk);
+   slock_unlock(relay->lock);
+}
+
+/**
+ * netplay_relay_attach
+ *
+ * Hand a connection's outgoing stream over to the relay thread.
+ *
+ * Returns true on success.
+ */
+bool netplay_relay_attach(struct netplay_relay *relay,
+      struct netplay_connection *connection)
+{
+   struct netplay_relay_peer *peer = (struct netplay_relay_peer*)
+      calloc(1, sizeof(*peer));
+   if (!peer)
+      return false;
+
+   /* Anything already in the socket buffer is ahead of the (empty) queue,
+    * and will be moved onto it by the next flush */
+   peer->relay = relay;
+   peer->fd    = connection->fd;
+
+   slock_lock(relay->lock);
+   peer->next   = relay->peers;
+   relay->peers = peer;
+   slock_unlock(relay->lock);
+
+   connection->send_packet_buffer.relay = peer;
+   return true;
+}
+
+/**
+ * netplay_relay_detach
+ *
+ * Take a connection's outgoing stream back from the relay thread. If keep is
+ * set, whatever the relay hasn't sent yet is put back in the connection's
+ * socket buffer; otherwise it's discarded.
+ *
+ * Returns false if keep was set but the connection broke.
+ */
+bool netplay_relay_detach(struct netplay_connection *connection, bool keep)
+{
+   struct netplay_relay_peer *peer = connection->send_packet_buffer.relay;
+   struct netplay_relay *relay;
+   struct netplay_relay_peer **pp;
+   unsigned select_count;
+   bool ret;
+
+   if (!peer)
+      return true;
+   relay = peer->relay;
+
+   /* Once it's off the list, the relay thread can't touch it */
+   slock_lock(relay->lock);
+   for (pp = &relay->peers; *pp; pp = &(*pp)->next)
+   {
+      if (*pp == peer)
+      {
+         *pp = peer->next;
+         break;
+      }
+   }
+   ret = !peer->failed;
+
+   /* A select that is already running may still be waiting on the socket,
+    * which the caller is about to close. Later ones won't include it. */
+   select_count = relay->select_count;
+   while (relay->selecting && relay->select_count == select_count)
+      scond_wait(relay->cond, relay->lock);
+   slock_unlock(relay->lock);
+
+   connection->send_packet_buffer.relay = NULL;
+
+   while (peer->head)
+   {
+      struct netplay_relay_chunk *chunk = peer->head->chunk;
+      if (keep && ret)
+         ret = netplay_send(&connection->send_packet_buffer, connection->fd,
+               chunk->data + peer->offset, chunk->size - peer->offset);
+      slock_lock(relay->lock);
+      netplay_relay_pop_locked(peer);
+      slock_unlock(relay->lock);
+   }
+
+   free(peer);
+   return ret || !keep;
+}
+
+/**
+ * netplay_relay_push
+ *
+ * Queue a private copy of the given data for a relayed connection.
+ *
+ * Returns false if the connection broke or fell too far behind.
+ */
+bool netplay_relay_push(struct netplay_relay_peer *peer,
+      const void *data, size_t len)
+{
+   bool ret;
+   struct netplay_relay *relay = peer->relay;
+   struct netplay_relay_chunk *chunk;
+
+   if (!len)
+      return !peer->failed;
+
+   chunk = netplay_relay_chunk_new(len);
+   if (!chunk)
+      return false;
+   memcpy(chunk->data, data, len);
+
+   slock_lock(relay->lock);
+   ret = netplay_relay_queue_locked(peer, chunk);
+   netplay_relay_unref_locked(chunk);
+   scond_signal(relay->cond);
+   slock_unlock(relay->lock);
+
+   return ret;
+}
+
+/**
+ * netplay_relay_flush
+ *
+ * Move whatever is in a relayed connection's socket buffer onto its relay
+ * queue.
+ *
+ * Returns false if the connection broke or fell too far behind.
+ */
+bool netplay_relay_flush(struct socket_buffer *sbuf)
+{
+   bool ret = true;
+
+   if (sbuf->end < sbuf->start)
+   {
+      ret = netplay_relay_push(sbuf->relay, sbuf->data + sbuf->start,
+            sbuf->bufsz - sbuf->start) &&
+         netplay_relay_push(sbuf->relay, sbuf->data, sbuf->end);
+   }
+   else
+      ret = netplay_relay_push(sbuf->relay, sbuf->data + sbuf->start,
+            sbuf->end - sbuf->start);
+
+   sbuf->start = sbuf->end = 0;
+   return ret;
+}
+
+/**
+ * netplay_relay_send
+ *
+ * Queue a shared chunk for a relayed connection, after anything already in
+ * its socket buffer.
+ *
+ * Returns false if the connection broke or fell too far behind.
+ */
+bool netplay_relay_send(struct netplay_connection *connection,
+      struct netplay_relay_chunk *chunk)
+{
+   bool ret;
+   struct netplay_relay_peer *peer = connection->send_packet_buffer.relay;
+   struct netplay_relay *relay     = peer->relay;
+
+   if (!netplay_relay_flush(&connection->send_packet_buffer))
+      return false;
+
+   slock_lock(relay->lock);
+   ret = netplay_relay_queue_locked(peer, chunk);
+   scond_signal(relay->cond);
+   slock_unlock(relay->lock);
+
+   return ret;
+}
+#else
+struct netplay_relay *netplay_relay_new(void) { return NULL; }
+void netplay_relay_free(struct netplay_relay *relay) { }
+struct netplay_relay_chunk *netplay_relay_chunk_new(size_t size)
+{
+   return NULL;
+}
+void netplay_relay_chunk_unref(struct netplay_relay *relay,
+      struct netplay_relay_chunk *chunk) { }
+bool netplay_relay_attach(struct netplay_relay *relay,
+      struct netplay_connection *connection) { return false; }
+bool netplay_relay_detach(struct netplay_connection *connection,
+      bool keep) { return true; }
+bool netplay_relay_push(struct netplay_relay_peer *peer,
+      const void *data, size_t len) { return false; }
+bool netplay_relay_flush(struct socket_buffer *sbuf) { return false; }
+bool netplay_relay_send(struct netplay_connection *connection,
+      struct netplay_relay_chunk *chunk) { return false; }
+#endif
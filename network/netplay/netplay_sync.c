@@ -389,6 +389,16 @@ bool netplay_resolve_input(netplay_t *netplay, size_t sim_ptr, bool resim)
             if (!simstate)
                continue;
 
+            /* If this input already came in over UDP, that's as good as a
+             * prediction gets */
+            if (netplay->udp_input && netplay_udp_predict(netplay, client,
+                     simframe->frame, device, simstate->data, dsize))
+            {
+               client_state = simstate;
+               client_count++;
+               continue;
+            }
+
             prev = PREV_PTR(netplay->read_ptr[client]);
             pframe = &netplay->buffer[prev];
             pstate = netplay_input_state_for(&pframe->real_input[device], client, dsize, false, true);
@@ -508,6 +518,9 @@ bool netplay_resolve_input(netplay_t *netplay, size_t sim_ptr, bool resim)
 static void netplay_handle_frame_hash(netplay_t *netplay,
       struct delta_frame *delta)
 {
+   if (!delta->have_state)
+      return;
+
    if (netplay->is_server)
    {
       if (netplay->check_frames &&
@@ -544,6 +557,47 @@ static void netplay_handle_frame_hash(netplay_t *netplay,
    }
 }
 
+/**
+ * netplay_sync_want_checkpoint
+ *
+ * Should the state before this frame be serialized? Frames whose CRC we
+ * exchange always are, and so is the frame we're about to send; otherwise,
+ * one frame per checkpoint interval.
+ */
+static bool netplay_sync_want_checkpoint(netplay_t *netplay, uint32_t frame)
+{
+   return netplay->checkpoint_frames <= 1
+      || netplay->force_send_savestate
+      || (netplay->check_frames &&
+          frame % abs(netplay->check_frames) == 0)
+      || frame % netplay->checkpoint_frames == 0;
+}
+
+/**
+ * netplay_sync_serialize
+ *
+ * Serialize the core into a delta frame.
+ *
+ * Returns: true if the frame now holds its state.
+ */
+static bool netplay_sync_serialize(netplay_t *netplay,
+      struct delta_frame *delta)
+{
+   retro_ctx_serialize_info_t serial_info;
+
+   serial_info.data_const = NULL;
+   serial_info.data       = delta->state;
+   serial_info.size       = netplay->state_size;
+
+   /* Only states we CRC need the unused tail to be deterministic */
+   if (delta->crc || (netplay->check_frames &&
+          delta->frame % abs(netplay->check_frames) == 0))
+      memset(serial_info.data, 0, serial_info.size);
+
+   delta->have_state = core_serialize(&serial_info);
+   return delta->have_state;
+}
+
 /**
  * netplay_sync_pre_frame
  * @netplay              : pointer to netplay object
@@ -557,18 +611,25 @@ bool netplay_sync_pre_frame(netplay_t *netplay)
    if (netplay_delta_frame_ready(netplay,
             &netplay->buffer[netplay->run_ptr], netplay->run_frame_count))
    {
-      serial_info.data_const = NULL;
-      serial_info.data       = netplay->buffer[netplay->run_ptr].state;
-      serial_info.size       = netplay->state_size;
+      /* Once replays stop, we only need the odd checkpoint */
+      if (netplay->checkpoint_frames < netplay->checkpoint_frames_max &&
+            ++netplay->checkpoint_quiet >= NETPLAY_CHECKPOINT_QUIET_FRAMES)
+         netplay->checkpoint_frames = netplay->checkpoint_frames_max;
 
-      memset(serial_info.data, 0, serial_info.size);
       if ((netplay->quirks & NETPLAY_QUIRK_INITIALIZATION)
             || netplay->run_frame_count == 0)
       {
          /* Don't serialize until it's safe */
       }
       else if (!(netplay->quirks & NETPLAY_QUIRK_NO_SAVESTATES)
-            && core_serialize(&serial_info))
+            && !netplay_sync_want_checkpoint(netplay,
+               netplay->run_frame_count))
+      {
+         /* Between checkpoints, replays start from the last one */
+      }
+      else if (!(netplay->quirks & NETPLAY_QUIRK_NO_SAVESTATES)
+            && netplay_sync_serialize(netplay,
+               &netplay->buffer[netplay->run_ptr]))
       {
          if (netplay->force_send_savestate && !netplay->stall
                && !netplay->remote_paused)
@@ -580,12 +641,15 @@ bool netplay_sync_pre_frame(netplay_t *netplay)
                memcpy(netplay->buffer[netplay->self_ptr].state,
                   netplay->buffer[netplay->run_ptr].state,
                   netplay->state_size);
+               netplay->buffer[netplay->self_ptr].have_state = true;
                netplay->run_ptr         = netplay->self_ptr;
                netplay->run_frame_count = netplay->self_frame_count;
             }
 
             /* Send this along to the other side */
+            serial_info.data       = NULL;
             serial_info.data_const = netplay->buffer[netplay->run_ptr].state;
+            serial_info.size       = netplay->state_size;
             netplay_load_savestate(netplay, &serial_info, false);
             netplay->force_send_savestate = false;
          }
@@ -836,14 +900,49 @@ void netplay_sync_post_frame(netplay_t *netplay, bool stalled)
        netplay->replay_frame_count < netplay->run_frame_count)
    {
       retro_ctx_serialize_info_t serial_info;
+      uint32_t replay_from = netplay->replay_frame_count;
+      bool have_checkpoint = true;
 
       /* Replay frames. */
       netplay->is_replay = true;
 
+      /* We mispredicted, so checkpoint every frame for a while to keep
+       * the next replay short */
+      netplay->checkpoint_frames = 1;
+      netplay->checkpoint_quiet  = 0;
+
+      /* Replay from the newest checkpoint at or before the first bad frame */
+      if (!netplay->buffer[netplay->replay_ptr].have_state)
+      {
+         size_t ckpt_ptr     = netplay->replay_ptr;
+         uint32_t ckpt_frame = netplay->replay_frame_count;
+         if (netplay_delta_frame_checkpoint(netplay, &ckpt_ptr, &ckpt_frame))
+         {
+            netplay->replay_ptr         = ckpt_ptr;
+            netplay->replay_frame_count = ckpt_frame;
+         }
+         else
+         {
+            /* The frames since the checkpoint were overwritten, so there
+             * is nothing to replay from. Keep running and resynchronize
+             * from the server's state instead. */
+            RARCH_ERR("Netplay replay checkpoint for frame %u lost, resynchronizing.\n",
+                  replay_from);
+            if (netplay->is_server)
+               netplay->force_send_savestate = true;
+            else
+               netplay_cmd_request_savestate(netplay);
+
+            have_checkpoint             = false;
+            netplay->replay_ptr         = netplay->run_ptr;
+            netplay->replay_frame_count = netplay->run_frame_count;
+         }
+      }
+
       /* If we have a keyboard device, we replay the previous frame's input
        * just to assert that the keydown/keyup events work if the core
        * translates them in that way */
-      if (netplay->have_updown_device)
+      if (have_checkpoint && netplay->have_updown_device)
       {
          netplay->replay_ptr = PREV_PTR(netplay->replay_ptr);
          netplay->replay_frame_count--;
@@ -858,17 +957,20 @@ void netplay_sync_post_frame(netplay_t *netplay, bool stalled)
          netplay->replay_frame_count++;
       }
 
-      if (netplay->quirks & NETPLAY_QUIRK_INITIALIZATION)
-         /* Make sure we're initialized before we start loading things */
-         netplay_wait_and_init_serialization(netplay);
+      if (have_checkpoint)
+      {
+         if (netplay->quirks & NETPLAY_QUIRK_INITIALIZATION)
+            /* Make sure we're initialized before we start loading things */
+            netplay_wait_and_init_serialization(netplay);
 
-      serial_info.data       = NULL;
-      serial_info.data_const = netplay->buffer[netplay->replay_ptr].state;
-      serial_info.size       = netplay->state_size;
+         serial_info.data       = NULL;
+         serial_info.data_const = netplay->buffer[netplay->replay_ptr].state;
+         serial_info.size       = netplay->state_size;
 
-      if (!core_unserialize(&serial_info))
-      {
-         RARCH_ERR("Netplay savestate loading failed: Prepare for desync!\n");
+         if (!core_unserialize(&serial_info))
+         {
+            RARCH_ERR("Netplay savestate loading failed: Prepare for desync!\n");
+         }
       }
 
       while (netplay->replay_frame_count < netplay->run_frame_count)
@@ -876,16 +978,17 @@ void netplay_sync_post_frame(netplay_t *netplay, bool stalled)
          retro_time_t start, tm;
          struct delta_frame *ptr = &netplay->buffer[netplay->replay_ptr];
 
-         serial_info.data        = ptr->state;
-         serial_info.size        = netplay->state_size;
-         serial_info.data_const  = NULL;
-
          start                   = cpu_features_get_time_usec();
 
-         /* Remember the current state */
-         memset(serial_info.data, 0, serial_info.size);
-         core_serialize(&serial_info);
-         if (netplay->replay_frame_count < netplay->unread_frame_count)
+         /* Remember the current state. Frames after the first bad one are
+          * being rewritten, so whatever they held before is stale. */
+         if (netplay_sync_want_checkpoint(netplay,
+                  netplay->replay_frame_count))
+            netplay_sync_serialize(netplay, ptr);
+         else if (netplay->replay_frame_count > replay_from)
+            ptr->have_state = false;
+         if (netplay->replay_frame_count >= replay_from &&
+               netplay->replay_frame_count < netplay->unread_frame_count)
             netplay_handle_frame_hash(netplay, ptr);
 
          /* Re-simulate this frame's input */
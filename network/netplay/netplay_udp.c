@@ -0,0 +1,506 @@
+/*  RetroArch - A frontend for libretro.
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* The UDP input channel.
+ *
+ * TCP remains the authority for everything, input included. Each side that
+ * is playing additionally sends its last NETPLAY_UDP_INPUT_HISTORY frames of
+ * input in every UDP datagram, so a single lost datagram costs nothing and a
+ * TCP retransmit stall doesn't hold back input that has already arrived.
+ * Input from the UDP channel is only used as the prediction for frames whose
+ * real input TCP hasn't delivered yet, so a late, lost or forged datagram can
+ * at worst cause a replay, never a desync.
+ *
+ * Datagram format (all words in network byte order):
+ *    magic, token, client number, first frame, frame count, words per frame,
+ *    then the input of each frame in turn.
+ *
+ * Define NETPLAY_UDP_SIM_LOSS (percent) and/or NETPLAY_UDP_SIM_DELAY_MS to
+ * drop and delay outgoing datagrams, for testing over loopback. */
+
+#if defined(_MSC_VER) && !defined(_XBOX)
+#pragma comment(lib, "ws2_32")
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+
+#include <boolean.h>
+
+#include "netplay_private.h"
+
+#if defined(AF_INET6) && !defined(HAVE_SOCKET_LEGACY) && !defined(_3DS)
+#define HAVE_INET6 1
+#endif
+
+#define NETPLAY_UDP_HEADER_WORDS 6
+#define NETPLAY_UDP_MAX_WORDS (NETPLAY_UDP_HEADER_WORDS + \
+      NETPLAY_UDP_INPUT_HISTORY * NETPLAY_UDP_MAX_INPUT_WORDS)
+
+#if defined(NETPLAY_UDP_SIM_LOSS) || defined(NETPLAY_UDP_SIM_DELAY_MS)
+#define NETPLAY_UDP_SIMULATE 1
+#ifndef NETPLAY_UDP_SIM_LOSS
+#define NETPLAY_UDP_SIM_LOSS 0
+#endif
+#ifndef NETPLAY_UDP_SIM_DELAY_MS
+#define NETPLAY_UDP_SIM_DELAY_MS 0
+#endif
+#define NETPLAY_UDP_SIM_QUEUE 64
+
+struct netplay_udp_sim_packet
+{
+   retro_time_t due;
+   struct sockaddr_storage addr;
+   socklen_t addr_len;
+   size_t len;
+   uint32_t data[NETPLAY_UDP_MAX_WORDS];
+};
+
+static struct netplay_udp_sim_packet
+   netplay_udp_sim_queue[NETPLAY_UDP_SIM_QUEUE];
+static size_t netplay_udp_sim_head, netplay_udp_sim_count;
+#endif
+
+static bool netplay_udp_set_port(struct sockaddr_storage *addr,
+      uint16_t port)
+{
+   switch (addr->ss_family)
+   {
+      case AF_INET:
+         ((struct sockaddr_in*)addr)->sin_port = htons(port);
+         return true;
+#ifdef HAVE_INET6
+      case AF_INET6:
+         ((struct sockaddr_in6*)addr)->sin6_port = htons(port);
+         return true;
+#endif
+      default:
+         break;
+   }
+   return false;
+}
+
+static uint16_t netplay_udp_get_port(const struct sockaddr_storage *addr)
+{
+   switch (addr->ss_family)
+   {
+      case AF_INET:
+         return ntohs(((const struct sockaddr_in*)addr)->sin_port);
+#ifdef HAVE_INET6
+      case AF_INET6:
+         return ntohs(((const struct sockaddr_in6*)addr)->sin6_port);
+#endif
+      default:
+         break;
+   }
+   return 0;
+}
+
+static void netplay_udp_sendto(netplay_t *netplay,
+      const struct sockaddr_storage *addr, socklen_t addr_len,
+      const uint32_t *data, size_t len)
+{
+#ifdef NETPLAY_UDP_SIMULATE
+   struct netplay_udp_sim_packet *pkt;
+
+   if ((rand() % 100) < NETPLAY_UDP_SIM_LOSS)
+      return;
+   if (netplay_udp_sim_count >= NETPLAY_UDP_SIM_QUEUE)
+      return;
+
+   pkt = &netplay_udp_sim_queue[
+      (netplay_udp_sim_head + netplay_udp_sim_count) % NETPLAY_UDP_SIM_QUEUE];
+   pkt->due      = cpu_features_get_time_usec() +
+      NETPLAY_UDP_SIM_DELAY_MS * 1000;
+   pkt->addr     = *addr;
+   pkt->addr_len = addr_len;
+   pkt->len      = len;
+   memcpy(pkt->data, data, len);
+   netplay_udp_sim_count++;
+#else
+   sendto(netplay->udp_fd, (const char*)data, len, 0,
+         (const struct sockaddr*)addr, addr_len);
+#endif
+}
+
+#ifdef NETPLAY_UDP_SIMULATE
+static void netplay_udp_sim_flush(netplay_t *netplay)
+{
+   retro_time_t now = cpu_features_get_time_usec();
+
+   while (netplay_udp_sim_count)
+   {
+      struct netplay_udp_sim_packet *pkt =
+         &netplay_udp_sim_queue[netplay_udp_sim_head];
+      if (pkt->due > now)
+         break;
+      sendto(netplay->udp_fd, (const char*)pkt->data, pkt->len, 0,
+            (const struct sockaddr*)&pkt->addr, pkt->addr_len);
+      netplay_udp_sim_head = (netplay_udp_sim_head + 1) %
+         NETPLAY_UDP_SIM_QUEUE;
+      netplay_udp_sim_count--;
+   }
+}
+#endif
+
+/**
+ * netplay_udp_init
+ *
+ * Open the UDP input channel socket, next to our TCP socket.
+ *
+ * Returns true on success.
+ */
+bool netplay_udp_init(netplay_t *netplay)
+{
+   struct sockaddr_storage addr;
+   socklen_t addr_len = sizeof(addr);
+   int tcp_fd         = netplay->is_server ?
+      netplay->listen_fd : netplay->connections[0].fd;
+   int fd;
+
+   memset(&addr, 0, sizeof(addr));
+   if (tcp_fd < 0 ||
+         getsockname(tcp_fd, (struct sockaddr*)&addr, &addr_len) < 0)
+      return false;
+
+   fd = socket(addr.ss_family, SOCK_DGRAM, 0);
+   if (fd < 0)
+      return false;
+
+#if defined(HAVE_INET6) && defined(IPPROTO_IPV6) && defined(IPV6_V6ONLY)
+   /* Like the TCP socket, take both IPv6 and IPv4 */
+   if (addr.ss_family == AF_INET6)
+   {
+      int on = 0;
+      setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, (const char*)&on, sizeof(on));
+   }
+#endif
+
+   if (netplay->is_server)
+   {
+      /* The port after the TCP one is easy to forward alongside it, but
+       * anything will do */
+      netplay_udp_set_port(&addr, netplay->tcp_port + 1);
+      if (bind(fd, (struct sockaddr*)&addr, addr_len) < 0)
+      {
+         netplay_udp_set_port(&addr, 0);
+         if (bind(fd, (struct sockaddr*)&addr, addr_len) < 0)
+            goto error;
+      }
+   }
+   else
+   {
+      netplay_udp_set_port(&addr, 0);
+      if (bind(fd, (struct sockaddr*)&addr, addr_len) < 0)
+         goto error;
+   }
+
+   if (!socket_nonblock(fd))
+      goto error;
+
+   addr_len = sizeof(addr);
+   if (getsockname(fd, (struct sockaddr*)&addr, &addr_len) < 0)
+      goto error;
+
+   netplay->udp_input = (struct netplay_udp_input*)calloc(
+         MAX_CLIENTS * NETPLAY_UDP_INPUT_RING, sizeof(*netplay->udp_input));
+   if (!netplay->udp_input)
+      goto error;
+
+   netplay->udp_fd   = fd;
+   netplay->udp_port = netplay_udp_get_port(&addr);
+
+   RARCH_LOG("[netplay] UDP input channel on port %hu.\n",
+         (unsigned short)netplay->udp_port);
+   return true;
+
+error:
+   socket_close(fd);
+   return false;
+}
+
+/**
+ * netplay_udp_deinit
+ *
+ * Close the UDP input channel.
+ */
+void netplay_udp_deinit(netplay_t *netplay)
+{
+   if (netplay->udp_fd >= 0)
+      socket_close(netplay->udp_fd);
+   netplay->udp_fd = -1;
+
+   free(netplay->udp_input);
+   netplay->udp_input = NULL;
+
+#ifdef NETPLAY_UDP_SIMULATE
+   netplay_udp_sim_head  = 0;
+   netplay_udp_sim_count = 0;
+#endif
+}
+
+/**
+ * netplay_udp_announce
+ *
+ * Tell a client where to send its UDP input datagrams (server only).
+ *
+ * Returns false if the connection broke.
+ */
+bool netplay_udp_announce(netplay_t *netplay,
+      struct netplay_connection *connection)
+{
+   uint32_t payload[2];
+
+   /* The token only keeps strays apart; UDP input is never trusted beyond
+    * prediction */
+   connection->udp_token    = (uint32_t)rand() ^
+      (uint32_t)cpu_features_get_time_usec() ^
+      (uint32_t)(connection - netplay->connections);
+   connection->udp_addr_len = 0;
+   connection->udp_active   = true;
+
+   payload[0] = htonl(connection->udp_token);
+   payload[1] = htonl(netplay->udp_port);
+   return netplay_send_raw_cmd(netplay, connection, NETPLAY_CMD_UDP_INPUT,
+         payload, sizeof(payload));
+}
+
+/**
+ * netplay_udp_connect
+ *
+ * Handle a server's NETPLAY_CMD_UDP_INPUT announcement (client only).
+ */
+void netplay_udp_connect(netplay_t *netplay,
+      struct netplay_connection *connection, uint32_t token, uint16_t port)
+{
+   socklen_t addr_len = sizeof(connection->udp_addr);
+
+   memset(&connection->udp_addr, 0, sizeof(connection->udp_addr));
+   if (getpeername(connection->fd, (struct sockaddr*)&connection->udp_addr,
+            &addr_len) < 0 ||
+         !netplay_udp_set_port(&connection->udp_addr, port))
+      return;
+
+   connection->udp_token    = token;
+   connection->udp_addr_len = addr_len;
+   connection->udp_active   = true;
+}
+
+/**
+ * netplay_udp_send_input
+ *
+ * Send our recent input history to a connection over UDP.
+ */
+void netplay_udp_send_input(netplay_t *netplay,
+      struct netplay_connection *connection)
+{
+   uint32_t buffer[NETPLAY_UDP_MAX_WORDS];
+   uint32_t frames[NETPLAY_UDP_INPUT_HISTORY];
+   size_t ptrs[NETPLAY_UDP_INPUT_HISTORY];
+   uint32_t count = 0, words = 0, i;
+   size_t bufused = NETPLAY_UDP_HEADER_WORDS;
+   size_t ptr     = netplay->self_ptr;
+   uint32_t frame = netplay->self_frame_count;
+
+   /* The server learns where we are from our first datagram */
+   if (!connection->udp_addr_len)
+      return;
+
+   /* Gather our own real input, newest first */
+   if (netplay->self_mode == NETPLAY_CONNECTION_PLAYING)
+   {
+      while (count < NETPLAY_UDP_INPUT_HISTORY)
+      {
+         struct delta_frame *dframe = &netplay->buffer[ptr];
+         if (!dframe->used || dframe->frame != frame ||
+               !dframe->have_real[netplay->self_client_num])
+            break;
+         frames[count] = frame;
+         ptrs[count]   = ptr;
+         count++;
+         if (frame == 0)
+            break;
+         ptr = PREV_PTR(ptr);
+         frame--;
+      }
+   }
+
+   /* And pack it oldest first */
+   for (i = count; i > 0; i--)
+   {
+      size_t used = netplay_pack_input(netplay, &netplay->buffer[ptrs[i - 1]],
+            netplay->self_client_num, false, buffer + bufused,
+            NETPLAY_UDP_MAX_INPUT_WORDS);
+      if (words && used != words)
+      {
+         /* Our devices changed; only send this frame and the ones
+          * after it, in the new layout */
+         memmove(buffer + NETPLAY_UDP_HEADER_WORDS, buffer + bufused,
+               used * sizeof(uint32_t));
+         bufused = NETPLAY_UDP_HEADER_WORDS;
+         count   = i;
+      }
+      words    = (uint32_t)used;
+      bufused += used;
+   }
+   if (!words)
+      count = 0;
+
+   buffer[0] = htonl(NETPLAY_UDP_MAGIC);
+   buffer[1] = htonl(connection->udp_token);
+   buffer[2] = htonl(netplay->self_client_num);
+   buffer[3] = htonl(count ? frames[count - 1] : netplay->self_frame_count);
+   buffer[4] = htonl(count);
+   buffer[5] = htonl(words);
+
+   netplay_udp_sendto(netplay, &connection->udp_addr,
+         connection->udp_addr_len, buffer,
+         (NETPLAY_UDP_HEADER_WORDS + count * words) * sizeof(uint32_t));
+}
+
+static void netplay_udp_store(netplay_t *netplay, uint32_t client_num,
+      uint32_t frame, const uint32_t *data, uint32_t words)
+{
+   uint32_t i;
+   struct netplay_udp_input *in = &netplay->udp_input[
+      client_num * NETPLAY_UDP_INPUT_RING +
+      (frame & (NETPLAY_UDP_INPUT_RING - 1))];
+
+   in->frame = frame;
+   in->size  = words;
+   for (i = 0; i < words; i++)
+      in->data[i] = ntohl(data[i]);
+}
+
+/**
+ * netplay_udp_poll
+ *
+ * Read all pending UDP input datagrams.
+ */
+void netplay_udp_poll(netplay_t *netplay)
+{
+   uint32_t buffer[NETPLAY_UDP_MAX_WORDS];
+
+#ifdef NETPLAY_UDP_SIMULATE
+   netplay_udp_sim_flush(netplay);
+#endif
+
+   for (;;)
+   {
+      struct sockaddr_storage addr;
+      struct netplay_connection *connection = NULL;
+      socklen_t addr_len = sizeof(addr);
+      uint32_t token, client_num, first, count, words, i;
+      ssize_t len        = recvfrom(netplay->udp_fd, (char*)buffer,
+            sizeof(buffer), 0, (struct sockaddr*)&addr, &addr_len);
+
+      if (len < 0)
+         break;
+      if (len < (ssize_t)(NETPLAY_UDP_HEADER_WORDS * sizeof(uint32_t)) ||
+            ntohl(buffer[0]) != NETPLAY_UDP_MAGIC)
+         continue;
+
+      token      = ntohl(buffer[1]);
+      client_num = ntohl(buffer[2]);
+      first      = ntohl(buffer[3]);
+      count      = ntohl(buffer[4]);
+      words      = ntohl(buffer[5]);
+
+      for (i = 0; i < netplay->connections_size; i++)
+      {
+         struct netplay_connection *conn = &netplay->connections[i];
+         if (conn->active && conn->udp_active && conn->udp_token == token)
+         {
+            connection = conn;
+            break;
+         }
+      }
+      if (!connection)
+         continue;
+
+      if (netplay->is_server)
+      {
+         /* Replies go wherever the client's datagrams come from, and its
+          * input can only ever be its own */
+         connection->udp_addr     = addr;
+         connection->udp_addr_len = addr_len;
+         if (connection->mode != NETPLAY_CONNECTION_PLAYING)
+            continue;
+         client_num = (uint32_t)(connection - netplay->connections + 1);
+      }
+
+      /* client_num comes off the wire, so bound it before any
+       * per-client lookups */
+      if (client_num >= MAX_CLIENTS)
+         continue;
+
+      if (  !count ||
+            !(netplay->connected_players & (1 << client_num)) ||
+            count > NETPLAY_UDP_INPUT_HISTORY ||
+            words > NETPLAY_UDP_MAX_INPUT_WORDS ||
+            words != netplay_expected_input_size(netplay,
+               netplay->client_devices[client_num]) ||
+            (size_t)len < (NETPLAY_UDP_HEADER_WORDS + count * words)
+               * sizeof(uint32_t))
+         continue;
+
+      /* Anything TCP already delivered is better left alone */
+      for (i = 0; i < count; i++)
+      {
+         if (first + i < netplay->read_frame_count[client_num])
+            continue;
+         netplay_udp_store(netplay, client_num, first + i,
+               buffer + NETPLAY_UDP_HEADER_WORDS + i * words, words);
+      }
+   }
+}
+
+/**
+ * netplay_udp_predict
+ *
+ * Fetch a device's input for a frame from the UDP input channel, for use
+ * until the same input arrives over TCP.
+ *
+ * Returns true if data was filled in.
+ */
+bool netplay_udp_predict(netplay_t *netplay, uint32_t client_num,
+      uint32_t frame, uint32_t device, uint32_t *data, uint32_t dsize)
+{
+   uint32_t d, devices;
+   uint32_t offset     = 0;
+   const struct netplay_udp_input *in;
+
+   if (client_num >= MAX_CLIENTS)
+      return false;
+
+   devices             = netplay->client_devices[client_num];
+   if (!(devices & (1 << device)))
+      return false;
+
+   in = &netplay->udp_input[client_num * NETPLAY_UDP_INPUT_RING +
+      (frame & (NETPLAY_UDP_INPUT_RING - 1))];
+   if (!in->size || in->frame != frame)
+      return false;
+
+   /* Find this device's words within the client's input */
+   for (d = 0; d < device; d++)
+      if (devices & (1 << d))
+         offset += netplay_expected_input_size(netplay, 1 << d);
+   if (offset + dsize > in->size)
+      return false;
+
+   memcpy(data, in->data + offset, dsize * sizeof(uint32_t));
+   return true;
+}
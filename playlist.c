@@ -27,10 +27,12 @@
 #include <compat/posix_string.h>
 #include <string/stdstring.h>
 #include <streams/interface_stream.h>
+#include <streams/file_stream.h>
 #include <file/file_path.h>
 #include <lists/string_list.h>
 #include <formats/jsonsax_full.h>
 #include <array/rbuf.h>
+#include <encodings/crc32.h>
 
 #include "playlist.h"
 #include "verbosity.h"
@@ -41,6 +43,14 @@
 #define PLAYLIST_ENTRIES 6
 #endif
 
+/* Number of journal records after which the
+ * playlist file is rewritten in full */
+#ifndef PLAYLIST_JOURNAL_MAX_RECORDS
+#define PLAYLIST_JOURNAL_MAX_RECORDS 64
+#endif
+
+#define PLAYLIST_JOURNAL_MAGIC "RAPLJ1"
+
 #define WINDOWS_PATH_DELIMITER '\\'
 #define POSIX_PATH_DELIMITER '/'
 
@@ -52,6 +62,14 @@
 #define USING_POSIX_FILE_SYSTEM
 #endif
 
+/* Byte range of a not-yet-parsed entry object
+ * inside the raw playlist JSON text */
+struct playlist_entry_span
+{
+   size_t offset;
+   size_t len;
+};
+
 struct content_playlist
 {
    char *default_core_path;
@@ -60,6 +78,25 @@ struct content_playlist
 
    struct playlist_entry *entries;
 
+   /* Lazy entry materialization: when a JSON playlist
+    * is loaded, entries are only indexed. The raw file
+    * text is kept in 'lazy_data', and each entry is
+    * parsed from its span on first access */
+   char *lazy_data;
+   struct playlist_entry_span *lazy_spans;
+   size_t lazy_pending;
+
+   /* Journaled writes: small changes are recorded
+    * in 'journal' and appended to a journal file next
+    * to the playlist instead of rewriting it. Each
+    * journal file is bound to the CRC32 and length
+    * of the JSON text it applies to */
+   char *journal;
+   size_t journal_pending;
+   size_t journal_records;
+   size_t journal_base_len;
+   uint32_t journal_base_crc;
+
    playlist_config_t config;  /* size_t alignment */
 
    enum playlist_label_display_mode label_display_mode;
@@ -71,11 +108,13 @@ struct content_playlist
    bool old_format;
    bool compressed;
    bool cached_external;
+   bool journal_base_valid;
 };
 
 typedef struct
 {
    struct playlist_entry *current_entry;
+   struct playlist_entry *lazy_target;
    char *current_meta_string;
    char *current_items_string;
    char **current_entry_val;
@@ -91,9 +130,13 @@ typedef struct
    JSON_Parser parser;     /* ptr alignment */
    JSON_Writer writer;     /* ptr alignment */
 
+   size_t lazy_entry_start;
+   size_t output_len;
+   uint32_t output_crc;
    unsigned array_depth;
    unsigned object_depth;
 
+   bool lazy_index;
    bool in_items;
    bool in_subsystem_roms;
    bool capacity_exceeded;
@@ -107,6 +150,13 @@ typedef int (playlist_sort_fun_t)(
       const struct playlist_entry *a,
       const struct playlist_entry *b);
 
+static void playlist_materialize_entry(playlist_t *playlist, size_t idx);
+static void playlist_materialize_all(playlist_t *playlist);
+static void playlist_free_lazy_data(playlist_t *playlist);
+static void playlist_journal_record(playlist_t *playlist,
+      char op, size_t idx, const struct playlist_entry *entry);
+static void playlist_journal_clear(playlist_t *playlist);
+
 /* TODO/FIXME - hack for allowing the explore view to switch 
  * over to a playlist item */
 void playlist_set_cached_external(playlist_t* pl)
@@ -387,6 +437,8 @@ void playlist_get_index(playlist_t *playlist,
    if (!playlist || !entry || (idx >= RBUF_LEN(playlist->entries)))
       return;
 
+   playlist_materialize_entry(playlist, idx);
+
    *entry = &playlist->entries[idx];
 }
 
@@ -447,6 +499,88 @@ static void playlist_free_entry(struct playlist_entry *entry)
    entry->last_played_second = 0;
 }
 
+/* Marks the lazily indexed entry at @idx as no
+ * longer pending, e.g. because it is being removed
+ * or replaced without having been parsed */
+static void playlist_lazy_drop(playlist_t *playlist, size_t idx)
+{
+   if (     !playlist->lazy_pending
+         || !playlist->lazy_spans[idx].len)
+      return;
+
+   playlist->lazy_spans[idx].len = 0;
+
+   if (--playlist->lazy_pending == 0)
+      playlist_free_lazy_data(playlist);
+}
+
+/* The following helpers keep any lazy entry spans
+ * in sync with the entries array, so that entries
+ * may be reordered without being parsed first */
+static void playlist_remove_entry(playlist_t *playlist, size_t idx)
+{
+   size_t len = RBUF_LEN(playlist->entries);
+
+   playlist_lazy_drop(playlist, idx);
+   playlist_free_entry(&playlist->entries[idx]);
+
+   /* Shift remaining entries to fill the gap */
+   memmove(playlist->entries + idx, playlist->entries + idx + 1,
+         (len - 1 - idx) * sizeof(struct playlist_entry));
+   RBUF_RESIZE(playlist->entries, len - 1);
+
+   if (playlist->lazy_spans)
+   {
+      memmove(playlist->lazy_spans + idx, playlist->lazy_spans + idx + 1,
+            (len - 1 - idx) * sizeof(struct playlist_entry_span));
+      RBUF_RESIZE(playlist->lazy_spans, len - 1);
+   }
+}
+
+static void playlist_move_entry_to_front(playlist_t *playlist, size_t idx)
+{
+   struct playlist_entry tmp = playlist->entries[idx];
+
+   memmove(playlist->entries + 1, playlist->entries,
+         idx * sizeof(struct playlist_entry));
+   playlist->entries[0] = tmp;
+
+   if (playlist->lazy_spans)
+   {
+      struct playlist_entry_span tmp_span = playlist->lazy_spans[idx];
+
+      memmove(playlist->lazy_spans + 1, playlist->lazy_spans,
+            idx * sizeof(struct playlist_entry_span));
+      playlist->lazy_spans[0] = tmp_span;
+   }
+}
+
+static bool playlist_insert_entry_front(playlist_t *playlist)
+{
+   size_t len = RBUF_LEN(playlist->entries);
+
+   if (!RBUF_TRYFIT(playlist->entries, len + 1))
+      return false;
+   if (playlist->lazy_spans && !RBUF_TRYFIT(playlist->lazy_spans, len + 1))
+      return false;
+
+   RBUF_RESIZE(playlist->entries, len + 1);
+   memmove(playlist->entries + 1, playlist->entries,
+         len * sizeof(struct playlist_entry));
+   memset(&playlist->entries[0], 0, sizeof(struct playlist_entry));
+
+   if (playlist->lazy_spans)
+   {
+      RBUF_RESIZE(playlist->lazy_spans, len + 1);
+      memmove(playlist->lazy_spans + 1, playlist->lazy_spans,
+            len * sizeof(struct playlist_entry_span));
+      playlist->lazy_spans[0].offset = 0;
+      playlist->lazy_spans[0].len    = 0;
+   }
+
+   return true;
+}
+
 /**
  * playlist_delete_index:
  * @playlist            : Playlist handle.
@@ -457,28 +591,11 @@ static void playlist_free_entry(struct playlist_entry *entry)
 void playlist_delete_index(playlist_t *playlist,
       size_t idx)
 {
-   size_t len;
-   struct playlist_entry *entry_to_delete;
-
-   if (!playlist)
-      return;
-
-   len = RBUF_LEN(playlist->entries);
-   if (idx >= len)
+   if (!playlist || idx >= RBUF_LEN(playlist->entries))
       return;
 
-   /* Free unwanted entry */
-   entry_to_delete = (struct playlist_entry *)(playlist->entries + idx);
-   if (entry_to_delete)
-      playlist_free_entry(entry_to_delete);
-
-   /* Shift remaining entries to fill the gap */
-   memmove(playlist->entries + idx, playlist->entries + idx + 1,
-         (len - 1 - idx) * sizeof(struct playlist_entry));
-
-   RBUF_RESIZE(playlist->entries, len - 1);
-
-   playlist->modified = true;
+   playlist_remove_entry(playlist, idx);
+   playlist_journal_record(playlist, 'D', idx, NULL);
 }
 
 /**
@@ -504,6 +621,8 @@ void playlist_delete_by_path(playlist_t *playlist,
    strlcpy(real_search_path, search_path, sizeof(real_search_path));
    path_resolve_realpath(real_search_path, sizeof(real_search_path), true);
 
+   playlist_materialize_all(playlist);
+
    while (i < RBUF_LEN(playlist->entries))
    {
       if (!playlist_path_equal(real_search_path, playlist->entries[i].path,
@@ -537,6 +656,8 @@ void playlist_get_index_by_path(playlist_t *playlist,
    strlcpy(real_search_path, search_path, sizeof(real_search_path));
    path_resolve_realpath(real_search_path, sizeof(real_search_path), true);
 
+   playlist_materialize_all(playlist);
+
    for (i = 0, len = RBUF_LEN(playlist->entries); i < len; i++)
    {
       if (!playlist_path_equal(real_search_path, playlist->entries[i].path,
@@ -564,6 +685,8 @@ bool playlist_entry_exists(playlist_t *playlist,
    strlcpy(real_search_path, path, sizeof(real_search_path));
    path_resolve_realpath(real_search_path, sizeof(real_search_path), true);
 
+   playlist_materialize_all(playlist);
+
    for (i = 0, len = RBUF_LEN(playlist->entries); i < len; i++)
    {
       if (playlist_path_equal(real_search_path, playlist->entries[i].path,
@@ -578,10 +701,13 @@ void playlist_update(playlist_t *playlist, size_t idx,
       const struct playlist_entry *update_entry)
 {
    struct playlist_entry *entry = NULL;
+   bool entry_updated           = false;
 
    if (!playlist || idx >= RBUF_LEN(playlist->entries))
       return;
 
+   playlist_materialize_entry(playlist, idx);
+
    entry            = &playlist->entries[idx];
 
    if (update_entry->path && (update_entry->path != entry->path))
@@ -589,7 +715,7 @@ void playlist_update(playlist_t *playlist, size_t idx,
       if (entry->path)
          free(entry->path);
       entry->path        = strdup(update_entry->path);
-      playlist->modified = true;
+      entry_updated      = true;
    }
 
    if (update_entry->label && (update_entry->label != entry->label))
@@ -597,7 +723,7 @@ void playlist_update(playlist_t *playlist, size_t idx,
       if (entry->label)
          free(entry->label);
       entry->label       = strdup(update_entry->label);
-      playlist->modified = true;
+      entry_updated      = true;
    }
 
    if (update_entry->core_path && (update_entry->core_path != entry->core_path))
@@ -606,7 +732,7 @@ void playlist_update(playlist_t *playlist, size_t idx,
          free(entry->core_path);
       entry->core_path   = NULL;
       entry->core_path   = strdup(update_entry->core_path);
-      playlist->modified = true;
+      entry_updated      = true;
    }
 
    if (update_entry->core_name && (update_entry->core_name != entry->core_name))
@@ -614,7 +740,7 @@ void playlist_update(playlist_t *playlist, size_t idx,
       if (entry->core_name)
          free(entry->core_name);
       entry->core_name   = strdup(update_entry->core_name);
-      playlist->modified = true;
+      entry_updated      = true;
    }
 
    if (update_entry->db_name && (update_entry->db_name != entry->db_name))
@@ -622,7 +748,7 @@ void playlist_update(playlist_t *playlist, size_t idx,
       if (entry->db_name)
          free(entry->db_name);
       entry->db_name     = strdup(update_entry->db_name);
-      playlist->modified = true;
+      entry_updated      = true;
    }
 
    if (update_entry->crc32 && (update_entry->crc32 != entry->crc32))
@@ -630,8 +756,11 @@ void playlist_update(playlist_t *playlist, size_t idx,
       if (entry->crc32)
          free(entry->crc32);
       entry->crc32       = strdup(update_entry->crc32);
-      playlist->modified = true;
+      entry_updated      = true;
    }
+
+   if (entry_updated)
+      playlist_journal_record(playlist, 'U', idx, entry);
 }
 
 void playlist_update_runtime(playlist_t *playlist, size_t idx,
@@ -643,6 +772,8 @@ void playlist_update_runtime(playlist_t *playlist, size_t idx,
    if (!playlist || idx >= RBUF_LEN(playlist->entries))
       return;
 
+   playlist_materialize_entry(playlist, idx);
+
    entry            = &playlist->entries[idx];
 
    if (update_entry->path && (update_entry->path != entry->path))
@@ -781,6 +912,8 @@ bool playlist_push_runtime(playlist_t *playlist,
       return false;
    }
 
+   playlist_materialize_all(playlist);
+
    len = RBUF_LEN(playlist->entries);
    for (i = 0; i < len; i++)
    {
@@ -863,8 +996,10 @@ bool playlist_push_runtime(playlist_t *playlist,
    }
 
 success:
+   /* Runtime playlists are written with their own
+    * reduced set of fields, which journal records
+    * do not match, so they are always rewritten */
    playlist->modified = true;
-
    return true;
 }
 
@@ -985,6 +1120,8 @@ bool playlist_push(playlist_t *playlist,
       }
    }
 
+   playlist_materialize_all(playlist);
+
    len = RBUF_LEN(playlist->entries);
    for (i = 0; i < len; i++)
    {
@@ -1086,7 +1223,10 @@ bool playlist_push(playlist_t *playlist,
       if (i == 0)
       {
          if (entry_updated)
+         {
+            playlist_journal_record(playlist, 'U', 0, &playlist->entries[0]);
             goto success;
+         }
 
          return false;
       }
@@ -1097,6 +1237,10 @@ bool playlist_push(playlist_t *playlist,
             i * sizeof(struct playlist_entry));
       playlist->entries[0] = tmp;
 
+      playlist_journal_record(playlist, 'M', i, NULL);
+      if (entry_updated)
+         playlist_journal_record(playlist, 'U', 0, &playlist->entries[0]);
+
       goto success;
    }
 
@@ -1108,6 +1252,7 @@ bool playlist_push(playlist_t *playlist,
       struct playlist_entry *last_entry = &playlist->entries[len - 1];
       playlist_free_entry(last_entry);
       len--;
+      playlist_journal_record(playlist, 'D', len, NULL);
    }
    else
    {
@@ -1169,11 +1314,11 @@ bool playlist_push(playlist_t *playlist,
          for (i = 0; i < entry->subsystem_roms->size; i++)
             string_list_append(playlist->entries[0].subsystem_roms, entry->subsystem_roms->elems[i].data, attributes);
       }
+
+      playlist_journal_record(playlist, 'I', 0, &playlist->entries[0]);
    }
 
 success:
-   playlist->modified = true;
-
    return true;
 }
 
@@ -1182,9 +1327,27 @@ static JSON_Writer_HandlerResult JSONOutputHandler(JSON_Writer writer, const cha
    JSONContext *context = (JSONContext*)JSON_Writer_GetUserData(writer);
 
    (void)writer; /* unused */
+   context->output_crc  = encoding_crc32(context->output_crc,
+         (const uint8_t*)pBytes, length);
+   context->output_len += length;
    return intfstream_write(context->file, pBytes, length) == length ? JSON_Writer_Continue : JSON_Writer_Abort;
 }
 
+static JSON_Writer_HandlerResult JSONJournalOutputHandler(JSON_Writer writer, const char *pBytes, size_t length)
+{
+   JSONContext *context = (JSONContext*)JSON_Writer_GetUserData(writer);
+   char *journal        = context->playlist->journal;
+   size_t len           = RBUF_LEN(journal);
+
+   if (!RBUF_TRYFIT(journal, len + length))
+      return JSON_Writer_Abort;
+
+   memcpy(journal + len, pBytes, length);
+   RBUF_RESIZE(journal, len + length);
+   context->playlist->journal = journal;
+   return JSON_Writer_Continue;
+}
+
 static void JSONLogError(JSONContext *pCtx)
 {
    if (pCtx->parser && JSON_Parser_GetError(pCtx->parser) != JSON_Error_AbortedByHandler)
@@ -1214,6 +1377,8 @@ void playlist_write_runtime_file(playlist_t *playlist)
    if (!playlist || !playlist->modified)
       return;
 
+   playlist_materialize_all(playlist);
+
    file = intfstream_open_file(playlist->config.path,
          RETRO_VFS_FILE_ACCESS_WRITE, RETRO_VFS_FILE_ACCESS_HINT_NONE);
 
@@ -1429,9 +1594,14 @@ void playlist_write_runtime_file(playlist_t *playlist)
    JSON_Writer_WriteNewLine(context.writer);
    JSON_Writer_Free(context.writer);
 
-   playlist->modified        = false;
-   playlist->old_format      = false;
-   playlist->compressed      = false;
+   playlist->modified           = false;
+   playlist->old_format         = false;
+   playlist->compressed         = false;
+   playlist->journal_base_valid = true;
+   playlist->journal_base_crc   = context.output_crc;
+   playlist->journal_base_len   = context.output_len;
+
+   playlist_journal_clear(playlist);
 
    RARCH_LOG("[Playlist]: Written to playlist file: %s\n", playlist->config.path);
 end:
@@ -1451,6 +1621,383 @@ static JSON_Status JSON_CALL JSON_Writer_WriteSpace_NULL(JSON_Writer writer, siz
    return JSON_Success;
 }
 
+/**
+ * playlist_write_json_entry:
+ * @writer              : JSON writer handle.
+ * @entry               : Playlist entry handle.
+ * @compact             : Omit all indentation and new lines.
+ *
+ * Writes a single entry object of the 'items' array.
+ **/
+static void playlist_write_json_entry(JSON_Writer writer,
+      const struct playlist_entry *entry, bool compact)
+{
+   JSON_Status (JSON_CALL *json_write_new_line)(JSON_Writer writer) =
+         compact ?
+               JSON_Writer_WriteNewLine_NULL :
+               JSON_Writer_WriteNewLine;
+   JSON_Status (JSON_CALL *json_write_space)(JSON_Writer writer, size_t numberOfSpaces) =
+         compact ?
+            JSON_Writer_WriteSpace_NULL :
+            JSON_Writer_WriteSpace;
+
+   json_write_space(writer, 4);
+   JSON_Writer_WriteStartObject(writer);
+
+   json_write_new_line(writer);
+   json_write_space(writer, 6);
+   JSON_Writer_WriteString(writer, "path",
+         STRLEN_CONST("path"), JSON_UTF8);
+   JSON_Writer_WriteColon(writer);
+   json_write_space(writer, 1);
+   JSON_Writer_WriteString(writer,
+         entry->path
+         ? entry->path
+         : "",
+         entry->path
+         ? strlen(entry->path)
+         : 0,
+         JSON_UTF8);
+   JSON_Writer_WriteComma(writer);
+
+   json_write_new_line(writer);
+   json_write_space(writer, 6);
+   JSON_Writer_WriteString(writer, "label",
+         STRLEN_CONST("label"), JSON_UTF8);
+   JSON_Writer_WriteColon(writer);
+   json_write_space(writer, 1);
+   JSON_Writer_WriteString(writer,
+         entry->label
+         ? entry->label
+         : "",
+         entry->label
+         ? strlen(entry->label)
+         : 0,
+         JSON_UTF8);
+   JSON_Writer_WriteComma(writer);
+
+   json_write_new_line(writer);
+   json_write_space(writer, 6);
+   JSON_Writer_WriteString(writer, "core_path",
+         STRLEN_CONST("core_path"), JSON_UTF8);
+   JSON_Writer_WriteColon(writer);
+   json_write_space(writer, 1);
+   JSON_Writer_WriteString(writer,
+         entry->core_path
+         ? entry->core_path
+         : "",
+         entry->core_path
+         ? strlen(entry->core_path)
+         : 0,
+         JSON_UTF8);
+   JSON_Writer_WriteComma(writer);
+
+   json_write_new_line(writer);
+   json_write_space(writer, 6);
+   JSON_Writer_WriteString(writer, "core_name",
+         STRLEN_CONST("core_name"), JSON_UTF8);
+   JSON_Writer_WriteColon(writer);
+   json_write_space(writer, 1);
+   JSON_Writer_WriteString(writer,
+         entry->core_name
+         ? entry->core_name
+         : "",
+         entry->core_name
+         ? strlen(entry->core_name)
+         : 0,
+         JSON_UTF8);
+   JSON_Writer_WriteComma(writer);
+
+   json_write_new_line(writer);
+   json_write_space(writer, 6);
+   JSON_Writer_WriteString(writer, "crc32",
+         STRLEN_CONST("crc32"), JSON_UTF8);
+   JSON_Writer_WriteColon(writer);
+   json_write_space(writer, 1);
+   JSON_Writer_WriteString(writer, entry->crc32 ? entry->crc32 : "",
+         entry->crc32
+         ? strlen(entry->crc32)
+         : 0,
+         JSON_UTF8);
+   JSON_Writer_WriteComma(writer);
+
+   json_write_new_line(writer);
+   json_write_space(writer, 6);
+   JSON_Writer_WriteString(writer, "db_name",
+         STRLEN_CONST("db_name"), JSON_UTF8);
+   JSON_Writer_WriteColon(writer);
+   json_write_space(writer, 1);
+   JSON_Writer_WriteString(writer, entry->db_name ? entry->db_name : "",
+         entry->db_name
+         ? strlen(entry->db_name)
+         : 0,
+         JSON_UTF8);
+
+   if (!string_is_empty(entry->subsystem_ident))
+   {
+      JSON_Writer_WriteComma(writer);
+      json_write_new_line(writer);
+      json_write_space(writer, 6);
+      JSON_Writer_WriteString(writer, "subsystem_ident",
+            STRLEN_CONST("subsystem_ident"), JSON_UTF8);
+      JSON_Writer_WriteColon(writer);
+      json_write_space(writer, 1);
+      JSON_Writer_WriteString(writer, entry->subsystem_ident ? entry->subsystem_ident : "",
+            entry->subsystem_ident
+            ? strlen(entry->subsystem_ident)
+            : 0,
+            JSON_UTF8);
+   }
+
+   if (!string_is_empty(entry->subsystem_name))
+   {
+      JSON_Writer_WriteComma(writer);
+      json_write_new_line(writer);
+      json_write_space(writer, 6);
+      JSON_Writer_WriteString(writer, "subsystem_name",
+            STRLEN_CONST("subsystem_name"), JSON_UTF8);
+      JSON_Writer_WriteColon(writer);
+      json_write_space(writer, 1);
+      JSON_Writer_WriteString(writer,
+            entry->subsystem_name
+            ? entry->subsystem_name
+            : "",
+            entry->subsystem_name
+            ? strlen(entry->subsystem_name)
+            : 0, JSON_UTF8);
+   }
+
+   if (  entry->subsystem_roms &&
+         entry->subsystem_roms->size > 0)
+   {
+      unsigned j;
+
+      JSON_Writer_WriteComma(writer);
+      json_write_new_line(writer);
+      json_write_space(writer, 6);
+      JSON_Writer_WriteString(writer, "subsystem_roms",
+            STRLEN_CONST("subsystem_roms"), JSON_UTF8);
+      JSON_Writer_WriteColon(writer);
+      json_write_space(writer, 1);
+      JSON_Writer_WriteStartArray(writer);
+      json_write_new_line(writer);
+
+      for (j = 0; j < entry->subsystem_roms->size; j++)
+      {
+         const struct string_list *roms = entry->subsystem_roms;
+         json_write_space(writer, 8);
+         JSON_Writer_WriteString(writer,
+               !string_is_empty(roms->elems[j].data)
+               ? roms->elems[j].data
+               : "",
+               !string_is_empty(roms->elems[j].data)
+               ? strlen(roms->elems[j].data)
+               : 0,
+               JSON_UTF8);
+
+         if (j < entry->subsystem_roms->size - 1)
+         {
+            JSON_Writer_WriteComma(writer);
+            json_write_new_line(writer);
+         }
+      }
+
+      json_write_new_line(writer);
+      json_write_space(writer, 6);
+      JSON_Writer_WriteEndArray(writer);
+   }
+
+   json_write_new_line(writer);
+
+   json_write_space(writer, 4);
+   JSON_Writer_WriteEndObject(writer);
+}
+
+static void playlist_journal_get_path(playlist_t *playlist,
+      char *s, size_t len)
+{
+   fill_pathname(s, playlist->config.path,
+         FILE_PATH_PLAYLIST_JOURNAL_EXTENSION, len);
+}
+
+static bool playlist_journal_append(playlist_t *playlist,
+      const char *data, size_t len)
+{
+   char *journal = playlist->journal;
+   size_t size   = RBUF_LEN(journal);
+
+   if (!RBUF_TRYFIT(journal, size + len))
+      return false;
+
+   memcpy(journal + size, data, len);
+   RBUF_RESIZE(journal, size + len);
+   playlist->journal = journal;
+   return true;
+}
+
+/**
+ * playlist_journal_clear:
+ * @playlist            : Playlist handle.
+ *
+ * Drops all pending journal records and removes
+ * the journal file. Called whenever the playlist
+ * file itself is rewritten.
+ **/
+static void playlist_journal_clear(playlist_t *playlist)
+{
+   RBUF_FREE(playlist->journal);
+   playlist->journal_pending = 0;
+
+   if (playlist->journal_records > 0)
+   {
+      char journal_path[PATH_MAX_LENGTH];
+
+      journal_path[0] = '\0';
+
+      playlist_journal_get_path(playlist,
+            journal_path, sizeof(journal_path));
+      filestream_delete(journal_path);
+
+      playlist->journal_records = 0;
+   }
+}
+
+/**
+ * playlist_journal_record:
+ * @playlist            : Playlist handle.
+ * @op                  : 'D' - delete entry @idx
+ *                        'M' - move entry @idx to the front
+ *                        'I' - insert @entry at the front
+ *                        'U' - replace entry @idx with @entry
+ * @idx                 : Index of playlist entry.
+ * @entry               : Playlist entry handle, or NULL.
+ *
+ * Records a change to the playlist, to be appended to
+ * the journal file by playlist_write_file(). If the
+ * change cannot be journaled, the playlist is flagged
+ * as modified instead so it will be rewritten in full.
+ **/
+static void playlist_journal_record(playlist_t *playlist,
+      char op, size_t idx, const struct playlist_entry *entry)
+{
+   char header[32];
+   int header_len;
+
+   /* Playlist will be rewritten anyway */
+   if (playlist->modified)
+      return;
+
+   if (!playlist->journal_base_valid || playlist->config.old_format)
+      goto error;
+
+   if (op == 'I')
+      header_len = snprintf(header, sizeof(header), "%c ", op);
+   else
+      header_len = snprintf(header, sizeof(header),
+            entry ? "%c %u " : "%c %u", op, (unsigned)idx);
+
+   if (!playlist_journal_append(playlist, header, (size_t)header_len))
+      goto error;
+
+   if (entry)
+   {
+      bool success        = false;
+      JSONContext context = {0};
+
+      if (!(context.writer = JSON_Writer_Create(NULL)))
+         goto error;
+
+      context.playlist = playlist;
+
+      JSON_Writer_SetOutputEncoding(context.writer, JSON_UTF8);
+      JSON_Writer_SetOutputHandler(context.writer, &JSONJournalOutputHandler);
+      JSON_Writer_SetUserData(context.writer, &context);
+
+      playlist_write_json_entry(context.writer, entry, true);
+
+      success = JSON_Writer_GetError(context.writer) == JSON_Error_None;
+      JSON_Writer_Free(context.writer);
+
+      if (!success)
+         goto error;
+   }
+
+   if (!playlist_journal_append(playlist, "\n", 1))
+      goto error;
+
+   playlist->journal_pending++;
+   return;
+
+error:
+   playlist->modified = true;
+}
+
+/**
+ * playlist_journal_flush:
+ * @playlist            : Playlist handle.
+ *
+ * Appends pending journal records to the journal file.
+ *
+ * Returns: false if the playlist must be rewritten in
+ * full instead (journal is too long, or could not be
+ * written).
+ **/
+static bool playlist_journal_flush(playlist_t *playlist)
+{
+   char journal_path[PATH_MAX_LENGTH];
+   RFILE *file    = NULL;
+   size_t len     = RBUF_LEN(playlist->journal);
+   bool success   = false;
+
+   if (     !playlist->journal_base_valid
+         || (playlist->journal_records + playlist->journal_pending
+               > PLAYLIST_JOURNAL_MAX_RECORDS))
+      return false;
+
+   journal_path[0] = '\0';
+
+   playlist_journal_get_path(playlist,
+         journal_path, sizeof(journal_path));
+
+   if (playlist->journal_records > 0)
+   {
+      if ((file = filestream_open(journal_path,
+               RETRO_VFS_FILE_ACCESS_READ_WRITE
+               | RETRO_VFS_FILE_ACCESS_UPDATE_EXISTING,
+               RETRO_VFS_FILE_ACCESS_HINT_NONE)))
+         filestream_seek(file, 0, RETRO_VFS_SEEK_POSITION_END);
+   }
+   else if ((file = filestream_open(journal_path,
+               RETRO_VFS_FILE_ACCESS_WRITE,
+               RETRO_VFS_FILE_ACCESS_HINT_NONE)))
+      filestream_printf(file, PLAYLIST_JOURNAL_MAGIC " %08x %lu\n",
+            (unsigned)playlist->journal_base_crc,
+            (unsigned long)playlist->journal_base_len);
+
+   if (!file)
+   {
+      RARCH_ERR("Failed to write to playlist journal: %s\n", journal_path);
+      return false;
+   }
+
+   success = filestream_write(file, playlist->journal, len) == (int64_t)len;
+   filestream_close(file);
+
+   /* Even if writing failed, the journal file now
+    * exists and must be removed by the full rewrite */
+   playlist->journal_records += playlist->journal_pending;
+
+   if (!success)
+      return false;
+
+   RARCH_LOG("[Playlist]: Appended %u change(s) to playlist journal: %s\n",
+         (unsigned)playlist->journal_pending, journal_path);
+
+   RBUF_CLEAR(playlist->journal);
+   playlist->journal_pending = 0;
+   return true;
+}
+
 void playlist_write_file(playlist_t *playlist)
 {
    size_t i, len;
@@ -1470,7 +2017,17 @@ void playlist_write_file(playlist_t *playlist)
         (playlist->compressed != playlist->config.compress) ||
 #endif
         (playlist->old_format != playlist->config.old_format)))
-      return;
+   {
+      /* Otherwise, any journaled changes are appended
+       * to the journal file. The playlist is only
+       * rewritten once the journal grows too long */
+      if (     !playlist
+            || !playlist->journal_pending
+            || playlist_journal_flush(playlist))
+         return;
+   }
+
+   playlist_materialize_all(playlist);
 
 #if defined(HAVE_ZLIB)
    if (playlist->config.compress)
@@ -1521,7 +2078,8 @@ void playlist_write_file(playlist_t *playlist)
             playlist->right_thumbnail_mode, playlist->left_thumbnail_mode,
             playlist->sort_mode);
 
-      playlist->old_format = true;
+      playlist->old_format         = true;
+      playlist->journal_base_valid = false;
    }
    else
 #endif
@@ -1679,176 +2237,8 @@ void playlist_write_file(playlist_t *playlist)
 
       for (i = 0, len = RBUF_LEN(playlist->entries); i < len; i++)
       {
-         json_write_space(context.writer, 4);
-         JSON_Writer_WriteStartObject(context.writer);
-
-         json_write_new_line(context.writer);
-         json_write_space(context.writer, 6);
-         JSON_Writer_WriteString(context.writer, "path",
-               STRLEN_CONST("path"), JSON_UTF8);
-         JSON_Writer_WriteColon(context.writer);
-         json_write_space(context.writer, 1);
-         JSON_Writer_WriteString(context.writer,
-               playlist->entries[i].path
-               ? playlist->entries[i].path
-               : "",
-               playlist->entries[i].path
-               ? strlen(playlist->entries[i].path)
-               : 0,
-               JSON_UTF8);
-         JSON_Writer_WriteComma(context.writer);
-
-         json_write_new_line(context.writer);
-         json_write_space(context.writer, 6);
-         JSON_Writer_WriteString(context.writer, "label",
-               STRLEN_CONST("label"), JSON_UTF8);
-         JSON_Writer_WriteColon(context.writer);
-         json_write_space(context.writer, 1);
-         JSON_Writer_WriteString(context.writer,
-               playlist->entries[i].label
-               ? playlist->entries[i].label
-               : "",
-               playlist->entries[i].label
-               ? strlen(playlist->entries[i].label)
-               : 0,
-               JSON_UTF8);
-         JSON_Writer_WriteComma(context.writer);
-
-         json_write_new_line(context.writer);
-         json_write_space(context.writer, 6);
-         JSON_Writer_WriteString(context.writer, "core_path",
-               STRLEN_CONST("core_path"), JSON_UTF8);
-         JSON_Writer_WriteColon(context.writer);
-         json_write_space(context.writer, 1);
-         JSON_Writer_WriteString(context.writer,
-               playlist->entries[i].core_path
-               ? playlist->entries[i].core_path
-               : "",
-               playlist->entries[i].core_path
-               ? strlen(playlist->entries[i].core_path)
-               : 0,
-               JSON_UTF8);
-         JSON_Writer_WriteComma(context.writer);
-
-         json_write_new_line(context.writer);
-         json_write_space(context.writer, 6);
-         JSON_Writer_WriteString(context.writer, "core_name",
-               STRLEN_CONST("core_name"), JSON_UTF8);
-         JSON_Writer_WriteColon(context.writer);
-         json_write_space(context.writer, 1);
-         JSON_Writer_WriteString(context.writer,
-               playlist->entries[i].core_name
-               ? playlist->entries[i].core_name
-               : "",
-               playlist->entries[i].core_name
-               ? strlen(playlist->entries[i].core_name)
-               : 0,
-               JSON_UTF8);
-         JSON_Writer_WriteComma(context.writer);
-
-         json_write_new_line(context.writer);
-         json_write_space(context.writer, 6);
-         JSON_Writer_WriteString(context.writer, "crc32",
-               STRLEN_CONST("crc32"), JSON_UTF8);
-         JSON_Writer_WriteColon(context.writer);
-         json_write_space(context.writer, 1);
-         JSON_Writer_WriteString(context.writer, playlist->entries[i].crc32 ? playlist->entries[i].crc32 : "",
-               playlist->entries[i].crc32
-               ? strlen(playlist->entries[i].crc32)
-               : 0,
-               JSON_UTF8);
-         JSON_Writer_WriteComma(context.writer);
-
-         json_write_new_line(context.writer);
-         json_write_space(context.writer, 6);
-         JSON_Writer_WriteString(context.writer, "db_name",
-               STRLEN_CONST("db_name"), JSON_UTF8);
-         JSON_Writer_WriteColon(context.writer);
-         json_write_space(context.writer, 1);
-         JSON_Writer_WriteString(context.writer, playlist->entries[i].db_name ? playlist->entries[i].db_name : "",
-               playlist->entries[i].db_name
-               ? strlen(playlist->entries[i].db_name)
-               : 0,
-               JSON_UTF8);
-
-         if (!string_is_empty(playlist->entries[i].subsystem_ident))
-         {
-            JSON_Writer_WriteComma(context.writer);
-            json_write_new_line(context.writer);
-            json_write_space(context.writer, 6);
-            JSON_Writer_WriteString(context.writer, "subsystem_ident",
-                  STRLEN_CONST("subsystem_ident"), JSON_UTF8);
-            JSON_Writer_WriteColon(context.writer);
-            json_write_space(context.writer, 1);
-            JSON_Writer_WriteString(context.writer, playlist->entries[i].subsystem_ident ? playlist->entries[i].subsystem_ident : "",
-                  playlist->entries[i].subsystem_ident
-                  ? strlen(playlist->entries[i].subsystem_ident)
-                  : 0,
-                  JSON_UTF8);
-         }
-
-         if (!string_is_empty(playlist->entries[i].subsystem_name))
-         {
-            JSON_Writer_WriteComma(context.writer);
-            json_write_new_line(context.writer);
-            json_write_space(context.writer, 6);
-            JSON_Writer_WriteString(context.writer, "subsystem_name",
-                  STRLEN_CONST("subsystem_name"), JSON_UTF8);
-            JSON_Writer_WriteColon(context.writer);
-            json_write_space(context.writer, 1);
-            JSON_Writer_WriteString(context.writer,
-                  playlist->entries[i].subsystem_name
-                  ? playlist->entries[i].subsystem_name
-                  : "",
-                  playlist->entries[i].subsystem_name
-                  ? strlen(playlist->entries[i].subsystem_name)
-                  : 0, JSON_UTF8);
-         }
-
-         if (  playlist->entries[i].subsystem_roms &&
-               playlist->entries[i].subsystem_roms->size > 0)
-         {
-            unsigned j;
-
-            JSON_Writer_WriteComma(context.writer);
-            json_write_new_line(context.writer);
-            json_write_space(context.writer, 6);
-            JSON_Writer_WriteString(context.writer, "subsystem_roms",
-                  STRLEN_CONST("subsystem_roms"), JSON_UTF8);
-            JSON_Writer_WriteColon(context.writer);
-            json_write_space(context.writer, 1);
-            JSON_Writer_WriteStartArray(context.writer);
-            json_write_new_line(context.writer);
-
-            for (j = 0; j < playlist->entries[i].subsystem_roms->size; j++)
-            {
-               const struct string_list *roms = playlist->entries[i].subsystem_roms;
-               json_write_space(context.writer, 8);
-               JSON_Writer_WriteString(context.writer,
-                     !string_is_empty(roms->elems[j].data)
-                     ? roms->elems[j].data
-                     : "",
-                     !string_is_empty(roms->elems[j].data)
-                     ? strlen(roms->elems[j].data)
-                     : 0,
-                     JSON_UTF8);
-
-               if (j < playlist->entries[i].subsystem_roms->size - 1)
-               {
-                  JSON_Writer_WriteComma(context.writer);
-                  json_write_new_line(context.writer);
-               }
-            }
-
-            json_write_new_line(context.writer);
-            json_write_space(context.writer, 6);
-            JSON_Writer_WriteEndArray(context.writer);
-         }
-
-         json_write_new_line(context.writer);
-
-         json_write_space(context.writer, 4);
-         JSON_Writer_WriteEndObject(context.writer);
+         playlist_write_json_entry(context.writer,
+               &playlist->entries[i], compressed);
 
          if (i < len - 1)
             JSON_Writer_WriteComma(context.writer);
@@ -1863,12 +2253,17 @@ void playlist_write_file(playlist_t *playlist)
       json_write_new_line(context.writer);
       JSON_Writer_Free(context.writer);
 
-      playlist->old_format = false;
+      playlist->old_format         = false;
+      playlist->journal_base_valid = true;
+      playlist->journal_base_crc   = context.output_crc;
+      playlist->journal_base_len   = context.output_len;
    }
 
    playlist->modified   = false;
    playlist->compressed = compressed;
 
+   playlist_journal_clear(playlist);
+
    RARCH_LOG("[Playlist]: Written to playlist file: %s\n", playlist->config.path);
 end:
    intfstream_close(file);
@@ -1900,6 +2295,9 @@ void playlist_free(playlist_t *playlist)
       free(playlist->base_content_directory);
    playlist->base_content_directory = NULL;
 
+   playlist_free_lazy_data(playlist);
+   RBUF_FREE(playlist->journal);
+
    if (playlist->entries)
    {
       for (i = 0, len = RBUF_LEN(playlist->entries); i < len; i++)
@@ -1928,6 +2326,8 @@ void playlist_clear(playlist_t *playlist)
    if (!playlist)
       return;
 
+   playlist_free_lazy_data(playlist);
+
    for (i = 0, len = RBUF_LEN(playlist->entries); i < len; i++)
    {
       struct playlist_entry *entry = &playlist->entries[i];
@@ -1936,6 +2336,10 @@ void playlist_clear(playlist_t *playlist)
          playlist_free_entry(entry);
    }
    RBUF_CLEAR(playlist->entries);
+
+   /* Journal records no longer apply to the
+    * contents of the playlist file */
+   playlist->journal_base_valid = false;
 }
 
 /**
@@ -2030,6 +2434,15 @@ static JSON_Parser_HandlerResult JSONStartObjectHandler(JSON_Parser parser)
       if ((pCtx->array_depth == 1) && !pCtx->capacity_exceeded)
       {
          size_t len = RBUF_LEN(pCtx->playlist->entries);
+
+         /* Materializing a single lazily indexed entry:
+          * fill the existing slot in place */
+         if (pCtx->lazy_target)
+         {
+            pCtx->current_entry = pCtx->lazy_target;
+            return JSON_Parser_Continue;
+         }
+
          if (len < pCtx->playlist->config.capacity)
          {
             /* Allocate memory to fit one more item but don't resize the
@@ -2041,6 +2454,13 @@ static JSON_Parser_HandlerResult JSONStartObjectHandler(JSON_Parser parser)
             }
             pCtx->current_entry = &pCtx->playlist->entries[len];
             memset(pCtx->current_entry, 0, sizeof(*pCtx->current_entry));
+
+            if (pCtx->lazy_index)
+            {
+               JSON_Location location;
+               JSON_Parser_GetTokenLocation(parser, &location);
+               pCtx->lazy_entry_start = location.byte;
+            }
          }
          else
          {
@@ -2068,9 +2488,32 @@ static JSON_Parser_HandlerResult JSONEndObjectHandler(JSON_Parser parser)
 
    if (pCtx->in_items && pCtx->object_depth == 2)
    {
-      if ((pCtx->array_depth == 1) && !pCtx->capacity_exceeded)
-         RBUF_RESIZE(pCtx->playlist->entries,
-               RBUF_LEN(pCtx->playlist->entries) + 1);
+      if (     (pCtx->array_depth == 1)
+            && !pCtx->capacity_exceeded
+            && !pCtx->lazy_target)
+      {
+         size_t len = RBUF_LEN(pCtx->playlist->entries);
+
+         if (pCtx->lazy_index)
+         {
+            JSON_Location location;
+            struct playlist_entry_span *spans = pCtx->playlist->lazy_spans;
+
+            if (!RBUF_TRYFIT(spans, len + 1))
+            {
+               pCtx->out_of_memory = true;
+               return JSON_Parser_Abort;
+            }
+
+            JSON_Parser_GetAfterTokenLocation(parser, &location);
+            RBUF_RESIZE(spans, len + 1);
+            spans[len].offset = pCtx->lazy_entry_start;
+            spans[len].len    = location.byte - pCtx->lazy_entry_start;
+            pCtx->playlist->lazy_spans = spans;
+         }
+
+         RBUF_RESIZE(pCtx->playlist->entries, len + 1);
+      }
    }
 
    retro_assert(pCtx->object_depth > 0);
@@ -2192,6 +2635,12 @@ static JSON_Parser_HandlerResult JSONObjectMemberHandler(JSON_Parser parser, cha
 
    if (pCtx->in_items && pCtx->object_depth == 2)
    {
+      /* When only indexing entries, member values are
+       * left unassigned - they are parsed on demand by
+       * playlist_materialize_entry() */
+      if (pCtx->lazy_index)
+         return JSON_Parser_Continue;
+
       if (pCtx->array_depth == 1)
       {
          if (pCtx->current_entry_val)
@@ -2306,6 +2755,251 @@ static JSON_Parser_HandlerResult JSONObjectMemberHandler(JSON_Parser parser, cha
    return JSON_Parser_Continue;
 }
 
+static JSON_Parser_HandlerResult JSONEncodingDetectedHandler(JSON_Parser parser)
+{
+   JSONContext *pCtx = (JSONContext*)JSON_Parser_GetUserData(parser);
+
+   /* Entry spans are re-parsed as UTF-8 - anything
+    * else must be loaded eagerly */
+   if (JSON_Parser_GetInputEncoding(parser) != JSON_UTF8)
+      pCtx->lazy_index = false;
+
+   return JSON_Parser_Continue;
+}
+
+static void playlist_json_parser_init(JSONContext *pCtx)
+{
+#if 0
+   JSON_Parser_SetTrackObjectMembers(pCtx->parser, JSON_True);
+#endif
+   JSON_Parser_SetAllowBOM(pCtx->parser, JSON_True);
+   JSON_Parser_SetAllowComments(pCtx->parser, JSON_True);
+   JSON_Parser_SetAllowSpecialNumbers(pCtx->parser, JSON_True);
+   JSON_Parser_SetAllowHexNumbers(pCtx->parser, JSON_True);
+   JSON_Parser_SetAllowUnescapedControlCharacters(pCtx->parser, JSON_True);
+   JSON_Parser_SetReplaceInvalidEncodingSequences(pCtx->parser, JSON_True);
+
+#if 0
+   JSON_Parser_SetNullHandler(pCtx->parser,          &JSONNullHandler);
+   JSON_Parser_SetBooleanHandler(pCtx->parser,       &JSONBooleanHandler);
+   JSON_Parser_SetSpecialNumberHandler(pCtx->parser, &JSONSpecialNumberHandler);
+   JSON_Parser_SetArrayItemHandler(pCtx->parser,     &JSONArrayItemHandler);
+#endif
+
+   JSON_Parser_SetNumberHandler(pCtx->parser,        &JSONNumberHandler);
+   JSON_Parser_SetStringHandler(pCtx->parser,        &JSONStringHandler);
+   JSON_Parser_SetStartObjectHandler(pCtx->parser,   &JSONStartObjectHandler);
+   JSON_Parser_SetEndObjectHandler(pCtx->parser,     &JSONEndObjectHandler);
+   JSON_Parser_SetObjectMemberHandler(pCtx->parser,  &JSONObjectMemberHandler);
+   JSON_Parser_SetStartArrayHandler(pCtx->parser,    &JSONStartArrayHandler);
+   JSON_Parser_SetEndArrayHandler(pCtx->parser,      &JSONEndArrayHandler);
+   JSON_Parser_SetUserData(pCtx->parser, pCtx);
+}
+
+static void playlist_free_lazy_data(playlist_t *playlist)
+{
+   RBUF_FREE(playlist->lazy_data);
+   RBUF_FREE(playlist->lazy_spans);
+   playlist->lazy_pending = 0;
+}
+
+/* Parses a single entry object of the 'items'
+ * array into @entry */
+static bool playlist_parse_entry(playlist_t *playlist,
+      struct playlist_entry *entry, const char *data, size_t len)
+{
+   bool success        = false;
+   JSONContext context = {0};
+
+   if (!(context.parser = JSON_Parser_Create(NULL)))
+      return false;
+
+   context.playlist     = playlist;
+   context.lazy_target  = entry;
+   /* Resume parsing as if the 'items' array
+    * of the playlist object had just been entered */
+   context.in_items     = true;
+   context.array_depth  = 1;
+   context.object_depth = 1;
+
+   playlist_json_parser_init(&context);
+   JSON_Parser_SetInputEncoding(context.parser, JSON_UTF8);
+
+   if (JSON_Parser_Parse(context.parser, data, len, JSON_True))
+      success = true;
+   else
+      JSONLogError(&context);
+
+   JSON_Parser_Free(context.parser);
+
+   if (context.current_items_string)
+      free(context.current_items_string);
+
+   return success;
+}
+
+/**
+ * playlist_materialize_entry:
+ * @playlist            : Playlist handle.
+ * @idx                 : Index of playlist entry.
+ *
+ * Parses the entry at index @idx from the raw
+ * JSON text retained by playlist_read_file(),
+ * if this has not already been done.
+ **/
+static void playlist_materialize_entry(playlist_t *playlist, size_t idx)
+{
+   struct playlist_entry_span *span;
+
+   if (!playlist->lazy_pending || idx >= RBUF_LEN(playlist->lazy_spans))
+      return;
+
+   span = &playlist->lazy_spans[idx];
+   if (!span->len)
+      return;
+
+   if (!playlist_parse_entry(playlist, &playlist->entries[idx],
+            playlist->lazy_data + span->offset, span->len))
+      RARCH_WARN("Error parsing JSON playlist entry %u.\n", (unsigned)idx);
+
+   playlist_lazy_drop(playlist, idx);
+}
+
+/* Applies a single journal record to the playlist */
+static bool playlist_journal_apply(playlist_t *playlist, char *record)
+{
+   size_t idx = 0;
+   char *json = record + 1;
+   char op    = record[0];
+
+   if (op != 'I')
+   {
+      idx = (size_t)strtoul(record + 1, &json, 10);
+      if (     (json == record + 1)
+            || (idx >= RBUF_LEN(playlist->entries)))
+         return false;
+   }
+
+   switch (op)
+   {
+      case 'D':
+         playlist_remove_entry(playlist, idx);
+         return true;
+      case 'M':
+         playlist_move_entry_to_front(playlist, idx);
+         return true;
+      case 'I':
+         if (!playlist_insert_entry_front(playlist))
+            return false;
+         return playlist_parse_entry(playlist,
+               &playlist->entries[0], json, strlen(json));
+      case 'U':
+         playlist_lazy_drop(playlist, idx);
+         playlist_free_entry(&playlist->entries[idx]);
+         return playlist_parse_entry(playlist,
+               &playlist->entries[idx], json, strlen(json));
+      default:
+         break;
+   }
+
+   return false;
+}
+
+/**
+ * playlist_journal_replay:
+ * @playlist            : Playlist handle.
+ *
+ * Applies the records of the journal file to a
+ * freshly read playlist. Journal files that do not
+ * match the playlist file are removed.
+ **/
+static void playlist_journal_replay(playlist_t *playlist)
+{
+   char journal_path[PATH_MAX_LENGTH];
+   unsigned base_crc     = 0;
+   unsigned long base_len = 0;
+   int header_len        = 0;
+   int64_t size          = 0;
+   char *data            = NULL;
+   char *record          = NULL;
+   char *record_end      = NULL;
+   size_t records        = 0;
+
+   journal_path[0] = '\0';
+
+   playlist_journal_get_path(playlist,
+         journal_path, sizeof(journal_path));
+
+   if (     !path_is_valid(journal_path)
+         || !filestream_read_file(journal_path, (void**)&data, &size))
+      return;
+
+   if (     (sscanf(data, PLAYLIST_JOURNAL_MAGIC " %x %lu%n",
+               &base_crc, &base_len, &header_len) != 2)
+         || (data[header_len] != '\n')
+         || (base_crc != playlist->journal_base_crc)
+         || (base_len != playlist->journal_base_len))
+   {
+      /* Playlist file has been replaced since the
+       * journal was written */
+      RARCH_LOG("[Playlist]: Discarding stale playlist journal: %s\n",
+            journal_path);
+      free(data);
+      filestream_delete(journal_path);
+      return;
+   }
+
+   for (record = data + header_len + 1;
+        (record_end = strchr(record, '\n'));
+        record = record_end + 1)
+   {
+      *record_end = '\0';
+
+      if (!playlist_journal_apply(playlist, record))
+         break;
+
+      records++;
+   }
+
+   /* A truncated or invalid record means the journal
+    * cannot be appended to - rewrite the playlist
+    * on the next write */
+   if (*record)
+   {
+      RARCH_WARN("[Playlist]: Invalid playlist journal record: %s\n",
+            journal_path);
+      playlist->modified = true;
+   }
+
+   /* Journal file must be removed by the next
+    * rewrite, even if it held no valid records */
+   playlist->journal_records = records > 0 ? records : 1;
+
+   while (RBUF_LEN(playlist->entries) > playlist->config.capacity)
+   {
+      playlist_remove_entry(playlist, RBUF_LEN(playlist->entries) - 1);
+      playlist->modified = true;
+   }
+
+   free(data);
+}
+
+/**
+ * playlist_materialize_all:
+ * @playlist            : Playlist handle.
+ *
+ * Parses all lazily indexed entries. Must be
+ * called before entries are iterated, reordered,
+ * removed or appended.
+ **/
+static void playlist_materialize_all(playlist_t *playlist)
+{
+   size_t i;
+
+   for (i = 0; playlist->lazy_pending > 0; i++)
+      playlist_materialize_entry(playlist, i);
+}
+
 static void get_old_format_metadata_value(
       char *metadata_line, char *value, size_t len)
 {
@@ -2386,9 +3080,13 @@ static bool playlist_read_file(playlist_t *playlist)
    if (!playlist->old_format)
    {
       JSONContext context = {0};
+      char *json_data     = NULL;
+      uint32_t json_crc   = 0;
+      size_t json_len     = 0;
       context.parser      = JSON_Parser_Create(NULL);
       context.file        = file;
       context.playlist    = playlist;
+      context.lazy_index  = true;
 
       if (!context.parser)
       {
@@ -2396,31 +3094,9 @@ static bool playlist_read_file(playlist_t *playlist)
          goto end;
       }
 
-#if 0
-      JSON_Parser_SetTrackObjectMembers(context.parser, JSON_True);
-#endif
-      JSON_Parser_SetAllowBOM(context.parser, JSON_True);
-      JSON_Parser_SetAllowComments(context.parser, JSON_True);
-      JSON_Parser_SetAllowSpecialNumbers(context.parser, JSON_True);
-      JSON_Parser_SetAllowHexNumbers(context.parser, JSON_True);
-      JSON_Parser_SetAllowUnescapedControlCharacters(context.parser, JSON_True);
-      JSON_Parser_SetReplaceInvalidEncodingSequences(context.parser, JSON_True);
-
-#if 0
-      JSON_Parser_SetNullHandler(context.parser,          &JSONNullHandler);
-      JSON_Parser_SetBooleanHandler(context.parser,       &JSONBooleanHandler);
-      JSON_Parser_SetSpecialNumberHandler(context.parser, &JSONSpecialNumberHandler);
-      JSON_Parser_SetArrayItemHandler(context.parser,     &JSONArrayItemHandler);
-#endif
-
-      JSON_Parser_SetNumberHandler(context.parser,        &JSONNumberHandler);
-      JSON_Parser_SetStringHandler(context.parser,        &JSONStringHandler);
-      JSON_Parser_SetStartObjectHandler(context.parser,   &JSONStartObjectHandler);
-      JSON_Parser_SetEndObjectHandler(context.parser,     &JSONEndObjectHandler);
-      JSON_Parser_SetObjectMemberHandler(context.parser,  &JSONObjectMemberHandler);
-      JSON_Parser_SetStartArrayHandler(context.parser,    &JSONStartArrayHandler);
-      JSON_Parser_SetEndArrayHandler(context.parser,      &JSONEndArrayHandler);
-      JSON_Parser_SetUserData(context.parser, &context);
+      playlist_json_parser_init(&context);
+      JSON_Parser_SetEncodingDetectedHandler(context.parser,
+            &JSONEncodingDetectedHandler);
 
       while (!intfstream_eof(file))
       {
@@ -2433,6 +3109,26 @@ static bool playlist_read_file(playlist_t *playlist)
             goto json_cleanup;
          }
 
+         json_crc  = encoding_crc32(json_crc, (const uint8_t*)chunk,
+               (size_t)length);
+         json_len += (size_t)length;
+
+         /* Keep a copy of the raw text, so that indexed
+          * entries can be parsed later on */
+         if (context.lazy_index && length > 0)
+         {
+            size_t data_len = RBUF_LEN(json_data);
+
+            if (!RBUF_TRYFIT(json_data, data_len + (size_t)length))
+            {
+               RARCH_WARN("Ran out of memory while parsing JSON playlist\n");
+               res = false;
+               goto json_cleanup;
+            }
+            memcpy(json_data + data_len, chunk, (size_t)length);
+            RBUF_RESIZE(json_data, data_len + (size_t)length);
+         }
+
          if (!JSON_Parser_Parse(context.parser, chunk,
                   (size_t)length, JSON_False))
          {
@@ -2462,10 +3158,35 @@ static bool playlist_read_file(playlist_t *playlist)
          goto json_cleanup;
       }
 
+      /* Journal records are only valid for the
+       * exact file contents they were written for */
+      playlist->journal_base_valid = true;
+      playlist->journal_base_crc   = json_crc;
+      playlist->journal_base_len   = json_len;
+
 json_cleanup:
 
       JSON_Parser_Free(context.parser);
 
+      if (     res
+            && context.lazy_index
+            && RBUF_LEN(playlist->lazy_spans) > 0)
+      {
+         playlist->lazy_data    = json_data;
+         playlist->lazy_pending = RBUF_LEN(playlist->lazy_spans);
+      }
+      else
+      {
+         RBUF_FREE(json_data);
+         RBUF_FREE(playlist->lazy_spans);
+      }
+
+      /* Entry indices of the journal refer to the
+       * complete list of entries in the file */
+      if (     playlist->journal_base_valid
+            && !context.capacity_exceeded)
+         playlist_journal_replay(playlist);
+
       if (context.current_meta_string)
          free(context.current_meta_string);
 
@@ -2732,6 +3453,15 @@ playlist_t *playlist_init(const playlist_config_t *config)
    playlist->default_core_path      = NULL;
    playlist->base_content_directory = NULL;
    playlist->entries                = NULL;
+   playlist->lazy_data              = NULL;
+   playlist->lazy_spans             = NULL;
+   playlist->lazy_pending           = 0;
+   playlist->journal                = NULL;
+   playlist->journal_pending        = 0;
+   playlist->journal_records        = 0;
+   playlist->journal_base_len       = 0;
+   playlist->journal_base_crc       = 0;
+   playlist->journal_base_valid     = false;
    playlist->label_display_mode     = LABEL_DISPLAY_MODE_DEFAULT;
    playlist->right_thumbnail_mode   = PLAYLIST_THUMBNAIL_MODE_DEFAULT;
    playlist->left_thumbnail_mode    = PLAYLIST_THUMBNAIL_MODE_DEFAULT;
@@ -2754,6 +3484,8 @@ playlist_t *playlist_init(const playlist_config_t *config)
          size_t i, j, len;
          char tmp_entry_path[PATH_MAX_LENGTH];
 
+         playlist_materialize_all(playlist);
+
          for (i = 0, len = RBUF_LEN(playlist->entries); i < len; i++)
          {
             struct playlist_entry* entry = &playlist->entries[i];
@@ -2906,9 +3638,15 @@ void playlist_qsort(playlist_t *playlist)
        !playlist->entries)
       return;
 
+   playlist_materialize_all(playlist);
+
    qsort(playlist->entries, RBUF_LEN(playlist->entries),
          sizeof(struct playlist_entry),
          (int (*)(const void *, const void *))playlist_qsort_func);
+
+   /* Entry indices no longer match the playlist file,
+    * so any further changes require a full rewrite */
+   playlist->journal_base_valid = false;
 }
 
 void command_playlist_push_write(
@@ -2949,6 +3687,8 @@ bool playlist_index_is_valid(playlist_t *playlist, size_t idx,
    if (idx >= RBUF_LEN(playlist->entries))
       return false;
 
+   playlist_materialize_entry(playlist, idx);
+
    return string_is_equal(playlist->entries[idx].path, path) &&
           string_is_equal(path_basename(playlist->entries[idx].core_path), path_basename(core_path));
 }
@@ -3004,6 +3744,8 @@ void playlist_get_crc32(playlist_t *playlist, size_t idx,
    if (!playlist || idx >= RBUF_LEN(playlist->entries))
       return;
 
+   playlist_materialize_entry(playlist, idx);
+
    if (crc32)
       *crc32 = playlist->entries[idx].crc32;
 }
@@ -3014,6 +3756,8 @@ void playlist_get_db_name(playlist_t *playlist, size_t idx,
    if (!playlist || idx >= RBUF_LEN(playlist->entries))
       return;
 
+   playlist_materialize_entry(playlist, idx);
+
    if (db_name)
    {
       if (!string_is_empty(playlist->entries[idx].db_name))
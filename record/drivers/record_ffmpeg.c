@@ -28,6 +28,7 @@
 #include <rthreads/rthreads.h>
 #include <gfx/scaler/scaler.h>
 #include <gfx/video_frame.h>
+#include <features/features_cpu.h>
 #include <file/config_file.h>
 #include <audio/audio_resampler.h>
 #include <string/stdstring.h>
@@ -507,6 +508,9 @@ static bool ffmpeg_init_video(ffmpeg_t *handle)
          return false;
    }
 
+   /* Scaling happens on the recording thread, ahead of encoding */
+   video->scaler.threads = cpu_features_get_core_amount();
+
    video->codec = avcodec_alloc_context3(codec);
 
    /* Useful to set scale_factor to 2 for chroma subsampled formats to
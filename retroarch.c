@@ -218,6 +218,8 @@
 #include "file_path_special.h"
 #include "ui/ui_companion_driver.h"
 #include "verbosity.h"
+#include "frame_trace.h"
+#include "benchmark.h"
 
 #include "frontend/frontend_driver.h"
 #ifdef HAVE_THREADS
@@ -303,6 +305,40 @@ audio_driver_t audio_null = {
    NULL
 };
 
+/* Takes and discards everything. Unlike audio_null it initializes, so
+ * that benchmarks still go through conversion and resampling. */
+static void *audio_null_sink_init(const char *device, unsigned rate,
+      unsigned latency, unsigned block_frames, unsigned *new_rate)
+{
+   /* Nothing to keep, but the frontend needs a valid handle */
+   return calloc(1, sizeof(int));
+}
+
+static ssize_t audio_null_sink_write(void *data, const void *buf,
+      size_t size) { return size; }
+static bool audio_null_sink_stop(void *data) { return true; }
+static bool audio_null_sink_start(void *data, bool is_shutdown) { return true; }
+static bool audio_null_sink_alive(void *data) { return true; }
+static void audio_null_sink_set_nonblock_state(void *data, bool toggle) { }
+static void audio_null_sink_free(void *data) { free(data); }
+static bool audio_null_sink_use_float(void *data) { return true; }
+
+static audio_driver_t audio_null_sink = {
+   audio_null_sink_init,
+   audio_null_sink_write,
+   audio_null_sink_stop,
+   audio_null_sink_start,
+   audio_null_sink_alive,
+   audio_null_sink_set_nonblock_state,
+   audio_null_sink_free,
+   audio_null_sink_use_float,
+   "null_sink",
+   NULL,
+   NULL,
+   NULL, /* write_avail */
+   NULL
+};
+
 static const audio_driver_t *audio_drivers[] = {
 #ifdef HAVE_ALSA
    &audio_alsa,
@@ -422,6 +458,12 @@ static bool video_null_frame(void *data, const void *frame,
       unsigned frame_width, unsigned frame_height, uint64_t frame_count,
       unsigned pitch, const char *msg, video_frame_info_t *video_info)
 {
+#ifdef HAVE_MENU
+   /* Benchmarks still lay out and submit the menu through
+    * the null display driver, so its draw calls are counted */
+   if (benchmark_is_enabled())
+      menu_driver_frame(video_info->menu_is_alive, video_info);
+#endif
    return true;
 }
 
@@ -1160,6 +1202,9 @@ static const camera_driver_t *camera_drivers[] = {
 
 #define TIME_TO_FPS(last_time, new_time, frames) ((1000000.0f * (frames)) / ((new_time) - (last_time)))
 
+/* How often the on-screen video statistics are formatted */
+#define VIDEO_STATISTICS_UPDATE_USEC 250000
+
 #define AUDIO_BUFFER_FREE_SAMPLES_COUNT (8 * 1024)
 
 #define MENU_SOUND_FORMATS "ogg|mod|xm|s3m|mp3|flac|wav"
@@ -1517,7 +1562,9 @@ enum
    RA_OPT_MAX_FRAMES_SCREENSHOT_PATH,
    RA_OPT_SET_SHADER,
    RA_OPT_ACCESSIBILITY,
-   RA_OPT_LOAD_MENU_ON_ERROR
+   RA_OPT_LOAD_MENU_ON_ERROR,
+   RA_OPT_TRACE,
+   RA_OPT_BENCHMARK
 };
 
 enum  runloop_state
@@ -1762,6 +1809,44 @@ struct input_bind_map
 
 typedef struct turbo_buttons turbo_buttons_t;
 
+/* Automatic frame delay: how many frames of core run time to keep,
+ * which percentile of them to plan for, how often to reconsider, and
+ * how long to wait after an overrun before raising the delay again */
+#define FRAME_DELAY_AUTO_SAMPLES      64
+#define FRAME_DELAY_AUTO_PERCENTILE   95
+#define FRAME_DELAY_AUTO_INTERVAL     16
+#define FRAME_DELAY_AUTO_HOLD         180
+#define FRAME_DELAY_AUTO_MARGIN_USEC  1500
+#define FRAME_DELAY_AUTO_MAX          15
+
+/* Frame limiter: the shortest and longest final stretch to spin
+ * through rather than sleep, and how many frames the pacing error
+ * maximum covers */
+#define FRAME_LIMIT_SPIN_MIN_USEC     200
+#define FRAME_LIMIT_SPIN_MAX_USEC     2000
+#define FRAME_LIMIT_STATS_FRAMES      300
+
+typedef struct frame_limit_stats
+{
+   retro_time_t oversleep_usec;  /* running average of sleep lateness */
+   retro_time_t error_avg_usec;  /* running average of pacing error */
+   retro_time_t error_max_usec;
+   retro_time_t error_max_last_usec;
+   unsigned frames;
+} frame_limit_stats_t;
+
+typedef struct frame_delay_auto
+{
+   retro_time_t samples[FRAME_DELAY_AUTO_SAMPLES];
+   retro_time_t present_usec;    /* time spent in video frame() calls */
+   retro_time_t last_frame_time;
+   unsigned count;
+   unsigned index;
+   unsigned frames;
+   unsigned hold;
+   unsigned delay;               /* ms */
+} frame_delay_auto_t;
+
 /* Turbo support. */
 struct turbo_buttons
 {
@@ -1772,6 +1857,12 @@ struct turbo_buttons
    bool mode1_enable[MAX_USERS];
 };
 
+/* Which parts of a user's input snapshot have been filled in since the
+ * last poll */
+#define INPUT_SNAPSHOT_BUTTONS                1
+#define INPUT_SNAPSHOT_ANALOG(idx, id)        (1 << (1 + ((idx) * 2) + (id)))
+#define INPUT_SNAPSHOT_ANALOG_BUTTON(id)      (1 << (8 + (id)))
+
 struct input_keyboard_line
 {
    char *buffer;
@@ -1937,6 +2028,8 @@ struct rarch_state
    retro_time_t libretro_core_runtime_usec;
    retro_time_t video_driver_frame_time_samples[
       MEASURE_FRAME_TIME_SAMPLES_COUNT];
+   frame_delay_auto_t frame_delay_auto;         /* retro_time_t alignment */
+   frame_limit_stats_t frame_limit_stats;       /* retro_time_t alignment */
    struct global              g_extern;         /* retro_time_t alignment */
 #ifdef HAVE_MENU
    menu_input_t menu_input_state;               /* retro_time_t alignment */
@@ -1979,6 +2072,7 @@ struct rarch_state
 
    uint64_t video_driver_frame_time_count;
    uint64_t video_driver_frame_count;
+   retro_time_t video_driver_stat_time;
    struct retro_camera_callback camera_cb;    /* uint64_t alignment */
    gfx_animation_t anim;                      /* uint64_t alignment */
    gfx_thumbnail_state_t gfx_thumb_state;     /* uint64_t alignment */
@@ -2142,6 +2236,7 @@ struct rarch_state
    bsv_movie_t     *bsv_movie_state_handle;              /* ptr alignment */
 #endif
    gfx_display_t              dispgfx;                   /* ptr alignment */
+   video_frame_info_t video_driver_frame_info;           /* ptr alignment */
    input_keyboard_press_t keyboard_press_cb;             /* ptr alignment */
    struct retro_frame_time_callback runloop_frame_time;  /* ptr alignment */
    retro_input_state_t input_state_callback_original;    /* ptr alignment */
@@ -2213,6 +2308,11 @@ struct rarch_state
                                                put it right before long */
 
    turbo_buttons_t input_driver_turbo_btns; /* int32_t alignment */
+
+   /* Raw driver state for each user, gathered on first use after each
+    * poll, so that the core's further queries are lookups */
+   input_bits_t input_snapshot[MAX_USERS];  /* uint32_t alignment */
+   uint32_t input_snapshot_valid[MAX_USERS];
    int osk_ptr;
 #if defined(HAVE_COMMAND)
 #ifdef HAVE_NETWORK_CMD
@@ -2265,6 +2365,7 @@ struct rarch_state
    unsigned frame_cache_height;
    unsigned video_driver_width;
    unsigned video_driver_height;
+   unsigned video_frame_delay_current;          /* ms, as last applied */
    unsigned osk_last_codepoint;
    unsigned osk_last_codepoint_len;
    unsigned input_driver_flushing_input;
@@ -2353,6 +2454,8 @@ struct rarch_state
    char menu_input_dialog_keyboard_label[256];
 #endif
    char video_driver_window_title[512];
+   char video_driver_mem_text[128];
+   char video_driver_fps_text[32];
 #ifdef HAVE_NETWORKING
    char server_address_deferred[512];
 #endif
@@ -2367,6 +2470,7 @@ struct rarch_state
 #endif
 #ifdef HAVE_SCREENSHOTS
    char runloop_max_frames_screenshot_path[PATH_MAX_LENGTH];
+   char frame_trace_path[PATH_MAX_LENGTH];
 #endif
    char runtime_content_path[PATH_MAX_LENGTH];
    char runtime_core_path[PATH_MAX_LENGTH];
@@ -2436,6 +2540,7 @@ struct rarch_state
    bool runloop_core_running;
    bool runloop_perfcnt_enable;
    bool video_driver_window_title_update;
+   bool video_driver_frame_info_dirty;
 
    /**
     * dynamic.c:dynamic_request_hw_context will try to set
@@ -2797,6 +2902,8 @@ static int16_t input_state(unsigned port, unsigned device,
       unsigned idx, unsigned id);
 static void video_driver_frame(const void *data, unsigned width,
       unsigned height, size_t pitch);
+static void video_driver_update_info(struct rarch_state *p_rarch,
+      settings_t *settings, video_frame_info_t *video_info);
 static void retro_frame_null(const void *data, unsigned width,
       unsigned height, size_t pitch);
 static void retro_run_null(void);
@@ -6233,7 +6340,11 @@ void menu_driver_frame(bool menu_is_alive, video_frame_info_t *video_info)
 {
    struct rarch_state   *p_rarch  = &rarch_st;
    if (menu_is_alive && p_rarch->menu_driver_ctx->frame)
+   {
+      gfx_display_batch_begin();
       p_rarch->menu_driver_ctx->frame(p_rarch->menu_userdata, video_info);
+      gfx_display_batch_end();
+   }
 }
 
 /* Time format strings with AM-PM designation require special
@@ -9055,11 +9166,14 @@ static bool get_self_input_state(
       netplay->read_frame_count[netplay->self_client_num] = netplay->self_frame_count + 1;
    }
 
-   /* And send this input to our peers */
+   /* And send this input to our peers, spectators all at once if they're
+    * relayed */
+   netplay_send_cur_input_relayed(netplay);
    for (i = 0; i < netplay->connections_size; i++)
    {
       struct netplay_connection *connection = &netplay->connections[i];
-      if (connection->active && connection->mode >= NETPLAY_CONNECTION_CONNECTED)
+      if (connection->active && connection->mode >= NETPLAY_CONNECTION_CONNECTED
+            && !connection->send_packet_buffer.relay)
          netplay_send_cur_input(netplay, &netplay->connections[i]);
    }
 
@@ -9967,6 +10081,55 @@ static void netplay_force_future(netplay_t *netplay)
    }
 }
 
+/**
+ * netplay_savestate_delta_prepare
+ * @netplay              : pointer to netplay object
+ * @serial_info          : the savestate being loaded
+ *
+ * Compute the delta between the savestate being sent and the last state
+ * shared with our peers, if any peer can use it.
+ *
+ * Returns true if netplay->savestate_patch holds a delta worth sending.
+ */
+static bool netplay_savestate_delta_prepare(netplay_t *netplay,
+   retro_ctx_serialize_info_t *serial_info)
+{
+   size_t i;
+   bool wanted = false;
+
+   netplay->savestate_patch_size = 0;
+
+   if (!netplay->savestate_ref || serial_info->size != netplay->state_size)
+      return false;
+
+   for (i = 0; i < netplay->connections_size; i++)
+   {
+      struct netplay_connection *connection = &netplay->connections[i];
+      if (connection->active &&
+          connection->mode >= NETPLAY_CONNECTION_CONNECTED &&
+          connection->savestate_ref_valid)
+      {
+         wanted = true;
+         break;
+      }
+   }
+
+   if (!wanted)
+      return false;
+
+   memcpy(netplay->savestate_cur, serial_info->data_const,
+         netplay->state_size);
+   netplay->savestate_patch_size = state_manager_raw_compress(
+         netplay->savestate_cur, netplay->savestate_ref,
+         netplay->state_size, netplay->savestate_patch);
+
+   /* A state that changed almost everywhere isn't worth a delta */
+   if (netplay->savestate_patch_size >= netplay->state_size)
+      netplay->savestate_patch_size = 0;
+
+   return netplay->savestate_patch_size != 0;
+}
+
 /**
  * netplay_send_savestate
  * @netplay              : pointer to netplay object
@@ -9975,48 +10138,107 @@ static void netplay_force_future(netplay_t *netplay)
  * @z                    : compression backend to use
  *
  * Send a loaded savestate to those connected peers using the given compression
- * scheme.
+ * scheme. Peers holding our savestate reference get the delta prepared by
+ * netplay_savestate_delta_prepare instead of the full state.
  */
 void netplay_send_savestate(netplay_t *netplay,
    retro_ctx_serialize_info_t *serial_info, uint32_t cx,
    struct compression_transcoder *z)
 {
-   uint32_t header[4];
+   uint32_t header[5];
    uint32_t rd, wn;
    size_t i;
+   unsigned delta;
 
-   /* Compress it */
-   z->compression_backend->set_in(z->compression_stream,
-      (const uint8_t*)serial_info->data_const, (uint32_t)serial_info->size);
-   z->compression_backend->set_out(z->compression_stream,
-      netplay->zbuffer, (uint32_t)netplay->zbuffer_size);
-   if (!z->compression_backend->trans(z->compression_stream, true, &rd,
-         &wn, NULL))
+   for (delta = 0; delta < 2; delta++)
    {
-      /* Catastrophe! */
+      struct netplay_relay_chunk *chunk = NULL;
+      bool compressed                   = false;
+
+      if (delta && !netplay->savestate_patch_size)
+         break;
+
       for (i = 0; i < netplay->connections_size; i++)
-         netplay_hangup(netplay, &netplay->connections[i]);
-      return;
-   }
+      {
+         struct netplay_connection *connection = &netplay->connections[i];
+         if (!connection->active ||
+             connection->mode < NETPLAY_CONNECTION_CONNECTED ||
+             connection->compression_supported != cx) continue;
+         if ((netplay->savestate_patch_size &&
+                  connection->savestate_ref_valid) != (delta != 0))
+            continue;
 
-   /* Send it to relevant peers */
-   header[0] = htonl(NETPLAY_CMD_LOAD_SAVESTATE);
-   header[1] = htonl(wn + 2*sizeof(uint32_t));
-   header[2] = htonl(netplay->run_frame_count);
-   header[3] = htonl(serial_info->size);
+         /* Compress it, once per variant */
+         if (!compressed)
+         {
+            if (delta)
+               z->compression_backend->set_in(z->compression_stream,
+                  netplay->savestate_patch,
+                  (uint32_t)netplay->savestate_patch_size);
+            else
+               z->compression_backend->set_in(z->compression_stream,
+                  (const uint8_t*)serial_info->data_const,
+                  (uint32_t)serial_info->size);
+            z->compression_backend->set_out(z->compression_stream,
+               netplay->zbuffer, (uint32_t)netplay->zbuffer_size);
+            if (!z->compression_backend->trans(z->compression_stream, true,
+                     &rd, &wn, NULL))
+            {
+               /* Catastrophe! */
+               for (i = 0; i < netplay->connections_size; i++)
+                  netplay_hangup(netplay, &netplay->connections[i]);
+               return;
+            }
+            compressed = true;
 
-   for (i = 0; i < netplay->connections_size; i++)
-   {
-      struct netplay_connection *connection = &netplay->connections[i];
-      if (!connection->active ||
-          connection->mode < NETPLAY_CONNECTION_CONNECTED ||
-          connection->compression_supported != cx) continue;
+            header[2] = htonl(netplay->run_frame_count);
+            header[3] = htonl(serial_info->size);
+            if (delta)
+            {
+               header[0] = htonl(NETPLAY_CMD_LOAD_SAVESTATE_DELTA);
+               header[1] = htonl(wn + 3*sizeof(uint32_t));
+               header[4] = htonl(netplay->savestate_ref_crc);
+            }
+            else
+            {
+               header[0] = htonl(NETPLAY_CMD_LOAD_SAVESTATE);
+               header[1] = htonl(wn + 2*sizeof(uint32_t));
+            }
+         }
 
-      if (!netplay_send(&connection->send_packet_buffer, connection->fd, header,
-            sizeof(header)) ||
-          !netplay_send(&connection->send_packet_buffer, connection->fd,
-            netplay->zbuffer, wn))
-         netplay_hangup(netplay, connection);
+         /* Relayed spectators share one copy */
+         if (connection->send_packet_buffer.relay)
+         {
+            size_t hsize = (delta ? 5 : 4) * sizeof(uint32_t);
+
+            if (!chunk)
+            {
+               chunk = netplay_relay_chunk_new(hsize + wn);
+               if (chunk)
+               {
+                  memcpy(chunk->data, header, hsize);
+                  memcpy(chunk->data + hsize, netplay->zbuffer, wn);
+               }
+            }
+
+            if (chunk)
+            {
+               if (!netplay_relay_send(connection, chunk))
+                  netplay_hangup(netplay, connection);
+               continue;
+            }
+         }
+
+         /* Send it to relevant peers */
+         if (!netplay_send(&connection->send_packet_buffer, connection->fd,
+               header, (delta ? 5 : 4) * sizeof(uint32_t)) ||
+             !netplay_send(&connection->send_packet_buffer, connection->fd,
+               netplay->zbuffer, wn))
+            netplay_hangup(netplay, connection);
+      }
+
+      if (chunk)
+         netplay_relay_chunk_unref(netplay->relay, chunk);
    }
 }
 
@@ -10049,14 +10271,18 @@ void netplay_load_savestate(netplay_t *netplay,
             tmp_serial_info.data = netplay->buffer[netplay->run_ptr].state;
             if (!core_serialize(&tmp_serial_info))
                return;
+            netplay->buffer[netplay->run_ptr].have_state = true;
             tmp_serial_info.data_const = tmp_serial_info.data;
             serial_info = &tmp_serial_info;
          }
          else
          {
             if (serial_info->size <= netplay->state_size)
+            {
                memcpy(netplay->buffer[netplay->run_ptr].state,
                      serial_info->data_const, serial_info->size);
+               netplay->buffer[netplay->run_ptr].have_state = true;
+            }
          }
       }
       /* FIXME: This is a critical failure! */
@@ -10075,11 +10301,16 @@ void netplay_load_savestate(netplay_t *netplay,
       return;
 
    /* Send this to every peer */
+   netplay_savestate_delta_prepare(netplay, serial_info);
    if (netplay->compress_nil.compression_backend)
       netplay_send_savestate(netplay, serial_info, 0, &netplay->compress_nil);
    if (netplay->compress_zlib.compression_backend)
       netplay_send_savestate(netplay, serial_info, NETPLAY_COMPRESSION_ZLIB,
          &netplay->compress_zlib);
+
+   /* Everyone we sent it to now shares this state with us */
+   if (serial_info->size == netplay->state_size)
+      netplay_savestate_ref_update(netplay, serial_info->data_const, NULL);
 }
 
 /**
@@ -10273,8 +10504,11 @@ static bool init_netplay(
             : (port != 0 ? port : RARCH_DEFAULT_PORT),
          settings->bools.netplay_stateless_mode,
          settings->ints.netplay_check_frames,
+         settings->uints.netplay_checkpoint_frames,
          &cbs,
          settings->bools.netplay_nat_traversal && !settings->bools.netplay_use_mitm_server,
+         settings->bools.netplay_udp_input && !settings->bools.netplay_use_mitm_server,
+         settings->bools.netplay_spectator_relay,
 #ifdef HAVE_DISCORD
          discord_get_own_username(p_rarch) 
          ? discord_get_own_username(p_rarch) 
@@ -16074,7 +16308,9 @@ bool command_event(enum event_command cmd, void *data)
       case CMD_EVENT_SEND_DEBUG_INFO:
          break;
       case CMD_EVENT_FPS_TOGGLE:
-         settings->bools.video_fps_show = !(settings->bools.video_fps_show);
+         configuration_set_bool(settings,
+               settings->bools.video_fps_show,
+               !(settings->bools.video_fps_show));
          break;
       case CMD_EVENT_OVERLAY_NEXT:
          /* Switch to the next available overlay screen. */
@@ -16239,6 +16475,7 @@ bool command_event(enum event_command cmd, void *data)
             char ext_name[255];
             const char *dir_libretro       = settings->paths.directory_libretro;
             const char *path_libretro_info = settings->paths.path_libretro_info;
+            const char *dir_cache          = settings->paths.directory_cache;
             bool show_hidden_files         = settings->bools.show_hidden_files;
 
             ext_name[0]                    = '\0';
@@ -16251,6 +16488,7 @@ bool command_event(enum event_command cmd, void *data)
             if (!string_is_empty(dir_libretro))
                core_info_init_list(path_libretro_info,
                      dir_libretro,
+                     dir_cache,
                      ext_name,
                      show_hidden_files
                      );
@@ -17334,6 +17572,19 @@ void main_exit(void *args)
    if (p_rarch->runloop_perfcnt_enable)
       rarch_perf_log(p_rarch);
 
+   if (benchmark_is_enabled())
+   {
+      benchmark_report();
+      benchmark_deinit();
+   }
+
+   if (frame_trace_is_enabled())
+   {
+      task_queue_set_trace_cb(NULL);
+      frame_trace_export(p_rarch->frame_trace_path);
+      frame_trace_deinit();
+   }
+
 #if defined(HAVE_LOGGER) && !defined(ANDROID)
    logger_shutdown();
 #endif
@@ -17358,6 +17609,10 @@ void main_exit(void *args)
    rarch_ctl(RARCH_CTL_STATE_FREE,  NULL);
    global_free(p_rarch);
    task_queue_deinit();
+#ifdef HAVE_NETWORKING
+   /* No HTTP task is left to use the idle keep-alive connections */
+   net_http_pool_clear();
+#endif
 
    if (p_rarch->configuration_settings)
       free(p_rarch->configuration_settings);
@@ -17480,7 +17735,9 @@ int rarch_main(int argc, char *argv[], void *data)
 #endif
       ret = runloop_iterate();
 
+      FRAME_TRACE_BEGIN("task_queue_check");
       task_queue_check();
+      FRAME_TRACE_END("task_queue_check");
 
 #ifdef HAVE_QT
       app_exit = ui_companion_qt.application->exiting;
@@ -23693,6 +23950,7 @@ static void input_driver_poll(void)
    bool input_remap_binds_enable  = settings->bools.input_remap_binds_enable;
    uint8_t max_users              = (uint8_t)p_rarch->input_driver_max_users;
 
+   FRAME_TRACE_BEGIN("input_poll");
    if (p_rarch->joypad->poll)
       p_rarch->joypad->poll();
 #ifdef HAVE_MFI
@@ -23700,6 +23958,10 @@ static void input_driver_poll(void)
       p_rarch->sec_joypad->poll();
 #endif
    p_rarch->current_input->poll(p_rarch->current_input_data);
+   FRAME_TRACE_END("input_poll");
+
+   memset(p_rarch->input_snapshot_valid, 0,
+         sizeof(p_rarch->input_snapshot_valid));
 
    p_rarch->input_driver_turbo_btns.count++;
 
@@ -24421,26 +24683,13 @@ static int16_t input_state_device(
    return res;
 }
 
-/**
- * input_state:
- * @port                 : user number.
- * @device               : device identifier of user.
- * @idx                  : index value of user.
- * @id                   : identifier of key pressed by user.
- *
- * Input state callback function.
- *
- * Returns: Non-zero if the given key (identified by @id)
- * was pressed by the user (assigned to @port).
- **/
-static int16_t input_state(unsigned port, unsigned device,
-      unsigned idx, unsigned id)
+/* Ask the input driver for the state of a single input, as the core
+ * would see it before remapping, overlays and turbo */
+static int16_t input_state_raw(
+      struct rarch_state *p_rarch, settings_t *settings,
+      rarch_joypad_info_t *joypad_info,
+      unsigned port, unsigned device, unsigned idx, unsigned id)
 {
-   rarch_joypad_info_t joypad_info;
-   struct rarch_state *p_rarch = &rarch_st;
-   settings_t *settings        = p_rarch->configuration_settings;
-   int16_t result              = 0;
-   int16_t ret                 = 0;
 #ifdef HAVE_MFI
    const input_device_driver_t 
       *sec_joypad              = p_rarch->sec_joypad;
@@ -24448,33 +24697,11 @@ static int16_t input_state(unsigned port, unsigned device,
    const input_device_driver_t 
       *sec_joypad              = NULL;
 #endif
-
-   joypad_info.axis_threshold  = p_rarch->input_driver_axis_threshold;
-   joypad_info.joy_idx         = settings->uints.input_joypad_map[port];
-   joypad_info.auto_binds      = input_autoconf_binds[joypad_info.joy_idx];
-
-#ifdef HAVE_BSV_MOVIE
-   if (BSV_MOVIE_IS_PLAYBACK_ON())
-   {
-      int16_t bsv_result;
-      if (intfstream_read(p_rarch->bsv_movie_state_handle->file, &bsv_result, 2) == 2)
-      {
-#ifdef HAVE_CHEEVOS
-         rcheevos_pause_hardcore();
-#endif
-         return swap_if_big16(bsv_result);
-      }
-
-      p_rarch->bsv_movie_state.movie_end = true;
-   }
-#endif
-
-   device &= RETRO_DEVICE_MASK;
-   ret     = p_rarch->current_input->input_state(
+   int16_t ret = p_rarch->current_input->input_state(
          p_rarch->current_input_data,
          p_rarch->joypad,
          sec_joypad,
-         &joypad_info,
+         joypad_info,
          p_rarch->libretro_input_binds,
          p_rarch->keyboard_mapping_blocked,
          port, device, idx, id);
@@ -24483,11 +24710,6 @@ static int16_t input_state(unsigned port, unsigned device,
          (ret == 0))
    {
       const input_device_driver_t *joypad     = p_rarch->joypad;
-#ifdef HAVE_MFI
-      const input_device_driver_t *sec_joypad = p_rarch->sec_joypad;
-#else
-      const input_device_driver_t *sec_joypad = NULL;
-#endif
       if (p_rarch->libretro_input_binds[port])
       {
          if (idx == RETRO_DEVICE_INDEX_ANALOG_BUTTON)
@@ -24497,12 +24719,12 @@ static int16_t input_state(unsigned port, unsigned device,
                if (sec_joypad)
                   ret = input_joypad_analog_button(
                         p_rarch, settings,
-                        sec_joypad, &joypad_info,
+                        sec_joypad, joypad_info,
                         port, idx, id, p_rarch->libretro_input_binds[port]);
                if (joypad && (ret == 0))
                   ret = input_joypad_analog_button(
                         p_rarch, settings,
-                        joypad, &joypad_info,
+                        joypad, joypad_info,
                         port, idx, id, p_rarch->libretro_input_binds[port]);
             }
          }
@@ -24510,16 +24732,141 @@ static int16_t input_state(unsigned port, unsigned device,
          {
             if (sec_joypad)
                ret = input_joypad_analog_axis(p_rarch, settings,
-                     sec_joypad, &joypad_info,
+                     sec_joypad, joypad_info,
                      port, idx, id, p_rarch->libretro_input_binds[port]);
             if (joypad && (ret == 0))
                ret = input_joypad_analog_axis(p_rarch, settings,
-                     joypad, &joypad_info,
+                     joypad, joypad_info,
                      port, idx, id, p_rarch->libretro_input_binds[port]);
          }
       }
    }
 
+   return ret;
+}
+
+/* input_state_raw, but answered from the user's snapshot wherever it
+ * covers the query. The snapshot is filled in on first use after a poll:
+ * the whole button mask at once, and each analog axis or analog button
+ * separately. */
+static int16_t input_state_snapshot(
+      struct rarch_state *p_rarch, settings_t *settings,
+      rarch_joypad_info_t *joypad_info,
+      unsigned port, unsigned device, unsigned idx, unsigned id)
+{
+   input_bits_t *snapshot;
+   uint32_t *valid;
+   uint32_t bit = 0;
+
+   if (port < MAX_USERS)
+   {
+      switch (device)
+      {
+         case RETRO_DEVICE_JOYPAD:
+            if (id < RARCH_FIRST_CUSTOM_BIND ||
+                  id == RETRO_DEVICE_ID_JOYPAD_MASK)
+               bit = INPUT_SNAPSHOT_BUTTONS;
+            break;
+         case RETRO_DEVICE_ANALOG:
+            if (idx == RETRO_DEVICE_INDEX_ANALOG_BUTTON)
+            {
+               if (id < RARCH_FIRST_CUSTOM_BIND)
+                  bit = INPUT_SNAPSHOT_ANALOG_BUTTON(id);
+            }
+            else if (idx < 2 && id < 2)
+               bit = INPUT_SNAPSHOT_ANALOG(idx, id);
+            break;
+         default:
+            break;
+      }
+   }
+
+   if (!bit)
+      return input_state_raw(p_rarch, settings, joypad_info,
+            port, device, idx, id);
+
+   snapshot = &p_rarch->input_snapshot[port];
+   valid    = &p_rarch->input_snapshot_valid[port];
+
+   if (bit == INPUT_SNAPSHOT_BUTTONS)
+   {
+      if (!(*valid & bit))
+      {
+         snapshot->data[0] = (uint16_t)input_state_raw(p_rarch, settings,
+               joypad_info, port, RETRO_DEVICE_JOYPAD, 0,
+               RETRO_DEVICE_ID_JOYPAD_MASK);
+         *valid |= bit;
+      }
+      if (id == RETRO_DEVICE_ID_JOYPAD_MASK)
+         return (int16_t)snapshot->data[0];
+      return (snapshot->data[0] >> id) & 1;
+   }
+
+   if (idx == RETRO_DEVICE_INDEX_ANALOG_BUTTON)
+   {
+      if (!(*valid & bit))
+      {
+         snapshot->analog_buttons[id] = (uint16_t)input_state_raw(p_rarch,
+               settings, joypad_info, port, device, idx, id);
+         *valid |= bit;
+      }
+      return (int16_t)snapshot->analog_buttons[id];
+   }
+
+   if (!(*valid & bit))
+   {
+      snapshot->analogs[idx * 2 + id] = (uint16_t)input_state_raw(p_rarch,
+            settings, joypad_info, port, device, idx, id);
+      *valid |= bit;
+   }
+   return (int16_t)snapshot->analogs[idx * 2 + id];
+}
+
+/**
+ * input_state:
+ * @port                 : user number.
+ * @device               : device identifier of user.
+ * @idx                  : index value of user.
+ * @id                   : identifier of key pressed by user.
+ *
+ * Input state callback function.
+ *
+ * Returns: Non-zero if the given key (identified by @id)
+ * was pressed by the user (assigned to @port).
+ **/
+static int16_t input_state(unsigned port, unsigned device,
+      unsigned idx, unsigned id)
+{
+   rarch_joypad_info_t joypad_info;
+   struct rarch_state *p_rarch = &rarch_st;
+   settings_t *settings        = p_rarch->configuration_settings;
+   int16_t result              = 0;
+   int16_t ret                 = 0;
+
+   joypad_info.axis_threshold  = p_rarch->input_driver_axis_threshold;
+   joypad_info.joy_idx         = settings->uints.input_joypad_map[port];
+   joypad_info.auto_binds      = input_autoconf_binds[joypad_info.joy_idx];
+
+#ifdef HAVE_BSV_MOVIE
+   if (BSV_MOVIE_IS_PLAYBACK_ON())
+   {
+      int16_t bsv_result;
+      if (intfstream_read(p_rarch->bsv_movie_state_handle->file, &bsv_result, 2) == 2)
+      {
+#ifdef HAVE_CHEEVOS
+         rcheevos_pause_hardcore();
+#endif
+         return swap_if_big16(bsv_result);
+      }
+
+      p_rarch->bsv_movie_state.movie_end = true;
+   }
+#endif
+
+   device &= RETRO_DEVICE_MASK;
+   ret     = input_state_snapshot(p_rarch, settings, &joypad_info,
+         port, device, idx, id);
+
    if (     (p_rarch->input_driver_flushing_input == 0)
          && !p_rarch->input_driver_block_libretro_input)
    {
@@ -26377,6 +26724,13 @@ static bool input_driver_find_driver(struct rarch_state *p_rarch)
    driver_ctx_info_t drv;
    settings_t           *settings = p_rarch->configuration_settings;
 
+   /* Benchmarks take their input from a movie, if any */
+   if (benchmark_is_enabled())
+   {
+      p_rarch->current_input      = &input_null;
+      return true;
+   }
+
    drv.label                      = "input_driver";
    drv.s                          = settings->arrays.input_driver;
 
@@ -29381,6 +29735,12 @@ static bool audio_driver_find_driver(struct rarch_state *p_rarch)
    driver_ctx_info_t drv;
    settings_t     *settings    = p_rarch->configuration_settings;
 
+   if (benchmark_is_enabled())
+   {
+      p_rarch->current_audio   = &audio_null_sink;
+      return true;
+   }
+
    drv.label                   = "audio_driver";
    drv.s                       = settings->arrays.audio_driver;
 
@@ -29637,6 +29997,8 @@ static void audio_driver_flush(
          (audio_fastforward_mute && is_fastmotion)) ?
                0.0f : p_rarch->audio_driver_volume_gain;
 
+   FRAME_TRACE_BEGIN("audio_flush");
+
    src_data.data_out                 = NULL;
    src_data.output_frames            = 0;
 
@@ -29727,8 +30089,10 @@ static void audio_driver_flush(
     * trying to do anything. Just leave the ratio as-is,
     * and hope for the best... */
 
+   BENCHMARK_BEGIN(BENCHMARK_STAGE_AUDIO_RESAMPLE);
    p_rarch->audio_driver_resampler->process(
          p_rarch->audio_driver_resampler_data, &src_data);
+   BENCHMARK_END(BENCHMARK_STAGE_AUDIO_RESAMPLE);
 
 #ifdef HAVE_AUDIOMIXER
    if (p_rarch->audio_mixer_active)
@@ -29771,6 +30135,8 @@ static void audio_driver_flush(
                output_data, output_frames * 2) < 0)
          p_rarch->audio_driver_active = false;
    }
+
+   FRAME_TRACE_END("audio_flush");
 }
 
 /**
@@ -31641,6 +32007,12 @@ static bool video_driver_init_internal(bool *video_is_threaded)
       video_driver_init_filter(video_driver_pix_fmt);
 #endif
 
+   /* The new driver gets its frame info built from scratch */
+   p_rarch->video_driver_frame_info_dirty = true;
+   p_rarch->video_driver_stat_time        = 0;
+   p_rarch->video_driver_fps_text[0]      = '\0';
+   p_rarch->video_driver_mem_text[0]      = '\0';
+
    max_dim   = MAX(geom->max_width, geom->max_height);
    scale     = next_pow2(max_dim) / RARCH_SCALE_BASE;
    scale     = MAX(scale, 1);
@@ -31670,7 +32042,11 @@ static bool video_driver_init_internal(bool *video_is_threaded)
       /* Guard against aspect ratio index possibly being out of bounds */
       unsigned new_aspect_idx = settings->uints.video_aspect_ratio_idx;
       if (new_aspect_idx > ASPECT_RATIO_END)
-         new_aspect_idx = settings->uints.video_aspect_ratio_idx = 0;
+      {
+         new_aspect_idx = 0;
+         configuration_set_uint(settings,
+               settings->uints.video_aspect_ratio_idx, 0);
+      }
 
       video_driver_set_aspect_ratio_value(
             aspectratio_lut[new_aspect_idx].value);
@@ -32492,6 +32868,13 @@ static bool video_driver_find_driver(struct rarch_state *p_rarch)
    driver_ctx_info_t drv;
    settings_t          *settings           = p_rarch->configuration_settings;
 
+   /* Hardware rendered cores still need a real context */
+   if (benchmark_is_enabled() && !video_driver_is_hw_context())
+   {
+      p_rarch->current_video               = &video_null;
+      return true;
+   }
+
    if (video_driver_is_hw_context())
    {
       struct retro_hw_render_callback *hwr =
@@ -32845,9 +33228,10 @@ static void video_driver_frame(const void *data, unsigned width,
    static retro_time_t fps_time;
    static float last_fps, frame_time;
    static uint64_t last_used_memory, last_total_memory;
+   unsigned display_draw_calls, display_primitives;
    retro_time_t new_time;
-   video_frame_info_t video_info;
    struct rarch_state *p_rarch  = &rarch_st;
+   video_frame_info_t *video_info = &p_rarch->video_driver_frame_info;
    const enum retro_pixel_format
       video_driver_pix_fmt      = p_rarch->video_driver_pix_fmt;
    bool runloop_idle            = p_rarch->runloop_idle;
@@ -32876,17 +33260,25 @@ static void video_driver_frame(const void *data, unsigned width,
          && data
          && (video_driver_pix_fmt == RETRO_PIXEL_FORMAT_0RGB1555)
          && (data != RETRO_HW_FRAME_BUFFER_VALID)
-         && video_pixel_frame_scale(
-            p_rarch->video_driver_scaler_ptr->scaler,
-            p_rarch->video_driver_scaler_ptr->scaler_out,
-            data, width, height, pitch)
       )
    {
-      data                = p_rarch->video_driver_scaler_ptr->scaler_out;
-      pitch               = p_rarch->video_driver_scaler_ptr->scaler->out_stride;
+      bool scaled;
+
+      BENCHMARK_BEGIN(BENCHMARK_STAGE_PIXEL_CONVERSION);
+      scaled = video_pixel_frame_scale(
+            p_rarch->video_driver_scaler_ptr->scaler,
+            p_rarch->video_driver_scaler_ptr->scaler_out,
+            data, width, height, pitch);
+      BENCHMARK_END(BENCHMARK_STAGE_PIXEL_CONVERSION);
+
+      if (scaled)
+      {
+         data             = p_rarch->video_driver_scaler_ptr->scaler_out;
+         pitch            = p_rarch->video_driver_scaler_ptr->scaler->out_stride;
+      }
    }
 
-   video_driver_build_info(&video_info);
+   video_driver_update_info(p_rarch, settings, video_info);
 
    /* Get the amount of frames per seconds. */
    if (p_rarch->video_driver_frame_count)
@@ -32905,12 +33297,11 @@ static void video_driver_frame(const void *data, unsigned width,
          [write_index]                             = frame_time;
       fps_time                                     = new_time;
 
-      if (video_info.fps_show)
-         buf_pos = snprintf(
-               status_text, sizeof(status_text),
-               "FPS: %6.2f", last_fps);
+      if (video_info->fps_show)
+         buf_pos = strlcpy(status_text,
+               p_rarch->video_driver_fps_text, sizeof(status_text));
 
-      if (video_info.framecount_show)
+      if (video_info->framecount_show)
       {
          char frames_text[64];
          if (status_text[buf_pos-1] != '\0')
@@ -32922,29 +33313,35 @@ static void video_driver_frame(const void *data, unsigned width,
          buf_pos = strlcat(status_text, frames_text, sizeof(status_text));
       }
 
-      if (video_info.memory_show)
+      if (video_info->memory_show)
       {
-         char mem[128];
-
+         /* Only format the text again when memory was sampled */
          if ((p_rarch->video_driver_frame_count % memory_update_interval) == 0)
          {
             last_total_memory = frontend_driver_get_total_memory();
             last_used_memory  = last_total_memory - frontend_driver_get_free_memory();
+            p_rarch->video_driver_mem_text[0] = '\0';
          }
 
-         mem[0] = '\0';
-         snprintf(
-               mem, sizeof(mem), "MEM: %.2f/%.2fMB", last_used_memory / (1024.0f * 1024.0f),
-               last_total_memory / (1024.0f * 1024.0f));
+         if (!p_rarch->video_driver_mem_text[0])
+            snprintf(
+                  p_rarch->video_driver_mem_text,
+                  sizeof(p_rarch->video_driver_mem_text),
+                  "MEM: %.2f/%.2fMB", last_used_memory / (1024.0f * 1024.0f),
+                  last_total_memory / (1024.0f * 1024.0f));
          if (status_text[buf_pos-1] != '\0')
             strlcat(status_text, " || ", sizeof(status_text));
-         strlcat(status_text, mem, sizeof(status_text));
+         strlcat(status_text,
+               p_rarch->video_driver_mem_text, sizeof(status_text));
       }
 
       if ((p_rarch->video_driver_frame_count % fps_update_interval) == 0)
       {
          last_fps = TIME_TO_FPS(curr_time, new_time,
                fps_update_interval);
+         snprintf(p_rarch->video_driver_fps_text,
+               sizeof(p_rarch->video_driver_fps_text),
+               "FPS: %6.2f", last_fps);
 
          strlcpy(p_rarch->video_driver_window_title,
                p_rarch->video_driver_title_buf,
@@ -32965,12 +33362,16 @@ static void video_driver_frame(const void *data, unsigned width,
    else
    {
       curr_time = fps_time = new_time;
+      snprintf(p_rarch->video_driver_fps_text,
+            sizeof(p_rarch->video_driver_fps_text),
+            "FPS: %6.2f", last_fps);
+      p_rarch->video_driver_mem_text[0] = '\0';
 
       strlcpy(p_rarch->video_driver_window_title,
             p_rarch->video_driver_title_buf,
             sizeof(p_rarch->video_driver_window_title));
 
-      if (video_info.fps_show)
+      if (video_info->fps_show)
          strlcpy(status_text,
                msg_hash_to_str(MENU_ENUM_LABEL_VALUE_NOT_AVAILABLE),
                sizeof(status_text));
@@ -32979,7 +33380,7 @@ static void video_driver_frame(const void *data, unsigned width,
    }
 
    /* Add core status message to status text */
-   if (video_info.core_status_msg_show)
+   if (video_info->core_status_msg_show)
    {
       /* Note: We need to lock a mutex here. Strictly
        * speaking, runloop_core_status_msg is not part
@@ -33030,7 +33431,7 @@ static void video_driver_frame(const void *data, unsigned width,
 #ifdef HAVE_VIDEO_FILTER
              !p_rarch->video_driver_state_filter ||
 #endif
-             !video_info.post_filter_record
+             !video_info->post_filter_record
           || !data
           || p_rarch->video_driver_record_gpu_buffer
          ) && p_rarch->recording_data
@@ -33056,7 +33457,7 @@ static void video_driver_frame(const void *data, unsigned width,
             p_rarch->video_driver_state_buffer, output_pitch,
             data, width, height, pitch);
 
-      if (video_info.post_filter_record
+      if (video_info->post_filter_record
             && p_rarch->recording_data
             && p_rarch->recording_driver
             && p_rarch->recording_driver->push_video)
@@ -33113,9 +33514,9 @@ static void video_driver_frame(const void *data, unsigned width,
       }
       /* ...otherwise, just output message via
        * regular OSD notification text (if enabled) */
-      else if (video_info.font_enable)
+      else if (video_info->font_enable)
 #else
-      if (video_info.font_enable)
+      if (video_info->font_enable)
 #endif
       {
          const char *msg                 = NULL;
@@ -33128,7 +33529,18 @@ static void video_driver_frame(const void *data, unsigned width,
       }
    }
 
-   if (video_info.statistics_show)
+   gfx_display_get_draw_stats(&display_draw_calls, &display_primitives);
+   if (benchmark_is_enabled())
+      benchmark_display(display_draw_calls, display_primitives);
+
+   /* The statistics take one long snprintf to format, which is
+    * not worth doing on every frame at high refresh rates. The
+    * text is kept in the persistent frame info in between. */
+   if (!video_info->statistics_show)
+      p_rarch->video_driver_stat_time = 0;
+   else if (   !p_rarch->video_driver_stat_time
+            || new_time - p_rarch->video_driver_stat_time
+            >= VIDEO_STATISTICS_UPDATE_USEC)
    {
       audio_statistics_t audio_stats;
       double stddev                          = 0.0;
@@ -33138,6 +33550,8 @@ static void video_driver_frame(const void *data, unsigned width,
       unsigned blue                          = 255;
       unsigned alpha                         = 255;
 
+      p_rarch->video_driver_stat_time        = new_time;
+
       audio_stats.samples                    = 0;
       audio_stats.average_buffer_saturation  = 0.0f;
       audio_stats.std_deviation_percentage   = 0.0f;
@@ -33146,32 +33560,41 @@ static void video_driver_frame(const void *data, unsigned width,
 
       video_monitor_fps_statistics(NULL, &stddev, NULL);
 
-      video_info.osd_stat_params.x           = 0.010f;
-      video_info.osd_stat_params.y           = 0.950f;
-      video_info.osd_stat_params.scale       = 1.0f;
-      video_info.osd_stat_params.full_screen = true;
-      video_info.osd_stat_params.drop_x      = -2;
-      video_info.osd_stat_params.drop_y      = -2;
-      video_info.osd_stat_params.drop_mod    = 0.3f;
-      video_info.osd_stat_params.drop_alpha  = 1.0f;
-      video_info.osd_stat_params.color       = COLOR_ABGR(
+      video_info->osd_stat_params.x           = 0.010f;
+      video_info->osd_stat_params.y           = 0.950f;
+      video_info->osd_stat_params.scale       = 1.0f;
+      video_info->osd_stat_params.full_screen = true;
+      video_info->osd_stat_params.drop_x      = -2;
+      video_info->osd_stat_params.drop_y      = -2;
+      video_info->osd_stat_params.drop_mod    = 0.3f;
+      video_info->osd_stat_params.drop_alpha  = 1.0f;
+      video_info->osd_stat_params.color       = COLOR_ABGR(
             red, green, blue, alpha);
 
       audio_compute_buffer_statistics(p_rarch, &audio_stats);
 
-      snprintf(video_info.stat_text,
-            sizeof(video_info.stat_text),
+      snprintf(video_info->stat_text,
+            sizeof(video_info->stat_text),
             "Video Statistics:\n -Frame rate: %6.2f fps\n -Frame time: %6.2f ms\n -Frame time deviation: %.3f %%\n"
-            " -Frame count: %" PRIu64"\n -Viewport: %d x %d x %3.2f\n"
+            " -Frame count: %" PRIu64"\n -Viewport: %d x %d x %3.2f\n -Frame delay: %u ms%s\n"
+            " -Pacing error: %.3f ms avg, %.3f ms max\n"
+            " -Display draw calls: %u (%u primitives)\n"
             "Audio Statistics:\n -Average buffer saturation: %.2f %%\n -Standard deviation: %.2f %%\n -Time spent close to underrun: %.2f %%\n -Time spent close to blocking: %.2f %%\n -Sample count: %d\n"
             "Core Geometry:\n -Size: %u x %u\n -Max Size: %u x %u\n -Aspect: %3.2f\nCore Timing:\n -FPS: %3.2f\n -Sample Rate: %6.2f\n",
             last_fps,
             frame_time / 1000.0f,
             100.0 * stddev,
             p_rarch->video_driver_frame_count,
-            video_info.width,
-            video_info.height,
-            video_info.refresh_rate,
+            video_info->width,
+            video_info->height,
+            video_info->refresh_rate,
+            p_rarch->video_frame_delay_current,
+            settings->bools.video_frame_delay_auto ? " (auto)" : "",
+            p_rarch->frame_limit_stats.error_avg_usec / 1000.0f,
+            MAX(p_rarch->frame_limit_stats.error_max_usec,
+               p_rarch->frame_limit_stats.error_max_last_usec) / 1000.0f,
+            display_draw_calls,
+            display_primitives,
             audio_stats.average_buffer_saturation,
             audio_stats.std_deviation_percentage,
             audio_stats.close_to_underrun,
@@ -33189,18 +33612,25 @@ static void video_driver_frame(const void *data, unsigned width,
    }
 
    if (p_rarch->current_video && p_rarch->current_video->frame)
+   {
+      retro_time_t present_start   = cpu_features_get_time_usec();
+      FRAME_TRACE_BEGIN("video_frame");
       p_rarch->video_driver_active = p_rarch->current_video->frame(
             p_rarch->video_driver_data, data, width, height,
             p_rarch->video_driver_frame_count,
-            (unsigned)pitch, video_driver_msg, &video_info);
+            (unsigned)pitch, video_driver_msg, video_info);
+      FRAME_TRACE_END("video_frame");
+      p_rarch->frame_delay_auto.present_usec +=
+         cpu_features_get_time_usec() - present_start;
+   }
 
    p_rarch->video_driver_frame_count++;
 
    /* Display the status text, with a higher priority. */
-   if (     video_info.fps_show
-         || video_info.framecount_show
-         || video_info.memory_show
-         || video_info.core_status_msg_show
+   if (     video_info->fps_show
+         || video_info->framecount_show
+         || video_info->memory_show
+         || video_info->core_status_msg_show
          )
    {
 #if defined(HAVE_GFX_WIDGETS)
@@ -33217,17 +33647,17 @@ static void video_driver_frame(const void *data, unsigned width,
    }
 
    /* trigger set resolution*/
-   if (video_info.crt_switch_resolution)
+   if (video_info->crt_switch_resolution)
    {
       p_rarch->video_driver_crt_switching_active          = true;
 
-      switch (video_info.crt_switch_resolution_super)
+      switch (video_info->crt_switch_resolution_super)
       {
          case 2560:
          case 3840:
          case 1920:
             width                                         =
-               video_info.crt_switch_resolution_super;
+               video_info->crt_switch_resolution_super;
             p_rarch->video_driver_crt_dynamic_super_width = false;
             break;
          case 1:
@@ -33243,13 +33673,13 @@ static void video_driver_frame(const void *data, unsigned width,
             width,
             height,
             p_rarch->video_driver_core_hz,
-            video_info.crt_switch_resolution,
-            video_info.crt_switch_center_adjust,
-            video_info.crt_switch_porch_adjust,
-            video_info.monitor_index,
+            video_info->crt_switch_resolution,
+            video_info->crt_switch_center_adjust,
+            video_info->crt_switch_porch_adjust,
+            video_info->monitor_index,
             p_rarch->video_driver_crt_dynamic_super_width);
    }
-   else if (!video_info.crt_switch_resolution)
+   else if (!video_info->crt_switch_resolution)
       p_rarch->video_driver_crt_switching_active = false;
 }
 
@@ -33336,23 +33766,11 @@ bool video_driver_texture_unload(uintptr_t *id)
    return true;
 }
 
-void video_driver_build_info(video_frame_info_t *video_info)
+/* Fills in the part of the frame info that is taken from the
+ * settings. It only has to be redone when a setting changes. */
+static void video_driver_build_info_settings(
+      settings_t *settings, video_frame_info_t *video_info)
 {
-   video_viewport_t *custom_vp             = NULL;
-   struct rarch_state       *p_rarch       = &rarch_st;
-   settings_t *settings                    = p_rarch->configuration_settings;
-#ifdef HAVE_THREADS
-   bool is_threaded                        =
-      VIDEO_DRIVER_IS_THREADED_INTERNAL();
-
-   VIDEO_DRIVER_THREADED_LOCK(is_threaded);
-#endif
-   custom_vp                               = &settings->video_viewport_custom;
-#ifdef HAVE_GFX_WIDGETS
-   video_info->widgets_active              = p_rarch->widgets_active;
-#else
-   video_info->widgets_active              = false;
-#endif
    video_info->refresh_rate                = settings->floats.video_refresh_rate;
    video_info->crt_switch_resolution       = settings->uints.crt_switch_resolution;
    video_info->crt_switch_resolution_super = settings->uints.crt_switch_resolution_super;
@@ -33365,14 +33783,11 @@ void video_driver_build_info(video_frame_info_t *video_info)
    video_info->memory_show                 = settings->bools.video_memory_show;
    video_info->statistics_show             = settings->bools.video_statistics_show;
    video_info->framecount_show             = settings->bools.video_framecount_show;
-   video_info->core_status_msg_show        = runloop_core_status_msg.set;
    video_info->aspect_ratio_idx            = settings->uints.video_aspect_ratio_idx;
    video_info->post_filter_record          = settings->bools.video_post_filter_record;
    video_info->input_menu_swap_ok_cancel_buttons    = settings->bools.input_menu_swap_ok_cancel_buttons;
    video_info->max_swapchain_images        = settings->uints.video_max_swapchain_images;
    video_info->windowed_fullscreen         = settings->bools.video_windowed_fullscreen;
-   video_info->fullscreen                  = settings->bools.video_fullscreen
-      || p_rarch->rarch_force_fullscreen;
    video_info->menu_mouse_enable           = settings->bools.menu_mouse_enable;
    video_info->monitor_index               = settings->uints.video_monitor_index;
 
@@ -33382,34 +33797,11 @@ void video_driver_build_info(video_frame_info_t *video_info)
    video_info->font_msg_color_r            = settings->floats.video_msg_color_r;
    video_info->font_msg_color_g            = settings->floats.video_msg_color_g;
    video_info->font_msg_color_b            = settings->floats.video_msg_color_b;
-   video_info->custom_vp_x                 = custom_vp->x;
-   video_info->custom_vp_y                 = custom_vp->y;
-   video_info->custom_vp_width             = custom_vp->width;
-   video_info->custom_vp_height            = custom_vp->height;
-   video_info->custom_vp_full_width        = custom_vp->full_width;
-   video_info->custom_vp_full_height       = custom_vp->full_height;
-
-#if defined(HAVE_GFX_WIDGETS)
-   video_info->widgets_is_paused           = p_rarch->gfx_widgets_paused;
-   video_info->widgets_is_fast_forwarding  = p_rarch->gfx_widgets_fast_forward;
-   video_info->widgets_is_rewinding        = p_rarch->gfx_widgets_rewinding;
-#else
-   video_info->widgets_is_paused           = false;
-   video_info->widgets_is_fast_forwarding  = false;
-   video_info->widgets_is_rewinding        = false;
-#endif
-
-   video_info->width                       = p_rarch->video_driver_width;
-   video_info->height                      = p_rarch->video_driver_height;
-
-   video_info->use_rgba                    = p_rarch->video_driver_use_rgba;
 
-   video_info->libretro_running            = false;
    video_info->msg_bgcolor_enable          =
       settings->bools.video_msg_bgcolor_enable;
 
 #ifdef HAVE_MENU
-   video_info->menu_is_alive               = p_rarch->menu_driver_alive;
    video_info->menu_footer_opacity         = settings->floats.menu_footer_opacity;
    video_info->menu_header_opacity         = settings->floats.menu_header_opacity;
    video_info->materialui_color_theme      = settings->uints.menu_materialui_color_theme;
@@ -33427,10 +33819,7 @@ void video_driver_build_info(video_frame_info_t *video_info)
       settings->floats.menu_wallpaper_opacity;
    video_info->menu_framebuffer_opacity    =
       settings->floats.menu_framebuffer_opacity;
-
-   video_info->libretro_running            = p_rarch->current_core.game_loaded;
 #else
-   video_info->menu_is_alive               = false;
    video_info->menu_footer_opacity         = 0.0f;
    video_info->menu_header_opacity         = 0.0f;
    video_info->materialui_color_theme      = 0;
@@ -33444,13 +33833,99 @@ void video_driver_build_info(video_frame_info_t *video_info)
    video_info->menu_framebuffer_opacity    = 0.0f;
    video_info->menu_wallpaper_opacity      = 0.0f;
 #endif
+}
+
+/* Fills in the part of the frame info that follows the runloop
+ * and driver state, which has to be refreshed every frame */
+static void video_driver_build_info_state(
+      struct rarch_state *p_rarch, settings_t *settings,
+      video_frame_info_t *video_info)
+{
+   /* The custom viewport is edited in place by the menu */
+   video_viewport_t *custom_vp             = &settings->video_viewport_custom;
+#ifdef HAVE_GFX_WIDGETS
+   video_info->widgets_active              = p_rarch->widgets_active;
+#else
+   video_info->widgets_active              = false;
+#endif
+   video_info->core_status_msg_show        = runloop_core_status_msg.set;
+   video_info->fullscreen                  = settings->bools.video_fullscreen
+      || p_rarch->rarch_force_fullscreen;
+
+   video_info->custom_vp_x                 = custom_vp->x;
+   video_info->custom_vp_y                 = custom_vp->y;
+   video_info->custom_vp_width             = custom_vp->width;
+   video_info->custom_vp_height            = custom_vp->height;
+   video_info->custom_vp_full_width        = custom_vp->full_width;
+   video_info->custom_vp_full_height       = custom_vp->full_height;
+
+#if defined(HAVE_GFX_WIDGETS)
+   video_info->widgets_is_paused           = p_rarch->gfx_widgets_paused;
+   video_info->widgets_is_fast_forwarding  = p_rarch->gfx_widgets_fast_forward;
+   video_info->widgets_is_rewinding        = p_rarch->gfx_widgets_rewinding;
+#else
+   video_info->widgets_is_paused           = false;
+   video_info->widgets_is_fast_forwarding  = false;
+   video_info->widgets_is_rewinding        = false;
+#endif
+
+   video_info->width                       = p_rarch->video_driver_width;
+   video_info->height                      = p_rarch->video_driver_height;
+
+   video_info->use_rgba                    = p_rarch->video_driver_use_rgba;
+
+#ifdef HAVE_MENU
+   video_info->menu_is_alive               = p_rarch->menu_driver_alive;
+   video_info->libretro_running            = p_rarch->current_core.game_loaded;
+#else
+   video_info->menu_is_alive               = false;
+   video_info->libretro_running            = false;
+#endif
 
    video_info->runloop_is_paused           = p_rarch->runloop_paused;
    video_info->runloop_is_slowmotion       = p_rarch->runloop_slowmotion;
 
    video_info->input_driver_nonblock_state = p_rarch->input_driver_nonblock_state;
    video_info->userdata                    = VIDEO_DRIVER_GET_PTR_INTERNAL(false);
+}
+
+void video_driver_build_info(video_frame_info_t *video_info)
+{
+   struct rarch_state       *p_rarch       = &rarch_st;
+   settings_t *settings                    = p_rarch->configuration_settings;
+#ifdef HAVE_THREADS
+   bool is_threaded                        =
+      VIDEO_DRIVER_IS_THREADED_INTERNAL();
 
+   VIDEO_DRIVER_THREADED_LOCK(is_threaded);
+#endif
+   video_driver_build_info_settings(settings, video_info);
+   video_driver_build_info_state(p_rarch, settings, video_info);
+#ifdef HAVE_THREADS
+   VIDEO_DRIVER_THREADED_UNLOCK(is_threaded);
+#endif
+}
+
+/* Brings the persistent frame info up to date. Every settings
+ * write raises settings->modified, which doubles as the change
+ * notification here, so the settings are only copied again after
+ * one of them changed. */
+static void video_driver_update_info(struct rarch_state *p_rarch,
+      settings_t *settings, video_frame_info_t *video_info)
+{
+#ifdef HAVE_THREADS
+   bool is_threaded                        =
+      VIDEO_DRIVER_IS_THREADED_INTERNAL();
+
+   VIDEO_DRIVER_THREADED_LOCK(is_threaded);
+#endif
+   if (settings->modified || p_rarch->video_driver_frame_info_dirty)
+   {
+      video_driver_build_info_settings(settings, video_info);
+      settings->modified                     = false;
+      p_rarch->video_driver_frame_info_dirty = false;
+   }
+   video_driver_build_info_state(p_rarch, settings, video_info);
 #ifdef HAVE_THREADS
    VIDEO_DRIVER_THREADED_UNLOCK(is_threaded);
 #endif
@@ -34902,6 +35377,7 @@ static void retroarch_deinit_drivers(struct rarch_state *p_rarch)
    p_rarch->video_driver_record_gpu_buffer          = NULL;
    p_rarch->current_video                           = NULL;
    video_driver_set_cached_frame_ptr(NULL);
+   memset(&p_rarch->frame_delay_auto, 0, sizeof(frame_delay_auto_t));
 
    /* Audio */
    p_rarch->audio_driver_active                     = false;
@@ -35984,10 +36460,27 @@ static void retroarch_print_help(const char *arg0)
 #endif
       strlcat(buf, "      --load-menu-on-error\n"
             "                        Open menu instead of quitting if specified core or content fails to load.\n", sizeof(buf));
+      strlcat(buf, "      --trace=FILE      Records a timeline of the most recent frames and "
+            "writes it to FILE on exit, as Chrome trace JSON.\n", sizeof(buf));
+      strlcat(buf, "      --benchmark=FILE  Runs content without video, audio output or "
+            "frame limiting, and writes timings to FILE on exit, as JSON.\n"
+            "                        Combine with --bsvplay and --eof-exit or --max-frames.\n"
+            "                        With --menu, times the menu instead and counts its draw calls.\n", sizeof(buf));
       puts(buf);
    }
 }
 
+static void retroarch_task_trace(retro_task_t *task, bool begin)
+{
+   if (begin)
+   {
+      frame_trace_set_thread_name("tasks");
+      frame_trace_begin("task");
+   }
+   else
+      frame_trace_end("task");
+}
+
 /**
  * retroarch_parse_input_and_config:
  * @argc                 : Count of (commandline) arguments.
@@ -36064,6 +36557,8 @@ static void retroarch_parse_input_and_config(
       { "log-file",           1, NULL, RA_OPT_LOG_FILE },
       { "accessibility",      0, NULL, RA_OPT_ACCESSIBILITY},
       { "load-menu-on-error", 0, NULL, RA_OPT_LOAD_MENU_ON_ERROR },
+      { "trace",              1, NULL, RA_OPT_TRACE },
+      { "benchmark",          1, NULL, RA_OPT_BENCHMARK },
       { NULL, 0, NULL, 0 }
    };
 
@@ -36578,6 +37073,17 @@ static void retroarch_parse_input_and_config(
                path_set(RARCH_PATH_SUBSYSTEM, optarg);
                break;
 
+            case RA_OPT_BENCHMARK:
+               benchmark_init(optarg);
+               break;
+
+            case RA_OPT_TRACE:
+               strlcpy(p_rarch->frame_trace_path, optarg,
+                     sizeof(p_rarch->frame_trace_path));
+               if (frame_trace_init())
+                  task_queue_set_trace_cb(retroarch_task_trace);
+               break;
+
             case RA_OPT_FEATURES:
                retroarch_print_features();
                exit(0);
@@ -39192,7 +39698,9 @@ static enum runloop_state runloop_check_state(
 
    if (p_rarch->menu_driver_alive)
    {
-      if (!settings->bools.menu_throttle_framerate && !fastforward_ratio)
+      /* Benchmarks run as fast as possible */
+      if (     benchmark_is_enabled()
+            || (!settings->bools.menu_throttle_framerate && !fastforward_ratio))
          return RUNLOOP_STATE_MENU_ITERATE;
 
       return RUNLOOP_STATE_END;
@@ -39426,11 +39934,15 @@ static enum runloop_state runloop_check_state(
 
       s[0]           = '\0';
 
+      FRAME_TRACE_BEGIN("rewind");
+      BENCHMARK_BEGIN(BENCHMARK_STAGE_REWIND);
       rewinding      = state_manager_check_rewind(
             BIT256_GET(current_bits, RARCH_REWIND),
             settings->uints.rewind_granularity,
             p_rarch->runloop_paused,
             s, sizeof(s), &t);
+      BENCHMARK_END(BENCHMARK_STAGE_REWIND);
+      FRAME_TRACE_END("rewind");
 
 #if defined(HAVE_GFX_WIDGETS)
       if (widgets_active)
@@ -39583,6 +40095,154 @@ static enum runloop_state runloop_check_state(
    return RUNLOOP_STATE_ITERATE;
 }
 
+static retro_time_t frame_delay_auto_percentile(
+      const frame_delay_auto_t *fda)
+{
+   unsigned i, j;
+   retro_time_t sorted[FRAME_DELAY_AUTO_SAMPLES];
+
+   for (i = 0; i < fda->count; i++)
+   {
+      retro_time_t sample = fda->samples[i];
+      for (j = i; j > 0 && sorted[j - 1] > sample; j--)
+         sorted[j] = sorted[j - 1];
+      sorted[j] = sample;
+   }
+
+   return sorted[(fda->count - 1) * FRAME_DELAY_AUTO_PERCENTILE / 100];
+}
+
+/**
+ * frame_delay_auto_update:
+ * @busy                 : time the core took this frame, not counting
+ *                         time spent presenting
+ * @frame_start          : when this frame's iteration began
+ * @max_delay            : upper limit for the delay, in ms
+ *
+ * Feed one frame's measurements to the automatic frame delay. The delay
+ * is raised by at most 1 ms at a time while the chosen percentile of
+ * recent frames leaves room for it, and cut straight away, followed by a
+ * hold-off, when a frame overruns.
+ **/
+static void frame_delay_auto_update(struct rarch_state *p_rarch,
+      retro_time_t busy, retro_time_t frame_start, unsigned max_delay)
+{
+   frame_delay_auto_t *fda = &p_rarch->frame_delay_auto;
+   double fps              = p_rarch->video_driver_av_info.timing.fps;
+   retro_time_t period, margin, interval;
+
+   if (fps <= 0.0)
+      return;
+
+   period   = (retro_time_t)(1000000.0 / fps);
+   margin   = MAX(FRAME_DELAY_AUTO_MARGIN_USEC, period / 8);
+   interval = fda->last_frame_time ? frame_start - fda->last_frame_time : 0;
+   fda->last_frame_time = frame_start;
+
+   fda->samples[fda->index] = busy;
+   fda->index               = (fda->index + 1) % FRAME_DELAY_AUTO_SAMPLES;
+   if (fda->count < FRAME_DELAY_AUTO_SAMPLES)
+      fda->count++;
+
+   /* An overrun is a frame whose delay and run time didn't fit, or one
+    * that came noticeably late (but not so late it was a pause) */
+   if (fda->delay &&
+         (  (fda->delay * 1000 + busy > period - margin / 2)
+         || (interval > period * 3 / 2 && interval < period * 4)))
+   {
+      retro_time_t slack = period - margin - busy;
+      unsigned delay     = slack > 0 ? (unsigned)(slack / 1000) : 0;
+
+      fda->delay  = (delay < fda->delay) ? delay : fda->delay / 2;
+      fda->hold   = FRAME_DELAY_AUTO_HOLD;
+      fda->frames = 0;
+      return;
+   }
+
+   if (fda->hold)
+   {
+      fda->hold--;
+      return;
+   }
+
+   if (     fda->count >= FRAME_DELAY_AUTO_SAMPLES / 4
+         && ++fda->frames >= FRAME_DELAY_AUTO_INTERVAL)
+   {
+      retro_time_t slack = period - margin - frame_delay_auto_percentile(fda);
+      unsigned target    = slack > 0 ? (unsigned)(slack / 1000) : 0;
+
+      if (target > max_delay)
+         target = max_delay;
+
+      if (target > fda->delay)
+         fda->delay++;
+      else
+         fda->delay = target;
+      fda->frames = 0;
+   }
+}
+
+/**
+ * frame_limit_wait:
+ * @deadline             : time to wait for, as cpu_features_get_time_usec
+ *
+ * Wait for an absolute deadline. The bulk of the wait is slept, on an
+ * absolute deadline where the platform allows, so that nothing is lost to
+ * rounding; the last stretch, as long as sleeps have recently been
+ * overshooting by, is spun through.
+ **/
+static void frame_limit_wait(struct rarch_state *p_rarch,
+      retro_time_t deadline)
+{
+   frame_limit_stats_t *stats = &p_rarch->frame_limit_stats;
+   retro_time_t spin          = stats->oversleep_usec * 2;
+   retro_time_t now           = cpu_features_get_time_usec();
+   retro_time_t wake;
+
+   if (spin < FRAME_LIMIT_SPIN_MIN_USEC)
+      spin = FRAME_LIMIT_SPIN_MIN_USEC;
+   else if (spin > FRAME_LIMIT_SPIN_MAX_USEC)
+      spin = FRAME_LIMIT_SPIN_MAX_USEC;
+
+   wake = deadline - spin;
+   if (wake > now)
+   {
+      retro_time_t woke;
+#if defined(__linux__) && defined(CLOCK_MONOTONIC) && defined(TIMER_ABSTIME)
+      struct timespec ts;
+      ts.tv_sec  = (time_t)(wake / 1000000);
+      ts.tv_nsec = (long)(wake % 1000000) * 1000;
+      while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL)
+            == EINTR);
+#else
+      /* Relative sleeps only come in whole milliseconds */
+      unsigned sleep_ms = (unsigned)((wake - now) / 1000);
+      wake              = now + sleep_ms * 1000;
+      if (sleep_ms > 0)
+         retro_sleep(sleep_ms);
+#endif
+      woke = cpu_features_get_time_usec();
+      if (woke >= wake)
+         stats->oversleep_usec += ((woke - wake) - stats->oversleep_usec) / 8;
+   }
+
+   do
+   {
+      now = cpu_features_get_time_usec();
+   } while (now < deadline);
+
+   /* Pacing statistics */
+   stats->error_avg_usec += ((now - deadline) - stats->error_avg_usec) / 16;
+   if (now - deadline > stats->error_max_usec)
+      stats->error_max_usec = now - deadline;
+   if (++stats->frames >= FRAME_LIMIT_STATS_FRAMES)
+   {
+      stats->error_max_last_usec = stats->error_max_usec;
+      stats->error_max_usec      = 0;
+      stats->frames              = 0;
+   }
+}
+
 /**
  * runloop_iterate:
  *
@@ -39599,13 +40259,20 @@ int runloop_iterate(void)
    settings_t *settings                         = p_rarch->configuration_settings;
    float fastforward_ratio                      = settings->floats.fastforward_ratio;
    unsigned video_frame_delay                   = settings->uints.video_frame_delay;
+   bool video_frame_delay_auto                  = settings->bools.video_frame_delay_auto;
    bool vrr_runloop_enable                      = settings->bools.vrr_runloop_enable;
+   retro_time_t core_start                      = 0;
    unsigned max_users                           = p_rarch->input_driver_max_users;
    retro_time_t current_time                    = cpu_features_get_time_usec();
 
 #ifdef HAVE_DISCORD
    discord_state_t *discord_st                  = &p_rarch->discord_st;
+#endif
 
+   if (frame_trace_is_enabled())
+      frame_trace_instant("frame");
+
+#ifdef HAVE_DISCORD
    if (discord_is_inited)
       Discord_RunCallbacks();
 #endif
@@ -39671,6 +40338,8 @@ int runloop_iterate(void)
          /* FIXME: This is an ugly way to tell Netplay this... */
          netplay_driver_ctl(RARCH_NETPLAY_CTL_PAUSE, NULL);
 #endif
+         if (benchmark_is_enabled())
+            benchmark_frame();
          return 0;
       case RUNLOOP_STATE_ITERATE:
          p_rarch->runloop_core_running = true;
@@ -39746,8 +40415,29 @@ int runloop_iterate(void)
       }
    }
 
-   if ((video_frame_delay > 0) && !p_rarch->input_driver_nonblock_state)
-      retro_sleep(video_frame_delay);
+   if (video_frame_delay_auto)
+   {
+      /* Never past the configured delay, if there is one */
+      unsigned max_delay = video_frame_delay
+         ? video_frame_delay : FRAME_DELAY_AUTO_MAX;
+      video_frame_delay  = MIN(p_rarch->frame_delay_auto.delay, max_delay);
+   }
+
+   if (p_rarch->input_driver_nonblock_state || benchmark_is_enabled())
+      p_rarch->video_frame_delay_current = 0;
+   else
+   {
+      p_rarch->video_frame_delay_current = video_frame_delay;
+      if (video_frame_delay > 0)
+      {
+         FRAME_TRACE_BEGIN("frame_delay");
+         retro_sleep(video_frame_delay);
+         FRAME_TRACE_END("frame_delay");
+      }
+   }
+
+   core_start                               = cpu_features_get_time_usec();
+   p_rarch->frame_delay_auto.present_usec   = 0;
 
    {
 #ifdef HAVE_RUNAHEAD
@@ -39759,20 +40449,42 @@ int runloop_iterate(void)
 #endif
 
       if (want_runahead)
+      {
+         FRAME_TRACE_BEGIN("runahead");
+         BENCHMARK_BEGIN(BENCHMARK_STAGE_RUNAHEAD);
          do_runahead(
                p_rarch,
                run_ahead_num_frames,
                settings->bools.run_ahead_secondary_instance);
+         BENCHMARK_END(BENCHMARK_STAGE_RUNAHEAD);
+         FRAME_TRACE_END("runahead");
+      }
       else
 #endif
          core_run();
    }
 
+   if (video_frame_delay_auto)
+   {
+      if (p_rarch->input_driver_nonblock_state)
+         p_rarch->frame_delay_auto.last_frame_time = 0;
+      else
+         frame_delay_auto_update(p_rarch,
+               cpu_features_get_time_usec() - core_start
+               - p_rarch->frame_delay_auto.present_usec,
+               current_time,
+               settings->uints.video_frame_delay
+               ? settings->uints.video_frame_delay : FRAME_DELAY_AUTO_MAX);
+   }
+
    /* Increment runtime tick counter after each call to
     * core_run() or run_ahead() */
    p_rarch->libretro_core_runtime_usec += rarch_core_runtime_tick(
          p_rarch, current_time);
 
+   if (benchmark_is_enabled())
+      benchmark_frame();
+
 #ifdef HAVE_CHEEVOS
    if (settings->bools.cheevos_enable)
       rcheevos_test();
@@ -39827,6 +40539,10 @@ int runloop_iterate(void)
    if (!(fastforward_ratio || vrr_runloop_enable))
       return 0;
 
+   /* Benchmarks run as fast as possible */
+   if (benchmark_is_enabled())
+      return 0;
+
 end:
    if (vrr_runloop_enable)
    {
@@ -39875,22 +40591,20 @@ end:
    }
 
    {
-      retro_time_t to_sleep_ms  = (
-            (p_rarch->frame_limit_last_time + p_rarch->frame_limit_minimum_time)
-            - cpu_features_get_time_usec()) / 1000;
+      retro_time_t deadline = p_rarch->frame_limit_last_time
+         + p_rarch->frame_limit_minimum_time;
 
-      if (to_sleep_ms > 0)
+      if (deadline > cpu_features_get_time_usec())
       {
-         unsigned               sleep_ms = (unsigned)to_sleep_ms;
-
-         /* Combat jitter a bit. */
-         p_rarch->frame_limit_last_time += p_rarch->frame_limit_minimum_time;
+         /* Chain deadlines, so that nothing accumulates as drift */
+         p_rarch->frame_limit_last_time = deadline;
 
-         if (sleep_ms > 0)
+         FRAME_TRACE_BEGIN("frame_limit");
 #if defined(HAVE_COCOATOUCH)
-            if (!p_rarch->main_ui_companion_is_on_foreground)
+         if (!p_rarch->main_ui_companion_is_on_foreground)
 #endif
-               retro_sleep(sleep_ms);
+            frame_limit_wait(p_rarch, deadline);
+         FRAME_TRACE_END("frame_limit");
          return 1;
       }
    }
@@ -40400,7 +41114,11 @@ bool core_run(void)
    else if (late_polling)
       current_core->input_polled = false;
 
+   FRAME_TRACE_BEGIN("retro_run");
+   BENCHMARK_BEGIN(BENCHMARK_STAGE_CORE_RUN);
    current_core->retro_run();
+   BENCHMARK_END(BENCHMARK_STAGE_CORE_RUN);
+   FRAME_TRACE_END("retro_run");
 
    if (late_polling && !current_core->input_polled)
       input_driver_poll();
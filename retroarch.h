@@ -1168,7 +1168,7 @@ typedef struct video_frame_info
       bool full_screen;
    } osd_stat_params;
 
-   char stat_text[512];
+   char stat_text[1024];
 
    bool widgets_active;
    bool menu_mouse_enable;
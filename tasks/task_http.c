@@ -275,6 +275,11 @@ static void* task_push_http_transfer_generic(
    if (!conn)
       return NULL;
 
+   /* HTTP tasks are only ever iterated by the task
+    * queue, one at a time, so they can safely share
+    * pooled keep-alive connections */
+   net_http_connection_set_keep_alive(conn, true);
+
    http                    = (http_handle_t*)malloc(sizeof(*http));
 
    if (!http)
@@ -41,6 +41,12 @@
 #endif
 #endif
 
+/* Maximum number of thumbnail downloads a single
+ * task keeps in flight. The http tasks are iterated
+ * side by side by the task queue and share pooled
+ * keep-alive connections to the thumbnail server */
+#define PL_THUMB_MAX_TRANSFERS 4
+
 enum pl_thumb_status
 {
    PL_THUMB_BEGIN = 0,
@@ -49,6 +55,12 @@ enum pl_thumb_status
    PL_THUMB_END
 };
 
+typedef struct pl_thumb_transfer
+{
+   retro_task_t *http_task;
+   bool complete;
+} pl_thumb_transfer_t;
+
 typedef struct pl_thumb_handle
 {
    char *system;
@@ -56,7 +68,7 @@ typedef struct pl_thumb_handle
    char *dir_thumbnails;
    playlist_t *playlist;
    gfx_thumbnail_path_data_t *thumbnail_path_data;
-   retro_task_t *http_task;
+   pl_thumb_transfer_t transfers[PL_THUMB_MAX_TRANSFERS];
 
    playlist_config_t playlist_config; /* size_t alignment */
 
@@ -69,7 +81,6 @@ typedef struct pl_thumb_handle
    bool overwrite;
    bool right_thumbnail_exists;
    bool left_thumbnail_exists;
-   bool http_task_complete;
 } pl_thumb_handle_t;
 
 typedef struct pl_entry_id
@@ -176,10 +187,10 @@ void cb_http_task_download_pl_thumbnail(
       void *user_data, const char *err)
 {
    char output_dir[PATH_MAX_LENGTH];
-   http_transfer_data_t *data  = (http_transfer_data_t*)task_data;
-   file_transfer_t *transf     = (file_transfer_t*)user_data;
-   pl_thumb_handle_t *pl_thumb = NULL;
-   output_dir[0]               = '\0';
+   http_transfer_data_t *data    = (http_transfer_data_t*)task_data;
+   file_transfer_t *transf       = (file_transfer_t*)user_data;
+   pl_thumb_transfer_t *transfer = NULL;
+   output_dir[0]                 = '\0';
 
    /* Update pl_thumb task status
     * > Do this first, to minimise the risk of hanging
@@ -187,12 +198,12 @@ void cb_http_task_download_pl_thumbnail(
    if (!transf)
       goto finish;
 
-   pl_thumb = (pl_thumb_handle_t*)transf->user_data;
+   transfer = (pl_thumb_transfer_t*)transf->user_data;
 
-   if (!pl_thumb)
+   if (!transfer)
       goto finish;
 
-   pl_thumb->http_task_complete = true;
+   transfer->complete = true;
 
    /* Remaining sanity checks... */
    if (!data)
@@ -238,9 +249,46 @@ finish:
       free(transf);
 }
 
+/* Returns a transfer slot that is not currently
+ * in use, or NULL if all downloads are in flight */
+static pl_thumb_transfer_t *get_free_transfer(pl_thumb_handle_t *pl_thumb)
+{
+   size_t i;
+
+   for (i = 0; i < PL_THUMB_MAX_TRANSFERS; i++)
+   {
+      pl_thumb_transfer_t *transfer = &pl_thumb->transfers[i];
+
+      /* > If HTTP task is NULL, then it either finished
+       *   or an error occurred - in either case,
+       *   the slot is free */
+      if (!transfer->http_task || transfer->complete)
+      {
+         transfer->http_task = NULL;
+         transfer->complete  = true;
+         return transfer;
+      }
+   }
+
+   return NULL;
+}
+
+static bool transfers_pending(pl_thumb_handle_t *pl_thumb)
+{
+   size_t i;
+
+   for (i = 0; i < PL_THUMB_MAX_TRANSFERS; i++)
+      if (pl_thumb->transfers[i].http_task &&
+            !pl_thumb->transfers[i].complete)
+         return true;
+
+   return false;
+}
+
 /* Download thumbnail of the current type for the current
  * playlist entry */
-static void download_pl_thumbnail(pl_thumb_handle_t *pl_thumb)
+static void download_pl_thumbnail(pl_thumb_handle_t *pl_thumb,
+      pl_thumb_transfer_t *transfer)
 {
    char path[PATH_MAX_LENGTH];
    char url[2048];
@@ -263,24 +311,24 @@ static void download_pl_thumbnail(pl_thumb_handle_t *pl_thumb)
             return; /* If this happens then everything is broken anyway... */
 
          /* Initialise http task status */
-         pl_thumb->http_task_complete = false;
+         transfer->complete           = false;
 
          transf->enum_idx             = MSG_UNKNOWN;
          transf->path[0]              = '\0';
          /* Initialise file transfer */
-         transf->user_data            = (void*)pl_thumb;
+         transf->user_data            = (void*)transfer;
          strlcpy(transf->path, path, sizeof(transf->path));
 
          /* Note: We don't actually care if this fails since that
           * just means the file is missing from the server, so it's
           * not something we can handle here... */
-         pl_thumb->http_task = (retro_task_t*)task_push_http_transfer_file(
+         transfer->http_task = (retro_task_t*)task_push_http_transfer_file(
                url, true, NULL, cb_http_task_download_pl_thumbnail, transf);
 
          /* ...if it does fail, however, we can immediately
           * signal that the task is 'complete' */
-         if (!pl_thumb->http_task)
-            pl_thumb->http_task_complete = true;
+         if (!transfer->http_task)
+            transfer->complete = true;
       }
    }
 }
@@ -341,7 +389,12 @@ static void task_pl_thumbnail_download_handler(retro_task_t *task)
       goto task_finished;
    
    if (task_get_cancelled(task))
+   {
+      /* Outstanding downloads still reference this handle */
+      if (transfers_pending(pl_thumb))
+         return;
       goto task_finished;
+   }
    
    switch (pl_thumb->status)
    {
@@ -403,42 +456,39 @@ static void task_pl_thumbnail_download_handler(retro_task_t *task)
          }
          break;
       case PL_THUMB_ITERATE_TYPE:
-         /* Ensure that we only enqueue one transfer
-          * at a time... */
-
-         /* > If HTTP task is NULL, then it either finished
-          *   or an error occurred - in either case,
-          *   current task is 'complete' */
-         if (!pl_thumb->http_task)
-            pl_thumb->http_task_complete = true;
-
-         /* > Wait for task_push_http_transfer_file()
-          *   callback to trigger */
-         if (!pl_thumb->http_task_complete)
-            break;
+         {
+            pl_thumb_transfer_t *transfer = NULL;
 
-         pl_thumb->http_task = NULL;
+            /* Check whether all thumbnail types have been processed */
+            if (pl_thumb->type_idx > 3)
+            {
+               /* Time to move on to the next entry */
+               pl_thumb->list_index++;
+               if (pl_thumb->list_index < pl_thumb->list_size)
+                  pl_thumb->status = PL_THUMB_ITERATE_ENTRY;
+               else
+                  pl_thumb->status = PL_THUMB_END;
+               break;
+            }
 
-         /* Check whether all thumbnail types have been processed */
-         if (pl_thumb->type_idx > 3)
-         {
-            /* Time to move on to the next entry */
-            pl_thumb->list_index++;
-            if (pl_thumb->list_index < pl_thumb->list_size)
-               pl_thumb->status = PL_THUMB_ITERATE_ENTRY;
-            else
-               pl_thumb->status = PL_THUMB_END;
-            break;
-         }
+            /* > Wait for a task_push_http_transfer_file()
+             *   callback to free up a transfer slot */
+            if (!(transfer = get_free_transfer(pl_thumb)))
+               break;
 
-         /* Download current thumbnail */
-         download_pl_thumbnail(pl_thumb);
+            /* Download current thumbnail */
+            download_pl_thumbnail(pl_thumb, transfer);
 
-         /* Increment thumbnail type */
-         pl_thumb->type_idx++;
+            /* Increment thumbnail type */
+            pl_thumb->type_idx++;
+         }
          break;
       case PL_THUMB_END:
       default:
+         /* Wait for outstanding downloads, their
+          * callbacks reference this handle */
+         if (transfers_pending(pl_thumb))
+            break;
          task_set_progress(task, 100);
          goto task_finished;
    }
@@ -523,8 +573,6 @@ bool task_push_pl_thumbnail_download(
    pl_thumb->dir_thumbnails      = strdup(dir_thumbnails);
    pl_thumb->playlist            = NULL;
    pl_thumb->thumbnail_path_data = NULL;
-   pl_thumb->http_task           = NULL;
-   pl_thumb->http_task_complete  = false;
    pl_thumb->list_size           = 0;
    pl_thumb->list_index          = 0;
    pl_thumb->type_idx            = 1;
@@ -668,7 +716,12 @@ static void task_pl_entry_thumbnail_download_handler(retro_task_t *task)
       goto task_finished;
    
    if (task_get_cancelled(task))
+   {
+      /* Outstanding downloads still reference this handle */
+      if (transfers_pending(pl_thumb))
+         return;
       goto task_finished;
+   }
    
    switch (pl_thumb->status)
    {
@@ -704,22 +757,8 @@ static void task_pl_entry_thumbnail_download_handler(retro_task_t *task)
          break;
       case PL_THUMB_ITERATE_TYPE:
          {
-            /* Ensure that we only enqueue one transfer
-             * at a time... */
-            
-            /* > If HTTP task is NULL, then it either finished
-             *   or an error occurred - in either case,
-             *   current task is 'complete' */
-            if (!pl_thumb->http_task)
-               pl_thumb->http_task_complete = true;
-            
-            /* > Wait for task_push_http_transfer_file()
-             *   callback to trigger */
-            if (pl_thumb->http_task_complete)
-               pl_thumb->http_task = NULL;
-            else
-               break;
-            
+            pl_thumb_transfer_t *transfer = NULL;
+
             /* Check whether all thumbnail types have been processed */
             if (pl_thumb->type_idx > 3)
             {
@@ -727,11 +766,16 @@ static void task_pl_entry_thumbnail_download_handler(retro_task_t *task)
                break;
             }
             
+            /* > Wait for a task_push_http_transfer_file()
+             *   callback to free up a transfer slot */
+            if (!(transfer = get_free_transfer(pl_thumb)))
+               break;
+
             /* Update progress */
             task_set_progress(task, ((pl_thumb->type_idx - 1) * 100) / 3);
             
             /* Download current thumbnail */
-            download_pl_thumbnail(pl_thumb);
+            download_pl_thumbnail(pl_thumb, transfer);
             
             /* Increment thumbnail type */
             pl_thumb->type_idx++;
@@ -739,6 +783,10 @@ static void task_pl_entry_thumbnail_download_handler(retro_task_t *task)
          break;
       case PL_THUMB_END:
       default:
+         /* Wait for outstanding downloads - the menu is
+          * refreshed once all thumbnails are on disk */
+         if (transfers_pending(pl_thumb))
+            break;
          task_set_progress(task, 100);
          goto task_finished;
    }
@@ -853,8 +901,6 @@ bool task_push_pl_entry_thumbnail_download(
    pl_thumb->dir_thumbnails      = strdup(dir_thumbnails);
    pl_thumb->playlist            = NULL;
    pl_thumb->thumbnail_path_data = thumbnail_path_data;
-   pl_thumb->http_task           = NULL;
-   pl_thumb->http_task_complete  = false;
    pl_thumb->list_size           = playlist_size(playlist);
    pl_thumb->list_index          = idx;
    pl_thumb->type_idx            = 1;
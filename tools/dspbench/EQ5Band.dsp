@@ -0,0 +1,7 @@
+filters = 1
+filter0 = eq
+
+# A five band curve with boosts and cuts over the whole range,
+# used by 'make check' to compare eq.so against eq_direct.so.
+eq_frequencies = "60 250 1000 4000 12000"
+eq_gains = "6 -4 3 -6 8"
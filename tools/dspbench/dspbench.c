@@ -0,0 +1,342 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2020 - The RetroArch team
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Runs audio DSP presets (.dsp) through the same filter chain code as
+ * RetroArch, over a fixed stereo test signal, and reports how long each
+ * one takes.
+ *
+ * With -c, each preset is also run with a reference plugin taking the
+ * place of the plugin that has the same ident, and the two outputs are
+ * compared. Buffering does not move samples within the output stream,
+ * but a reference with a different filter delay would, so the outputs
+ * are aligned first. */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <boolean.h>
+#include <audio/dsp_filter.h>
+#include <features/features_cpu.h>
+#include <file/file_path.h>
+#include <lists/dir_list.h>
+#include <lists/string_list.h>
+
+#define SAMPLE_RATE    48000.0f
+#define CHUNK_FRAMES   512
+#define BENCH_RUNS     3
+#define MAX_LAG        8192
+#define LAG_WINDOW     4096
+#define DEFAULT_TOL    1e-5
+
+static uint32_t rand_state = 2463534242u;
+
+static float rand_float(void)
+{
+   rand_state ^= rand_state << 13;
+   rand_state ^= rand_state >> 17;
+   rand_state ^= rand_state << 5;
+   return (float)rand_state / 4294967296.0f * 2.0f - 1.0f;
+}
+
+/* Noise plus a slow sine sweep, different on each channel */
+static float *make_signal(unsigned frames)
+{
+   unsigned i;
+   float *signal = (float*)malloc(frames * 2 * sizeof(*signal));
+   double phase  = 0.0;
+
+   if (!signal)
+      return NULL;
+
+   for (i = 0; i < frames; i++)
+   {
+      double freq        = 20.0 + 12000.0 * i / frames;
+      phase             += 2.0 * M_PI * freq / SAMPLE_RATE;
+      signal[2 * i + 0]  = 0.25f * (float)sin(phase) + 0.2f * rand_float();
+      signal[2 * i + 1]  = 0.25f * (float)cos(1.5 * phase)
+         + 0.2f * rand_float();
+   }
+
+   return signal;
+}
+
+static struct string_list *make_plug_list(const char *reference,
+      const struct string_list *plugins)
+{
+   unsigned i;
+   union string_list_elem_attr attr;
+   struct string_list *list = string_list_new();
+
+   attr.i = 0;
+
+   if (!list)
+      return NULL;
+
+   /* The filter chain uses the first plugin with a matching ident */
+   if (reference)
+      string_list_append(list, reference, attr);
+   for (i = 0; i < plugins->size; i++)
+      string_list_append(list, plugins->elems[i].data, attr);
+
+   return list;
+}
+
+/* Runs the whole signal through a preset in CHUNK_FRAMES pieces.
+ * The output is stored if out is not NULL. Returns the time
+ * spent in the filters in microseconds, or -1 on failure. */
+static retro_time_t run_preset(const char *preset, const char *reference,
+      const struct string_list *plugins, const float *signal,
+      unsigned frames, float *out, unsigned *out_frames)
+{
+   unsigned pos;
+   float chunk[CHUNK_FRAMES * 2];
+   retro_time_t elapsed      = 0;
+   unsigned written          = 0;
+   struct string_list *plugs = make_plug_list(reference, plugins);
+   retro_dsp_filter_t *dsp   = plugs
+      ? retro_dsp_filter_new(preset, plugs, SAMPLE_RATE) : NULL;
+
+   if (!dsp)
+      return -1;
+
+   for (pos = 0; pos < frames; pos += CHUNK_FRAMES)
+   {
+      retro_time_t start;
+      struct retro_dsp_data data;
+      unsigned count     = frames - pos;
+
+      if (count > CHUNK_FRAMES)
+         count           = CHUNK_FRAMES;
+
+      /* Some filters work in place */
+      memcpy(chunk, signal + pos * 2, count * 2 * sizeof(float));
+
+      data.input         = chunk;
+      data.input_frames  = count;
+      data.output        = NULL;
+      data.output_frames = 0;
+
+      start              = cpu_features_get_time_usec();
+      retro_dsp_filter_process(dsp, &data);
+      elapsed           += cpu_features_get_time_usec() - start;
+
+      if (out && data.output_frames)
+      {
+         unsigned avail = frames - written;
+         if (data.output_frames < avail)
+            avail       = data.output_frames;
+         memcpy(out + written * 2, data.output, avail * 2 * sizeof(float));
+         written       += avail;
+      }
+   }
+
+   retro_dsp_filter_free(dsp);
+
+   if (out_frames)
+      *out_frames = written;
+
+   return elapsed;
+}
+
+static bool bench_preset(const char *preset,
+      const struct string_list *plugins,
+      const float *signal, unsigned frames)
+{
+   unsigned i;
+   double audio_sec  = frames / SAMPLE_RATE;
+   retro_time_t best = -1;
+
+   for (i = 0; i < BENCH_RUNS; i++)
+   {
+      retro_time_t usec = run_preset(preset, NULL, plugins,
+            signal, frames, NULL, NULL);
+      if (usec < 0)
+      {
+         fprintf(stderr, "%s: could not create the filter chain\n",
+               path_basename(preset));
+         return false;
+      }
+      if (best < 0 || usec < best)
+         best = usec;
+   }
+
+   printf("%-24s %8.3f ms per second of audio, %8.1fx realtime\n",
+         path_basename(preset), best / 1000.0 / audio_sec,
+         audio_sec * 1000000.0 / (best ? best : 1));
+   return true;
+}
+
+/* Finds the shift between the two outputs that makes them line up,
+ * as a number of frames b lags behind a (or a behind b if negative). */
+static int find_lag(const float *a, unsigned a_frames,
+      const float *b, unsigned b_frames)
+{
+   int lag;
+   int best_lag     = 0;
+   double best_diff = -1.0;
+   unsigned start   = MAX_LAG;
+
+   for (lag = -MAX_LAG; lag <= MAX_LAG; lag++)
+   {
+      unsigned i;
+      double diff = 0.0;
+
+      if (start + LAG_WINDOW + MAX_LAG > a_frames
+            || start + LAG_WINDOW + MAX_LAG > b_frames)
+         break;
+
+      for (i = start; i < start + LAG_WINDOW; i++)
+         diff += fabs(a[2 * i] - b[2 * (i + lag)]);
+
+      if (best_diff < 0.0 || diff < best_diff)
+      {
+         best_diff = diff;
+         best_lag  = lag;
+      }
+   }
+
+   return best_lag;
+}
+
+static bool compare_preset(const char *preset, const char *reference,
+      const struct string_list *plugins, const float *signal,
+      unsigned frames, double tolerance)
+{
+   unsigned ref_frames, test_frames;
+   int i, lag, first, last;
+   double max_diff   = 0.0;
+   double max_level  = 0.0;
+   bool ok           = false;
+   float *ref_out    = (float*)calloc(frames * 2, sizeof(float));
+   float *test_out   = (float*)calloc(frames * 2, sizeof(float));
+
+   if (!ref_out || !test_out)
+      goto end;
+
+   if (  run_preset(preset, reference, plugins, signal, frames,
+            ref_out, &ref_frames) < 0
+      || run_preset(preset, NULL, plugins, signal, frames,
+            test_out, &test_frames) < 0)
+   {
+      fprintf(stderr, "%s: could not create the filter chain\n",
+            path_basename(preset));
+      goto end;
+   }
+
+   lag   = find_lag(test_out, test_frames, ref_out, ref_frames);
+   first = lag < 0 ? -lag : 0;
+   last  = (int)test_frames;
+   if ((int)ref_frames - lag < last)
+      last  = (int)ref_frames - lag;
+
+   for (i = first; i < last; i++)
+   {
+      unsigned c;
+      for (c = 0; c < 2; c++)
+      {
+         double ref  = ref_out[2 * (i + lag) + c];
+         double diff = fabs(test_out[2 * i + c] - ref);
+         if (diff > max_diff)
+            max_diff  = diff;
+         if (fabs(ref) > max_level)
+            max_level = fabs(ref);
+      }
+   }
+
+   ok = last > first && max_diff <= tolerance;
+
+   printf("%-24s offset %+d frames from the reference, "
+         "max difference %.3g (peak level %.3g), %s\n",
+         path_basename(preset), -lag, max_diff, max_level,
+         ok ? "ok" : "FAILED");
+
+end:
+   free(ref_out);
+   free(test_out);
+   return ok;
+}
+
+static void print_usage(const char *prog)
+{
+   fprintf(stderr,
+         "Usage: %s [-s seconds] [-c reference.so [-t tolerance]] "
+         "plugin_dir preset.dsp...\n", prog);
+}
+
+int main(int argc, char *argv[])
+{
+   int i;
+   unsigned frames;
+   float *signal                = NULL;
+   struct string_list *plugins  = NULL;
+   const char *reference        = NULL;
+   double seconds               = 10.0;
+   double tolerance             = DEFAULT_TOL;
+   int ret                      = 0;
+
+   for (i = 1; i < argc && argv[i][0] == '-'; i++)
+   {
+      if (i + 1 >= argc)
+         break;
+
+      if (!strcmp(argv[i], "-s"))
+         seconds   = atof(argv[++i]);
+      else if (!strcmp(argv[i], "-c"))
+         reference = argv[++i];
+      else if (!strcmp(argv[i], "-t"))
+         tolerance = atof(argv[++i]);
+      else
+         break;
+   }
+
+   if (argc - i < 2 || seconds <= 0.0)
+   {
+      print_usage(argv[0]);
+      return 1;
+   }
+
+   plugins = dir_list_new(argv[i], "so", false, false, false, false);
+   if (!plugins || !plugins->size)
+   {
+      fprintf(stderr, "No plugins found in %s\n", argv[i]);
+      string_list_free(plugins);
+      return 1;
+   }
+   i++;
+
+   frames = (unsigned)(seconds * SAMPLE_RATE);
+   signal = make_signal(frames);
+   if (!signal)
+   {
+      string_list_free(plugins);
+      return 1;
+   }
+
+   for (; i < argc; i++)
+   {
+      bool ok = reference
+         ? compare_preset(argv[i], reference, plugins,
+               signal, frames, tolerance)
+         : bench_preset(argv[i], plugins, signal, frames);
+      if (!ok)
+         ret = 1;
+   }
+
+   free(signal);
+   string_list_free(plugins);
+   return ret;
+}
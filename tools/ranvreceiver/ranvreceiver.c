@@ -0,0 +1,286 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2020 - The RetroArch team
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <zlib.h>
+
+#include "compat/getopt.h"
+#include "net/net_compat.h"
+#include "net/net_socket.h"
+
+#include "../../gfx/common/network_common.h"
+
+#define TILE_BYTES (NETWORK_VIDEO_TILE_SIZE * NETWORK_VIDEO_TILE_SIZE * 4)
+
+static int sock = -1;
+
+static void receive(void *data, size_t size)
+{
+   if (!socket_receive_all_blocking(sock, data, size))
+   {
+      fprintf(stderr, "Sender disconnected.\n");
+      exit(0);
+   }
+}
+
+static uint32_t get32(const uint8_t *p)
+{
+   return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16)
+      | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static void write_ppm(const char *path, const uint32_t *pixels,
+      unsigned width, unsigned height, unsigned pixfmt)
+{
+   size_t i;
+   FILE *f = fopen(path, "wb");
+
+   if (!f)
+   {
+      perror(path);
+      return;
+   }
+
+   fprintf(f, "P6\n%u %u\n255\n", width, height);
+   for (i = 0; i < (size_t)width * height; i++)
+   {
+      /* Pixels are stored as sent, 4 bytes each in memory order */
+      const uint8_t *p = (const uint8_t*)&pixels[i];
+      uint8_t rgb[3];
+
+      if (pixfmt == NETWORK_VIDEO_PIXELFORMAT_RGBA8888)
+      {
+         rgb[0] = p[0];
+         rgb[1] = p[1];
+         rgb[2] = p[2];
+      }
+      else
+      {
+         rgb[0] = p[2];
+         rgb[1] = p[1];
+         rgb[2] = p[0];
+      }
+      fwrite(rgb, 1, 3, f);
+   }
+   fclose(f);
+}
+
+static void usage(void)
+{
+   fprintf(stderr,
+         "Use: ranvreceiver [options]\n"
+         "Options:\n"
+         "  -p|--port <port>:     Port to listen on (default 4953)\n"
+         "  -n|--frames <count>:  Exit after this many frames\n"
+         "  -o|--output <file>:   Write the last frame to this PPM file on exit\n"
+         "\n");
+}
+
+int main(int argc, char **argv)
+{
+   const char *optstring      = "p:n:o:h";
+   const struct option opts[] = {
+      {"port",   1, NULL, 'p'},
+      {"frames", 1, NULL, 'n'},
+      {"output", 1, NULL, 'o'},
+      {"help",   0, NULL, 'h'},
+      {NULL, 0, NULL, 0}
+   };
+   struct addrinfo *addr  = NULL;
+   uint16_t port          = 4953;
+   unsigned long max      = 0;
+   const char *output     = NULL;
+   uint32_t *pixels       = NULL;
+   unsigned width         = 0;
+   unsigned height        = 0;
+   unsigned pixfmt        = 0;
+   unsigned long frames   = 0;
+   unsigned long second_frames = 0;
+   unsigned long second_tiles  = 0;
+   unsigned long second_bytes  = 0;
+   time_t second          = time(NULL);
+   uint8_t payload[TILE_BYTES + TILE_BYTES / 8 + 64];
+   uint8_t tile[TILE_BYTES];
+   int listen_fd, c;
+
+   for (;;)
+   {
+      c = getopt_long(argc, argv, optstring, opts, NULL);
+      if (c == -1)
+         break;
+
+      switch (c)
+      {
+         case 'p':
+            port = (uint16_t)atoi(optarg);
+            break;
+         case 'n':
+            max = strtoul(optarg, NULL, 10);
+            break;
+         case 'o':
+            output = optarg;
+            break;
+         case 'h':
+            usage();
+            return 0;
+         default:
+            usage();
+            return 1;
+      }
+   }
+
+   if ((listen_fd = socket_init((void**)&addr, port, NULL,
+               SOCKET_TYPE_STREAM)) < 0)
+   {
+      perror("socket");
+      return 1;
+   }
+   if (!socket_bind(listen_fd, addr) || listen(listen_fd, 1) < 0)
+   {
+      perror("bind");
+      return 1;
+   }
+   freeaddrinfo_retro(addr);
+
+   fprintf(stderr, "Waiting for RetroArch on port %u...\n", (unsigned)port);
+   if ((sock = accept(listen_fd, NULL, NULL)) < 0)
+   {
+      perror("accept");
+      return 1;
+   }
+   socket_close(listen_fd);
+
+   while (!max || frames < max)
+   {
+      uint8_t header[7 * 4];
+      unsigned tile_size, num_tiles, tiles_x, i;
+      unsigned frame_width, frame_height;
+
+      receive(header, sizeof(header));
+      if (get32(header) != NETWORK_VIDEO_FRAME_MAGIC)
+      {
+         fprintf(stderr, "Not a tiled network video stream.\n");
+         return 1;
+      }
+
+      frame_width  = get32(header + 8);
+      frame_height = get32(header + 12);
+      pixfmt       = get32(header + 16);
+      tile_size    = get32(header + 20);
+      num_tiles    = get32(header + 24);
+
+      if (!tile_size || tile_size > NETWORK_VIDEO_TILE_SIZE)
+      {
+         fprintf(stderr, "Unsupported tile size %u.\n", tile_size);
+         return 1;
+      }
+
+      if (frame_width != width || frame_height != height)
+      {
+         width  = frame_width;
+         height = frame_height;
+         free(pixels);
+         if (!(pixels = (uint32_t*)calloc((size_t)width * height,
+                     sizeof(*pixels))))
+         {
+            perror("calloc");
+            return 1;
+         }
+         fprintf(stderr, "Frame size is now %ux%u.\n", width, height);
+      }
+
+      tiles_x = (width + tile_size - 1) / tile_size;
+
+      for (i = 0; i < num_tiles; i++)
+      {
+         uint8_t tile_header[3 * 4];
+         unsigned index, encoding, size, x0, y0, tw, th, y;
+         const uint8_t *src = payload;
+
+         receive(tile_header, sizeof(tile_header));
+         index    = get32(tile_header);
+         encoding = get32(tile_header + 4);
+         size     = get32(tile_header + 8);
+
+         if (size > sizeof(payload))
+         {
+            fprintf(stderr, "Tile of %u bytes is too large.\n", size);
+            return 1;
+         }
+         receive(payload, size);
+
+         x0 = (index % tiles_x) * tile_size;
+         y0 = (index / tiles_x) * tile_size;
+         if (x0 >= width || y0 >= height)
+            continue;
+         tw = (width  - x0 < tile_size) ? width  - x0 : tile_size;
+         th = (height - y0 < tile_size) ? height - y0 : tile_size;
+
+         if (encoding == NETWORK_VIDEO_TILE_ZLIB)
+         {
+            uLongf tile_len = sizeof(tile);
+            if (uncompress(tile, &tile_len, payload, size) != Z_OK)
+            {
+               fprintf(stderr, "Tile %u does not decompress.\n", index);
+               continue;
+            }
+            size = (unsigned)tile_len;
+            src  = tile;
+         }
+
+         if (size != tw * th * 4)
+         {
+            fprintf(stderr, "Tile %u has the wrong size.\n", index);
+            continue;
+         }
+
+         for (y = 0; y < th; y++)
+            memcpy(pixels + (size_t)(y0 + y) * width + x0,
+                  src + y * tw * 4, tw * 4);
+
+         second_bytes += sizeof(tile_header) + size;
+      }
+
+      frames++;
+      second_frames++;
+      second_tiles += num_tiles;
+      second_bytes += sizeof(header);
+
+      if (time(NULL) != second)
+      {
+         printf("%lu frames, %.1f tiles/frame, %lu KiB/s\n",
+               second_frames,
+               (double)second_tiles / second_frames,
+               second_bytes / 1024);
+         fflush(stdout);
+         second        = time(NULL);
+         second_frames = 0;
+         second_tiles  = 0;
+         second_bytes  = 0;
+      }
+   }
+
+   if (output && pixels)
+      write_ppm(output, pixels, width, height, pixfmt);
+
+   socket_close(sock);
+   free(pixels);
+   return 0;
+}
@@ -0,0 +1,279 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2020 - The RetroArch team
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Checks that every SIMD build of the pixel converters in
+ * libretro-common/gfx/scaler/pixconv.c produces the same output as
+ * the scalar build, and reports the throughput of each.
+ *
+ * The converters are run on random pixels, for every width up to a
+ * few SIMD blocks and a handful of larger ones, with padded strides
+ * and input that is not aligned to the vector size. The output is
+ * compared over the whole buffer, so writes into the stride padding
+ * or past the last line count as mismatches too. */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <boolean.h>
+
+#include "pixconv_variant.h"
+#include "simdtest.h"
+
+#define MAX_WIDTH      1024
+#define MAX_HEIGHT     8
+#define MAX_PAD        64
+#define MAX_OFFSET     32
+#define BENCH_WIDTH    640
+#define BENCH_HEIGHT   480
+#define BENCH_USEC     250000
+#define CANARY         0x5a
+
+struct converter
+{
+   const char *name;
+   unsigned in_bpp;
+   unsigned out_bpp;
+};
+
+struct variant
+{
+   const char *name;
+   const pixconv_func_t *funcs;
+   bool (*supported)(void);
+};
+
+static const struct converter converters[] = {
+#define X(name, in_bpp, out_bpp) { #name, in_bpp, out_bpp },
+   PIXCONV_CONVERTERS
+#undef X
+};
+
+#if defined(HAVE_PIXCONV_X86)
+static bool cpu_has_sse2(void)
+{
+   __builtin_cpu_init();
+   return __builtin_cpu_supports("sse2");
+}
+
+static bool cpu_has_ssse3(void)
+{
+   __builtin_cpu_init();
+   return __builtin_cpu_supports("ssse3");
+}
+
+static bool cpu_has_avx2(void)
+{
+   __builtin_cpu_init();
+   return __builtin_cpu_supports("avx2");
+}
+#endif
+
+static const struct variant variants[] = {
+#if defined(HAVE_PIXCONV_X86)
+   { "SSE2",  pixconv_sse2_converters,  cpu_has_sse2  },
+   { "SSSE3", pixconv_ssse3_converters, cpu_has_ssse3 },
+   { "AVX2",  pixconv_avx2_converters,  cpu_has_avx2  },
+#endif
+#if defined(HAVE_PIXCONV_NEON)
+   { "NEON",  pixconv_neon_converters,  NULL          },
+#endif
+   { NULL,    NULL,                     NULL          }
+};
+
+static const unsigned extra_widths[] = {
+   127, 129, 255, 256, 257, 320, 321, 639, 640, 1023, MAX_WIDTH
+};
+
+static void fill_random(uint8_t *data, size_t size)
+{
+   size_t i;
+   for (i = 0; i < size; i++)
+      data[i] = (uint8_t)(simdtest_rand() >> 24);
+}
+
+static size_t line_stride(unsigned width, unsigned bpp, unsigned pad)
+{
+   /* Keep lines 4-byte aligned, pixconv steps through
+    * 16- and 32-bit pixels with the stride */
+   return (width * bpp + pad + 3) & ~(size_t)3;
+}
+
+/* Returns the first line that differs, or -1 */
+static int compare_lines(const uint8_t *a, const uint8_t *b,
+      size_t stride, unsigned height, size_t size)
+{
+   unsigned y;
+
+   for (y = 0; y < height; y++)
+      if (memcmp(a + y * stride, b + y * stride, stride))
+         return y;
+
+   if (memcmp(a, b, size))
+      return height;
+
+   return -1;
+}
+
+static bool test_size(const struct converter *conv,
+      const struct variant *var, unsigned index,
+      unsigned width, unsigned height,
+      uint8_t *in, uint8_t *out_ref, uint8_t *out_simd, size_t out_size)
+{
+   int line;
+   unsigned pad        = (simdtest_rand() % (MAX_PAD / 4 + 1)) * 4;
+   unsigned offset     = (simdtest_rand() % (MAX_OFFSET / 4)) * 4;
+   size_t in_stride    = line_stride(width, conv->in_bpp, pad);
+   size_t out_stride   = line_stride(width, conv->out_bpp, pad);
+   const uint8_t *src  = in + offset;
+
+   memset(out_ref,  CANARY, out_size);
+   memset(out_simd, CANARY, out_size);
+
+   pixconv_scalar_converters[index](out_ref, src, width, height,
+         (int)out_stride, (int)in_stride);
+   var->funcs[index](out_simd, src, width, height,
+         (int)out_stride, (int)in_stride);
+
+   line = compare_lines(out_ref, out_simd, out_stride, height, out_size);
+   if (line < 0)
+      return true;
+
+   fprintf(stderr, "  %s: %s differs at %ux%u (strides %u/%u, "
+         "input offset %u), line %d\n",
+         var->name, conv->name, width, height,
+         (unsigned)in_stride, (unsigned)out_stride, offset, line);
+   return false;
+}
+
+static bool test_converter(const struct converter *conv,
+      const struct variant *var, unsigned index,
+      uint8_t *in, uint8_t *out_ref, uint8_t *out_simd, size_t out_size)
+{
+   unsigned i, width, height;
+   /* YUYV carries two pixels per chroma pair */
+   unsigned step = !strcmp(conv->name, "conv_yuyv_argb8888") ? 2 : 1;
+
+   for (height = 1; height <= MAX_HEIGHT; height++)
+   {
+      for (width = step; width <= 80; width += step)
+         if (!test_size(conv, var, index, width, height,
+                  in, out_ref, out_simd, out_size))
+            return false;
+
+      for (i = 0; i < sizeof(extra_widths) / sizeof(extra_widths[0]); i++)
+      {
+         width = extra_widths[i] & ~(step - 1);
+         if (!test_size(conv, var, index, width, height,
+                  in, out_ref, out_simd, out_size))
+            return false;
+      }
+   }
+
+   return true;
+}
+
+static double bench_func(pixconv_func_t func, const struct converter *conv,
+      uint8_t *in, uint8_t *out)
+{
+   unsigned frames   = 0;
+   size_t in_stride  = line_stride(BENCH_WIDTH, conv->in_bpp, 0);
+   size_t out_stride = line_stride(BENCH_WIDTH, conv->out_bpp, 0);
+   int64_t start     = simdtest_time_usec();
+   int64_t elapsed;
+
+   do
+   {
+      func(out, in, BENCH_WIDTH, BENCH_HEIGHT,
+            (int)out_stride, (int)in_stride);
+      frames++;
+      elapsed = simdtest_time_usec() - start;
+   } while (elapsed < BENCH_USEC);
+
+   return (double)frames * BENCH_WIDTH * BENCH_HEIGHT / (double)elapsed;
+}
+
+int main(int argc, char *argv[])
+{
+   unsigned c, v;
+   int ret               = 0;
+   bool bench            = argc > 1 && !strcmp(argv[1], "-b");
+   size_t in_size        = (MAX_WIDTH * 4 + MAX_PAD + 4)
+      * (BENCH_HEIGHT > MAX_HEIGHT ? BENCH_HEIGHT : MAX_HEIGHT) + MAX_OFFSET;
+   size_t out_size       = (MAX_WIDTH * 4 + MAX_PAD + 4)
+      * (BENCH_HEIGHT > MAX_HEIGHT ? BENCH_HEIGHT : MAX_HEIGHT);
+   uint8_t *in           = (uint8_t*)malloc(in_size);
+   uint8_t *out_ref      = (uint8_t*)malloc(out_size);
+   uint8_t *out_simd     = (uint8_t*)malloc(out_size);
+
+   if (argc > 2 || (argc == 2 && !bench))
+   {
+      fprintf(stderr, "Usage: %s [-b]\n", argv[0]);
+      return 1;
+   }
+
+   if (!in || !out_ref || !out_simd)
+   {
+      fprintf(stderr, "Out of memory\n");
+      return 1;
+   }
+
+   fill_random(in, in_size);
+
+   for (v = 0; variants[v].name; v++)
+   {
+      const struct variant *var = &variants[v];
+      bool ok                   = true;
+
+      if (var->supported && !var->supported())
+      {
+         printf("%s: not supported by this CPU, skipped\n", var->name);
+         continue;
+      }
+
+      printf("%s\n", var->name);
+
+      for (c = 0; c < sizeof(converters) / sizeof(converters[0]); c++)
+      {
+         if (!test_converter(&converters[c], var, c,
+                  in, out_ref, out_simd, out_size))
+            ok = false;
+
+         if (bench)
+         {
+            double scalar = bench_func(pixconv_scalar_converters[c],
+                  &converters[c], in, out_ref);
+            double simd   = bench_func(var->funcs[c],
+                  &converters[c], in, out_simd);
+
+            printf("  %-24s %8.1f Mpix/s scalar, %8.1f Mpix/s %s (%.2fx)\n",
+                  converters[c].name, scalar, simd, var->name,
+                  simd / scalar);
+         }
+      }
+
+      if (ok)
+         printf("  ok\n");
+      else
+         ret = 1;
+   }
+
+   free(in);
+   free(out_ref);
+   free(out_simd);
+
+   return ret;
+}
@@ -0,0 +1,58 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2020 - The RetroArch team
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Builds libretro-common's pixconv.c under a prefix, so that the
+ * scalar build and one build per instruction set can be linked into
+ * the same program. The Makefile compiles this file once for every
+ * variant, with PIXCONV_VARIANT set to its name and the matching
+ * compiler flags (SCALER_NO_SIMD for the scalar one). */
+
+#ifndef PIXCONV_VARIANT
+#error "PIXCONV_VARIANT must be defined"
+#endif
+
+#define PIXCONV_PASTE_(a, b) pixconv_##a##_##b
+#define PIXCONV_PASTE(a, b)  PIXCONV_PASTE_(a, b)
+#define PIXCONV_NAME(name)   PIXCONV_PASTE(PIXCONV_VARIANT, name)
+
+#define conv_0rgb1555_argb8888 PIXCONV_NAME(conv_0rgb1555_argb8888)
+#define conv_0rgb1555_rgb565   PIXCONV_NAME(conv_0rgb1555_rgb565)
+#define conv_rgb565_0rgb1555   PIXCONV_NAME(conv_rgb565_0rgb1555)
+#define conv_rgb565_abgr8888   PIXCONV_NAME(conv_rgb565_abgr8888)
+#define conv_rgb565_argb8888   PIXCONV_NAME(conv_rgb565_argb8888)
+#define conv_rgba4444_argb8888 PIXCONV_NAME(conv_rgba4444_argb8888)
+#define conv_rgba4444_rgb565   PIXCONV_NAME(conv_rgba4444_rgb565)
+#define conv_bgr24_argb8888    PIXCONV_NAME(conv_bgr24_argb8888)
+#define conv_bgr24_rgb565      PIXCONV_NAME(conv_bgr24_rgb565)
+#define conv_argb8888_0rgb1555 PIXCONV_NAME(conv_argb8888_0rgb1555)
+#define conv_argb8888_rgba4444 PIXCONV_NAME(conv_argb8888_rgba4444)
+#define conv_argb8888_rgb565   PIXCONV_NAME(conv_argb8888_rgb565)
+#define conv_argb8888_bgr24    PIXCONV_NAME(conv_argb8888_bgr24)
+#define conv_abgr8888_bgr24    PIXCONV_NAME(conv_abgr8888_bgr24)
+#define conv_argb8888_abgr8888 PIXCONV_NAME(conv_argb8888_abgr8888)
+#define conv_0rgb1555_bgr24    PIXCONV_NAME(conv_0rgb1555_bgr24)
+#define conv_rgb565_bgr24      PIXCONV_NAME(conv_rgb565_bgr24)
+#define conv_yuyv_argb8888     PIXCONV_NAME(conv_yuyv_argb8888)
+#define conv_copy              PIXCONV_NAME(conv_copy)
+
+#include "../../libretro-common/gfx/scaler/pixconv.c"
+
+#include "pixconv_variant.h"
+
+const pixconv_func_t PIXCONV_PASTE(PIXCONV_VARIANT, converters)[] = {
+#define X(name, in_bpp, out_bpp) name,
+   PIXCONV_CONVERTERS
+#undef X
+};
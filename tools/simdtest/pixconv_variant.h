@@ -0,0 +1,51 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2020 - The RetroArch team
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __PIXCONV_VARIANT_H
+#define __PIXCONV_VARIANT_H
+
+typedef void (*pixconv_func_t)(void *output, const void *input,
+      int width, int height,
+      int out_stride, int in_stride);
+
+/* The converters that have SIMD paths, with their input
+ * and output bytes per pixel. conv_copy and
+ * conv_argb8888_rgba4444 are plain C only. */
+#define PIXCONV_CONVERTERS \
+   X(conv_0rgb1555_argb8888, 2, 4) \
+   X(conv_0rgb1555_rgb565,   2, 2) \
+   X(conv_rgb565_0rgb1555,   2, 2) \
+   X(conv_rgb565_abgr8888,   2, 4) \
+   X(conv_rgb565_argb8888,   2, 4) \
+   X(conv_rgba4444_argb8888, 2, 4) \
+   X(conv_rgba4444_rgb565,   2, 2) \
+   X(conv_bgr24_argb8888,    3, 4) \
+   X(conv_bgr24_rgb565,      3, 2) \
+   X(conv_argb8888_0rgb1555, 4, 2) \
+   X(conv_argb8888_bgr24,    4, 3) \
+   X(conv_abgr8888_bgr24,    4, 3) \
+   X(conv_argb8888_abgr8888, 4, 4) \
+   X(conv_0rgb1555_bgr24,    2, 3) \
+   X(conv_rgb565_bgr24,      2, 3) \
+   X(conv_yuyv_argb8888,     2, 4)
+
+/* pixconv.c is built once per instruction set, see pixconv_variant.c */
+extern const pixconv_func_t pixconv_scalar_converters[];
+extern const pixconv_func_t pixconv_sse2_converters[];
+extern const pixconv_func_t pixconv_ssse3_converters[];
+extern const pixconv_func_t pixconv_avx2_converters[];
+extern const pixconv_func_t pixconv_neon_converters[];
+
+#endif
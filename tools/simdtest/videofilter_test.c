@@ -0,0 +1,412 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2020 - The RetroArch team
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Checks that the SIMD paths of the CPU video filters produce the same
+ * output as their scalar paths, and reports the throughput of both.
+ *
+ * Every filter is created twice from the same plugin: once with an
+ * empty SIMD mask, which forces the scalar code, and once with every
+ * SIMD bit set, which lets the plugin pick whatever it was built with.
+ * Both are fed the same frames, for each supported input format, over
+ * a set of sizes that includes odd widths and heights, and split into
+ * several thread slices. */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <boolean.h>
+#include <dynamic/dylib.h>
+
+#include "../../gfx/video_filters/softfilter.h"
+
+#include "simdtest.h"
+
+#define MAX_WIDTH   1024
+#define MAX_HEIGHT  512
+#define MAX_SCALE   4
+#define MAX_THREADS 8
+
+struct frame_size
+{
+   unsigned width;
+   unsigned height;
+};
+
+/* The edge columns are always done by scalar code, so the SIMD paths
+ * only start to matter from a few pixels wide. The filters also look
+ * at the neighbours of the first and last row and column, so narrower
+ * frames are not something they support. */
+static const struct frame_size frame_sizes[] = {
+   { 3,   2   },
+   { 4,   3   },
+   { 7,   5   },
+   { 15,  9   },
+   { 16,  16  },
+   { 17,  31  },
+   { 33,  7   },
+   { 63,  64  },
+   { 255, 17  },
+   { 320, 240 },
+   { 321, 241 },
+};
+
+static const unsigned thread_counts[] = { 1, 2, 3, 8 };
+
+static int config_get_float(void *userdata, const char *key,
+      float *value, float default_value)
+{
+   *value = default_value;
+   return 0;
+}
+
+static int config_get_int(void *userdata, const char *key,
+      int *value, int default_value)
+{
+   *value = default_value;
+   return 0;
+}
+
+static int config_get_float_array(void *userdata, const char *key,
+      float **values, unsigned *out_num_values,
+      const float *default_values, unsigned num_default_values)
+{
+   *values = (float*)malloc(num_default_values * sizeof(float));
+   if (!*values)
+      return 0;
+   memcpy(*values, default_values, num_default_values * sizeof(float));
+   *out_num_values = num_default_values;
+   return 0;
+}
+
+static int config_get_int_array(void *userdata, const char *key,
+      int **values, unsigned *out_num_values,
+      const int *default_values, unsigned num_default_values)
+{
+   *values = (int*)malloc(num_default_values * sizeof(int));
+   if (!*values)
+      return 0;
+   memcpy(*values, default_values, num_default_values * sizeof(int));
+   *out_num_values = num_default_values;
+   return 0;
+}
+
+static int config_get_string(void *userdata, const char *key,
+      char **output, const char *default_output)
+{
+   *output = strdup(default_output);
+   return 0;
+}
+
+static const struct softfilter_config filter_config = {
+   config_get_float,
+   config_get_int,
+   config_get_float_array,
+   config_get_int_array,
+   config_get_string,
+   free,
+};
+
+struct filter_instance
+{
+   const struct softfilter_implementation *impl;
+   void *data;
+   unsigned threads;
+};
+
+static bool filter_create(struct filter_instance *filt,
+      const struct softfilter_implementation *impl, unsigned fmt,
+      unsigned threads, softfilter_simd_mask_t simd)
+{
+   filt->impl = impl;
+   filt->data = impl->create(&filter_config, fmt, fmt,
+         MAX_WIDTH, MAX_HEIGHT, threads, simd, NULL);
+   if (!filt->data)
+      return false;
+   filt->threads = impl->query_num_threads(filt->data);
+   return filt->threads && filt->threads <= MAX_THREADS;
+}
+
+/* The frontend hands each packet to its own thread. They write to
+ * disjoint slices of the output, so running them one after another
+ * gives the same result. */
+static void filter_run(struct filter_instance *filt,
+      void *out, size_t out_stride,
+      const void *in, unsigned width, unsigned height, size_t in_stride)
+{
+   unsigned i;
+   struct softfilter_work_packet packets[MAX_THREADS];
+
+   filt->impl->get_work_packets(filt->data, packets, out, out_stride,
+         in, width, height, in_stride);
+   for (i = 0; i < filt->threads; i++)
+      packets[i].work(filt->data, packets[i].thread_data);
+}
+
+enum pattern
+{
+   PATTERN_RANDOM = 0,
+   PATTERN_FEW_COLORS,
+   PATTERN_TWO_COLORS,
+   PATTERN_COUNT
+};
+
+static const char *pattern_names[] = { "random", "few colours", "two colours" };
+
+/* Flat areas and edges are what the edge-directed filters branch on,
+ * so pure noise alone would leave most of their paths untested. */
+static void fill_frame(uint8_t *frame, size_t size, unsigned bpp,
+      enum pattern pattern)
+{
+   size_t i, j;
+   uint32_t palette[4];
+
+   for (i = 0; i < 4; i++)
+      palette[i] = simdtest_rand();
+
+   for (i = 0; i < size; i += bpp)
+   {
+      uint32_t pixel;
+      switch (pattern)
+      {
+         case PATTERN_FEW_COLORS:
+            pixel = palette[(simdtest_rand() >> 7) & 3];
+            break;
+         case PATTERN_TWO_COLORS:
+            pixel = palette[(simdtest_rand() >> 11) & 1];
+            break;
+         default:
+            pixel = simdtest_rand();
+            break;
+      }
+      for (j = 0; j < bpp; j++)
+         frame[i + j] = (uint8_t)(pixel >> (8 * j));
+   }
+}
+
+static unsigned test_format(const struct softfilter_implementation *impl,
+      unsigned fmt, unsigned bpp)
+{
+   unsigned s, t, p, y;
+   unsigned failures  = 0;
+   size_t in_stride   = (MAX_WIDTH + 3) * bpp;
+   size_t out_stride  = (MAX_WIDTH * MAX_SCALE + 5) * bpp;
+   size_t out_size    = out_stride * MAX_HEIGHT * MAX_SCALE;
+   /* Filters read the row above the first and below the last one */
+   uint8_t *in_rows   = (uint8_t*)malloc(in_stride * (MAX_HEIGHT + 2));
+   uint8_t *in        = in_rows + in_stride;
+   uint8_t *out_ref   = (uint8_t*)malloc(out_size);
+   uint8_t *out_simd  = (uint8_t*)malloc(out_size);
+
+   if (!in_rows || !out_ref || !out_simd)
+      goto end;
+
+   for (t = 0; t < sizeof(thread_counts) / sizeof(*thread_counts); t++)
+   {
+      struct filter_instance ref, simd;
+
+      memset(&ref,  0, sizeof(ref));
+      memset(&simd, 0, sizeof(simd));
+
+      if (     !filter_create(&ref, impl, fmt, thread_counts[t], 0)
+            || !filter_create(&simd, impl, fmt, thread_counts[t],
+               ~(softfilter_simd_mask_t)0))
+      {
+         printf("  %s: could not create with %u threads\n",
+               bpp == 2 ? "RGB565" : "XRGB8888", thread_counts[t]);
+         failures++;
+         if (ref.data)
+            impl->destroy(ref.data);
+         if (simd.data)
+            impl->destroy(simd.data);
+         continue;
+      }
+
+      for (s = 0; s < sizeof(frame_sizes) / sizeof(*frame_sizes); s++)
+      {
+         unsigned width  = frame_sizes[s].width;
+         unsigned height = frame_sizes[s].height;
+         unsigned out_width, out_height;
+
+         impl->query_output_size(ref.data, &out_width, &out_height,
+               width, height);
+         if (     out_width  > MAX_WIDTH * MAX_SCALE
+               || out_height > MAX_HEIGHT * MAX_SCALE)
+            continue;
+
+         for (p = 0; p < PATTERN_COUNT; p++)
+         {
+            fill_frame(in_rows, in_stride * (MAX_HEIGHT + 2), bpp,
+                  (enum pattern)p);
+
+            /* Same canary in both, so stray writes show up as well */
+            memset(out_ref,  0x5a, out_size);
+            memset(out_simd, 0x5a, out_size);
+
+            filter_run(&ref,  out_ref,  out_stride, in, width, height,
+                  in_stride);
+            filter_run(&simd, out_simd, out_stride, in, width, height,
+                  in_stride);
+
+            if (!memcmp(out_ref, out_simd, out_size))
+               continue;
+
+            for (y = 0; y < out_height; y++)
+               if (memcmp(out_ref + y * out_stride,
+                        out_simd + y * out_stride, out_stride))
+                  break;
+            printf("  %s: MISMATCH at %ux%u, %u threads, %s frame, "
+                  "first in output row %u\n",
+                  bpp == 2 ? "RGB565" : "XRGB8888", width, height,
+                  ref.threads, pattern_names[p], y);
+            failures++;
+         }
+      }
+
+      impl->destroy(ref.data);
+      impl->destroy(simd.data);
+   }
+
+end:
+   free(in_rows);
+   free(out_ref);
+   free(out_simd);
+   return failures;
+}
+
+static double bench_format(const struct softfilter_implementation *impl,
+      unsigned fmt, unsigned bpp, softfilter_simd_mask_t mask,
+      unsigned width, unsigned height)
+{
+   unsigned frames = 0;
+   double mpix     = 0.0;
+   size_t in_stride;
+   size_t out_stride;
+   uint8_t *in_rows = NULL;
+   uint8_t *in     = NULL;
+   uint8_t *out    = NULL;
+   int64_t start, elapsed;
+   unsigned out_width, out_height;
+   struct filter_instance filt;
+
+   if (!filter_create(&filt, impl, fmt, 1, mask))
+      return 0.0;
+
+   impl->query_output_size(filt.data, &out_width, &out_height,
+         width, height);
+   in_stride  = width * bpp;
+   out_stride = out_width * bpp;
+   in_rows    = (uint8_t*)malloc(in_stride * (height + 2));
+   in         = in_rows + in_stride;
+   out        = (uint8_t*)malloc(out_stride * out_height);
+
+   if (in_rows && out)
+   {
+      fill_frame(in_rows, in_stride * (height + 2), bpp,
+            PATTERN_FEW_COLORS);
+
+      start = simdtest_time_usec();
+      do
+      {
+         filter_run(&filt, out, out_stride, in, width, height, in_stride);
+         frames++;
+         elapsed = simdtest_time_usec() - start;
+      } while (elapsed < 250000);
+
+      mpix = (double)width * height * frames / elapsed;
+   }
+
+   free(in_rows);
+   free(out);
+   impl->destroy(filt.data);
+   return mpix;
+}
+
+static unsigned test_filter(const char *path, bool bench)
+{
+   unsigned failures = 0;
+   softfilter_get_implementation_t cb;
+   const struct softfilter_implementation *impl;
+   unsigned formats;
+   dylib_t lib = dylib_load(path);
+
+   if (!lib)
+   {
+      printf("%s: could not load\n", path);
+      return 1;
+   }
+
+   cb = (softfilter_get_implementation_t)dylib_proc(lib,
+         "softfilter_get_implementation");
+   impl = cb ? cb(~(softfilter_simd_mask_t)0) : NULL;
+   if (!impl || impl->api_version != SOFTFILTER_API_VERSION)
+   {
+      printf("%s: not a softfilter plugin\n", path);
+      dylib_close(lib);
+      return 1;
+   }
+
+   printf("%s (%s)\n", impl->ident, path);
+   formats = impl->query_input_formats();
+
+   if (formats & SOFTFILTER_FMT_RGB565)
+      failures += test_format(impl, SOFTFILTER_FMT_RGB565, 2);
+   if (formats & SOFTFILTER_FMT_XRGB8888)
+      failures += test_format(impl, SOFTFILTER_FMT_XRGB8888, 4);
+
+   if (bench)
+   {
+      if (formats & SOFTFILTER_FMT_RGB565)
+         printf("  RGB565   640x480: %8.1f Mpix/s scalar, %8.1f Mpix/s SIMD\n",
+               bench_format(impl, SOFTFILTER_FMT_RGB565, 2, 0, 640, 480),
+               bench_format(impl, SOFTFILTER_FMT_RGB565, 2,
+                  ~(softfilter_simd_mask_t)0, 640, 480));
+      if (formats & SOFTFILTER_FMT_XRGB8888)
+         printf("  XRGB8888 640x480: %8.1f Mpix/s scalar, %8.1f Mpix/s SIMD\n",
+               bench_format(impl, SOFTFILTER_FMT_XRGB8888, 4, 0, 640, 480),
+               bench_format(impl, SOFTFILTER_FMT_XRGB8888, 4,
+                  ~(softfilter_simd_mask_t)0, 640, 480));
+   }
+
+   printf("  %s\n", failures ? "FAILED" : "ok");
+   dylib_close(lib);
+   return failures;
+}
+
+int main(int argc, char *argv[])
+{
+   int i;
+   unsigned failures = 0;
+   bool bench        = false;
+   int first         = 1;
+
+   if (argc > 1 && !strcmp(argv[1], "-b"))
+   {
+      bench = true;
+      first = 2;
+   }
+
+   if (first >= argc)
+   {
+      fprintf(stderr, "Usage: %s [-b] filter.so...\n", argv[0]);
+      return 2;
+   }
+
+   for (i = first; i < argc; i++)
+      failures += test_filter(argv[i], bench);
+
+   return failures ? 1 : 0;
+}
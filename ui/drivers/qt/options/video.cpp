@@ -301,8 +301,9 @@ void CrtSwitchresPage::onCrtSuperResolutionComboIndexChanged(int index)
    settings_t *settings = config_get_ptr();
    Q_UNUSED(index)
 
-   settings->uints.crt_switch_resolution_super = 
-   m_crtSuperResolutionCombo->currentData().value<unsigned>();
+   configuration_set_uint(settings,
+         settings->uints.crt_switch_resolution_super,
+         m_crtSuperResolutionCombo->currentData().value<unsigned>());
 }
 
 AspectRatioRadioButton::AspectRatioRadioButton(unsigned min, unsigned max, QWidget *parent) :